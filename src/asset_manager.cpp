@@ -0,0 +1,357 @@
+#include "asset_manager.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+
+#include "profiler.h"
+
+static uint64_t nowNs() {
+  return uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                      std::chrono::steady_clock::now().time_since_epoch())
+                      .count());
+}
+
+// Kolejność obsługi: priorytet malejąco, w priorytecie kolejność żądań
+template <typename AssetT>
+static bool servedBefore(const AssetT &a, const AssetT &b) {
+  if (a.priority != b.priority)
+    return a.priority > b.priority;
+  return a.sequence < b.sequence;
+}
+
+// ============================================================
+//  AssetHandle
+// ============================================================
+
+AssetHandle::AssetHandle(const AssetHandle &other)
+    : m_manager(other.m_manager), m_index(other.m_index) {
+  if (m_manager)
+    m_manager->addRef(m_index);
+}
+
+AssetHandle::AssetHandle(AssetHandle &&other) noexcept
+    : m_manager(other.m_manager), m_index(other.m_index) {
+  other.m_manager = nullptr;
+}
+
+AssetHandle &AssetHandle::operator=(AssetHandle other) noexcept {
+  std::swap(m_manager, other.m_manager);
+  std::swap(m_index, other.m_index);
+  return *this;
+}
+
+AssetHandle::~AssetHandle() { reset(); }
+
+void AssetHandle::reset() {
+  if (m_manager)
+    m_manager->releaseRef(m_index);
+  m_manager = nullptr;
+}
+
+// ============================================================
+//  AssetManager
+// ============================================================
+
+AssetManager::AssetManager(WGPUDevice device, WGPUQueue queue,
+                           JobSystem &jobs, uint64_t uploadBudget)
+    : m_device(device), m_queue(queue), m_jobs(jobs),
+      m_uploadBudget(std::max<uint64_t>(uploadBudget, 1)) {
+  m_ioThread = std::thread(&AssetManager::ioThreadLoop, this);
+}
+
+AssetManager::~AssetManager() {
+  {
+    std::lock_guard<std::mutex> lock(m_ioMutex);
+    m_quit = true;
+  }
+  m_ioWake.notify_all();
+  m_ioThread.join();
+  // Dekodowanie w toku kończy się samo (zadania w tle nie są przerywane)
+  while (m_inFlight.load(std::memory_order_acquire) > 0)
+    std::this_thread::yield();
+  for (uint32_t i = 0; i < m_assets.size(); ++i)
+    if (m_assets[i]->alive)
+      releaseAsset(i);
+}
+
+AssetHandle AssetManager::loadAtlas(const std::string &path,
+                                    WGPUBindGroupLayout layout,
+                                    AssetPriority priority) {
+  uint32_t index;
+  if (!m_freeSlots.empty()) {
+    index = m_freeSlots.back();
+    m_freeSlots.pop_back();
+  } else {
+    index = uint32_t(m_assets.size());
+    m_assets.push_back(std::make_unique<Asset>());
+  }
+
+  Asset &asset = *m_assets[index];
+  asset.manager = this;
+  asset.path = path;
+  asset.priority = priority;
+  asset.sequence = m_nextSequence++;
+  asset.layout = layout;
+  asset.requestNs = nowNs();
+  asset.alive = true;
+  asset.refCount.store(1, std::memory_order_relaxed);
+  asset.state.store(AssetState::Queued, std::memory_order_relaxed);
+  asset.inFlight.store(true, std::memory_order_relaxed);
+  m_inFlight.fetch_add(1, std::memory_order_relaxed);
+  ++m_stats.requested;
+
+  {
+    std::lock_guard<std::mutex> lock(m_ioMutex);
+    m_ioQueue.push_back(&asset);
+  }
+  m_ioWake.notify_one();
+  return AssetHandle(this, index);
+}
+
+AssetManager::Asset *AssetManager::slot(const AssetHandle &handle) const {
+  if (handle.m_manager != this || handle.m_index >= m_assets.size())
+    return nullptr;
+  return m_assets[handle.m_index].get();
+}
+
+AssetState AssetManager::state(const AssetHandle &handle) const {
+  const Asset *asset = slot(handle);
+  return asset ? asset->state.load(std::memory_order_acquire)
+               : AssetState::Failed;
+}
+
+const TextureAtlas *AssetManager::atlas(const AssetHandle &handle) const {
+  const Asset *asset = slot(handle);
+  return asset && asset->state.load(std::memory_order_acquire) ==
+                      AssetState::Ready
+             ? &asset->atlas
+             : nullptr;
+}
+
+void AssetManager::addRef(uint32_t index) {
+  m_assets[index]->refCount.fetch_add(1, std::memory_order_relaxed);
+}
+
+void AssetManager::releaseRef(uint32_t index) {
+  // Zwolnienie zasobów odroczone do update() — asset może być właśnie
+  // czytany albo dekodowany, a zasoby GPU zwalnia wątek główny
+  m_assets[index]->refCount.fetch_sub(1, std::memory_order_acq_rel);
+}
+
+AssetStats AssetManager::stats() const {
+  AssetStats stats = m_stats;
+  stats.failed += m_failed.load(std::memory_order_relaxed);
+  stats.bytesRead = m_bytesRead.load(std::memory_order_relaxed);
+  return stats;
+}
+
+void AssetManager::finishInFlight(Asset &asset, AssetState state) {
+  if (state == AssetState::Failed)
+    m_failed.fetch_add(1, std::memory_order_relaxed);
+  asset.state.store(state, std::memory_order_release);
+  asset.inFlight.store(false, std::memory_order_release);
+  m_inFlight.fetch_sub(1, std::memory_order_acq_rel);
+}
+
+// ============================================================
+//  Wątek I/O i dekodowanie
+// ============================================================
+
+void AssetManager::ioThreadLoop() {
+  for (;;) {
+    Asset *asset;
+    {
+      std::unique_lock<std::mutex> lock(m_ioMutex);
+      m_ioWake.wait(lock, [&] { return m_quit || !m_ioQueue.empty(); });
+      if (m_quit) {
+        // Niewczytane żądania przy zamykaniu — anulowane
+        for (Asset *pending : m_ioQueue)
+          finishInFlight(*pending, AssetState::Cancelled);
+        m_ioQueue.clear();
+        return;
+      }
+      auto next = std::min_element(
+          m_ioQueue.begin(), m_ioQueue.end(),
+          [](const Asset *a, const Asset *b) { return servedBefore(*a, *b); });
+      asset = *next;
+      m_ioQueue.erase(next);
+    }
+
+    if (asset->refCount.load(std::memory_order_acquire) == 0) {
+      finishInFlight(*asset, AssetState::Cancelled);
+      continue;
+    }
+
+    WARP_PROFILE_SCOPE("Asset Read");
+    asset->state.store(AssetState::Reading, std::memory_order_release);
+    if (!mapFile(asset->path.c_str(), asset->file)) {
+      std::cerr << "Could not read asset: " << asset->path << std::endl;
+      finishInFlight(*asset, AssetState::Failed);
+      continue;
+    }
+    // Dotknięcie każdej strony ściąga plik z dysku tutaj — dekodowanie i
+    // przesyłanie na GPU czytają już z pamięci
+    volatile uint8_t sink = 0;
+    for (size_t offset = 0; offset < asset->file.size; offset += 4096)
+      sink = sink + asset->file.data[offset];
+    m_bytesRead.fetch_add(asset->file.size, std::memory_order_relaxed);
+
+    asset->state.store(AssetState::Decoding, std::memory_order_release);
+    asset->decodeJob.execute = decodeAsset;
+    asset->decodeJob.context = asset;
+    m_jobs.submitBackground(&asset->decodeJob);
+  }
+}
+
+void AssetManager::decodeAsset(const Job &job, uint32_t) {
+  Asset &asset = *static_cast<Asset *>(const_cast<void *>(job.context));
+  AssetManager &manager = *asset.manager;
+  if (asset.refCount.load(std::memory_order_acquire) == 0) {
+    manager.finishInFlight(asset, AssetState::Cancelled);
+    return;
+  }
+
+  WARP_PROFILE_SCOPE("Asset Decode");
+  if (!parseAtlas(asset.file.data, asset.file.size, asset.view)) {
+    std::cerr << "Invalid atlas: " << asset.path << std::endl;
+    manager.finishInFlight(asset, AssetState::Failed);
+    return;
+  }
+  buildAtlasFrameTable(asset.view, asset.atlas, asset.gpuFrames);
+
+  // Pasy wierszy mieszczące się w budżecie klatki (co najmniej 1 wiersz)
+  const AtlasFileHeader &header = *asset.view.header;
+  asset.bands.clear();
+  asset.nextBand = 0;
+  for (uint32_t page = 0; page < header.pageCount; ++page) {
+    for (uint32_t level = 0; level < header.mipLevelCount; ++level) {
+      const uint32_t size = std::max(header.pageSize >> level, 1u);
+      const uint64_t rowBytes = uint64_t(size) * 4;
+      const uint32_t bandRows = uint32_t(std::clamp<uint64_t>(
+          manager.m_uploadBudget / rowBytes, 1, size));
+      for (uint32_t row = 0; row < size; row += bandRows) {
+        const uint32_t rows = std::min(bandRows, size - row);
+        asset.bands.push_back({page, level, row, rows, rows * rowBytes});
+      }
+    }
+  }
+  manager.finishInFlight(asset, AssetState::Uploading);
+}
+
+// ============================================================
+//  Przesyłanie i zwalnianie (wątek główny)
+// ============================================================
+
+bool AssetManager::uploadAsset(Asset &asset, uint64_t &budget,
+                               bool unlimited) {
+  if (!asset.gpuCreated) {
+    if (!createAtlasGpuResources(m_device, m_queue, asset.layout,
+                                 *asset.view.header, asset.gpuFrames,
+                                 asset.atlas)) {
+      m_failed.fetch_add(1, std::memory_order_relaxed);
+      asset.state.store(AssetState::Failed, std::memory_order_release);
+      return false;
+    }
+    asset.gpuCreated = true;
+    const uint64_t bytes = asset.gpuFrames.size() * sizeof(AtlasGpuFrame);
+    m_stats.bytesUploaded += bytes;
+    budget -= std::min(budget, bytes);
+  }
+
+  while (asset.nextBand < asset.bands.size()) {
+    const UploadBand &band = asset.bands[asset.nextBand];
+    // Pas większy niż reszta budżetu czeka na następną klatkę — chyba że
+    // w tej klatce nic jeszcze nie wysłano (pas większy niż cały budżet)
+    if (!unlimited && band.bytes > budget && budget < m_uploadBudget)
+      return false;
+    writeAtlasPixelRows(m_queue, asset.atlas, asset.view, band.page,
+                        band.level, band.firstRow, band.rowCount);
+    m_stats.bytesUploaded += band.bytes;
+    budget -= std::min(budget, band.bytes);
+    ++asset.nextBand;
+    if (!unlimited && budget == 0)
+      break;
+  }
+  if (asset.nextBand < asset.bands.size())
+    return false;
+
+  // wgpuQueueWriteTexture kopiuje dane od razu — plik można odmapować
+  unmapFile(asset.file);
+  asset.view = {};
+  asset.bands = {};
+  asset.gpuFrames = {};
+  asset.state.store(AssetState::Ready, std::memory_order_release);
+  ++m_stats.ready;
+  m_stats.totalLatencyMs += double(nowNs() - asset.requestNs) / 1.0e6;
+  std::cout << "Asset ready: " << asset.path << " (" << asset.atlas.frameCount
+            << " frames, " << asset.atlas.pageCount << " pages)" << std::endl;
+  return true;
+}
+
+void AssetManager::releaseAsset(uint32_t index) {
+  Asset &asset = *m_assets[index];
+  const AssetState state = asset.state.load(std::memory_order_acquire);
+  if (state != AssetState::Ready && state != AssetState::Failed)
+    ++m_stats.cancelled;
+  releaseTextureAtlas(asset.atlas);
+  unmapFile(asset.file);
+  asset.view = {};
+  asset.gpuFrames = {};
+  asset.bands = {};
+  asset.nextBand = 0;
+  asset.gpuCreated = false;
+  asset.path.clear();
+  asset.alive = false;
+  m_freeSlots.push_back(index);
+}
+
+void AssetManager::update() {
+  WARP_PROFILE_SCOPE("Asset Update");
+  // Assety bez uchwytów (poza tymi, nad którymi pracuje inny wątek)
+  std::vector<Asset *> uploading;
+  for (uint32_t i = 0; i < m_assets.size(); ++i) {
+    Asset &asset = *m_assets[i];
+    if (!asset.alive || asset.inFlight.load(std::memory_order_acquire))
+      continue;
+    if (asset.refCount.load(std::memory_order_acquire) == 0)
+      releaseAsset(i);
+    else if (asset.state.load(std::memory_order_acquire) ==
+             AssetState::Uploading)
+      uploading.push_back(&asset);
+  }
+  if (uploading.empty())
+    return;
+
+  std::sort(uploading.begin(), uploading.end(),
+            [](const Asset *a, const Asset *b) {
+              return servedBefore(*a, *b);
+            });
+  uint64_t budget = m_uploadBudget;
+  for (Asset *asset : uploading) {
+    if (budget == 0)
+      break;
+    uploadAsset(*asset, budget, false);
+  }
+  m_stats.peakFrameUploadBytes =
+      std::max(m_stats.peakFrameUploadBytes, m_uploadBudget - budget);
+}
+
+AssetState AssetManager::wait(const AssetHandle &handle) {
+  Asset *asset = slot(handle);
+  if (!asset)
+    return AssetState::Failed;
+  for (;;) {
+    const AssetState state = asset->state.load(std::memory_order_acquire);
+    if (state == AssetState::Ready || state == AssetState::Failed ||
+        state == AssetState::Cancelled)
+      return state;
+    if (state == AssetState::Uploading &&
+        !asset->inFlight.load(std::memory_order_acquire)) {
+      uint64_t budget = m_uploadBudget;
+      uploadAsset(*asset, budget, true);
+      continue;
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+}
@@ -0,0 +1,178 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <webgpu/webgpu.h>
+
+#include "job_system.h"
+#include "mapped_file.h"
+#include "texture_atlas.h"
+
+class AssetManager;
+
+// ============================================================
+//  Uchwyty
+// ============================================================
+
+enum class AssetState : uint32_t {
+  Queued,    // czeka na wątek I/O
+  Reading,   // mapowanie i wczytanie stron pliku (wątek I/O)
+  Decoding,  // walidacja i przygotowanie danych (worker JobSystem)
+  Uploading, // przesyłanie na GPU w porcjach (wątek główny, budżet)
+  Ready,
+  Failed,
+  Cancelled, // ostatni uchwyt zwolniony przed zakończeniem
+};
+
+// Wyższy priorytet jest czytany, dekodowany i przesyłany wcześniej
+enum class AssetPriority : uint32_t {
+  Background, // np. assety następnego poziomu
+  Normal,
+  Critical, // potrzebne w najbliższych klatkach (np. nowa fala wrogów)
+};
+
+// Uchwyt ze zliczaniem referencji. Asset istnieje, dopóki istnieje choć
+// jeden uchwyt — zwolnienie ostatniego anuluje wczytywanie w dowolnym
+// etapie albo zwalnia gotowe zasoby (w AssetManager::update).
+class AssetHandle {
+public:
+  AssetHandle() = default;
+  AssetHandle(const AssetHandle &other);
+  AssetHandle(AssetHandle &&other) noexcept;
+  AssetHandle &operator=(AssetHandle other) noexcept;
+  ~AssetHandle();
+
+  bool valid() const { return m_manager != nullptr; }
+  void reset();
+
+private:
+  friend class AssetManager;
+  AssetHandle(AssetManager *manager, uint32_t index)
+      : m_manager(manager), m_index(index) {}
+
+  AssetManager *m_manager = nullptr;
+  uint32_t m_index = 0;
+};
+
+// ============================================================
+//  AssetManager
+// ============================================================
+
+struct AssetStats {
+  uint32_t requested = 0;
+  uint32_t ready = 0;
+  uint32_t failed = 0;
+  uint32_t cancelled = 0;
+  uint64_t bytesRead = 0;
+  uint64_t bytesUploaded = 0;
+  uint64_t peakFrameUploadBytes = 0; // największy upload jednej klatki
+  double totalLatencyMs = 0.0;       // od żądania do Ready (suma)
+};
+
+// Wczytywanie assetów bez blokowania pętli gry:
+//   1. wątek I/O mapuje plik i wczytuje jego strony (dysk tylko tu),
+//   2. dekodowanie/walidacja na workerze JobSystem (zadanie w tle),
+//   3. przesyłanie na GPU na wątku głównym w update() — najwyżej
+//      uploadBudget bajtów na klatkę (wgpuQueueWriteTexture/WriteBuffer
+//      w pasach wierszy), w kolejności priorytetów.
+// Obecnie obsługiwane są atlasy tekstur (.watl).
+class AssetManager {
+public:
+  AssetManager(WGPUDevice device, WGPUQueue queue, JobSystem &jobs,
+               uint64_t uploadBudget);
+  ~AssetManager();
+
+  AssetManager(const AssetManager &) = delete;
+  AssetManager &operator=(const AssetManager &) = delete;
+
+  // Rozpoczyna wczytywanie atlasu. layout: grupa atlasu pipeline'u
+  // sprite'ów (atlasBindGroupLayoutDesc).
+  AssetHandle loadAtlas(const std::string &path, WGPUBindGroupLayout layout,
+                        AssetPriority priority = AssetPriority::Normal);
+
+  AssetState state(const AssetHandle &handle) const;
+  // nullptr, dopóki atlas nie jest w stanie Ready
+  const TextureAtlas *atlas(const AssetHandle &handle) const;
+
+  // Raz na klatkę (wątek główny, przed submit): przesyła kolejne porcje w
+  // ramach budżetu i zwalnia assety bez uchwytów
+  void update();
+  // Czeka na zakończenie wczytywania (ekran ładowania, poza pętlą gry) —
+  // bez limitu budżetu
+  AssetState wait(const AssetHandle &handle);
+
+  AssetStats stats() const;
+  uint64_t uploadBudget() const { return m_uploadBudget; }
+
+private:
+  friend class AssetHandle;
+
+  // Porcja przesyłania: pas wierszy poziomu mip strony atlasu
+  struct UploadBand {
+    uint32_t page, level, firstRow, rowCount;
+    uint64_t bytes;
+  };
+
+  struct Asset {
+    AssetManager *manager = nullptr;
+    std::string path;
+    AssetPriority priority = AssetPriority::Normal;
+    uint64_t sequence = 0; // kolejność żądań (FIFO w priorytecie)
+    std::atomic<AssetState> state{AssetState::Queued};
+    std::atomic<uint32_t> refCount{0};
+    std::atomic<bool> inFlight{false}; // w rękach wątku I/O lub workera
+    uint64_t requestNs = 0;
+    // Dane wczytywania
+    MappedFile file;
+    AtlasView view;
+    WGPUBindGroupLayout layout = nullptr;
+    std::vector<AtlasGpuFrame> gpuFrames;
+    std::vector<UploadBand> bands;
+    size_t nextBand = 0;
+    bool gpuCreated = false;
+    TextureAtlas atlas;
+    Job decodeJob;
+    bool alive = false; // slot zajęty
+  };
+
+  void ioThreadLoop();
+  static void decodeAsset(const Job &job, uint32_t threadIndex);
+  // Koniec pracy wątku I/O lub workera nad assetem
+  void finishInFlight(Asset &asset, AssetState state);
+  // Zwalnia zasoby assetu i slot (wątek główny)
+  void releaseAsset(uint32_t index);
+  // Kolejne porcje assetu do wyczerpania budżetu; true = wszystko przesłane
+  bool uploadAsset(Asset &asset, uint64_t &budget, bool unlimited);
+  void addRef(uint32_t index);
+  void releaseRef(uint32_t index);
+  Asset *slot(const AssetHandle &handle) const;
+
+  WGPUDevice m_device;
+  WGPUQueue m_queue;
+  JobSystem &m_jobs;
+  uint64_t m_uploadBudget;
+
+  // Sloty o stałych adresach — wątek I/O i workery dostają wskaźniki,
+  // sam wektor zmienia tylko wątek główny
+  std::vector<std::unique_ptr<Asset>> m_assets;
+  std::vector<uint32_t> m_freeSlots;
+  uint64_t m_nextSequence = 0;
+
+  // Kolejka wątku I/O
+  std::thread m_ioThread;
+  std::mutex m_ioMutex;
+  std::condition_variable m_ioWake;
+  std::vector<Asset *> m_ioQueue;
+  bool m_quit = false;
+
+  std::atomic<uint32_t> m_inFlight{0}; // assety w wątku I/O lub workerze
+  AssetStats m_stats;                  // pola wątku głównego
+  std::atomic<uint32_t> m_failed{0};
+  std::atomic<uint64_t> m_bytesRead{0};
+};
@@ -0,0 +1,158 @@
+#include "atlas_file.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+
+// ============================================================
+//  Format pliku
+// ============================================================
+
+static uint64_t alignUp(uint64_t value, uint64_t alignment) {
+  return (value + alignment - 1) / alignment * alignment;
+}
+
+uint64_t atlasPageBytes(uint32_t pageSize, uint32_t mipLevelCount) {
+  uint64_t bytes = 0;
+  for (uint32_t level = 0; level < mipLevelCount; ++level) {
+    const uint64_t size = std::max(pageSize >> level, 1u);
+    bytes += size * size * 4;
+  }
+  return bytes;
+}
+
+void generateMipChain(uint8_t *page, uint32_t pageSize,
+                      uint32_t mipLevelCount) {
+  uint8_t *source = page;
+  uint32_t sourceSize = pageSize;
+  for (uint32_t level = 1; level < mipLevelCount; ++level) {
+    const uint32_t size = std::max(sourceSize / 2, 1u);
+    uint8_t *target = source + uint64_t(sourceSize) * sourceSize * 4;
+    for (uint32_t y = 0; y < size; ++y) {
+      const uint32_t sy0 = std::min(y * 2, sourceSize - 1);
+      const uint32_t sy1 = std::min(y * 2 + 1, sourceSize - 1);
+      for (uint32_t x = 0; x < size; ++x) {
+        const uint32_t sx0 = std::min(x * 2, sourceSize - 1);
+        const uint32_t sx1 = std::min(x * 2 + 1, sourceSize - 1);
+        const uint8_t *p00 = source + (uint64_t(sy0) * sourceSize + sx0) * 4;
+        const uint8_t *p01 = source + (uint64_t(sy0) * sourceSize + sx1) * 4;
+        const uint8_t *p10 = source + (uint64_t(sy1) * sourceSize + sx0) * 4;
+        const uint8_t *p11 = source + (uint64_t(sy1) * sourceSize + sx1) * 4;
+        uint8_t *out = target + (uint64_t(y) * size + x) * 4;
+        for (int c = 0; c < 4; ++c)
+          out[c] = uint8_t((p00[c] + p01[c] + p10[c] + p11[c] + 2) / 4);
+      }
+    }
+    source = target;
+    sourceSize = size;
+  }
+}
+
+std::vector<uint8_t> serializeAtlas(const AtlasImage &image) {
+  AtlasFileHeader header = {};
+  std::memcpy(header.magic, "WATL", 4);
+  header.version = kAtlasFileVersion;
+  header.pageSize = image.pageSize;
+  header.pageCount = image.pageCount;
+  header.mipLevelCount = image.mipLevelCount;
+  header.frameCount = uint32_t(image.frames.size());
+  header.framesOffset = sizeof(AtlasFileHeader);
+  header.namesOffset =
+      header.framesOffset + image.frames.size() * sizeof(AtlasFrame);
+  header.namesSize = image.names.size();
+  header.pixelsOffset = alignUp(header.namesOffset + header.namesSize, 16);
+  header.pixelsSize = image.pixels.size();
+
+  std::vector<uint8_t> bytes(header.pixelsOffset + header.pixelsSize, 0);
+  std::memcpy(bytes.data(), &header, sizeof(header));
+  if (!image.frames.empty())
+    std::memcpy(bytes.data() + header.framesOffset, image.frames.data(),
+                image.frames.size() * sizeof(AtlasFrame));
+  if (!image.names.empty())
+    std::memcpy(bytes.data() + header.namesOffset, image.names.data(),
+                image.names.size());
+  if (!image.pixels.empty())
+    std::memcpy(bytes.data() + header.pixelsOffset, image.pixels.data(),
+                image.pixels.size());
+  return bytes;
+}
+
+bool writeAtlasFile(const char *path, const AtlasImage &image) {
+  const std::vector<uint8_t> bytes = serializeAtlas(image);
+  FILE *file = std::fopen(path, "wb");
+  if (!file) {
+    std::cerr << "Could not open atlas file for writing: " << path
+              << std::endl;
+    return false;
+  }
+  const bool ok = std::fwrite(bytes.data(), 1, bytes.size(), file) ==
+                  bytes.size();
+  std::fclose(file);
+  if (!ok)
+    std::cerr << "Failed to write atlas file: " << path << std::endl;
+  return ok;
+}
+
+// Zakres [offset, offset + bytes) mieści się w pliku (bez przepełnienia sumy)
+static bool rangeInFile(uint64_t offset, uint64_t bytes, size_t size) {
+  return offset <= size && bytes <= size - offset;
+}
+
+bool parseAtlas(const uint8_t *data, size_t size, AtlasView &view) {
+  if (size < sizeof(AtlasFileHeader)) {
+    std::cerr << "Atlas file too small" << std::endl;
+    return false;
+  }
+  const AtlasFileHeader *header =
+      reinterpret_cast<const AtlasFileHeader *>(data);
+  if (std::memcmp(header->magic, "WATL", 4) != 0 ||
+      header->version != kAtlasFileVersion) {
+    std::cerr << "Not a WATL atlas or unsupported version" << std::endl;
+    return false;
+  }
+
+  // Strona: potęga 2 (co najwyżej 64k — bez przepełnień w rozmiarach
+  // poziomów), mipy najwyżej do 1×1
+  const uint32_t pageSize = header->pageSize;
+  uint32_t maxMipLevels = 1;
+  for (uint32_t s = pageSize; s > 1; s >>= 1)
+    ++maxMipLevels;
+  const bool validPage = pageSize != 0 && pageSize <= (1u << 16) &&
+                         (pageSize & (pageSize - 1)) == 0 &&
+                         header->mipLevelCount >= 1 &&
+                         header->mipLevelCount <= maxMipLevels;
+  const uint64_t pageBytes =
+      validPage ? atlasPageBytes(pageSize, header->mipLevelCount) : 1;
+  // Atlas bez klatek jest bezużyteczny (sprite'y losują klatkę modulo
+  // frameCount) — odrzucany razem z pustymi stronami
+  if (!validPage || header->pageCount == 0 || header->frameCount == 0 ||
+      header->framesOffset % alignof(AtlasFrame) != 0 ||
+      !rangeInFile(header->framesOffset,
+                   uint64_t(header->frameCount) * sizeof(AtlasFrame), size) ||
+      !rangeInFile(header->namesOffset, header->namesSize, size) ||
+      header->pixelsOffset % 16 != 0 ||
+      header->pixelsSize % pageBytes != 0 ||
+      header->pixelsSize / pageBytes != header->pageCount ||
+      !rangeInFile(header->pixelsOffset, header->pixelsSize, size)) {
+    std::cerr << "Corrupted atlas file" << std::endl;
+    return false;
+  }
+  // Strona klatki trafia na GPU jako indeks warstwy tekstury
+  const AtlasFrame *frames =
+      reinterpret_cast<const AtlasFrame *>(data + header->framesOffset);
+  for (uint32_t i = 0; i < header->frameCount; ++i) {
+    if (frames[i].page >= header->pageCount) {
+      std::cerr << "Corrupted atlas file: frame " << i
+                << " references missing page " << frames[i].page
+                << std::endl;
+      return false;
+    }
+  }
+
+  view.header = header;
+  view.frames = frames;
+  view.names = reinterpret_cast<const char *>(data + header->namesOffset);
+  view.pixels = data + header->pixelsOffset;
+  return true;
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// ============================================================
+//  Format pliku atlasu (.watl)
+// ============================================================
+
+// Plik jest gotowym obrazem pamięci: nagłówek, tablica klatek, nazwy
+// klatek, a na końcu piksele stron RGBA8 ze wszystkimi poziomami mip
+// (strona po stronie, mip 0 pierwszy). Runtime mapuje plik i przesyła
+// piksele prosto do WGPUTexture — bez dekodowania PNG przy starcie.
+// Wszystkie liczby w little-endian.
+constexpr uint32_t kAtlasFileVersion = 1;
+
+struct AtlasFileHeader {
+  char magic[4]; // "WATL"
+  uint32_t version;
+  uint32_t pageSize; // strony są kwadratowe, potęga 2
+  uint32_t pageCount;
+  uint32_t mipLevelCount;
+  uint32_t frameCount; // >= 1 (parseAtlas odrzuca pusty atlas)
+  uint64_t framesOffset; // AtlasFrame[frameCount]
+  uint64_t namesOffset;  // nazwy zakończone zerem
+  uint64_t namesSize;
+  uint64_t pixelsOffset; // wyrównany do 16 B
+  uint64_t pixelsSize;
+};
+static_assert(sizeof(AtlasFileHeader) == 64, "AtlasFileHeader layout");
+
+// Klatka atlasu: prostokąt na stronie (bez marginesu) i gotowe UV
+struct AtlasFrame {
+  uint32_t nameOffset; // offset w tablicy nazw
+  uint32_t page;
+  uint16_t x, y, width, height;
+  float uvRect[4]; // u0, v0, u1, v1
+};
+static_assert(sizeof(AtlasFrame) == 32, "AtlasFrame layout");
+
+// Atlas zbudowany w pamięci (wyjście buildera, atlas domyślny)
+struct AtlasImage {
+  uint32_t pageSize = 0;
+  uint32_t pageCount = 0;
+  uint32_t mipLevelCount = 1;
+  std::vector<AtlasFrame> frames;
+  std::vector<char> names;
+  std::vector<uint8_t> pixels; // pageCount × atlasPageBytes()
+};
+
+// Widok na sparsowany atlas (wskaźniki do pliku zmapowanego lub bufora)
+struct AtlasView {
+  const AtlasFileHeader *header = nullptr;
+  const AtlasFrame *frames = nullptr;
+  const char *names = nullptr;
+  const uint8_t *pixels = nullptr;
+};
+
+// Rozmiar jednej strony ze wszystkimi poziomami mip
+uint64_t atlasPageBytes(uint32_t pageSize, uint32_t mipLevelCount);
+// Wypełnia poziomy 1..mipLevelCount-1 strony filtrem pudełkowym 2×2
+void generateMipChain(uint8_t *page, uint32_t pageSize,
+                      uint32_t mipLevelCount);
+
+std::vector<uint8_t> serializeAtlas(const AtlasImage &image);
+bool writeAtlasFile(const char *path, const AtlasImage &image);
+// Sprawdza nagłówek i zakresy; view wskazuje do środka data
+bool parseAtlas(const uint8_t *data, size_t size, AtlasView &view);
@@ -0,0 +1,94 @@
+#include "atlas_packer.h"
+
+#include <algorithm>
+
+void SkylinePacker::reset(uint32_t width, uint32_t height) {
+  m_width = width;
+  m_height = height;
+  m_usedArea = 0;
+  m_skyline.clear();
+  m_skyline.push_back({0, 0, width});
+}
+
+bool SkylinePacker::fit(size_t index, uint32_t width, uint32_t height,
+                        uint32_t &y) const {
+  const uint32_t x = m_skyline[index].x;
+  if (x + width > m_width)
+    return false;
+
+  // Prostokąt może przykryć kilka kolejnych odcinków — leży na najwyższym
+  uint32_t remaining = width;
+  y = 0;
+  for (size_t i = index; remaining > 0; ++i) {
+    y = std::max(y, m_skyline[i].y);
+    if (y + height > m_height)
+      return false;
+    remaining -= std::min(remaining, m_skyline[i].width);
+  }
+  return true;
+}
+
+bool SkylinePacker::insert(uint32_t width, uint32_t height, uint32_t &x,
+                           uint32_t &y) {
+  if (width == 0 || height == 0 || width > m_width || height > m_height)
+    return false;
+
+  size_t bestIndex = m_skyline.size();
+  uint32_t bestTop = ~0u;
+  uint32_t bestWidth = ~0u;
+  uint32_t bestY = 0;
+  for (size_t i = 0; i < m_skyline.size(); ++i) {
+    uint32_t fitY;
+    if (!fit(i, width, height, fitY))
+      continue;
+    const uint32_t top = fitY + height;
+    if (top < bestTop || (top == bestTop && m_skyline[i].width < bestWidth)) {
+      bestIndex = i;
+      bestTop = top;
+      bestWidth = m_skyline[i].width;
+      bestY = fitY;
+    }
+  }
+  if (bestIndex == m_skyline.size())
+    return false;
+
+  x = m_skyline[bestIndex].x;
+  y = bestY;
+
+  // Nowy odcinek nad prostokątem; przykryte odcinki są skracane lub usuwane
+  const Segment added = {x, bestY + height, width};
+  m_skyline.insert(m_skyline.begin() + bestIndex, added);
+  for (size_t i = bestIndex + 1; i < m_skyline.size();) {
+    Segment &segment = m_skyline[i];
+    const uint32_t addedEnd = added.x + added.width;
+    if (segment.x >= addedEnd)
+      break;
+    const uint32_t segmentEnd = segment.x + segment.width;
+    if (segmentEnd <= addedEnd) {
+      m_skyline.erase(m_skyline.begin() + i);
+      continue;
+    }
+    segment.width = segmentEnd - addedEnd;
+    segment.x = addedEnd;
+    break;
+  }
+
+  // Scal sąsiednie odcinki na tej samej wysokości
+  for (size_t i = 0; i + 1 < m_skyline.size();) {
+    if (m_skyline[i].y == m_skyline[i + 1].y) {
+      m_skyline[i].width += m_skyline[i + 1].width;
+      m_skyline.erase(m_skyline.begin() + i + 1);
+    } else {
+      ++i;
+    }
+  }
+
+  m_usedArea += uint64_t(width) * height;
+  return true;
+}
+
+float SkylinePacker::occupancy() const {
+  return m_width && m_height
+             ? float(double(m_usedArea) / (double(m_width) * m_height))
+             : 0.0f;
+}
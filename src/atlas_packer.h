@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Pakowanie prostokątów metodą skyline (bottom-left): zajęta część strony
+// jest opisana "linią horyzontu" — listą poziomych odcinków. Nowy
+// prostokąt trafia tam, gdzie jego górna krawędź wypada najniżej (remis:
+// najwęższy odcinek). Szybkie i przy sortowaniu wejścia po wysokości
+// daje wypełnienie zbliżone do MaxRects.
+class SkylinePacker {
+public:
+  SkylinePacker(uint32_t width, uint32_t height) { reset(width, height); }
+
+  void reset(uint32_t width, uint32_t height);
+
+  // Zwraca false, gdy prostokąt nie mieści się na stronie
+  bool insert(uint32_t width, uint32_t height, uint32_t &x, uint32_t &y);
+
+  // Zajęte piksele / powierzchnia strony
+  float occupancy() const;
+
+private:
+  struct Segment {
+    uint32_t x;
+    uint32_t y; // wysokość horyzontu na odcinku
+    uint32_t width;
+  };
+
+  // Najniższe y, na którym prostokąt zaczynający się w segmencie index
+  // mieści się nad horyzontem; false, gdy wychodzi poza stronę
+  bool fit(size_t index, uint32_t width, uint32_t height, uint32_t &y) const;
+
+  uint32_t m_width = 0;
+  uint32_t m_height = 0;
+  uint64_t m_usedArea = 0;
+  std::vector<Segment> m_skyline;
+};
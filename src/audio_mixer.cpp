@@ -0,0 +1,441 @@
+#include "audio_mixer.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+#include <emmintrin.h>
+#define WARP_AUDIO_SSE2 1
+#elif defined(__ARM_NEON) || defined(_M_ARM64)
+#include <arm_neon.h>
+#define WARP_AUDIO_NEON 1
+#endif
+
+constexpr double kFixedOne = 4294967296.0; // 1.0 w formacie 32.32
+constexpr float kInvFixedOne = 1.0f / 4294967296.0f;
+
+// ============================================================
+//  Kernele
+// ============================================================
+
+uint32_t audioMixVoice(const float *samples, uint32_t sampleCount,
+                       uint64_t &position, uint64_t step, float gainLeft,
+                       float gainRight, float *left, float *right,
+                       uint32_t frames) {
+  uint32_t i = 0;
+#if defined(WARP_AUDIO_SSE2) || defined(WARP_AUDIO_NEON)
+  // Po 4 ramki, dopóki ostatnia ramka czwórki ma obie próbki interpolacji
+  alignas(16) float first[4], second[4], fraction[4];
+#if defined(WARP_AUDIO_SSE2)
+  const __m128 gainL = _mm_set1_ps(gainLeft);
+  const __m128 gainR = _mm_set1_ps(gainRight);
+#else
+  const float32x4_t gainL = vdupq_n_f32(gainLeft);
+  const float32x4_t gainR = vdupq_n_f32(gainRight);
+#endif
+  for (; i + 4 <= frames; i += 4) {
+    if (((position + 3 * step) >> 32) + 1 >= sampleCount)
+      break;
+    for (uint32_t lane = 0; lane < 4; ++lane) {
+      const uint64_t p = position + lane * step;
+      const uint32_t index = uint32_t(p >> 32);
+      first[lane] = samples[index];
+      second[lane] = samples[index + 1];
+      fraction[lane] = float(uint32_t(p)) * kInvFixedOne;
+    }
+    position += 4 * step;
+#if defined(WARP_AUDIO_SSE2)
+    const __m128 a = _mm_load_ps(first);
+    const __m128 sample = _mm_add_ps(
+        a, _mm_mul_ps(_mm_sub_ps(_mm_load_ps(second), a),
+                      _mm_load_ps(fraction)));
+    _mm_storeu_ps(left + i, _mm_add_ps(_mm_loadu_ps(left + i),
+                                       _mm_mul_ps(sample, gainL)));
+    _mm_storeu_ps(right + i, _mm_add_ps(_mm_loadu_ps(right + i),
+                                        _mm_mul_ps(sample, gainR)));
+#else
+    const float32x4_t a = vld1q_f32(first);
+    const float32x4_t sample =
+        vmlaq_f32(a, vsubq_f32(vld1q_f32(second), a), vld1q_f32(fraction));
+    vst1q_f32(left + i, vmlaq_f32(vld1q_f32(left + i), sample, gainL));
+    vst1q_f32(right + i, vmlaq_f32(vld1q_f32(right + i), sample, gainR));
+#endif
+  }
+#endif
+  // Końcówka bloku i dźwięku: za ostatnią próbką interpolacja do ciszy
+  for (; i < frames; ++i) {
+    const uint32_t index = uint32_t(position >> 32);
+    if (index >= sampleCount)
+      break;
+    const float a = samples[index];
+    const float b = index + 1 < sampleCount ? samples[index + 1] : 0.0f;
+    const float sample = a + (b - a) * float(uint32_t(position)) * kInvFixedOne;
+    left[i] += sample * gainLeft;
+    right[i] += sample * gainRight;
+    position += step;
+  }
+  return i;
+}
+
+// Kanały L/R → przeplatane stereo z głośnością główną, obcięte do [-1, 1]
+static void interleave(const float *left, const float *right, float gain,
+                       float *out, uint32_t frames) {
+  uint32_t i = 0;
+#if defined(WARP_AUDIO_SSE2)
+  const __m128 g = _mm_set1_ps(gain);
+  const __m128 lo = _mm_set1_ps(-1.0f);
+  const __m128 hi = _mm_set1_ps(1.0f);
+  for (; i + 4 <= frames; i += 4) {
+    const __m128 l =
+        _mm_min_ps(_mm_max_ps(_mm_mul_ps(_mm_loadu_ps(left + i), g), lo), hi);
+    const __m128 r =
+        _mm_min_ps(_mm_max_ps(_mm_mul_ps(_mm_loadu_ps(right + i), g), lo), hi);
+    _mm_storeu_ps(out + 2 * i, _mm_unpacklo_ps(l, r));
+    _mm_storeu_ps(out + 2 * i + 4, _mm_unpackhi_ps(l, r));
+  }
+#elif defined(WARP_AUDIO_NEON)
+  const float32x4_t lo = vdupq_n_f32(-1.0f);
+  const float32x4_t hi = vdupq_n_f32(1.0f);
+  for (; i + 4 <= frames; i += 4) {
+    float32x4x2_t lr;
+    lr.val[0] = vminq_f32(vmaxq_f32(vmulq_n_f32(vld1q_f32(left + i), gain), lo),
+                          hi);
+    lr.val[1] =
+        vminq_f32(vmaxq_f32(vmulq_n_f32(vld1q_f32(right + i), gain), lo), hi);
+    vst2q_f32(out + 2 * i, lr);
+  }
+#endif
+  for (; i < frames; ++i) {
+    out[2 * i] = std::clamp(left[i] * gain, -1.0f, 1.0f);
+    out[2 * i + 1] = std::clamp(right[i] * gain, -1.0f, 1.0f);
+  }
+}
+
+// ============================================================
+//  AudioMixer
+// ============================================================
+
+AudioMixer::AudioMixer() {
+  std::memset(m_left, 0, sizeof(m_left));
+  std::memset(m_right, 0, sizeof(m_right));
+}
+
+AudioMixer::~AudioMixer() { stop(); }
+
+SoundId AudioMixer::addSound(SoundDesc desc) {
+  if (m_running.load(std::memory_order_relaxed) || desc.samples.empty() ||
+      desc.sampleRate == 0) {
+    std::cerr << "Cannot add sound " << (desc.name ? desc.name : "?")
+              << "!" << std::endl;
+    return kInvalidSound;
+  }
+  Sound sound;
+  sound.rateRatio = double(desc.sampleRate) / double(kAudioSampleRate);
+  desc.maxInstances = std::max(desc.maxInstances, 1u);
+  sound.desc = std::move(desc);
+  m_sounds.push_back(std::move(sound));
+  return SoundId(m_sounds.size() - 1);
+}
+
+bool AudioMixer::start(AudioOutput output, const char *path) {
+  if (m_running.load(std::memory_order_relaxed))
+    return true;
+  if (!openOutput(output, path))
+    return false;
+  m_running.store(true, std::memory_order_release);
+  m_thread = std::thread([this] { threadMain(); });
+  std::cout << "Audio mixer started (" << kAudioSampleRate << " Hz, "
+            << kAudioBlockFrames << "-frame blocks, "
+            << (output == AudioOutput::File ? path : "null output") << ")."
+            << std::endl;
+  return true;
+}
+
+void AudioMixer::stop() {
+  if (!m_running.exchange(false, std::memory_order_acq_rel))
+    return;
+  if (m_thread.joinable())
+    m_thread.join();
+  closeOutput();
+}
+
+bool AudioMixer::play(SoundId sound, const SoundParams &params) {
+  if (sound >= m_sounds.size())
+    return false;
+  Command command;
+  command.type = CommandType::Play;
+  command.sound = sound;
+  command.params = params;
+  if (m_commands.push(command))
+    return true;
+  m_droppedCommands.fetch_add(1, std::memory_order_relaxed);
+  return false;
+}
+
+bool AudioMixer::stopAll() {
+  Command command;
+  command.type = CommandType::StopAll;
+  if (m_commands.push(command))
+    return true;
+  m_droppedCommands.fetch_add(1, std::memory_order_relaxed);
+  return false;
+}
+
+bool AudioMixer::setMasterVolume(float volume) {
+  Command command;
+  command.type = CommandType::MasterVolume;
+  command.params.volume = std::max(volume, 0.0f);
+  if (m_commands.push(command))
+    return true;
+  m_droppedCommands.fetch_add(1, std::memory_order_relaxed);
+  return false;
+}
+
+void AudioMixer::applyCommands() {
+  Command command;
+  while (m_commands.pop(command)) {
+    switch (command.type) {
+    case CommandType::Play:
+      startVoice(command);
+      break;
+    case CommandType::StopAll:
+      for (Voice &voice : m_voices)
+        voice.active = false;
+      break;
+    case CommandType::MasterVolume:
+      m_masterVolume = command.params.volume;
+      break;
+    }
+  }
+}
+
+void AudioMixer::startVoice(const Command &command) {
+  const Sound &sound = m_sounds[command.sound];
+
+  // 1. Limit instancji: nowa kradnie najstarszą instancję tego dźwięku
+  Voice *target = nullptr;
+  Voice *oldestInstance = nullptr;
+  uint32_t instances = 0;
+  for (Voice &voice : m_voices) {
+    if (!voice.active) {
+      if (!target)
+        target = &voice;
+      continue;
+    }
+    if (voice.sound != command.sound)
+      continue;
+    ++instances;
+    if (!oldestInstance || voice.order < oldestInstance->order)
+      oldestInstance = &voice;
+  }
+  if (instances >= sound.desc.maxInstances) {
+    target = oldestInstance;
+    m_instanceCapped.fetch_add(1, std::memory_order_relaxed);
+  } else if (!target) {
+    // 2. Brak wolnego głosu: najniższy priorytet, z nich najstarszy —
+    // ale nigdy ważniejszy od nowego dźwięku
+    for (Voice &voice : m_voices)
+      if (!target || voice.priority < target->priority ||
+          (voice.priority == target->priority && voice.order < target->order))
+        target = &voice;
+    if (target->priority > sound.desc.priority) {
+      m_rejected.fetch_add(1, std::memory_order_relaxed);
+      return;
+    }
+    m_voicesStolen.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  // Panorama o stałej mocy: cos/sin kąta [0, π/2]
+  const SoundParams &params = command.params;
+  const float angle =
+      (std::clamp(params.pan, -1.0f, 1.0f) + 1.0f) * 0.25f * 3.14159265f;
+  const float volume = std::max(params.volume, 0.0f);
+  target->active = true;
+  target->sound = command.sound;
+  target->priority = sound.desc.priority;
+  target->position = 0;
+  target->step = std::max<uint64_t>(
+      1, uint64_t(sound.rateRatio * std::max(params.pitch, 0.01f) * kFixedOne));
+  target->gainLeft = volume * std::cos(angle);
+  target->gainRight = volume * std::sin(angle);
+  target->order = m_voiceOrder++;
+  m_voicesStarted.fetch_add(1, std::memory_order_relaxed);
+}
+
+void AudioMixer::mixBlock(float *interleaved, uint32_t frames) {
+  frames = std::min(frames, kAudioBlockFrames);
+  applyCommands();
+
+  std::memset(m_left, 0, frames * sizeof(float));
+  std::memset(m_right, 0, frames * sizeof(float));
+  uint32_t activeVoices = 0;
+  for (Voice &voice : m_voices) {
+    if (!voice.active)
+      continue;
+    ++activeVoices;
+    const SoundDesc &desc = m_sounds[voice.sound].desc;
+    const uint32_t mixed = audioMixVoice(
+        desc.samples.data(), uint32_t(desc.samples.size()), voice.position,
+        voice.step, voice.gainLeft, voice.gainRight, m_left, m_right, frames);
+    if (mixed < frames)
+      voice.active = false;
+  }
+  interleave(m_left, m_right, m_masterVolume, interleaved, frames);
+
+  if (activeVoices > m_peakVoices.load(std::memory_order_relaxed))
+    m_peakVoices.store(activeVoices, std::memory_order_relaxed);
+}
+
+void AudioMixer::threadMain() {
+  using Clock = std::chrono::steady_clock;
+  const auto period = std::chrono::nanoseconds(
+      uint64_t(kAudioBlockFrames) * 1000000000ull / kAudioSampleRate);
+  alignas(16) float block[kAudioBlockFrames * 2];
+  Clock::time_point deadline = Clock::now();
+  while (m_running.load(std::memory_order_acquire)) {
+    const Clock::time_point mixStart = Clock::now();
+    mixBlock(block, kAudioBlockFrames);
+    const uint64_t mixNs = uint64_t(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() -
+                                                             mixStart)
+            .count());
+    writeOutput(block, kAudioBlockFrames);
+
+    m_blocks.fetch_add(1, std::memory_order_relaxed);
+    m_mixNs.fetch_add(mixNs, std::memory_order_relaxed);
+    if (mixNs > m_maxMixNs.load(std::memory_order_relaxed))
+      m_maxMixNs.store(mixNs, std::memory_order_relaxed);
+
+    // Tempo urządzenia: blok co period. Spóźniony blok (urządzenie
+    // zagrałoby ciszę) jest liczony, a zegar wraca do teraz — bez nadrabiania
+    deadline += period;
+    const Clock::time_point now = Clock::now();
+    if (now > deadline) {
+      m_lateBlocks.fetch_add(1, std::memory_order_relaxed);
+      deadline = now;
+    }
+    std::this_thread::sleep_until(deadline);
+  }
+}
+
+AudioStats AudioMixer::stats() const {
+  AudioStats stats;
+  stats.blocks = m_blocks.load(std::memory_order_relaxed);
+  stats.lateBlocks = m_lateBlocks.load(std::memory_order_relaxed);
+  stats.voicesStarted = m_voicesStarted.load(std::memory_order_relaxed);
+  stats.voicesStolen = m_voicesStolen.load(std::memory_order_relaxed);
+  stats.instanceCapped = m_instanceCapped.load(std::memory_order_relaxed);
+  stats.rejected = m_rejected.load(std::memory_order_relaxed);
+  stats.droppedCommands = m_droppedCommands.load(std::memory_order_relaxed);
+  stats.peakVoices = m_peakVoices.load(std::memory_order_relaxed);
+  if (stats.blocks)
+    stats.avgMixUs = double(m_mixNs.load(std::memory_order_relaxed)) /
+                     double(stats.blocks) * 1e-3;
+  stats.maxMixUs = double(m_maxMixNs.load(std::memory_order_relaxed)) * 1e-3;
+  return stats;
+}
+
+// ============================================================
+//  Wyjście (null / WAV)
+// ============================================================
+
+// Nagłówek WAV: RIFF + fmt (IEEE float, 44 B razem z nagłówkiem data)
+static void writeWavHeader(std::FILE *file, uint64_t frames) {
+  const uint32_t channels = 2;
+  const uint32_t bytesPerFrame = channels * sizeof(float);
+  const uint32_t dataBytes = uint32_t(std::min<uint64_t>(
+      frames * bytesPerFrame, 0xFFFFFFFFull - 36));
+  uint8_t header[44];
+  auto put32 = [&header](size_t offset, uint32_t value) {
+    for (uint32_t b = 0; b < 4; ++b)
+      header[offset + b] = uint8_t(value >> (8 * b));
+  };
+  auto put16 = [&header](size_t offset, uint16_t value) {
+    header[offset] = uint8_t(value);
+    header[offset + 1] = uint8_t(value >> 8);
+  };
+  std::memcpy(header, "RIFF", 4);
+  put32(4, 36 + dataBytes);
+  std::memcpy(header + 8, "WAVEfmt ", 8);
+  put32(16, 16);
+  put16(20, 3); // WAVE_FORMAT_IEEE_FLOAT
+  put16(22, uint16_t(channels));
+  put32(24, kAudioSampleRate);
+  put32(28, kAudioSampleRate * bytesPerFrame);
+  put16(32, uint16_t(bytesPerFrame));
+  put16(34, 32);
+  std::memcpy(header + 36, "data", 4);
+  put32(40, dataBytes);
+  std::fseek(file, 0, SEEK_SET);
+  std::fwrite(header, 1, sizeof(header), file);
+}
+
+bool AudioMixer::openOutput(AudioOutput output, const char *path) {
+  m_output = output;
+  m_fileFrames = 0;
+  if (output == AudioOutput::Null)
+    return true;
+  m_file = path ? std::fopen(path, "wb") : nullptr;
+  if (!m_file) {
+    std::cerr << "Failed to open audio output file "
+              << (path ? path : "(none)") << "!" << std::endl;
+    return false;
+  }
+  // Rozmiary uzupełnia closeOutput()
+  writeWavHeader(m_file, 0);
+  return true;
+}
+
+void AudioMixer::writeOutput(const float *interleaved, uint32_t frames) {
+  if (!m_file)
+    return;
+  m_fileFrames +=
+      std::fwrite(interleaved, 2 * sizeof(float), frames, m_file);
+}
+
+void AudioMixer::closeOutput() {
+  if (!m_file)
+    return;
+  writeWavHeader(m_file, m_fileFrames);
+  std::fclose(m_file);
+  m_file = nullptr;
+}
+
+// ============================================================
+//  Dźwięki syntetyczne
+// ============================================================
+
+std::vector<float> audioSynthNoiseBurst(uint32_t sampleRate, float seconds,
+                                        uint32_t seed) {
+  std::vector<float> samples(size_t(std::max(seconds, 0.0f) * sampleRate));
+  uint32_t state = seed ? seed : 1u;
+  float lowPass = 0.0f;
+  for (size_t i = 0; i < samples.size(); ++i) {
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    const float noise = float(state) * (2.0f / 4294967296.0f) - 1.0f;
+    // Szum dolnoprzepustowy — głuchy wybuch zamiast syczenia
+    lowPass += (noise - lowPass) * 0.2f;
+    const float t = float(i) / float(sampleRate);
+    samples[i] = lowPass * std::exp(-t * 6.0f / std::max(seconds, 1e-3f));
+  }
+  return samples;
+}
+
+std::vector<float> audioSynthBlip(uint32_t sampleRate, float seconds,
+                                  float frequency) {
+  std::vector<float> samples(size_t(std::max(seconds, 0.0f) * sampleRate));
+  float phase = 0.0f;
+  for (size_t i = 0; i < samples.size(); ++i) {
+    const float t = float(i) / float(sampleRate);
+    const float progress = t / std::max(seconds, 1e-3f);
+    phase += frequency * (1.0f - 0.5f * progress) / float(sampleRate);
+    phase -= std::floor(phase);
+    samples[i] = std::sin(phase * 6.2831853f) * (1.0f - progress) * 0.5f;
+  }
+  return samples;
+}
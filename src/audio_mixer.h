@@ -0,0 +1,161 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+#include "spsc_ring.h"
+
+// ============================================================
+//  Mikser audio
+// ============================================================
+
+constexpr uint32_t kAudioSampleRate = 48000; // wyjście: stereo float
+constexpr uint32_t kAudioBlockFrames = 256;  // ~5.3 ms na blok
+constexpr uint32_t kMaxAudioVoices = 64;
+
+using SoundId = uint32_t;
+constexpr SoundId kInvalidSound = ~0u;
+
+// Dźwięk mono w pamięci (dowolna częstotliwość — mikser resampluje)
+struct SoundDesc {
+  const char *name = nullptr;
+  std::vector<float> samples;
+  uint32_t sampleRate = kAudioSampleRate;
+  uint32_t maxInstances = 8; // więcej naraz: nowa kradnie najstarszą
+  uint8_t priority = 0;      // wyższy nie traci głosu na rzecz niższego
+};
+
+struct SoundParams {
+  float volume = 1.0f;
+  float pan = 0.0f;   // -1 lewo, 1 prawo
+  float pitch = 1.0f; // mnożnik prędkości odtwarzania
+};
+
+enum class AudioOutput : uint8_t {
+  Null, // bloki są miksowane w tempie urządzenia i wyrzucane
+  File, // zapis do pliku WAV (float, stereo)
+};
+
+// Liczniki wątku audio (odczyt z dowolnego wątku)
+struct AudioStats {
+  uint64_t blocks = 0;
+  uint64_t lateBlocks = 0; // mikser nie zdążył przed terminem bloku
+  uint64_t voicesStarted = 0;
+  uint64_t voicesStolen = 0;   // brak wolnego głosu
+  uint64_t instanceCapped = 0; // limit instancji dźwięku
+  uint64_t rejected = 0;       // wszystkie głosy ważniejsze od nowego
+  uint64_t droppedCommands = 0; // pełna kolejka komend
+  uint32_t peakVoices = 0;
+  double avgMixUs = 0.0; // czas miksowania bloku
+  double maxMixUs = 0.0;
+};
+
+// Miks pojedynczego głosu: próbki mono z pozycji `position` (stałoprzecinkowo
+// 32.32) co `step`, interpolacja liniowa, wzmocnienia kanałów dodawane do
+// left/right. SSE2 / NEON po 4 ramki, reszta skalarnie. Zwraca liczbę
+// zmiksowanych ramek (< frames, gdy dźwięk się skończył).
+uint32_t audioMixVoice(const float *samples, uint32_t sampleCount,
+                       uint64_t &position, uint64_t step, float gainLeft,
+                       float gainRight, float *left, float *right,
+                       uint32_t frames);
+
+// Programowy mikser z wątkiem czasu rzeczywistego: co blok zdejmuje komendy
+// z kolejki, miksuje aktywne głosy z puli i oddaje blok urządzeniu
+// wyjściowemu. Rozgrywka rozmawia z nim wyłącznie przez kolejkę komend SPSC
+// (play/stopAll/setMasterVolume — jeden wątek producenta), więc wątek audio
+// nie bierze blokad i nie alokuje pamięci. Koszt ograniczają pula głosów
+// (kradzież najmniej ważnego, potem najstarszego) i limit instancji
+// dźwięku. Dźwięki dodaje się przed start() — potem są tylko czytane.
+class AudioMixer {
+public:
+  AudioMixer();
+  ~AudioMixer();
+  AudioMixer(const AudioMixer &) = delete;
+  AudioMixer &operator=(const AudioMixer &) = delete;
+
+  SoundId addSound(SoundDesc desc);
+
+  // Otwiera wyjście (path dla File) i uruchamia wątek audio
+  bool start(AudioOutput output, const char *path = nullptr);
+  void stop();
+
+  // Producent komend (jeden wątek). false, gdy kolejka jest pełna.
+  bool play(SoundId sound, const SoundParams &params = {});
+  bool stopAll();
+  bool setMasterVolume(float volume);
+
+  // Jeden blok przeplatanego stereo (frames <= kAudioBlockFrames) na
+  // wątku wołającym — pętla wątku audio, testy i render offline
+  void mixBlock(float *interleaved, uint32_t frames);
+
+  AudioStats stats() const;
+
+private:
+  enum class CommandType : uint8_t { Play, StopAll, MasterVolume };
+  struct Command {
+    CommandType type = CommandType::Play;
+    SoundId sound = kInvalidSound;
+    SoundParams params;
+  };
+
+  struct Sound {
+    SoundDesc desc;
+    double rateRatio = 1.0; // częstotliwość dźwięku / wyjścia
+  };
+
+  struct Voice {
+    bool active = false;
+    SoundId sound = kInvalidSound;
+    uint8_t priority = 0;
+    uint64_t position = 0; // 32.32
+    uint64_t step = 0;
+    float gainLeft = 0.0f;
+    float gainRight = 0.0f;
+    uint64_t order = 0; // numer startu (najmniejszy = najstarszy)
+  };
+
+  void threadMain();
+  void applyCommands();
+  void startVoice(const Command &command);
+  bool openOutput(AudioOutput output, const char *path);
+  void writeOutput(const float *interleaved, uint32_t frames);
+  void closeOutput();
+
+  std::vector<Sound> m_sounds;
+  SpscRing<Command, 256> m_commands;
+  Voice m_voices[kMaxAudioVoices];
+  uint64_t m_voiceOrder = 0;
+  float m_masterVolume = 1.0f;
+  alignas(16) float m_left[kAudioBlockFrames];
+  alignas(16) float m_right[kAudioBlockFrames];
+
+  AudioOutput m_output = AudioOutput::Null;
+  std::FILE *m_file = nullptr;
+  uint64_t m_fileFrames = 0;
+  std::thread m_thread;
+  std::atomic<bool> m_running{false};
+
+  // Statystyki: zapis tylko wątek audio (droppedCommands: producent);
+  // odczyt w stats() z dowolnego wątku
+  std::atomic<uint64_t> m_blocks{0};
+  std::atomic<uint64_t> m_lateBlocks{0};
+  std::atomic<uint64_t> m_voicesStarted{0};
+  std::atomic<uint64_t> m_voicesStolen{0};
+  std::atomic<uint64_t> m_instanceCapped{0};
+  std::atomic<uint64_t> m_rejected{0};
+  std::atomic<uint32_t> m_peakVoices{0};
+  std::atomic<uint64_t> m_mixNs{0};
+  std::atomic<uint64_t> m_maxMixNs{0};
+  std::atomic<uint64_t> m_droppedCommands{0}; // wątek producenta
+};
+
+// Proste dźwięki syntetyczne (silnik nie ma jeszcze assetów audio)
+// Wybuch: szum z wykładniczym wygaszaniem
+std::vector<float> audioSynthNoiseBurst(uint32_t sampleRate, float seconds,
+                                        uint32_t seed);
+// Trafienie: krótki ton opadający w wysokości
+std::vector<float> audioSynthBlip(uint32_t sampleRate, float seconds,
+                                  float frequency);
@@ -0,0 +1,292 @@
+#include "bench_report.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <sstream>
+
+FrameTimeSummary summarizeFrameTimes(std::vector<double> samplesMs) {
+  FrameTimeSummary summary;
+  if (samplesMs.empty())
+    return summary;
+  std::sort(samplesMs.begin(), samplesMs.end());
+  const size_t count = samplesMs.size();
+  auto percentile = [&](double p) {
+    const size_t rank = size_t(std::ceil(p * double(count)));
+    return samplesMs[std::clamp<size_t>(rank, 1, count) - 1];
+  };
+  double total = 0.0;
+  for (double ms : samplesMs)
+    total += ms;
+  summary.samples = uint32_t(count);
+  summary.avg = total / double(count);
+  summary.p50 = percentile(0.50);
+  summary.p95 = percentile(0.95);
+  summary.p99 = percentile(0.99);
+  summary.max = samplesMs.back();
+  return summary;
+}
+
+// ============================================================
+//  Zapis
+// ============================================================
+
+static std::string escapeJson(const std::string &text) {
+  std::string out;
+  for (char c : text) {
+    if (c == '"' || c == '\\')
+      out += '\\';
+    if (uint8_t(c) >= 0x20)
+      out += c;
+  }
+  return out;
+}
+
+static void writeSummary(std::ostringstream &out, const char *key,
+                         const FrameTimeSummary &summary) {
+  out << "      \"" << key << "\": ";
+  if (summary.samples == 0) {
+    out << "null";
+    return;
+  }
+  out << "{\"samples\": " << summary.samples << ", \"avg\": " << summary.avg
+      << ", \"p50\": " << summary.p50 << ", \"p95\": " << summary.p95
+      << ", \"p99\": " << summary.p99 << ", \"max\": " << summary.max << "}";
+}
+
+std::string benchResultsToJson(const std::vector<BenchResult> &results) {
+  std::ostringstream out;
+  out.precision(6);
+  out << "{\n  \"version\": 1,\n  \"scenarios\": [";
+  for (size_t i = 0; i < results.size(); ++i) {
+    const BenchResult &result = results[i];
+    out << (i ? ",\n" : "\n") << "    {\n"
+        << "      \"name\": \"" << escapeJson(result.name) << "\",\n"
+        << "      \"adapter\": \"" << escapeJson(result.adapter) << "\",\n"
+        << "      \"frames\": " << result.frames << ",\n"
+        << "      \"entities\": " << result.entities << ",\n"
+        << "      \"entities_per_second\": " << result.entitiesPerSecond
+        << ",\n";
+    writeSummary(out, "cpu_ms", result.cpu);
+    out << ",\n";
+    writeSummary(out, "gpu_ms", result.gpu);
+    out << "\n    }";
+  }
+  out << "\n  ]\n}\n";
+  return out.str();
+}
+
+bool writeBenchReport(const char *path,
+                      const std::vector<BenchResult> &results) {
+  std::ofstream file(path, std::ios::binary);
+  if (!file) {
+    std::cerr << "Could not write benchmark report: " << path << std::endl;
+    return false;
+  }
+  file << benchResultsToJson(results);
+  return bool(file);
+}
+
+// ============================================================
+//  Odczyt
+// ============================================================
+
+// Minimalny parser JSON — wystarcza dla raportów z benchResultsToJson
+// (obiekty, tablice, liczby, napisy bez sekwencji \u, null)
+namespace {
+
+struct JsonValue {
+  enum class Type { Null, Number, String, Array, Object } type = Type::Null;
+  double number = 0.0;
+  std::string text;
+  std::vector<JsonValue> items;
+  std::map<std::string, JsonValue> fields;
+
+  const JsonValue *field(const char *key) const {
+    auto it = fields.find(key);
+    return it != fields.end() ? &it->second : nullptr;
+  }
+  double numberField(const char *key) const {
+    const JsonValue *value = field(key);
+    return value && value->type == Type::Number ? value->number : 0.0;
+  }
+};
+
+struct JsonParser {
+  const char *cursor;
+  const char *end;
+
+  void skipSpace() {
+    while (cursor < end && std::isspace(uint8_t(*cursor)))
+      ++cursor;
+  }
+  bool consume(char c) {
+    skipSpace();
+    if (cursor < end && *cursor == c) {
+      ++cursor;
+      return true;
+    }
+    return false;
+  }
+
+  bool parseString(std::string &out) {
+    if (!consume('"'))
+      return false;
+    while (cursor < end && *cursor != '"') {
+      if (*cursor == '\\' && cursor + 1 < end)
+        ++cursor;
+      out += *cursor++;
+    }
+    return consume('"');
+  }
+
+  bool parse(JsonValue &value, int depth = 0) {
+    if (depth > 16)
+      return false;
+    skipSpace();
+    if (cursor >= end)
+      return false;
+    if (*cursor == '{') {
+      ++cursor;
+      value.type = JsonValue::Type::Object;
+      if (consume('}'))
+        return true;
+      do {
+        std::string key;
+        if (!parseString(key) || !consume(':') ||
+            !parse(value.fields[key], depth + 1))
+          return false;
+      } while (consume(','));
+      return consume('}');
+    }
+    if (*cursor == '[') {
+      ++cursor;
+      value.type = JsonValue::Type::Array;
+      if (consume(']'))
+        return true;
+      do {
+        value.items.emplace_back();
+        if (!parse(value.items.back(), depth + 1))
+          return false;
+      } while (consume(','));
+      return consume(']');
+    }
+    if (*cursor == '"') {
+      value.type = JsonValue::Type::String;
+      return parseString(value.text);
+    }
+    if (end - cursor >= 4 && std::string(cursor, 4) == "null") {
+      cursor += 4;
+      return true;
+    }
+    char *numberEnd = nullptr;
+    const std::string token(cursor, std::min<size_t>(end - cursor, 64));
+    value.number = std::strtod(token.c_str(), &numberEnd);
+    if (numberEnd == token.c_str())
+      return false;
+    value.type = JsonValue::Type::Number;
+    cursor += numberEnd - token.c_str();
+    return true;
+  }
+};
+
+FrameTimeSummary readSummary(const JsonValue *value) {
+  FrameTimeSummary summary;
+  if (!value || value->type != JsonValue::Type::Object)
+    return summary;
+  summary.samples = uint32_t(value->numberField("samples"));
+  summary.avg = value->numberField("avg");
+  summary.p50 = value->numberField("p50");
+  summary.p95 = value->numberField("p95");
+  summary.p99 = value->numberField("p99");
+  summary.max = value->numberField("max");
+  return summary;
+}
+
+} // namespace
+
+bool readBenchReport(const char *path, std::vector<BenchResult> &results) {
+  std::ifstream file(path, std::ios::binary);
+  if (!file) {
+    std::cerr << "Could not open benchmark report: " << path << std::endl;
+    return false;
+  }
+  const std::string text((std::istreambuf_iterator<char>(file)),
+                         std::istreambuf_iterator<char>());
+  JsonParser parser{text.data(), text.data() + text.size()};
+  JsonValue root;
+  const JsonValue *scenarios = nullptr;
+  if (parser.parse(root) && root.type == JsonValue::Type::Object)
+    scenarios = root.field("scenarios");
+  if (!scenarios || scenarios->type != JsonValue::Type::Array) {
+    std::cerr << "Invalid benchmark report: " << path << std::endl;
+    return false;
+  }
+
+  results.clear();
+  for (const JsonValue &scenario : scenarios->items) {
+    BenchResult result;
+    if (const JsonValue *name = scenario.field("name"))
+      result.name = name->text;
+    if (const JsonValue *adapter = scenario.field("adapter"))
+      result.adapter = adapter->text;
+    result.frames = uint32_t(scenario.numberField("frames"));
+    result.entities = uint64_t(scenario.numberField("entities"));
+    result.entitiesPerSecond = scenario.numberField("entities_per_second");
+    result.cpu = readSummary(scenario.field("cpu_ms"));
+    result.gpu = readSummary(scenario.field("gpu_ms"));
+    results.push_back(std::move(result));
+  }
+  return true;
+}
+
+// ============================================================
+//  Porównanie z bazą
+// ============================================================
+
+uint32_t compareBenchResults(const std::vector<BenchResult> &current,
+                             const std::vector<BenchResult> &baseline,
+                             double tolerance) {
+  uint32_t regressions = 0;
+  auto check = [&](const char *scenario, const char *metric, double now,
+                   double base, bool higherIsBetter) {
+    if (base <= 0.0)
+      return;
+    const double change = (now - base) / base;
+    const bool regressed =
+        higherIsBetter ? change < -tolerance : change > tolerance;
+    regressions += regressed;
+    std::printf("  %-18s %-14s %12.3f %12.3f %+8.1f%%%s\n", scenario, metric,
+                base, now, change * 100.0, regressed ? "  REGRESSION" : "");
+  };
+
+  std::printf("  %-18s %-14s %12s %12s %9s\n", "scenario", "metric",
+              "baseline", "current", "change");
+  for (const BenchResult &result : current) {
+    auto base = std::find_if(
+        baseline.begin(), baseline.end(),
+        [&](const BenchResult &entry) { return entry.name == result.name; });
+    if (base == baseline.end()) {
+      std::printf("  %-18s (not in baseline)\n", result.name.c_str());
+      continue;
+    }
+    if (base->adapter != result.adapter)
+      std::printf("  %-18s baseline adapter: %s\n", result.name.c_str(),
+                  base->adapter.c_str());
+    const char *name = result.name.c_str();
+    check(name, "cpu p95 ms", result.cpu.p95, base->cpu.p95, false);
+    check(name, "cpu p99 ms", result.cpu.p99, base->cpu.p99, false);
+    if (result.gpu.samples && base->gpu.samples) {
+      check(name, "gpu p95 ms", result.gpu.p95, base->gpu.p95, false);
+      check(name, "gpu p99 ms", result.gpu.p99, base->gpu.p99, false);
+    }
+    check(name, "entities/s", result.entitiesPerSecond,
+          base->entitiesPerSecond, true);
+  }
+  return regressions;
+}
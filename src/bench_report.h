@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// ============================================================
+//  Raport benchmarku (JSON)
+// ============================================================
+
+// Rozkład czasów klatek jednego przebiegu (ms)
+struct FrameTimeSummary {
+  uint32_t samples = 0; // 0 = brak pomiaru (np. GPU bez timestampów)
+  double avg = 0.0;
+  double p50 = 0.0;
+  double p95 = 0.0;
+  double p99 = 0.0;
+  double max = 0.0;
+};
+
+// Wynik jednego scenariusza. Przebieg headless jest deterministyczny
+// (ziarno, jeden tick na klatkę), więc różnice między raportami to
+// różnice wydajności, a nie innej pracy.
+struct BenchResult {
+  std::string name;
+  std::string adapter; // nazwa GPU (porównanie z bazą innego sprzętu)
+  uint32_t frames = 0; // zmierzone klatki (bez rozgrzewki)
+  uint64_t entities = 0;
+  FrameTimeSummary cpu;
+  FrameTimeSummary gpu;
+  double entitiesPerSecond = 0.0; // encje × klatki / suma czasu CPU
+};
+
+// Percentyle metodą najbliższego rangi (wartość z próbek, bez interpolacji)
+FrameTimeSummary summarizeFrameTimes(std::vector<double> samplesMs);
+
+std::string benchResultsToJson(const std::vector<BenchResult> &results);
+bool writeBenchReport(const char *path,
+                      const std::vector<BenchResult> &results);
+// Czyta raport zapisany przez writeBenchReport (także plik bazowy)
+bool readBenchReport(const char *path, std::vector<BenchResult> &results);
+
+// Porównanie z bazą: regresja, gdy p95/p99 CPU lub GPU wzrosną, albo
+// encje/s spadną o więcej niż tolerance (0.1 = 10%). Wypisuje tabelę
+// i zwraca liczbę regresji. Scenariusze spoza bazy są pomijane.
+uint32_t compareBenchResults(const std::vector<BenchResult> &current,
+                             const std::vector<BenchResult> &baseline,
+                             double tolerance);
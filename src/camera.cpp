@@ -0,0 +1,101 @@
+#include "camera.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+#include <emmintrin.h>
+#define WARP_CULL_SSE2 1
+#elif defined(__ARM_NEON) || defined(_M_ARM64)
+#include <arm_neon.h>
+#define WARP_CULL_NEON 1
+#endif
+
+void cameraFollow(Camera2D &camera, glm::vec2 target, float dt) {
+  if (camera.followSharpness <= 0.0f) {
+    camera.position = target;
+    return;
+  }
+  const float t = 1.0f - std::exp(-camera.followSharpness * dt);
+  camera.position += (target - camera.position) * t;
+}
+
+void cameraSetZoom(Camera2D &camera, float zoom) {
+  camera.zoom = std::clamp(zoom, camera.minZoom, camera.maxZoom);
+}
+
+CameraUniforms cameraBuildUniforms(const Camera2D &camera) {
+  const glm::vec2 half = camera.viewportSize * 0.5f;
+  CameraUniforms uniforms;
+  uniforms.projection =
+      glm::ortho(-half.x, half.x, half.y, -half.y, -1.0f, 1.0f);
+  uniforms.view =
+      glm::translate(glm::scale(glm::mat4(1.0f),
+                                glm::vec3(camera.zoom, camera.zoom, 1.0f)),
+                     glm::vec3(-camera.position, 0.0f));
+  uniforms.viewProjection = uniforms.projection * uniforms.view;
+  return uniforms;
+}
+
+CullRect cameraViewRect(const Camera2D &camera, float margin) {
+  const glm::vec2 half = camera.viewportSize * (0.5f / camera.zoom) +
+                         glm::vec2(margin);
+  return {camera.position.x - half.x, camera.position.y - half.y,
+          camera.position.x + half.x, camera.position.y + half.y};
+}
+
+uint32_t cullAabbs(const float *xs, const float *ys, const float *halfSizes,
+                   uint32_t count, const CullRect &rect, uint32_t *visible) {
+  uint32_t visibleCount = 0;
+  uint32_t i = 0;
+#if defined(WARP_CULL_SSE2)
+  const __m128 minX = _mm_set1_ps(rect.minX);
+  const __m128 minY = _mm_set1_ps(rect.minY);
+  const __m128 maxX = _mm_set1_ps(rect.maxX);
+  const __m128 maxY = _mm_set1_ps(rect.maxY);
+  for (; i + 4 <= count; i += 4) {
+    const __m128 x = _mm_loadu_ps(xs + i);
+    const __m128 y = _mm_loadu_ps(ys + i);
+    const __m128 h = _mm_loadu_ps(halfSizes + i);
+    // x + h >= minX && x - h <= maxX && (to samo dla y)
+    __m128 inside = _mm_cmpge_ps(_mm_add_ps(x, h), minX);
+    inside = _mm_and_ps(inside, _mm_cmple_ps(_mm_sub_ps(x, h), maxX));
+    inside = _mm_and_ps(inside, _mm_cmpge_ps(_mm_add_ps(y, h), minY));
+    inside = _mm_and_ps(inside, _mm_cmple_ps(_mm_sub_ps(y, h), maxY));
+    const uint32_t mask = uint32_t(_mm_movemask_ps(inside));
+    if (mask == 0)
+      continue;
+    for (uint32_t lane = 0; lane < 4; ++lane)
+      if (mask & (1u << lane))
+        visible[visibleCount++] = i + lane;
+  }
+#elif defined(WARP_CULL_NEON)
+  const float32x4_t minX = vdupq_n_f32(rect.minX);
+  const float32x4_t minY = vdupq_n_f32(rect.minY);
+  const float32x4_t maxX = vdupq_n_f32(rect.maxX);
+  const float32x4_t maxY = vdupq_n_f32(rect.maxY);
+  for (; i + 4 <= count; i += 4) {
+    const float32x4_t x = vld1q_f32(xs + i);
+    const float32x4_t y = vld1q_f32(ys + i);
+    const float32x4_t h = vld1q_f32(halfSizes + i);
+    uint32x4_t inside = vcgeq_f32(vaddq_f32(x, h), minX);
+    inside = vandq_u32(inside, vcleq_f32(vsubq_f32(x, h), maxX));
+    inside = vandq_u32(inside, vcgeq_f32(vaddq_f32(y, h), minY));
+    inside = vandq_u32(inside, vcleq_f32(vsubq_f32(y, h), maxY));
+    uint32_t lanes[4];
+    vst1q_u32(lanes, inside);
+    for (uint32_t lane = 0; lane < 4; ++lane)
+      if (lanes[lane])
+        visible[visibleCount++] = i + lane;
+  }
+#endif
+  for (; i < count; ++i) {
+    if (xs[i] + halfSizes[i] >= rect.minX &&
+        xs[i] - halfSizes[i] <= rect.maxX &&
+        ys[i] + halfSizes[i] >= rect.minY && ys[i] - halfSizes[i] <= rect.maxY)
+      visible[visibleCount++] = i;
+  }
+  return visibleCount;
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstdint>
+#include <glm/glm.hpp>
+
+// ============================================================
+//  Kamera 2D
+// ============================================================
+
+// Uniform grupy 0 shadera sprite'ów (192 B). Shader używa viewProjection;
+// view i projection osobno — dla efektów w przestrzeni ekranu.
+struct CameraUniforms {
+  glm::mat4 viewProjection;
+  glm::mat4 view;
+  glm::mat4 projection;
+};
+
+// Kamera patrzy na `position` (środek ekranu) z przybliżeniem `zoom`;
+// oś Y rośnie w dół, jak w przestrzeni świata sprite'ów
+struct Camera2D {
+  glm::vec2 position{0.0f};
+  glm::vec2 viewportSize{800.0f, 600.0f}; // w pikselach
+  float zoom = 1.0f;                      // > 1 przybliża
+  float minZoom = 0.25f;
+  float maxZoom = 4.0f;
+  float followSharpness = 8.0f; // 1/s; 0 = kamera przyklejona do celu
+};
+
+// Prostokąt widoku w przestrzeni świata (do cullingu)
+struct CullRect {
+  float minX, minY, maxX, maxY;
+};
+
+// Wygładzone podążanie za celem (wykładniczo, niezależnie od FPS)
+void cameraFollow(Camera2D &camera, glm::vec2 target, float dt);
+void cameraSetZoom(Camera2D &camera, float zoom);
+
+CameraUniforms cameraBuildUniforms(const Camera2D &camera);
+// Widoczny obszar świata powiększony o margin (jednostki świata)
+CullRect cameraViewRect(const Camera2D &camera, float margin = 0.0f);
+
+// Testuje AABB (środek x/y, połowa rozmiaru) z prostokątem po 4 naraz
+// (SSE2 / NEON, reszta skalarnie). Zapisuje indeksy widocznych elementów
+// do visible (pojemność >= count) i zwraca ich liczbę.
+uint32_t cullAabbs(const float *xs, const float *ys, const float *halfSizes,
+                   uint32_t count, const CullRect &rect, uint32_t *visible);
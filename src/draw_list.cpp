@@ -0,0 +1,69 @@
+#include "draw_list.h"
+
+#include <cstring>
+
+uint64_t makeSortKey(uint32_t layer, uint32_t pipeline, uint32_t page,
+                     float depth) {
+  // float → uint32 zachowujący kolejność (ujemne odwrócone), górne 24 bity
+  uint32_t bits;
+  std::memcpy(&bits, &depth, sizeof(bits));
+  bits = (bits & 0x80000000u) ? ~bits : bits | 0x80000000u;
+  return (uint64_t(layer & 0xFF) << kSortKeyLayerShift) |
+         (uint64_t(pipeline & 0xFF) << kSortKeyPipelineShift) |
+         (uint64_t(page & 0xFF) << kSortKeyPageShift) |
+         (uint64_t(bits >> 8) << kSortKeyDepthShift);
+}
+
+void drawListClear(DrawList &list) {
+  list.keys.clear();
+  list.items.clear();
+  list.batches.clear();
+}
+
+void drawListSort(DrawList &list) {
+  const size_t count = list.keys.size();
+  list.sortPasses = 0;
+  if (count < 2)
+    return;
+
+  uint32_t histograms[8][256] = {};
+  for (uint64_t key : list.keys)
+    for (uint32_t byte = 0; byte < 8; ++byte)
+      ++histograms[byte][(key >> (byte * 8)) & 0xFF];
+
+  list.scratchKeys.resize(count);
+  list.scratchItems.resize(count);
+  for (uint32_t byte = 0; byte < 8; ++byte) {
+    uint32_t *histogram = histograms[byte];
+    // Wszystkie klucze mają ten sam bajt — przebieg niczego nie zmieni
+    if (histogram[(list.keys[0] >> (byte * 8)) & 0xFF] == count)
+      continue;
+
+    uint32_t offset = 0;
+    for (uint32_t bucket = 0; bucket < 256; ++bucket) {
+      const uint32_t bucketCount = histogram[bucket];
+      histogram[bucket] = offset;
+      offset += bucketCount;
+    }
+    for (size_t i = 0; i < count; ++i) {
+      const uint64_t key = list.keys[i];
+      const uint32_t target = histogram[(key >> (byte * 8)) & 0xFF]++;
+      list.scratchKeys[target] = key;
+      list.scratchItems[target] = list.items[i];
+    }
+    list.keys.swap(list.scratchKeys);
+    list.items.swap(list.scratchItems);
+    ++list.sortPasses;
+  }
+}
+
+void drawListBuildBatches(DrawList &list) {
+  list.batches.clear();
+  const uint32_t count = uint32_t(list.keys.size());
+  for (uint32_t i = 0; i < count; ++i) {
+    const uint32_t pipeline = sortKeyPipeline(list.keys[i]);
+    if (list.batches.empty() || list.batches.back().pipeline != pipeline)
+      list.batches.push_back({pipeline, i, 0});
+    ++list.batches.back().count;
+  }
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+// ============================================================
+//  Klucze sortowania
+// ============================================================
+
+// Klucz rysowania (64 bity, od najstarszych):
+//   warstwa 8 | pipeline 8 | strona atlasu 8 | głębokość 24 | wolne 16
+// Rosnąco: warstwy od spodu, w warstwie grupy jednego pipeline'u i jednej
+// strony atlasu, w grupie od tyłu do przodu (mniejsza głębokość wcześniej).
+constexpr uint32_t kSortKeyLayerShift = 56;
+constexpr uint32_t kSortKeyPipelineShift = 48;
+constexpr uint32_t kSortKeyPageShift = 40;
+constexpr uint32_t kSortKeyDepthShift = 16;
+
+uint64_t makeSortKey(uint32_t layer, uint32_t pipeline, uint32_t page,
+                     float depth);
+
+inline uint32_t sortKeyPipeline(uint64_t key) {
+  return uint32_t(key >> kSortKeyPipelineShift) & 0xFF;
+}
+
+// ============================================================
+//  Lista rysowania
+// ============================================================
+
+// Ciągły zakres posortowanych elementów rysowany jednym pipeline'em.
+// Zmiana warstwy ani strony atlasu (warstwy tekstury 2D array) nie wymaga
+// zmiany stanu, więc nie dzieli batcha.
+struct DrawBatch {
+  uint32_t pipeline;
+  uint32_t first;
+  uint32_t count;
+};
+
+struct DrawList {
+  std::vector<uint64_t> keys;
+  std::vector<uint32_t> items; // indeks elementu, np. instancji
+  std::vector<DrawBatch> batches;
+  // Bufory robocze sortowania (utrzymywane między klatkami)
+  std::vector<uint64_t> scratchKeys;
+  std::vector<uint32_t> scratchItems;
+  uint32_t sortPasses = 0; // przebiegi ostatniego sortowania (0..8)
+};
+
+void drawListClear(DrawList &list);
+
+inline void drawListAdd(DrawList &list, uint64_t key, uint32_t item) {
+  list.keys.push_back(key);
+  list.items.push_back(item);
+}
+
+// Stabilny radix sort LSD po bajtach klucza. Histogramy wszystkich bajtów
+// liczone są w jednym przejściu; bajty identyczne we wszystkich kluczach
+// (np. nieużywane pola) są pomijane.
+void drawListSort(DrawList &list);
+
+// Po sortowaniu: łączy sąsiednie elementy o tym samym pipeline w batche
+void drawListBuildBatches(DrawList &list);
@@ -0,0 +1,245 @@
+#include "dynamic_resolution.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+#include "pipeline_cache.h"
+
+// Pełnoekranowy trójkąt; UV (0, 0) w lewym górnym rogu wyjścia
+static const char *upscaleShaderSource = R"(
+struct Params {
+  uvScale: vec2f,
+  uvMax: vec2f,
+};
+
+@group(0) @binding(0) var sceneTexture: texture_2d<f32>;
+@group(0) @binding(1) var sceneSampler: sampler;
+@group(0) @binding(2) var<uniform> params: Params;
+
+struct VertexOutput {
+  @builtin(position) position: vec4f,
+  @location(0) uv: vec2f,
+};
+
+@vertex
+fn vs_main(@builtin(vertex_index) index: u32) -> VertexOutput {
+  // Wierzchołki (-1, -1), (3, -1), (-1, 3) pokrywają cały ekran
+  let corner = vec2f(f32((index << 1u) & 2u), f32(index & 2u));
+  var out: VertexOutput;
+  out.position = vec4f(corner * 2.0 - 1.0, 0.0, 1.0);
+  out.uv = vec2f(corner.x, 1.0 - corner.y);
+  return out;
+}
+
+@fragment
+fn fs_main(in: VertexOutput) -> @location(0) vec4f {
+  // Filtr dwuliniowy nie może sięgnąć poza viewport sceny
+  let uv = min(in.uv * params.uvScale, params.uvMax);
+  return textureSample(sceneTexture, sceneSampler, uv);
+}
+)";
+
+// ============================================================
+//  Tworzenie
+// ============================================================
+
+static BindGroupLayoutDesc upscaleBindGroupLayoutDesc() {
+  BindGroupLayoutDesc desc;
+  desc.label = "Upscale Bind Group Layout";
+  desc.entries = {
+      BindingDesc::texture(0, WGPUShaderStage_Fragment,
+                           WGPUTextureSampleType_Float,
+                           WGPUTextureViewDimension_2D),
+      BindingDesc::sampler(1, WGPUShaderStage_Fragment,
+                           WGPUSamplerBindingType_Filtering),
+      BindingDesc::buffer(2, WGPUShaderStage_Fragment,
+                          WGPUBufferBindingType_Uniform,
+                          sizeof(UpscaleParams)),
+  };
+  return desc;
+}
+
+bool createScaledScene(WGPUDevice device, PipelineCache &pipelines,
+                       WGPUTextureFormat format, uint32_t width,
+                       uint32_t height, ScaledScene &scene) {
+  scene.device = device;
+  scene.format = format;
+  scene.width = std::max(width, 1u);
+  scene.height = std::max(height, 1u);
+
+  // 1. Pipeline (bez buforów wierzchołków) i layout z cache'a
+  const BindGroupLayoutDesc layoutDesc = upscaleBindGroupLayoutDesc();
+  RenderPipelineDesc pipelineDesc;
+  pipelineDesc.label = "Upscale Pipeline";
+  pipelineDesc.shaderSource = upscaleShaderSource;
+  pipelineDesc.bindGroups = {layoutDesc};
+  pipelineDesc.colorFormat = format;
+  pipelineDesc.blend = BlendMode::Opaque;
+  scene.pipeline = pipelines.renderPipeline(pipelineDesc);
+  scene.layout = pipelines.bindGroupLayout(layoutDesc);
+
+  // 2. Sampler dwuliniowy i uniformy (bind group — przy pierwszym
+  // rysowaniu, gdy znany jest widok tekstury sceny)
+  WGPUSamplerDescriptor samplerDesc = {};
+  samplerDesc.nextInChain = nullptr;
+  samplerDesc.label = "Upscale Sampler";
+  samplerDesc.addressModeU = WGPUAddressMode_ClampToEdge;
+  samplerDesc.addressModeV = WGPUAddressMode_ClampToEdge;
+  samplerDesc.addressModeW = WGPUAddressMode_ClampToEdge;
+  samplerDesc.magFilter = WGPUFilterMode_Linear;
+  samplerDesc.minFilter = WGPUFilterMode_Linear;
+  samplerDesc.mipmapFilter = WGPUMipmapFilterMode_Nearest;
+  samplerDesc.lodMinClamp = 0.0f;
+  samplerDesc.lodMaxClamp = 1.0f;
+  samplerDesc.compare = WGPUCompareFunction_Undefined;
+  samplerDesc.maxAnisotropy = 1;
+  scene.sampler = wgpuDeviceCreateSampler(device, &samplerDesc);
+
+  WGPUBufferDescriptor bufferDesc = {};
+  bufferDesc.nextInChain = nullptr;
+  bufferDesc.label = "Upscale Params";
+  bufferDesc.usage = WGPUBufferUsage_Uniform | WGPUBufferUsage_CopyDst;
+  bufferDesc.size = sizeof(UpscaleParams);
+  bufferDesc.mappedAtCreation = false;
+  scene.paramsBuffer = wgpuDeviceCreateBuffer(device, &bufferDesc);
+
+  if (!scene.pipeline || !scene.layout || !scene.sampler ||
+      !scene.paramsBuffer) {
+    std::cerr << "Failed to create scene upscale resources!" << std::endl;
+    releaseScaledScene(scene);
+    return false;
+  }
+  return true;
+}
+
+void releaseScaledScene(ScaledScene &scene) {
+  if (scene.bindGroup)
+    wgpuBindGroupRelease(scene.bindGroup);
+  if (scene.paramsBuffer)
+    wgpuBufferRelease(scene.paramsBuffer);
+  if (scene.sampler)
+    wgpuSamplerRelease(scene.sampler);
+  scene = {};
+}
+
+void scaledSceneResize(ScaledScene &scene, uint32_t width, uint32_t height) {
+  scene.width = std::max(width, 1u);
+  scene.height = std::max(height, 1u);
+  // Stara tekstura sceny zniknie razem z planem grafu
+  if (scene.bindGroup)
+    wgpuBindGroupRelease(scene.bindGroup);
+  scene.bindGroup = nullptr;
+  scene.boundView = nullptr;
+}
+
+// ============================================================
+//  Klatka
+// ============================================================
+
+void scaledSceneExtent(const ScaledScene &scene, float scale,
+                       uint32_t &width, uint32_t &height) {
+  scale = std::clamp(scale, 0.0f, 1.0f);
+  width = std::max(1u, uint32_t(std::lround(float(scene.width) * scale)));
+  height = std::max(1u, uint32_t(std::lround(float(scene.height) * scale)));
+}
+
+void scaledSceneSetViewport(WGPURenderPassEncoder pass,
+                            const ScaledScene &scene, float scale) {
+  uint32_t width = 0, height = 0;
+  scaledSceneExtent(scene, scale, width, height);
+  wgpuRenderPassEncoderSetViewport(pass, 0.0f, 0.0f, float(width),
+                                   float(height), 0.0f, 1.0f);
+}
+
+void scaledScenePrepare(WGPUQueue queue, const ScaledScene &scene,
+                        float scale) {
+  uint32_t width = 0, height = 0;
+  scaledSceneExtent(scene, scale, width, height);
+  UpscaleParams params = {};
+  params.uvScale[0] = float(width) / float(scene.width);
+  params.uvScale[1] = float(height) / float(scene.height);
+  params.uvMax[0] = (float(width) - 0.5f) / float(scene.width);
+  params.uvMax[1] = (float(height) - 0.5f) / float(scene.height);
+  wgpuQueueWriteBuffer(queue, scene.paramsBuffer, 0, &params, sizeof(params));
+}
+
+void scaledSceneDrawUpscale(WGPURenderPassEncoder pass, ScaledScene &scene,
+                            WGPUTextureView sceneView) {
+  if (sceneView != scene.boundView) {
+    if (scene.bindGroup)
+      wgpuBindGroupRelease(scene.bindGroup);
+    WGPUBindGroupEntry entries[3] = {};
+    entries[0].binding = 0;
+    entries[0].textureView = sceneView;
+    entries[1].binding = 1;
+    entries[1].sampler = scene.sampler;
+    entries[2].binding = 2;
+    entries[2].buffer = scene.paramsBuffer;
+    entries[2].size = sizeof(UpscaleParams);
+
+    WGPUBindGroupDescriptor bindGroupDesc = {};
+    bindGroupDesc.nextInChain = nullptr;
+    bindGroupDesc.label = "Upscale Bind Group";
+    bindGroupDesc.layout = scene.layout;
+    bindGroupDesc.entryCount = 3;
+    bindGroupDesc.entries = entries;
+    scene.bindGroup = wgpuDeviceCreateBindGroup(scene.device, &bindGroupDesc);
+    scene.boundView = sceneView;
+  }
+  wgpuRenderPassEncoderSetPipeline(pass, scene.pipeline);
+  wgpuRenderPassEncoderSetBindGroup(pass, 0, scene.bindGroup, 0, nullptr);
+  wgpuRenderPassEncoderDraw(pass, 3, 1, 0, 0);
+}
+
+// ============================================================
+//  Sterowanie skalą
+// ============================================================
+
+constexpr double kGpuSmoothing = 0.25;   // waga nowego pomiaru
+constexpr uint32_t kSettleSamples = 4;   // pomiary przed decyzją
+constexpr double kRaiseBelow = 0.85;     // podnieś skalę poniżej 85% celu
+constexpr float kMaxScaleChange = 0.125f; // największy krok na decyzję
+
+bool dynamicResolutionUpdate(DynamicResolution &controller,
+                             uint64_t frameIndex, const FrameStats *latest) {
+  bool changed = false;
+  // Tylko nowe pomiary klatek renderowanych już w bieżącej skali
+  if (latest && latest->gpuMs >= 0.0 && controller.targetGpuMs > 0.0 &&
+      latest->frameIndex > controller.lastSampleFrame &&
+      latest->frameIndex >= controller.settleFrame) {
+    controller.lastSampleFrame = latest->frameIndex;
+    controller.filteredGpuMs =
+        controller.samples == 0
+            ? latest->gpuMs
+            : controller.filteredGpuMs +
+                  (latest->gpuMs - controller.filteredGpuMs) * kGpuSmoothing;
+    ++controller.samples;
+
+    // Pas tolerancji [85%, 100%] celu — bez oscylacji wokół progu
+    const double load =
+        controller.filteredGpuMs / std::max(controller.targetGpuMs, 1e-3);
+    if (controller.samples >= kSettleSamples &&
+        (load > 1.0 || load < kRaiseBelow)) {
+      const double correction = std::sqrt(1.0 / std::max(load, 1e-3));
+      float next = controller.scale * float(correction);
+      next = std::clamp(next, controller.scale - kMaxScaleChange,
+                        controller.scale + kMaxScaleChange);
+      // W dół do kroku kwantyzacji — nad celem skala zawsze spada
+      next = std::floor(next / controller.step + 1e-4f) * controller.step;
+      next = std::clamp(next, controller.minScale, controller.maxScale);
+      if (next != controller.scale) {
+        controller.scale = next;
+        controller.settleFrame = frameIndex;
+        controller.samples = 0;
+        ++controller.adjustments;
+        changed = true;
+      }
+    }
+  }
+
+  ++controller.frames;
+  controller.scaleSum += controller.scale;
+  controller.lowestScale = std::min(controller.lowestScale, controller.scale);
+  return changed;
+}
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <cstdint>
+#include <webgpu/webgpu.h>
+
+#include "profiler.h"
+
+class PipelineCache;
+
+// ============================================================
+//  Scena w zmiennej rozdzielczości
+// ============================================================
+
+// Uniformy passa skalowania (16 B) — ten sam układ co struct w WGSL
+struct UpscaleParams {
+  float uvScale[2]; // część tekstury zajęta przez scenę
+  float uvMax[2];   // środek ostatniego texela sceny (bez przecieku)
+};
+static_assert(sizeof(UpscaleParams) == 16, "UpscaleParams layout");
+
+// Skalowanie sceny: tekstura sceny (tymczasowa z grafu renderowania) ma
+// pełny rozmiar wyjścia, świat rysowany jest do jej lewego górnego
+// fragmentu (viewport przeskalowany o `scale`), a pass skalowania
+// rozciąga ten fragment filtrem dwuliniowym na cały cel wyjścia. Zmiana
+// skali nie realokuje tekstury — tylko viewport i UV.
+struct ScaledScene {
+  WGPUDevice device = nullptr;
+  WGPUTextureFormat format = WGPUTextureFormat_Undefined;
+  uint32_t width = 0; // rozmiar tekstury sceny = rozmiar wyjścia
+  uint32_t height = 0;
+  WGPUSampler sampler = nullptr;
+  WGPUBuffer paramsBuffer = nullptr; // Uniform
+  WGPUBindGroup bindGroup = nullptr;
+  WGPUTextureView boundView = nullptr; // widok sceny w bindGroup
+  // Z PipelineCache, nie posiadane
+  WGPURenderPipeline pipeline = nullptr;
+  WGPUBindGroupLayout layout = nullptr;
+};
+
+bool createScaledScene(WGPUDevice device, PipelineCache &pipelines,
+                       WGPUTextureFormat format, uint32_t width,
+                       uint32_t height, ScaledScene &scene);
+void releaseScaledScene(ScaledScene &scene);
+// Nowy rozmiar wyjścia (okno). Zwalnia bind group starej tekstury sceny —
+// graf renderowania trzeba przebudować z nowym rozmiarem.
+void scaledSceneResize(ScaledScene &scene, uint32_t width, uint32_t height);
+
+// Rozmiar viewportu sceny dla skali (co najmniej 1 px)
+void scaledSceneExtent(const ScaledScene &scene, float scale,
+                       uint32_t &width, uint32_t &height);
+// Viewport passa sceny dla skali
+void scaledSceneSetViewport(WGPURenderPassEncoder pass,
+                            const ScaledScene &scene, float scale);
+// Zapisuje UV skalowania dla skali bieżącej klatki (przed submit)
+void scaledScenePrepare(WGPUQueue queue, const ScaledScene &scene,
+                        float scale);
+// Pełnoekranowy trójkąt próbkujący scenę — w passie celu wyjścia. Bind
+// group powstaje od nowa tylko po zmianie widoku tekstury sceny.
+void scaledSceneDrawUpscale(WGPURenderPassEncoder pass, ScaledScene &scene,
+                            WGPUTextureView sceneView);
+
+// ============================================================
+//  Sterowanie skalą
+// ============================================================
+
+// Regulator skali renderowania: czas GPU rośnie mniej więcej z liczbą
+// pikseli (scale²), więc nowa skala = scale · √(cel / zmierzony czas).
+// Pomiar jest wygładzany, w pasie tolerancji skala się nie zmienia, a po
+// każdej zmianie regulator czeka na pomiary klatek już w nowej skali
+// (timestampy wracają z opóźnieniem kilku klatek).
+struct DynamicResolution {
+  double targetGpuMs = 0.0; // docelowy czas GPU klatki
+  float minScale = 0.5f;
+  float maxScale = 1.0f;
+  float step = 1.0f / 32.0f; // kwantyzacja skali
+  float scale = 1.0f;        // skala bieżącej klatki
+  double filteredGpuMs = 0.0;
+  uint32_t samples = 0;         // pomiary od ostatniej zmiany skali
+  uint64_t lastSampleFrame = 0; // ostatnia klatka wzięta z profilera
+  uint64_t settleFrame = 0; // pierwsza klatka renderowana w bieżącej skali
+  // Statystyki
+  uint32_t adjustments = 0;
+  uint64_t frames = 0;
+  double scaleSum = 0.0;
+  float lowestScale = 1.0f;
+};
+
+// Raz na klatkę, przed jej renderowaniem. `latest` = najnowsza klatka z
+// odczytanym czasem GPU (profilerLatestGpuFrame). Zwraca true, gdy skala
+// się zmieniła.
+bool dynamicResolutionUpdate(DynamicResolution &controller,
+                             uint64_t frameIndex, const FrameStats *latest);
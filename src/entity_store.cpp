@@ -0,0 +1,415 @@
+#include "entity_store.h"
+
+#include <cstring>
+#include <new>
+
+// Komponent, do którego należy każda kolumna
+static constexpr ComponentMask kColumnComponent[Column_Count] = {
+    Component_Position, Component_Position, Component_Position,
+    Component_Position, Component_Velocity, Component_Velocity,
+    Component_Health,   Component_Sprite,   Component_Sprite,
+    Component_Sprite,   Component_Sprite,   Component_Sprite,
+};
+
+static bool hasColumn(ComponentMask mask, uint32_t column) {
+  return (mask & kColumnComponent[column]) != 0;
+}
+
+// Tworzy chunk z kolumnami archetypu w jednym wyrównanym bloku pamięci
+static std::unique_ptr<Chunk> allocateChunk(ComponentMask mask) {
+  auto chunk = std::make_unique<Chunk>();
+  const size_t columnBytes = size_t(kChunkCapacity) * 4;
+
+  size_t columnCount = 0;
+  for (uint32_t c = 0; c < Column_Count; ++c)
+    columnCount += hasColumn(mask, c) ? 1 : 0;
+  if (columnCount == 0)
+    return chunk;
+
+  chunk->memory = static_cast<uint8_t *>(::operator new(
+      columnCount * columnBytes, std::align_val_t(kColumnAlignment)));
+  size_t offset = 0;
+  for (uint32_t c = 0; c < Column_Count; ++c) {
+    if (!hasColumn(mask, c))
+      continue;
+    chunk->columns[c] = chunk->memory + offset;
+    offset += columnBytes;
+  }
+  return chunk;
+}
+
+Chunk::~Chunk() {
+  if (memory)
+    ::operator delete(memory, std::align_val_t(kColumnAlignment));
+}
+
+// ============================================================
+//  Archetypy i wiersze
+// ============================================================
+
+uint32_t EntityStore::findOrCreateArchetype(ComponentMask mask) {
+  for (uint32_t i = 0; i < m_archetypes.size(); ++i)
+    if (m_archetypes[i].mask == mask)
+      return i;
+  Archetype archetype;
+  archetype.mask = mask;
+  m_archetypes.push_back(std::move(archetype));
+  return uint32_t(m_archetypes.size() - 1);
+}
+
+void EntityStore::allocateRow(uint32_t archetypeIndex, uint32_t &chunk,
+                              uint32_t &row) {
+  Archetype &archetype = m_archetypes[archetypeIndex];
+  if (archetype.activeChunks == 0 ||
+      archetype.chunks[archetype.activeChunks - 1]->count == kChunkCapacity) {
+    // Aktywuj zapasowy chunk albo zaalokuj nowy
+    if (archetype.activeChunks == archetype.chunks.size())
+      archetype.chunks.push_back(allocateChunk(archetype.mask));
+    ++archetype.activeChunks;
+  }
+
+  chunk = archetype.activeChunks - 1;
+  Chunk &target = *archetype.chunks[chunk];
+  row = target.count++;
+  for (uint32_t c = 0; c < Column_Count; ++c)
+    if (target.columns[c])
+      std::memset(static_cast<uint8_t *>(target.columns[c]) + row * 4, 0, 4);
+  ++archetype.entityCount;
+}
+
+void EntityStore::removeRow(uint32_t archetypeIndex, uint32_t chunk,
+                            uint32_t row) {
+  Archetype &archetype = m_archetypes[archetypeIndex];
+  Chunk &lastChunk = *archetype.chunks[archetype.activeChunks - 1];
+  const uint32_t lastRow = lastChunk.count - 1;
+  Chunk &target = *archetype.chunks[chunk];
+
+  // Przenieś ostatni wiersz archetypu w miejsce usuwanego
+  if (&target != &lastChunk || row != lastRow) {
+    for (uint32_t c = 0; c < Column_Count; ++c) {
+      if (!target.columns[c])
+        continue;
+      std::memcpy(static_cast<uint8_t *>(target.columns[c]) + row * 4,
+                  static_cast<uint8_t *>(lastChunk.columns[c]) + lastRow * 4,
+                  4);
+    }
+    const EntityHandle moved = lastChunk.entities[lastRow];
+    target.entities[row] = moved;
+    m_records[moved.index].chunk = chunk;
+    m_records[moved.index].row = row;
+  }
+
+  if (--lastChunk.count == 0)
+    --archetype.activeChunks; // chunk zostaje jako zapas
+  --archetype.entityCount;
+}
+
+// ============================================================
+//  Encje
+// ============================================================
+
+const EntityStore::EntityRecord *
+EntityStore::record(EntityHandle handle) const {
+  if (handle.index >= m_records.size())
+    return nullptr;
+  const EntityRecord &rec = m_records[handle.index];
+  if (rec.generation != handle.generation || rec.archetype == kInvalid)
+    return nullptr;
+  return &rec;
+}
+
+bool EntityStore::isAlive(EntityHandle handle) const {
+  return record(handle) != nullptr;
+}
+
+EntityHandle EntityStore::create(ComponentMask mask) {
+  uint32_t index;
+  if (!m_freeRecords.empty()) {
+    index = m_freeRecords.back();
+    m_freeRecords.pop_back();
+  } else {
+    index = uint32_t(m_records.size());
+    m_records.emplace_back();
+  }
+
+  EntityRecord &rec = m_records[index];
+  rec.archetype = findOrCreateArchetype(mask);
+  allocateRow(rec.archetype, rec.chunk, rec.row);
+
+  const EntityHandle handle{index, rec.generation};
+  m_archetypes[rec.archetype].chunks[rec.chunk]->entities[rec.row] = handle;
+  ++m_aliveCount;
+  return handle;
+}
+
+void EntityStore::destroy(EntityHandle handle) {
+  if (!isAlive(handle))
+    return;
+  EntityRecord &rec = m_records[handle.index];
+  removeRow(rec.archetype, rec.chunk, rec.row);
+
+  rec.archetype = kInvalid;
+  if (++rec.generation == 0)
+    rec.generation = 1;
+  m_freeRecords.push_back(handle.index);
+  --m_aliveCount;
+}
+
+void EntityStore::flushDestroyQueue() {
+  for (EntityHandle handle : m_destroyQueue)
+    destroy(handle); // duplikaty są ignorowane przez kontrolę generacji
+  m_destroyQueue.clear();
+}
+
+ComponentMask EntityStore::mask(EntityHandle handle) const {
+  const EntityRecord *rec = record(handle);
+  return rec ? m_archetypes[rec->archetype].mask : 0;
+}
+
+void EntityStore::migrate(EntityHandle handle, ComponentMask newMask) {
+  if (!isAlive(handle))
+    return;
+  EntityRecord &rec = m_records[handle.index];
+  if (m_archetypes[rec.archetype].mask == newMask)
+    return;
+
+  const uint32_t oldArchetype = rec.archetype;
+  const uint32_t oldChunk = rec.chunk;
+  const uint32_t oldRow = rec.row;
+  const uint32_t newArchetype = findOrCreateArchetype(newMask);
+  uint32_t newChunk, newRow;
+  allocateRow(newArchetype, newChunk, newRow);
+
+  // Skopiuj wspólne kolumny
+  Chunk &src = *m_archetypes[oldArchetype].chunks[oldChunk];
+  Chunk &dst = *m_archetypes[newArchetype].chunks[newChunk];
+  for (uint32_t c = 0; c < Column_Count; ++c) {
+    if (src.columns[c] && dst.columns[c])
+      std::memcpy(static_cast<uint8_t *>(dst.columns[c]) + newRow * 4,
+                  static_cast<uint8_t *>(src.columns[c]) + oldRow * 4, 4);
+  }
+  dst.entities[newRow] = handle;
+
+  removeRow(oldArchetype, oldChunk, oldRow);
+  rec.archetype = newArchetype;
+  rec.chunk = newChunk;
+  rec.row = newRow;
+}
+
+void EntityStore::addComponents(EntityHandle handle, ComponentMask components) {
+  migrate(handle, mask(handle) | components);
+}
+
+void EntityStore::removeComponents(EntityHandle handle,
+                                   ComponentMask components) {
+  migrate(handle, mask(handle) & ~components);
+}
+
+float &EntityStore::f32(EntityHandle handle, Column column) {
+  const EntityRecord *rec = record(handle);
+  assert(rec && "stale entity handle");
+  Chunk &chunk = *m_archetypes[rec->archetype].chunks[rec->chunk];
+  assert(chunk.columns[column] && "column not present in archetype");
+  return static_cast<float *>(chunk.columns[column])[rec->row];
+}
+
+uint32_t &EntityStore::u32(EntityHandle handle, Column column) {
+  const EntityRecord *rec = record(handle);
+  assert(rec && "stale entity handle");
+  Chunk &chunk = *m_archetypes[rec->archetype].chunks[rec->chunk];
+  assert(chunk.columns[column] && "column not present in archetype");
+  return static_cast<uint32_t *>(chunk.columns[column])[rec->row];
+}
+
+// ============================================================
+//  Zrzut stanu
+// ============================================================
+
+static_assert(sizeof(EntityHandle) == 8, "EntityHandle layout");
+
+static size_t columnCount(ComponentMask mask) {
+  size_t count = 0;
+  for (uint32_t c = 0; c < Column_Count; ++c)
+    count += hasColumn(mask, c) ? 1 : 0;
+  return count;
+}
+
+// Tablica uint32 dopełniona do 8 bajtów
+static size_t paddedU32Bytes(size_t count) {
+  return (count * 4 + 7) & ~size_t(7);
+}
+
+size_t EntityStore::snapshotChunkBytes(ComponentMask mask) {
+  return sizeof(SnapshotChunk) + size_t(kChunkCapacity) *
+                                     (sizeof(EntityHandle) +
+                                      4 * columnCount(mask));
+}
+
+size_t EntityStore::snapshotSize() const {
+  size_t size = sizeof(SnapshotHeader);
+  for (const Archetype &archetype : m_archetypes)
+    size += sizeof(SnapshotArchetype) +
+            archetype.activeChunks * snapshotChunkBytes(archetype.mask);
+  return size + paddedU32Bytes(m_records.size()) +
+         paddedU32Bytes(m_freeRecords.size());
+}
+
+void EntityStore::writeSnapshot(uint8_t *out) const {
+  // Kopia usedBytes i wyzerowanie reszty sekcji — zrzut nie zależy od
+  // śmieci po usuniętych wierszach
+  forEachSnapshotSection(
+      [&out](const void *data, size_t usedBytes, size_t sectionBytes) {
+        if (usedBytes)
+          std::memcpy(out, data, usedBytes);
+        std::memset(out + usedBytes, 0, sectionBytes - usedBytes);
+        out += sectionBytes;
+      });
+}
+
+bool EntityStore::readSnapshot(const uint8_t *data, size_t size) {
+  // 1. Walidacja całego zrzutu, zanim cokolwiek się zmieni
+  struct ParsedArchetype {
+    SnapshotArchetype header;
+    const uint8_t *chunks;
+  };
+  const uint8_t *cursor = data;
+  const uint8_t *end = data + size;
+  auto take = [&](size_t bytes) -> const uint8_t * {
+    if (size_t(end - cursor) < bytes)
+      return nullptr;
+    const uint8_t *taken = cursor;
+    cursor += bytes;
+    return taken;
+  };
+  auto chunkHeaderAt = [](const uint8_t *chunk) {
+    SnapshotChunk header;
+    std::memcpy(&header, chunk, sizeof(header));
+    return header;
+  };
+
+  SnapshotHeader header;
+  const uint8_t *headerBytes = take(sizeof(header));
+  if (!headerBytes)
+    return false;
+  std::memcpy(&header, headerBytes, sizeof(header));
+
+  std::vector<ParsedArchetype> archetypes(header.archetypeCount);
+  uint64_t aliveCount = 0;
+  for (uint32_t a = 0; a < header.archetypeCount; ++a) {
+    ParsedArchetype &parsed = archetypes[a];
+    const uint8_t *archetypeBytes = take(sizeof(parsed.header));
+    if (!archetypeBytes)
+      return false;
+    std::memcpy(&parsed.header, archetypeBytes, sizeof(parsed.header));
+    for (uint32_t b = 0; b < a; ++b)
+      if (archetypes[b].header.mask == parsed.header.mask)
+        return false;
+    const size_t chunkBytes = snapshotChunkBytes(parsed.header.mask);
+    if (parsed.header.activeChunks > size_t(end - cursor) / chunkBytes)
+      return false;
+    parsed.chunks = take(parsed.header.activeChunks * chunkBytes);
+    uint64_t entityCount = 0;
+    for (uint32_t c = 0; c < parsed.header.activeChunks; ++c) {
+      const uint32_t count =
+          chunkHeaderAt(parsed.chunks + c * chunkBytes).count;
+      if (count == 0 || count > kChunkCapacity)
+        return false;
+      entityCount += count;
+    }
+    if (entityCount != parsed.header.entityCount)
+      return false;
+    aliveCount += entityCount;
+  }
+  if (aliveCount != header.aliveCount)
+    return false;
+
+  const uint8_t *generations = take(paddedU32Bytes(header.recordCount));
+  const uint8_t *freeRecords = take(paddedU32Bytes(header.freeCount));
+  if (!generations || !freeRecords || cursor != end)
+    return false;
+  // Rekordy z uchwytów w chunkach: każda żywa encja dokładnie raz, z
+  // generacją swojego rekordu
+  std::vector<EntityRecord> records(header.recordCount);
+  for (uint32_t i = 0; i < header.recordCount; ++i)
+    std::memcpy(&records[i].generation, generations + i * 4, 4);
+  for (uint32_t a = 0; a < header.archetypeCount; ++a) {
+    const ParsedArchetype &parsed = archetypes[a];
+    const size_t chunkBytes = snapshotChunkBytes(parsed.header.mask);
+    for (uint32_t c = 0; c < parsed.header.activeChunks; ++c) {
+      const uint8_t *chunk = parsed.chunks + c * chunkBytes;
+      const uint32_t count = chunkHeaderAt(chunk).count;
+      for (uint32_t row = 0; row < count; ++row) {
+        EntityHandle handle;
+        std::memcpy(&handle,
+                    chunk + sizeof(SnapshotChunk) + row * sizeof(EntityHandle),
+                    sizeof(handle));
+        if (handle.index >= header.recordCount)
+          return false;
+        EntityRecord &rec = records[handle.index];
+        if (rec.archetype != kInvalid || rec.generation != handle.generation)
+          return false;
+        rec.archetype = a;
+        rec.chunk = c;
+        rec.row = row;
+      }
+    }
+  }
+  // Wolne rekordy: dokładnie martwe, każdy raz
+  if (uint64_t(header.recordCount) - aliveCount != header.freeCount)
+    return false;
+  std::vector<uint8_t> freed(header.recordCount, 0);
+  for (uint32_t i = 0; i < header.freeCount; ++i) {
+    uint32_t index;
+    std::memcpy(&index, freeRecords + i * 4, 4);
+    if (index >= header.recordCount || records[index].archetype != kInvalid ||
+        freed[index]++)
+      return false;
+  }
+
+  // 2. Odtworzenie archetypów (chunki o tej samej masce bez alokacji)
+  std::vector<Archetype> previous = std::move(m_archetypes);
+  m_archetypes.clear();
+  m_archetypes.reserve(archetypes.size());
+  for (const ParsedArchetype &parsed : archetypes) {
+    Archetype archetype;
+    archetype.mask = parsed.header.mask;
+    for (Archetype &old : previous)
+      if (old.mask == archetype.mask) {
+        archetype.chunks = std::move(old.chunks);
+        break;
+      }
+    while (archetype.chunks.size() < parsed.header.activeChunks)
+      archetype.chunks.push_back(allocateChunk(archetype.mask));
+    archetype.activeChunks = parsed.header.activeChunks;
+    archetype.entityCount = parsed.header.entityCount;
+
+    const size_t chunkBytes = snapshotChunkBytes(archetype.mask);
+    for (uint32_t c = 0; c < archetype.chunks.size(); ++c) {
+      Chunk &chunk = *archetype.chunks[c];
+      if (c >= archetype.activeChunks) {
+        chunk.count = 0; // zapas
+        continue;
+      }
+      const uint8_t *in = parsed.chunks + c * chunkBytes;
+      chunk.count = chunkHeaderAt(in).count;
+      in += sizeof(SnapshotChunk);
+      std::memcpy(chunk.entities, in, chunk.count * sizeof(EntityHandle));
+      in += kChunkCapacity * sizeof(EntityHandle);
+      for (uint32_t column = 0; column < Column_Count; ++column) {
+        if (!chunk.columns[column])
+          continue;
+        std::memcpy(chunk.columns[column], in, chunk.count * 4);
+        in += kChunkCapacity * 4;
+      }
+    }
+    m_archetypes.push_back(std::move(archetype));
+  }
+
+  m_records = std::move(records);
+  m_freeRecords.resize(header.freeCount);
+  if (header.freeCount)
+    std::memcpy(m_freeRecords.data(), freeRecords, header.freeCount * 4);
+  m_aliveCount = header.aliveCount;
+  m_destroyQueue.clear();
+  return true;
+}
@@ -0,0 +1,237 @@
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// ============================================================
+//  Komponenty
+// ============================================================
+
+// Kolumny danych komponentów. Każda kolumna to ciągła tablica 4-bajtowych
+// wartości (SoA), więc systemy iterują po gęstych floatach, które kompilator
+// może wektoryzować.
+enum Column : uint32_t {
+  Column_PositionX,
+  Column_PositionY,
+  Column_PrevPositionX, // pozycja z poprzedniego ticka (interpolacja)
+  Column_PrevPositionY,
+  Column_VelocityX,
+  Column_VelocityY,
+  Column_Health,
+  Column_SpriteSize,
+  Column_SpriteRotation,
+  Column_SpriteAtlas, // uint32_t
+  Column_SpriteTint,  // uint32_t (RGBA8, jak SpriteInstance::tint)
+  Column_SpriteLayer, // uint32_t (warstwa rysowania, 0..255)
+  Column_Count
+};
+
+// Bity komponentów tworzące maskę archetypu. Tagi nie mają kolumn danych.
+enum ComponentBit : uint32_t {
+  Component_Position = 1u << 0, // PositionX/Y, PrevPositionX/Y
+  Component_Velocity = 1u << 1, // VelocityX, VelocityY
+  Component_Health = 1u << 2,   // Health
+  Component_Sprite = 1u << 3,   // SpriteSize/Rotation/Atlas/Tint/Layer
+
+  Tag_Player = 1u << 16,
+  Tag_Enemy = 1u << 17,
+  Tag_Projectile = 1u << 18,
+  Tag_XpGem = 1u << 19,
+};
+using ComponentMask = uint32_t;
+
+// Uchwyt encji: indeks rekordu + generacja. Generacja rośnie przy każdym
+// usunięciu, więc stary uchwyt nie wskaże nowej encji w tym samym slocie.
+struct EntityHandle {
+  uint32_t index = 0;
+  uint32_t generation = 0; // 0 = uchwyt pusty
+
+  bool operator==(const EntityHandle &other) const = default;
+};
+
+// Liczba encji w chunku — wielokrotność szerokości SIMD (16 floatów AVX-512)
+constexpr uint32_t kChunkCapacity = 1024;
+constexpr size_t kColumnAlignment = 64;
+
+// Chunk archetypu: kolumny SoA o stałej pojemności w jednym bloku pamięci
+struct Chunk {
+  uint32_t count = 0;
+  void *columns[Column_Count] = {}; // nullptr dla kolumn spoza archetypu
+  EntityHandle entities[kChunkCapacity];
+  uint8_t *memory = nullptr;
+
+  Chunk() = default;
+  Chunk(const Chunk &) = delete;
+  Chunk &operator=(const Chunk &) = delete;
+  ~Chunk();
+};
+
+// Widok chunku przekazywany systemom w forEachChunk
+struct ChunkView {
+  uint32_t count;
+  ComponentMask mask;
+  Chunk *chunk;
+
+  float *f32(Column column) const {
+    assert(chunk->columns[column] && "column not present in archetype");
+    return static_cast<float *>(chunk->columns[column]);
+  }
+  uint32_t *u32(Column column) const {
+    assert(chunk->columns[column] && "column not present in archetype");
+    return static_cast<uint32_t *>(chunk->columns[column]);
+  }
+  const EntityHandle *entities() const { return chunk->entities; }
+};
+
+// Grupa encji o identycznej masce komponentów. Wszystkie chunki poza
+// ostatnim aktywnym są pełne; puste chunki zostają jako zapas do ponownego
+// użycia (bez alokacji przy fali spawnów).
+struct Archetype {
+  ComponentMask mask = 0;
+  std::vector<std::unique_ptr<Chunk>> chunks;
+  uint32_t activeChunks = 0;
+  uint32_t entityCount = 0;
+};
+
+// ============================================================
+//  EntityStore (ECS-lite)
+// ============================================================
+
+class EntityStore {
+public:
+  // Tworzy encję z wyzerowanymi kolumnami podanych komponentów
+  EntityHandle create(ComponentMask mask);
+  // Usuwa encję w O(1): ostatni wiersz archetypu trafia w miejsce usuniętego
+  void destroy(EntityHandle handle);
+  bool isAlive(EntityHandle handle) const;
+
+  // Usunięcie odroczone — bezpieczne w trakcie forEachChunk
+  void queueDestroy(EntityHandle handle) { m_destroyQueue.push_back(handle); }
+  void flushDestroyQueue();
+
+  // Zmiana zestawu komponentów (przeniesienie encji do innego archetypu)
+  void addComponents(EntityHandle handle, ComponentMask components);
+  void removeComponents(EntityHandle handle, ComponentMask components);
+  ComponentMask mask(EntityHandle handle) const;
+
+  // Dostęp do pojedynczej wartości kolumny encji
+  float &f32(EntityHandle handle, Column column);
+  uint32_t &u32(EntityHandle handle, Column column);
+
+  uint32_t size() const { return m_aliveCount; }
+  uint32_t archetypeCount() const { return uint32_t(m_archetypes.size()); }
+
+  // Zrzut całego magazynu (world_snapshot.h): kolumny i uchwyty aktywnych
+  // chunków w pełnej pojemności, potem generacje rekordów (położenie żywych
+  // encji wynika z uchwytów w chunkach) i wolne rekordy. Układ bajtów zależy
+  // tylko od liczby archetypów, chunków i rekordów, więc kolejne zrzuty
+  // różnią się jedynie zmienionymi wartościami. Rozmiar jest wielokrotnością
+  // 8 bajtów. Kolejka usunięć nie jest zapisywana.
+  size_t snapshotSize() const;
+  void writeSnapshot(uint8_t *out) const;
+  // Ten sam zrzut jako kolejne sekcje: fn(data, usedBytes, sectionBytes),
+  // bajty od usedBytes do sectionBytes to zera (SnapshotRing koduje deltę
+  // prosto z kolumn, bez kopii pośredniej)
+  template <typename Fn> void forEachSnapshotSection(Fn &&fn) const;
+  // Zastępuje zawartość magazynu zrzutem (chunki archetypów o tej samej
+  // masce są używane ponownie). Przy błędnych danych false i magazyn bez zmian.
+  bool readSnapshot(const uint8_t *data, size_t size);
+
+  // Wywołuje fn(const ChunkView &) dla każdego niepustego chunku archetypów,
+  // które mają wszystkie komponenty z `required` i żadnego z `excluded`
+  template <typename Fn>
+  void forEachChunk(ComponentMask required, Fn &&fn,
+                    ComponentMask excluded = 0) {
+    for (Archetype &archetype : m_archetypes) {
+      if ((archetype.mask & required) != required ||
+          (archetype.mask & excluded) != 0)
+        continue;
+      for (uint32_t c = 0; c < archetype.activeChunks; ++c) {
+        Chunk *chunk = archetype.chunks[c].get();
+        if (chunk->count > 0)
+          fn(ChunkView{chunk->count, archetype.mask, chunk});
+      }
+    }
+  }
+
+private:
+  // Nagłówki sekcji zrzutu
+  struct SnapshotHeader {
+    uint32_t archetypeCount;
+    uint32_t recordCount;
+    uint32_t freeCount;
+    uint32_t aliveCount;
+  };
+  struct SnapshotArchetype {
+    uint32_t mask;
+    uint32_t activeChunks;
+    uint32_t entityCount;
+    uint32_t reserved;
+  };
+  struct SnapshotChunk {
+    uint32_t count;
+    uint32_t reserved;
+  };
+
+  struct EntityRecord {
+    uint32_t generation = 1;
+    uint32_t archetype = kInvalid;
+    uint32_t chunk = 0;
+    uint32_t row = 0;
+  };
+  static constexpr uint32_t kInvalid = ~0u;
+
+  // Bajty chunku archetypu w zrzucie (nagłówek, uchwyty, kolumny)
+  static size_t snapshotChunkBytes(ComponentMask mask);
+  uint32_t findOrCreateArchetype(ComponentMask mask);
+  // Rezerwuje wiersz na końcu archetypu i zeruje jego kolumny
+  void allocateRow(uint32_t archetypeIndex, uint32_t &chunk, uint32_t &row);
+  // Usuwa wiersz (swap-remove) i poprawia rekord przeniesionej encji
+  void removeRow(uint32_t archetypeIndex, uint32_t chunk, uint32_t row);
+  void migrate(EntityHandle handle, ComponentMask newMask);
+  const EntityRecord *record(EntityHandle handle) const;
+
+  std::vector<Archetype> m_archetypes;
+  std::vector<EntityRecord> m_records;
+  std::vector<uint32_t> m_freeRecords;
+  std::vector<EntityHandle> m_destroyQueue;
+  uint32_t m_aliveCount = 0;
+};
+
+template <typename Fn>
+void EntityStore::forEachSnapshotSection(Fn &&fn) const {
+  const SnapshotHeader header{
+      uint32_t(m_archetypes.size()), uint32_t(m_records.size()),
+      uint32_t(m_freeRecords.size()), m_aliveCount};
+  fn(&header, sizeof(header), sizeof(header));
+  for (const Archetype &archetype : m_archetypes) {
+    const SnapshotArchetype info{archetype.mask, archetype.activeChunks,
+                                 archetype.entityCount, 0};
+    fn(&info, sizeof(info), sizeof(info));
+    for (uint32_t c = 0; c < archetype.activeChunks; ++c) {
+      const Chunk &chunk = *archetype.chunks[c];
+      const SnapshotChunk chunkInfo{chunk.count, 0};
+      fn(&chunkInfo, sizeof(chunkInfo), sizeof(chunkInfo));
+      // Pełna pojemność chunku: przesunięcia nie zależą od liczby encji
+      fn(chunk.entities, chunk.count * sizeof(EntityHandle),
+         kChunkCapacity * sizeof(EntityHandle));
+      for (uint32_t column = 0; column < Column_Count; ++column)
+        if (chunk.columns[column])
+          fn(chunk.columns[column], chunk.count * 4, kChunkCapacity * 4);
+    }
+  }
+  // Generacje zbierane blokami — koder dostaje ciągłą pamięć
+  uint32_t generations[512];
+  for (size_t first = 0; first < m_records.size(); first += 512) {
+    const size_t count =
+        m_records.size() - first < 512 ? m_records.size() - first : 512;
+    for (size_t i = 0; i < count; ++i)
+      generations[i] = m_records[first + i].generation;
+    fn(generations, count * 4, (count * 4 + 7) & ~size_t(7));
+  }
+  fn(m_freeRecords.data(), m_freeRecords.size() * 4,
+     (m_freeRecords.size() * 4 + 7) & ~size_t(7));
+}
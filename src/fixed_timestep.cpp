@@ -0,0 +1,25 @@
+#include "fixed_timestep.h"
+
+#include <algorithm>
+
+uint32_t fixedTimestepAdvance(FixedTimestep &timestep, double frameSeconds) {
+  timestep.accumulator +=
+      std::clamp(frameSeconds, 0.0, timestep.maxFrameSeconds);
+
+  uint32_t ticks = uint32_t(timestep.accumulator / timestep.tickSeconds);
+  if (ticks > timestep.maxTicksPerFrame) {
+    timestep.droppedTicks += ticks - timestep.maxTicksPerFrame;
+    ticks = timestep.maxTicksPerFrame;
+    // Symulacja nie nadąża — porzuć zaległy czas zamiast go nadrabiać
+    timestep.accumulator = 0.0;
+  } else {
+    timestep.accumulator -= double(ticks) * timestep.tickSeconds;
+  }
+  timestep.tickCount += ticks;
+  return ticks;
+}
+
+float fixedTimestepAlpha(const FixedTimestep &timestep) {
+  return float(std::clamp(timestep.accumulator / timestep.tickSeconds, 0.0,
+                          1.0));
+}
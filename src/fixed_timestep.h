@@ -0,0 +1,24 @@
+#pragma once
+
+#include <cstdint>
+
+// Stały krok symulacji niezależny od częstotliwości renderowania.
+// Czas rzeczywisty klatki trafia do akumulatora, z którego symulacja
+// "wypłaca" pełne ticki; reszta służy do interpolacji stanu renderowanego.
+struct FixedTimestep {
+  double tickSeconds = 1.0 / 60.0;
+  // Ochrona przed "spiralą śmierci": czas klatki jest przycinany, a liczba
+  // ticków na klatkę ograniczona — nadmiar czasu jest porzucany
+  double maxFrameSeconds = 0.25;
+  uint32_t maxTicksPerFrame = 8;
+
+  double accumulator = 0.0;
+  uint64_t tickCount = 0;    // wszystkie wykonane ticki
+  uint64_t droppedTicks = 0; // ticki porzucone przez limit
+};
+
+// Dodaje czas klatki do akumulatora i zwraca liczbę ticków do wykonania
+uint32_t fixedTimestepAdvance(FixedTimestep &timestep, double frameSeconds);
+
+// Współczynnik interpolacji [0, 1] między poprzednim a bieżącym tickiem
+float fixedTimestepAlpha(const FixedTimestep &timestep);
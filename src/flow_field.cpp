@@ -0,0 +1,216 @@
+#include "flow_field.h"
+
+#include <algorithm>
+#include <cmath>
+#include <thread>
+
+#include "profiler.h"
+
+constexpr uint32_t kUnreachable = ~0u;
+constexpr uint32_t kStraightCost = 2;
+constexpr uint32_t kDiagonalCost = 3; // ≈ 2·√2
+
+// Sąsiedzi: 4 proste, potem 4 skośne (indeks = kierunek w polu)
+static const int32_t kNeighborX[8] = {1, -1, 0, 0, 1, -1, 1, -1};
+static const int32_t kNeighborY[8] = {0, 0, 1, -1, 1, 1, -1, -1};
+static const glm::vec2 kDirections[8] = {
+    {1.0f, 0.0f},           {-1.0f, 0.0f},
+    {0.0f, 1.0f},           {0.0f, -1.0f},
+    {0.7071f, 0.7071f},     {-0.7071f, 0.7071f},
+    {0.7071f, -0.7071f},    {-0.7071f, -0.7071f},
+};
+
+FlowField::FlowField(JobSystem &jobs, uint32_t width, uint32_t height,
+                     float cellSize, uint32_t radius)
+    : m_jobs(jobs), m_width(width), m_height(height), m_cellSize(cellSize),
+      m_radius(std::max(radius, 1u)),
+      m_blocked(size_t(width) * height, 0) {
+  m_job.execute = buildJob;
+  m_job.context = this;
+}
+
+FlowField::~FlowField() {
+  // Zadanie w tle pisze do bufora tylnego — poczekaj na jego koniec
+  while (m_building && !m_buildDone.load(std::memory_order_acquire))
+    std::this_thread::yield();
+}
+
+void FlowField::setBlockedMask(std::vector<uint8_t> mask) {
+  if (mask.size() != m_blocked.size())
+    return;
+  m_blocked = std::move(mask);
+  ++m_obstacleVersion;
+}
+
+void FlowField::setBlocked(uint32_t x, uint32_t y, bool blocked) {
+  if (x >= m_width || y >= m_height)
+    return;
+  uint8_t &cell = m_blocked[size_t(y) * m_width + x];
+  if (cell != uint8_t(blocked)) {
+    cell = uint8_t(blocked);
+    ++m_obstacleVersion;
+  }
+}
+
+bool FlowField::current() const {
+  return m_front->targetX == m_wantedX && m_front->targetY == m_wantedY &&
+         m_front->obstacleVersion == m_obstacleVersion;
+}
+
+void FlowField::update(glm::vec2 target) {
+  const int32_t cx = int32_t(std::floor(target.x / m_cellSize));
+  const int32_t cy = int32_t(std::floor(target.y / m_cellSize));
+  const bool inside =
+      cx >= 0 && cy >= 0 && cx < int32_t(m_width) && cy < int32_t(m_height);
+  if (m_building && (cx != m_wantedX || cy != m_wantedY))
+    ++m_stats.coalesced;
+  m_wantedX = inside ? cx : -1;
+  m_wantedY = inside ? cy : -1;
+
+  if (m_building) {
+    if (!m_buildDone.load(std::memory_order_acquire))
+      return;
+    m_building = false;
+    std::swap(m_front, m_back);
+    ++m_stats.builds;
+    m_stats.totalBuildMs += m_front->buildMs;
+    m_stats.maxBuildMs = std::max(m_stats.maxBuildMs, m_front->buildMs);
+  }
+  // Cel poza siatką — pole zostaje, direction() i tak go nie obejmie
+  if (!inside || current())
+    return;
+  startBuild(cx, cy);
+  // Budowa już skończona — podmiana w tym samym ticku
+  if (m_synchronous)
+    update(target);
+}
+
+void FlowField::startBuild(int32_t targetX, int32_t targetY) {
+  // Okno wokół celu i kopia jego przeszkód (budowa nie czyta m_blocked,
+  // więc setBlocked może działać w trakcie)
+  Buffer &buffer = *m_back;
+  const int32_t radius = int32_t(m_radius);
+  const int32_t minX = std::max(targetX - radius, 0);
+  const int32_t minY = std::max(targetY - radius, 0);
+  const int32_t maxX = std::min(targetX + radius, int32_t(m_width) - 1);
+  const int32_t maxY = std::min(targetY + radius, int32_t(m_height) - 1);
+  buffer.originX = minX;
+  buffer.originY = minY;
+  buffer.width = uint32_t(maxX - minX + 1);
+  buffer.height = uint32_t(maxY - minY + 1);
+  buffer.targetX = targetX;
+  buffer.targetY = targetY;
+  buffer.obstacleVersion = m_obstacleVersion;
+  buffer.blocked.resize(size_t(buffer.width) * buffer.height);
+  for (uint32_t y = 0; y < buffer.height; ++y)
+    std::copy_n(&m_blocked[size_t(minY + y) * m_width + minX], buffer.width,
+                &buffer.blocked[size_t(y) * buffer.width]);
+
+  m_building = true;
+  if (m_synchronous) {
+    buildJob(m_job, 0);
+    return;
+  }
+  m_buildDone.store(false, std::memory_order_relaxed);
+  m_jobs.submitBackground(&m_job);
+}
+
+void FlowField::buildJob(const Job &job, uint32_t) {
+  FlowField &field = *static_cast<FlowField *>(const_cast<void *>(job.context));
+  build(*field.m_back);
+  field.m_buildDone.store(true, std::memory_order_release);
+}
+
+void FlowField::build(Buffer &buffer) {
+  WARP_PROFILE_SCOPE("Flow Field Build");
+  const uint64_t startNs = profilerNowNs();
+  const int32_t width = int32_t(buffer.width);
+  const int32_t height = int32_t(buffer.height);
+  const size_t cellCount = size_t(width) * height;
+  const uint8_t *blocked = buffer.blocked.data();
+  buffer.cost.assign(cellCount, kUnreachable);
+  buffer.direction.assign(cellCount, kFlowNoDirection);
+
+  // Ruch skośny tylko, gdy obie komórki proste obok są wolne
+  auto passable = [&](int32_t x, int32_t y, uint32_t dir) {
+    const int32_t nx = x + kNeighborX[dir];
+    const int32_t ny = y + kNeighborY[dir];
+    if (nx < 0 || ny < 0 || nx >= width || ny >= height ||
+        blocked[size_t(ny) * width + nx])
+      return false;
+    return dir < 4 || (!blocked[size_t(y) * width + nx] &&
+                       !blocked[size_t(ny) * width + x]);
+  };
+
+  // 1. Koszt dojścia: Dijkstra z kolejką kubełkową — krawędzie kosztują
+  // 2 lub 3, więc wystarczą 4 kubełki po koszcie mod 4
+  const int32_t targetX = buffer.targetX - buffer.originX;
+  const int32_t targetY = buffer.targetY - buffer.originY;
+  const size_t target = size_t(targetY) * width + targetX;
+  if (!blocked[target]) {
+    for (std::vector<uint32_t> &bucket : buffer.buckets)
+      bucket.clear();
+    buffer.cost[target] = 0;
+    buffer.buckets[0].push_back(uint32_t(target));
+    size_t pending = 1;
+    for (uint32_t cost = 0; pending > 0; ++cost) {
+      std::vector<uint32_t> &bucket = buffer.buckets[cost & 3];
+      // Nowe wpisy trafiają do kubełków cost+2 / cost+3 — ten się nie
+      // zmienia w trakcie przejścia
+      for (uint32_t cell : bucket) {
+        --pending;
+        if (buffer.cost[cell] != cost)
+          continue; // nieaktualny wpis (znaleziono tańszą drogę)
+        const int32_t x = int32_t(cell % width);
+        const int32_t y = int32_t(cell / width);
+        for (uint32_t dir = 0; dir < 8; ++dir) {
+          if (!passable(x, y, dir))
+            continue;
+          const size_t neighbor =
+              size_t(y + kNeighborY[dir]) * width + x + kNeighborX[dir];
+          const uint32_t next =
+              cost + (dir < 4 ? kStraightCost : kDiagonalCost);
+          if (next < buffer.cost[neighbor]) {
+            buffer.cost[neighbor] = next;
+            buffer.buckets[next & 3].push_back(uint32_t(neighbor));
+            ++pending;
+          }
+        }
+      }
+      bucket.clear();
+    }
+  }
+
+  // 2. Kierunek: sąsiad o najniższym koszcie
+  for (int32_t y = 0; y < height; ++y) {
+    for (int32_t x = 0; x < width; ++x) {
+      const size_t cell = size_t(y) * width + x;
+      uint32_t best = buffer.cost[cell];
+      if (best == kUnreachable || best == 0)
+        continue;
+      for (uint32_t dir = 0; dir < 8; ++dir) {
+        if (!passable(x, y, dir))
+          continue;
+        const uint32_t cost =
+            buffer.cost[size_t(y + kNeighborY[dir]) * width + x +
+                        kNeighborX[dir]];
+        if (cost < best) {
+          best = cost;
+          buffer.direction[cell] = uint8_t(dir);
+        }
+      }
+    }
+  }
+  buffer.buildMs = double(profilerNowNs() - startNs) / 1.0e6;
+}
+
+glm::vec2 FlowField::direction(float x, float y) const {
+  const Buffer &buffer = *m_front;
+  const int32_t cx = int32_t(std::floor(x / m_cellSize)) - buffer.originX;
+  const int32_t cy = int32_t(std::floor(y / m_cellSize)) - buffer.originY;
+  if (cx < 0 || cy < 0 || cx >= int32_t(buffer.width) ||
+      cy >= int32_t(buffer.height))
+    return glm::vec2(0.0f);
+  const uint8_t dir = buffer.direction[size_t(cy) * buffer.width + cx];
+  return dir == kFlowNoDirection ? glm::vec2(0.0f) : kDirections[dir];
+}
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <glm/glm.hpp>
+#include <vector>
+
+#include "job_system.h"
+
+// ============================================================
+//  Flow field (wspólne pathfinding hordy)
+// ============================================================
+
+constexpr uint8_t kFlowNoDirection = 0xFF;
+
+struct FlowFieldStats {
+  uint64_t builds = 0;
+  uint64_t coalesced = 0; // zmiany celu w trakcie budowy (jedna budowa)
+  double totalBuildMs = 0.0;
+  double maxBuildMs = 0.0;
+};
+
+// Pole przepływu na siatce komórek (np. kafelków mapy) prowadzące do
+// komórki celu: koszt dojścia (Dijkstra kubełkowa, krok 2 / skos 3, bez
+// ścinania rogów przeszkód) i kierunek do najtańszego sąsiada. Pole
+// obejmuje okno radius komórek wokół celu — dalej wrogowie idą prosto.
+//
+// Przebudowa tylko po zmianie komórki celu albo przeszkód, jako zadanie w
+// tle JobSystem do bufora tylnego; update() podmienia bufory, gdy budowa
+// się skończy. Odczyt direction() to O(1) na wroga, niezależnie od ich
+// liczby. update()/direction()/setBlocked() — jeden wątek (symulacja).
+class FlowField {
+public:
+  FlowField(JobSystem &jobs, uint32_t width, uint32_t height, float cellSize,
+            uint32_t radius = 96);
+  ~FlowField();
+  FlowField(const FlowField &) = delete;
+  FlowField &operator=(const FlowField &) = delete;
+
+  // Maska width × height (1 = komórka zablokowana)
+  void setBlockedMask(std::vector<uint8_t> mask);
+  void setBlocked(uint32_t x, uint32_t y, bool blocked);
+
+  // Raz na tick: podmienia gotowy bufor i zleca przebudowę, gdy cel
+  // zmienił komórkę albo zmieniły się przeszkody
+  void update(glm::vec2 target);
+  // Budowa na wątku wołającym i podmiana jeszcze w tym samym update() —
+  // pole zależy tylko od komórki celu, nie od czasu budowy w tle
+  // (headless: deterministyczne przebiegi i powtórki)
+  void setSynchronous(bool synchronous) { m_synchronous = synchronous; }
+
+  // Jednostkowy kierunek ruchu w punkcie świata; (0, 0), gdy punkt leży
+  // poza polem, w komórce celu, w przeszkodzie albo cel jest nieosiągalny
+  glm::vec2 direction(float x, float y) const;
+
+  // Pole gotowe dla komórki celu z ostatniego update()
+  bool current() const;
+  float cellSize() const { return m_cellSize; }
+  const FlowFieldStats &stats() const { return m_stats; }
+
+private:
+  // Okno pola wokół celu (bufor przedni albo budowany)
+  struct Buffer {
+    int32_t originX = 0, originY = 0; // lewy górny róg okna (komórki)
+    uint32_t width = 0, height = 0;
+    int32_t targetX = -1, targetY = -1;
+    uint64_t obstacleVersion = 0;
+    std::vector<uint8_t> blocked; // kopia przeszkód okna
+    std::vector<uint32_t> cost;
+    std::vector<uint8_t> direction;
+    std::vector<uint32_t> buckets[4]; // kolejka kubełkowa (koszt mod 4)
+    double buildMs = 0.0;
+  };
+
+  static void buildJob(const Job &job, uint32_t threadIndex);
+  static void build(Buffer &buffer);
+  void startBuild(int32_t targetX, int32_t targetY);
+
+  JobSystem &m_jobs;
+  uint32_t m_width, m_height;
+  float m_cellSize;
+  uint32_t m_radius;
+  std::vector<uint8_t> m_blocked;
+  uint64_t m_obstacleVersion = 1;
+
+  Buffer m_buffers[2];
+  Buffer *m_front = &m_buffers[0];
+  Buffer *m_back = &m_buffers[1];
+  Job m_job;
+  bool m_building = false;
+  bool m_synchronous = false;
+  std::atomic<bool> m_buildDone{false};
+  int32_t m_wantedX = -1, m_wantedY = -1; // komórka celu z update()
+  FlowFieldStats m_stats;
+};
@@ -0,0 +1,169 @@
+#include "frame_ring.h"
+
+#include <algorithm>
+#include <iostream>
+#include <webgpu/wgpu.h>
+
+static uint64_t alignUp(uint64_t value, uint64_t alignment) {
+  return (value + alignment - 1) / alignment * alignment;
+}
+
+static void onStagingMapped(WGPUBufferMapAsyncStatus status, void *userdata) {
+  FrameSlot *slot = static_cast<FrameSlot *>(userdata);
+  slot->mapPending = false;
+  if (status != WGPUBufferMapAsyncStatus_Success)
+    std::cerr << "Frame ring staging map failed: " << status << std::endl;
+}
+
+static void releaseSlot(FrameSlot &slot) {
+  if (slot.staging)
+    wgpuBufferRelease(slot.staging);
+  if (slot.buffer)
+    wgpuBufferRelease(slot.buffer);
+  slot.staging = nullptr;
+  slot.buffer = nullptr;
+  slot.mapped = nullptr;
+  slot.offset = 0;
+  slot.mapPending = false;
+}
+
+// Tworzy bufor GPU i staging (zmapowany od razu przy tworzeniu)
+static bool createSlot(WGPUDevice device, uint64_t capacity, FrameSlot &slot) {
+  WGPUBufferDescriptor desc = {};
+  desc.nextInChain = nullptr;
+  desc.label = "Frame Ring Buffer";
+  desc.usage = WGPUBufferUsage_Uniform | WGPUBufferUsage_Vertex |
+               WGPUBufferUsage_Index | WGPUBufferUsage_CopyDst;
+  desc.size = capacity;
+  desc.mappedAtCreation = false;
+  slot.buffer = wgpuDeviceCreateBuffer(device, &desc);
+
+  desc.label = "Frame Ring Staging";
+  desc.usage = WGPUBufferUsage_MapWrite | WGPUBufferUsage_CopySrc;
+  desc.mappedAtCreation = true;
+  slot.staging = wgpuDeviceCreateBuffer(device, &desc);
+  if (!slot.buffer || !slot.staging) {
+    std::cerr << "Could not create frame ring buffers!" << std::endl;
+    releaseSlot(slot);
+    return false;
+  }
+  slot.mapped = static_cast<uint8_t *>(
+      wgpuBufferGetMappedRange(slot.staging, 0, capacity));
+  slot.offset = 0;
+  ++slot.version;
+  return slot.mapped != nullptr;
+}
+
+bool createFrameRing(WGPUDevice device, uint64_t capacity, FrameRing &ring) {
+  ring.device = device;
+  ring.capacity = alignUp(std::max<uint64_t>(capacity, 4096), 4);
+
+  WGPUSupportedLimits supported = {};
+  supported.nextInChain = nullptr;
+  if (wgpuDeviceGetLimits(device, &supported) &&
+      supported.limits.minUniformBufferOffsetAlignment != 0)
+    ring.uniformAlignment = supported.limits.minUniformBufferOffsetAlignment;
+
+  for (FrameSlot &slot : ring.slots) {
+    if (!createSlot(device, ring.capacity, slot)) {
+      releaseFrameRing(ring);
+      return false;
+    }
+  }
+  ring.current = 0;
+  return true;
+}
+
+void releaseFrameRing(FrameRing &ring) {
+  for (FrameSlot &slot : ring.slots)
+    releaseSlot(slot);
+}
+
+FrameSlot &frameRingCurrent(FrameRing &ring) {
+  return ring.slots[ring.current];
+}
+
+void frameRingWaitForSlot(FrameRing &ring) {
+  FrameSlot &slot = ring.slots[ring.current];
+  // GPU wciąż używa tego slotu (sprzed kFramesInFlight klatek) — czekaj
+  if (slot.mapPending) {
+    ++ring.fenceWaits;
+    while (slot.mapPending)
+      wgpuDevicePoll(ring.device, true, nullptr);
+  }
+}
+
+bool frameRingBeginFrame(FrameRing &ring, uint64_t minCapacity) {
+  FrameSlot &slot = ring.slots[ring.current];
+  if (slot.mapPending) {
+    std::cerr << "Frame ring slot is still in use by the GPU" << std::endl;
+    return false;
+  }
+
+  if (minCapacity > ring.capacity) {
+    // Rośnie o 50% ponad żądanie, żeby nie realokować co klatkę. Pozostałe
+    // sloty dostosują się, gdy przyjdzie ich kolej.
+    ring.capacity = alignUp(minCapacity + minCapacity / 2, 4);
+  }
+  if (!slot.staging || wgpuBufferGetSize(slot.buffer) < ring.capacity) {
+    releaseSlot(slot);
+    if (!createSlot(ring.device, ring.capacity, slot))
+      return false;
+  }
+
+  if (!slot.mapped)
+    slot.mapped = static_cast<uint8_t *>(
+        wgpuBufferGetMappedRange(slot.staging, 0, ring.capacity));
+  slot.offset = 0;
+  return slot.mapped != nullptr;
+}
+
+FrameAllocation frameRingAllocate(FrameRing &ring, uint64_t size,
+                                  uint64_t alignment) {
+  FrameSlot &slot = ring.slots[ring.current];
+  FrameAllocation allocation;
+  if (!slot.mapped)
+    return allocation;
+
+  // Kopie bufor→bufor wymagają rozmiaru i offsetu podzielnego przez 4
+  const uint64_t offset =
+      alignUp(slot.offset, std::max<uint64_t>(alignment, 4));
+  const uint64_t alignedSize = alignUp(size, 4);
+  if (offset + alignedSize > ring.capacity)
+    return allocation;
+
+  slot.offset = offset + alignedSize;
+  ring.peakBytes = std::max(ring.peakBytes, slot.offset);
+  allocation.data = slot.mapped + offset;
+  allocation.buffer = slot.buffer;
+  allocation.offset = offset;
+  allocation.size = size;
+  return allocation;
+}
+
+FrameAllocation frameRingAllocateUniform(FrameRing &ring, uint64_t size) {
+  return frameRingAllocate(ring, size, ring.uniformAlignment);
+}
+
+void frameRingFlush(FrameRing &ring, WGPUCommandEncoder encoder) {
+  FrameSlot &slot = ring.slots[ring.current];
+  if (!slot.mapped)
+    return;
+  wgpuBufferUnmap(slot.staging);
+  slot.mapped = nullptr;
+  if (slot.offset > 0)
+    wgpuCommandEncoderCopyBufferToBuffer(encoder, slot.staging, 0, slot.buffer,
+                                         0, slot.offset);
+}
+
+void frameRingAfterSubmit(FrameRing &ring) {
+  FrameSlot &slot = ring.slots[ring.current];
+  if (slot.mapped || slot.mapPending)
+    return; // klatka nie została wysłana (brak Flush)
+
+  slot.mapPending = true;
+  wgpuBufferMapAsync(slot.staging, WGPUMapMode_Write, 0,
+                     size_t(wgpuBufferGetSize(slot.staging)), onStagingMapped,
+                     &slot);
+  ring.current = (ring.current + 1) % kFramesInFlight;
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <cstdint>
+#include <webgpu/webgpu.h>
+
+// ============================================================
+//  Pierścień zasobów klatki (frames in flight)
+// ============================================================
+
+// Dane dynamiczne (uniformy kamery, instancje, wierzchołki tymczasowe)
+// trafiają do dużego bufora danej klatki przez liniowy bump allocator.
+// Każdy slot ma własny bufor staging (MapWrite) — CPU pisze prosto do
+// zmapowanej pamięci klatki N+1, podczas gdy GPU czyta bufor klatki N.
+// Czekamy tylko wtedy, gdy GPU jest kFramesInFlight klatek w tyle.
+constexpr uint32_t kFramesInFlight = 3;
+
+// Wynik alokacji: wskaźnik do zapisu + miejsce w buforze GPU
+struct FrameAllocation {
+  void *data = nullptr;        // nullptr = brak miejsca w klatce
+  WGPUBuffer buffer = nullptr; // bufor GPU (vertex / index / uniform)
+  uint64_t offset = 0;
+  uint64_t size = 0;
+};
+
+struct FrameSlot {
+  WGPUBuffer staging = nullptr; // MapWrite | CopySrc
+  WGPUBuffer buffer = nullptr;  // Uniform | Vertex | Index | CopyDst
+  uint8_t *mapped = nullptr;    // zmapowany staging (między Begin a Flush)
+  uint64_t offset = 0;          // wskaźnik bump allocatora
+  bool mapPending = false;      // czeka na wgpuBufferMapAsync
+  uint32_t version = 0;         // rośnie przy realokacji (odśwież bind groupy)
+};
+
+struct FrameRing {
+  WGPUDevice device = nullptr;
+  uint64_t capacity = 0;          // rozmiar bufora jednego slotu
+  uint32_t uniformAlignment = 256; // minUniformBufferOffsetAlignment
+  FrameSlot slots[kFramesInFlight];
+  uint32_t current = 0;
+  uint64_t fenceWaits = 0; // ile razy CPU czekało na GPU
+  uint64_t peakBytes = 0;  // największe zużycie slotu w jednej klatce
+};
+
+bool createFrameRing(WGPUDevice device, uint64_t capacity, FrameRing &ring);
+void releaseFrameRing(FrameRing &ring);
+
+// Czeka, aż GPU odda slot bieżącej klatki (tylko gdy jest kFramesInFlight
+// klatek w tyle). Tylko wątek główny: wgpuDevicePoll wywołuje callbacki
+// mapowania wszystkich modułów (np. timestampy profilera).
+void frameRingWaitForSlot(FrameRing &ring);
+// Przygotowuje slot bieżącej klatki — po frameRingWaitForSlot, z dowolnego
+// wątku (bez polla). Gdy minCapacity przekracza pojemność, bufory slotu
+// są tworzone na nowo (zmienia się FrameSlot::version).
+bool frameRingBeginFrame(FrameRing &ring, uint64_t minCapacity);
+FrameSlot &frameRingCurrent(FrameRing &ring);
+
+FrameAllocation frameRingAllocate(FrameRing &ring, uint64_t size,
+                                  uint64_t alignment = 4);
+// Alokacja z wyrównaniem dla dynamicznego offsetu bufora uniform
+FrameAllocation frameRingAllocateUniform(FrameRing &ring, uint64_t size);
+
+// Odmapowuje staging i kopiuje zużyty zakres do bufora GPU. Wołać po
+// ostatniej alokacji, przed passami czytającymi dane klatki.
+void frameRingFlush(FrameRing &ring, WGPUCommandEncoder encoder);
+// Po wgpuQueueSubmit: ponownie mapuje staging slotu (asynchronicznie)
+void frameRingAfterSubmit(FrameRing &ring);
@@ -0,0 +1,217 @@
+#include "game_systems.h"
+
+#include <cmath>
+#include <cstring>
+
+#include "flow_field.h"
+#include "job_system.h"
+#include "profiler.h"
+#include "sprite_batch.h"
+
+void storePreviousPositionsSystem(EntityStore &store) {
+  WARP_PROFILE_SCOPE("Store Previous Positions");
+  store.forEachChunk(Component_Position, [](const ChunkView &view) {
+    std::memcpy(view.f32(Column_PrevPositionX), view.f32(Column_PositionX),
+                view.count * sizeof(float));
+    std::memcpy(view.f32(Column_PrevPositionY), view.f32(Column_PositionY),
+                view.count * sizeof(float));
+  });
+}
+
+void seekTargetSystem(EntityStore &store, glm::vec2 target, float speed) {
+  WARP_PROFILE_SCOPE("Seek Target");
+  store.forEachChunk(
+      Tag_Enemy | Component_Position | Component_Velocity,
+      [&](const ChunkView &view) {
+        const float *px = view.f32(Column_PositionX);
+        const float *py = view.f32(Column_PositionY);
+        float *vx = view.f32(Column_VelocityX);
+        float *vy = view.f32(Column_VelocityY);
+        for (uint32_t i = 0; i < view.count; ++i) {
+          const float dx = target.x - px[i];
+          const float dy = target.y - py[i];
+          const float invLen = speed / std::sqrt(dx * dx + dy * dy + 1e-4f);
+          vx[i] = dx * invLen;
+          vy[i] = dy * invLen;
+        }
+      });
+}
+
+void flowFieldSeekSystem(EntityStore &store, const FlowField &field,
+                         glm::vec2 target, float speed) {
+  WARP_PROFILE_SCOPE("Flow Field Seek");
+  store.forEachChunk(
+      Tag_Enemy | Component_Position | Component_Velocity,
+      [&](const ChunkView &view) {
+        const float *px = view.f32(Column_PositionX);
+        const float *py = view.f32(Column_PositionY);
+        float *vx = view.f32(Column_VelocityX);
+        float *vy = view.f32(Column_VelocityY);
+        for (uint32_t i = 0; i < view.count; ++i) {
+          glm::vec2 dir = field.direction(px[i], py[i]);
+          if (dir.x == 0.0f && dir.y == 0.0f) {
+            const float dx = target.x - px[i];
+            const float dy = target.y - py[i];
+            dir = glm::vec2(dx, dy) / std::sqrt(dx * dx + dy * dy + 1e-4f);
+          }
+          vx[i] = dir.x * speed;
+          vy[i] = dir.y * speed;
+        }
+      });
+}
+
+void integrateVelocitySystem(EntityStore &store, float dt) {
+  WARP_PROFILE_SCOPE("Integrate Velocity");
+  store.forEachChunk(
+      Component_Position | Component_Velocity, [&](const ChunkView &view) {
+        float *px = view.f32(Column_PositionX);
+        float *py = view.f32(Column_PositionY);
+        const float *vx = view.f32(Column_VelocityX);
+        const float *vy = view.f32(Column_VelocityY);
+        for (uint32_t i = 0; i < view.count; ++i) {
+          px[i] += vx[i] * dt;
+          py[i] += vy[i] * dt;
+        }
+      });
+}
+
+void packSpritesSystem(EntityStore &store, SpriteBatch &batch, float alpha,
+                       const CullRect &view,
+                       const std::vector<uint32_t> &framePages,
+                       FrameArena &frameArena, SpriteDrawList &drawList) {
+  WARP_PROFILE_SCOPE("Pack Sprites");
+  // Kandydaci po cullingu (kolejność chunków) potrzebni tylko do zapisu
+  // instancji w kolejności rysowania — pamięć klatki, miejsce na wszystkie
+  SpriteInstance *candidates =
+      frameArena.allocateArray<SpriteInstance>(store.size());
+  uint32_t candidateCount = 0;
+  drawListClear(drawList.drawList);
+  drawList.total = 0;
+
+  // 1. Interpolacja + culling po chunku (kolumny robocze na stosie)
+  {
+    WARP_PROFILE_SCOPE("Cull Sprites");
+    alignas(kColumnAlignment) float xs[kChunkCapacity];
+    alignas(kColumnAlignment) float ys[kChunkCapacity];
+    alignas(kColumnAlignment) float halfSizes[kChunkCapacity];
+    uint32_t visible[kChunkCapacity];
+    store.forEachChunk(
+        Component_Position | Component_Sprite, [&](const ChunkView &chunk) {
+          const float *px = chunk.f32(Column_PositionX);
+          const float *py = chunk.f32(Column_PositionY);
+          const float *prevX = chunk.f32(Column_PrevPositionX);
+          const float *prevY = chunk.f32(Column_PrevPositionY);
+          const float *size = chunk.f32(Column_SpriteSize);
+          const float *rotation = chunk.f32(Column_SpriteRotation);
+          const uint32_t *atlas = chunk.u32(Column_SpriteAtlas);
+          const uint32_t *tint = chunk.u32(Column_SpriteTint);
+          const uint32_t *layer = chunk.u32(Column_SpriteLayer);
+
+          // Połowa przekątnej — obrócony quad mieści się w tym AABB
+          for (uint32_t i = 0; i < chunk.count; ++i) {
+            xs[i] = prevX[i] + (px[i] - prevX[i]) * alpha;
+            ys[i] = prevY[i] + (py[i] - prevY[i]) * alpha;
+            halfSizes[i] = size[i] * 0.70710678f;
+          }
+          const uint32_t visibleCount =
+              cullAabbs(xs, ys, halfSizes, chunk.count, view, visible);
+          drawList.total += chunk.count;
+
+          for (uint32_t v = 0; v < visibleCount; ++v) {
+            const uint32_t i = visible[v];
+            SpriteInstance instance;
+            instance.position[0] = xs[i];
+            instance.position[1] = ys[i];
+            instance.scale[0] = size[i];
+            instance.scale[1] = size[i];
+            instance.rotation = rotation[i];
+            instance.atlasIndex = atlas[i];
+            instance.tint = tint[i];
+            const uint32_t page =
+                atlas[i] < framePages.size() ? framePages[atlas[i]] : 0;
+            drawListAdd(drawList.drawList,
+                        makeSortKey(layer[i], 0, page, ys[i]),
+                        candidateCount);
+            candidates[candidateCount++] = instance;
+          }
+        });
+  }
+
+  // 2. Sortowanie kluczy i zapis instancji w kolejności rysowania
+  DrawList &list = drawList.drawList;
+  drawListSort(list);
+  drawListBuildBatches(list);
+  const uint32_t count = uint32_t(list.items.size());
+  batch.instances.resize(count);
+  for (uint32_t i = 0; i < count; ++i)
+    batch.instances[i] = candidates[list.items[i]];
+  spriteBatchMarkDirty(batch, 0, count);
+
+  drawList.visible = count;
+  drawList.totalSum += drawList.total;
+  drawList.visibleSum += count;
+}
+
+void buildEnemyGridSystem(EntityStore &store, EnemyBroadPhase &broadPhase) {
+  WARP_PROFILE_SCOPE("Build Enemy Grid");
+  broadPhase.xs.clear();
+  broadPhase.ys.clear();
+  broadPhase.handles.clear();
+  store.forEachChunk(Tag_Enemy | Component_Position,
+                     [&](const ChunkView &view) {
+                       const float *px = view.f32(Column_PositionX);
+                       const float *py = view.f32(Column_PositionY);
+                       broadPhase.xs.insert(broadPhase.xs.end(), px,
+                                            px + view.count);
+                       broadPhase.ys.insert(broadPhase.ys.end(), py,
+                                            py + view.count);
+                       broadPhase.handles.insert(broadPhase.handles.end(),
+                                                 view.entities(),
+                                                 view.entities() + view.count);
+                     });
+  broadPhase.grid.build(broadPhase.xs.data(), broadPhase.ys.data(),
+                        uint32_t(broadPhase.xs.size()));
+}
+
+void separationSystem(EntityStore &store, EnemyBroadPhase &broadPhase,
+                      JobSystem &jobs, float radius, float strength) {
+  WARP_PROFILE_SCOPE("Separation");
+  const size_t count = broadPhase.xs.size();
+  broadPhase.pushX.assign(count, 0.0f);
+  broadPhase.pushY.assign(count, 0.0f);
+
+  // 1. Pary sąsiadów — równolegle, każda porcja do własnego wektora
+  broadPhase.grid.findPairsParallel(radius, jobs, broadPhase.pairsPerRange);
+
+  // 2. Akumulacja przesunięć (każda para rozpycha oba elementy po połowie)
+  // w kolejności porcji — sumy float są te same niezależnie od wątków
+  float *pushX = broadPhase.pushX.data();
+  float *pushY = broadPhase.pushY.data();
+  const float *xs = broadPhase.xs.data();
+  const float *ys = broadPhase.ys.data();
+  for (const std::vector<GridPair> &pairs : broadPhase.pairsPerRange) {
+    for (const GridPair &pair : pairs) {
+      const float dx = xs[pair.b] - xs[pair.a];
+      const float dy = ys[pair.b] - ys[pair.a];
+      const float dist = std::sqrt(dx * dx + dy * dy) + 1e-4f;
+      const float push = 0.5f * strength * (radius - dist) / dist;
+      pushX[pair.a] -= dx * push;
+      pushY[pair.a] -= dy * push;
+      pushX[pair.b] += dx * push;
+      pushY[pair.b] += dy * push;
+    }
+  }
+
+  // 3. Zapis do kolumn pozycji (ta sama kolejność chunków co w build)
+  size_t base = 0;
+  store.forEachChunk(Tag_Enemy | Component_Position,
+                     [&](const ChunkView &view) {
+                       float *px = view.f32(Column_PositionX);
+                       float *py = view.f32(Column_PositionY);
+                       for (uint32_t i = 0; i < view.count; ++i) {
+                         px[i] += pushX[base + i];
+                         py[i] += pushY[base + i];
+                       }
+                       base += view.count;
+                     });
+}
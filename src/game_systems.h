@@ -0,0 +1,70 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <vector>
+
+#include "camera.h"
+#include "draw_list.h"
+#include "entity_store.h"
+#include "memory_arena.h"
+#include "spatial_grid.h"
+#include "sprite_batch.h"
+
+class FlowField;
+class JobSystem;
+
+// Broad-phase wrogów: siatka + bufory robocze utrzymywane między klatkami.
+// Indeksy elementów siatki odpowiadają kolejności forEachChunk dla Tag_Enemy.
+struct EnemyBroadPhase {
+  SpatialGrid grid{16.0f};
+  std::vector<float> xs;
+  std::vector<float> ys;
+  std::vector<EntityHandle> handles;
+  std::vector<float> pushX;
+  std::vector<float> pushY;
+  std::vector<std::vector<GridPair>> pairsPerRange;
+};
+
+// Widoczne sprite'y klatki: lista rysowania posortowana kluczami i
+// statystyki cullingu
+struct SpriteDrawList {
+  DrawList drawList;
+  uint32_t total = 0;   // sprite'y przed cullingiem (ostatnia klatka)
+  uint32_t visible = 0; // po cullingu
+  uint64_t totalSum = 0; // sumy ze wszystkich klatek (średnie na końcu)
+  uint64_t visibleSum = 0;
+};
+
+// Systemy gry — każdy przechodzi po kolumnach SoA pasujących chunków
+
+// Zapamiętuje pozycje na początku ticka (PrevPosition = Position)
+void storePreviousPositionsSystem(EntityStore &store);
+
+// Wrogowie (Enemy + Position + Velocity) kierują się w stronę celu
+void seekTargetSystem(EntityStore &store, glm::vec2 target, float speed);
+
+// Jak seekTargetSystem, ale kierunek pochodzi z pola przepływu (omijanie
+// przeszkód, jeden odczyt na wroga); poza polem i w komórce celu — prosto
+void flowFieldSeekSystem(EntityStore &store, const FlowField &field,
+                         glm::vec2 target, float speed);
+
+// Position += Velocity * dt
+void integrateVelocitySystem(EntityStore &store, float dt);
+
+// Przepisuje widoczne encje z komponentem Sprite do bufora instancji,
+// interpolując pozycję między poprzednim a bieżącym tickiem (alpha 0..1).
+// Sprite'y poza view są odrzucane (SIMD), reszta trafia do batcha w
+// kolejności kluczy (warstwa, pipeline 0, strona atlasu, Y jako głębokość).
+// framePages: strona atlasu dla każdej klatki (TextureAtlas::framePages).
+void packSpritesSystem(EntityStore &store, SpriteBatch &batch, float alpha,
+                       const CullRect &view,
+                       const std::vector<uint32_t> &framePages,
+                       FrameArena &frameArena, SpriteDrawList &drawList);
+
+// Zbiera pozycje wrogów i przebudowuje siatkę broad-phase
+void buildEnemyGridSystem(EntityStore &store, EnemyBroadPhase &broadPhase);
+
+// Rozpycha wrogów bliższych niż radius (pary szukane równolegle w siatce),
+// żeby horda nie zapadała się w jeden punkt
+void separationSystem(EntityStore &store, EnemyBroadPhase &broadPhase,
+                      JobSystem &jobs, float radius, float strength);
@@ -0,0 +1,338 @@
+#include "gpu_culling.h"
+
+#include <algorithm>
+#include <iostream>
+
+#include "camera.h"
+#include "pipeline_cache.h"
+#include "sprite_batch.h"
+
+// ============================================================
+//  WGSL
+// ============================================================
+
+static const char *cullShaderSource = R"(
+struct Params {
+    viewMin: vec2f,
+    viewMax: vec2f,
+    count: u32,
+    groupCount: u32,
+    _pad0: u32,
+    _pad1: u32,
+};
+
+// Układ SpriteInstance (28 B) — same skalary, bez wyrównania vec2
+struct Instance {
+    x: f32,
+    y: f32,
+    scaleX: f32,
+    scaleY: f32,
+    rotation: f32,
+    atlasIndex: u32,
+    tint: u32,
+};
+
+struct DrawArgs {
+    indexCount: u32,
+    instanceCount: u32,
+    firstIndex: u32,
+    baseVertex: i32,
+    firstInstance: u32,
+};
+
+@group(0) @binding(0) var<uniform> params: Params;
+@group(0) @binding(1) var<storage, read> source: array<Instance>;
+// [0, G): widoczne w grupie, [G, 2G): początki grup w visible
+@group(0) @binding(2) var<storage, read_write> groups: array<u32>;
+@group(0) @binding(3) var<storage, read_write> visible: array<Instance>;
+@group(0) @binding(4) var<storage, read_write> args: DrawArgs;
+
+var<workgroup> flags: array<u32, 256>;
+
+// AABB okręgu opisanego na sprite'cie (obrót nie ma znaczenia); zerowy
+// rozmiar = instancja martwa
+fn isVisible(i: u32) -> bool {
+    if (i >= params.count) {
+        return false;
+    }
+    let s = source[i];
+    let extent = 0.5 * length(vec2f(s.scaleX, s.scaleY));
+    let p = vec2f(s.x, s.y);
+    return extent > 0.0 && all(p + extent >= params.viewMin) &&
+           all(p - extent <= params.viewMax);
+}
+
+// Skan inkluzywny flags (Hillis-Steele), wołany przez całą grupę
+fn scanFlags(lid: u32) {
+    for (var offset = 1u; offset < 256u; offset <<= 1u) {
+        var value = 0u;
+        if (lid >= offset) {
+            value = flags[lid - offset];
+        }
+        workgroupBarrier();
+        flags[lid] += value;
+        workgroupBarrier();
+    }
+}
+
+// 1. Liczba widocznych instancji w każdej grupie
+@compute @workgroup_size(256)
+fn cs_count(@builtin(local_invocation_index) lid: u32,
+            @builtin(workgroup_id) group: vec3u) {
+    flags[lid] = select(0u, 1u, isVisible(group.x * 256u + lid));
+    workgroupBarrier();
+    scanFlags(lid);
+    if (lid == 255u) {
+        groups[group.x] = flags[255];
+    }
+}
+
+// 2. Początki grup i argumenty rysowania — jedna grupa, każdy wątek
+// sumuje swój blok liczników
+@compute @workgroup_size(256)
+fn cs_scan(@builtin(local_invocation_index) lid: u32) {
+    let total = params.groupCount;
+    let perThread = (total + 255u) / 256u;
+    let begin = min(lid * perThread, total);
+    let end = min(begin + perThread, total);
+
+    var sum = 0u;
+    for (var g = begin; g < end; g++) {
+        sum += groups[g];
+    }
+    flags[lid] = sum;
+    workgroupBarrier();
+    scanFlags(lid);
+
+    var running = flags[lid] - sum;
+    for (var g = begin; g < end; g++) {
+        groups[total + g] = running;
+        running += groups[g];
+    }
+    if (lid == 255u) {
+        args.indexCount = 6u;
+        args.instanceCount = flags[255];
+        args.firstIndex = 0u;
+        args.baseVertex = 0;
+        args.firstInstance = 0u;
+    }
+}
+
+// 3. Widoczne instancje pod początek grupy, w kolejności źródła
+@compute @workgroup_size(256)
+fn cs_compact(@builtin(local_invocation_index) lid: u32,
+              @builtin(workgroup_id) group: vec3u) {
+    let i = group.x * 256u + lid;
+    let keep = isVisible(i);
+    flags[lid] = select(0u, 1u, keep);
+    workgroupBarrier();
+    scanFlags(lid);
+    if (keep) {
+        let first = groups[params.groupCount + group.x];
+        visible[first + flags[lid] - 1u] = source[i];
+    }
+}
+)";
+
+// Uniform — ten sam układ co struct Params w WGSL (32 B)
+struct CullParams {
+  float viewMin[2];
+  float viewMax[2];
+  uint32_t count;
+  uint32_t groupCount;
+  uint32_t padding[2];
+};
+static_assert(sizeof(CullParams) == 32, "CullParams layout");
+
+constexpr uint32_t kCullGroupSize = 256;
+
+// ============================================================
+//  Tworzenie
+// ============================================================
+
+static WGPUBuffer createBuffer(WGPUDevice device, const char *label,
+                               WGPUBufferUsageFlags usage, uint64_t size) {
+  WGPUBufferDescriptor desc = {};
+  desc.nextInChain = nullptr;
+  desc.label = label;
+  desc.usage = usage;
+  desc.size = size;
+  desc.mappedAtCreation = false;
+  return wgpuDeviceCreateBuffer(device, &desc);
+}
+
+static BindGroupLayoutDesc cullBindGroupLayoutDesc() {
+  BindGroupLayoutDesc desc;
+  desc.label = "Cull Bind Group Layout";
+  desc.entries = {
+      BindingDesc::buffer(0, WGPUShaderStage_Compute,
+                          WGPUBufferBindingType_Uniform, sizeof(CullParams)),
+      BindingDesc::buffer(1, WGPUShaderStage_Compute,
+                          WGPUBufferBindingType_ReadOnlyStorage,
+                          sizeof(SpriteInstance)),
+      BindingDesc::buffer(2, WGPUShaderStage_Compute,
+                          WGPUBufferBindingType_Storage, sizeof(uint32_t)),
+      BindingDesc::buffer(3, WGPUShaderStage_Compute,
+                          WGPUBufferBindingType_Storage,
+                          sizeof(SpriteInstance)),
+      BindingDesc::buffer(4, WGPUShaderStage_Compute,
+                          WGPUBufferBindingType_Storage,
+                          sizeof(DrawIndexedIndirectArgs)),
+  };
+  return desc;
+}
+
+bool createGpuCulling(WGPUDevice device, PipelineCache &pipelines,
+                      GpuCulling &culling) {
+  culling.device = device;
+
+  // Jeden shader module, trzy entry pointy
+  const BindGroupLayoutDesc layoutDesc = cullBindGroupLayoutDesc();
+  ComputePipelineDesc pipelineDesc;
+  pipelineDesc.label = "Cull Pipeline";
+  pipelineDesc.shaderSource = cullShaderSource;
+  pipelineDesc.bindGroups = {layoutDesc};
+  pipelineDesc.entryPoint = "cs_count";
+  culling.countPipeline = pipelines.computePipeline(pipelineDesc);
+  pipelineDesc.entryPoint = "cs_scan";
+  culling.scanPipeline = pipelines.computePipeline(pipelineDesc);
+  pipelineDesc.entryPoint = "cs_compact";
+  culling.compactPipeline = pipelines.computePipeline(pipelineDesc);
+  culling.layout = pipelines.bindGroupLayout(layoutDesc);
+
+  if (!culling.layout || !culling.countPipeline || !culling.scanPipeline ||
+      !culling.compactPipeline) {
+    std::cerr << "Failed to create GPU culling pipelines!" << std::endl;
+    releaseGpuCulling(culling);
+    return false;
+  }
+  return true;
+}
+
+static void releaseStream(GpuCullStream &stream) {
+  if (stream.bindGroup)
+    wgpuBindGroupRelease(stream.bindGroup);
+  const WGPUBuffer buffers[] = {stream.indirectBuffer, stream.visibleBuffer,
+                                stream.groupBuffer, stream.paramsBuffer};
+  for (WGPUBuffer buffer : buffers)
+    if (buffer)
+      wgpuBufferRelease(buffer);
+  stream = {};
+}
+
+void releaseGpuCulling(GpuCulling &culling) {
+  for (uint32_t i = 0; i < culling.streamCount; ++i)
+    releaseStream(culling.streams[i]);
+  culling = {};
+}
+
+uint32_t gpuCullingAddStream(GpuCulling &culling, WGPUBuffer source,
+                             uint32_t capacity) {
+  if (!culling.layout || !source || capacity == 0 ||
+      culling.streamCount == kMaxCullStreams) {
+    std::cerr << "Cannot add GPU cull stream!" << std::endl;
+    return ~0u;
+  }
+
+  // 1. Bufory (limit dispatchu: 65535 workgroup po 256 wątków)
+  GpuCullStream &stream = culling.streams[culling.streamCount];
+  stream.source = source;
+  stream.capacity = std::min(capacity, 65535u * kCullGroupSize);
+  stream.groupCount = (stream.capacity + kCullGroupSize - 1) / kCullGroupSize;
+  const uint64_t instanceBytes =
+      uint64_t(stream.capacity) * sizeof(SpriteInstance);
+  const uint64_t groupBytes =
+      uint64_t(stream.groupCount) * 2 * sizeof(uint32_t);
+  stream.paramsBuffer =
+      createBuffer(culling.device, "Cull Params",
+                   WGPUBufferUsage_Uniform | WGPUBufferUsage_CopyDst,
+                   sizeof(CullParams));
+  stream.groupBuffer = createBuffer(culling.device, "Cull Groups",
+                                    WGPUBufferUsage_Storage, groupBytes);
+  stream.visibleBuffer =
+      createBuffer(culling.device, "Visible Instances",
+                   WGPUBufferUsage_Storage | WGPUBufferUsage_Vertex,
+                   instanceBytes);
+  stream.indirectBuffer =
+      createBuffer(culling.device, "Cull Draw Args",
+                   WGPUBufferUsage_Storage | WGPUBufferUsage_Indirect,
+                   sizeof(DrawIndexedIndirectArgs));
+
+  // 2. Bind group strumienia
+  if (stream.paramsBuffer && stream.groupBuffer && stream.visibleBuffer &&
+      stream.indirectBuffer) {
+    WGPUBindGroupEntry entries[5] = {};
+    const WGPUBuffer buffers[5] = {stream.paramsBuffer, stream.source,
+                                   stream.groupBuffer, stream.visibleBuffer,
+                                   stream.indirectBuffer};
+    const uint64_t sizes[5] = {sizeof(CullParams), instanceBytes, groupBytes,
+                               instanceBytes, sizeof(DrawIndexedIndirectArgs)};
+    for (uint32_t b = 0; b < 5; ++b) {
+      entries[b].binding = b;
+      entries[b].buffer = buffers[b];
+      entries[b].offset = 0;
+      entries[b].size = sizes[b];
+    }
+    WGPUBindGroupDescriptor bindGroupDesc = {};
+    bindGroupDesc.nextInChain = nullptr;
+    bindGroupDesc.label = "Cull Bind Group";
+    bindGroupDesc.layout = culling.layout;
+    bindGroupDesc.entryCount = 5;
+    bindGroupDesc.entries = entries;
+    stream.bindGroup =
+        wgpuDeviceCreateBindGroup(culling.device, &bindGroupDesc);
+  }
+  if (!stream.bindGroup) {
+    std::cerr << "Failed to create GPU cull stream!" << std::endl;
+    releaseStream(stream);
+    return ~0u;
+  }
+  return culling.streamCount++;
+}
+
+// ============================================================
+//  Klatka
+// ============================================================
+
+void gpuCullingPrepare(WGPUQueue queue, GpuCulling &culling,
+                       const CullRect &view) {
+  for (uint32_t i = 0; i < culling.streamCount; ++i) {
+    const GpuCullStream &stream = culling.streams[i];
+    CullParams params = {};
+    params.viewMin[0] = view.minX;
+    params.viewMin[1] = view.minY;
+    params.viewMax[0] = view.maxX;
+    params.viewMax[1] = view.maxY;
+    params.count = stream.capacity;
+    params.groupCount = stream.groupCount;
+    wgpuQueueWriteBuffer(queue, stream.paramsBuffer, 0, &params,
+                         sizeof(params));
+  }
+}
+
+void gpuCullingEncode(WGPUCommandEncoder encoder, const GpuCulling &culling,
+                      const WGPUComputePassTimestampWrites *timestampWrites) {
+  if (culling.streamCount == 0)
+    return;
+
+  WGPUComputePassDescriptor passDesc = {};
+  passDesc.nextInChain = nullptr;
+  passDesc.label = "Cull Pass";
+  passDesc.timestampWrites = timestampWrites;
+  WGPUComputePassEncoder pass =
+      wgpuCommandEncoderBeginComputePass(encoder, &passDesc);
+
+  for (uint32_t i = 0; i < culling.streamCount; ++i) {
+    const GpuCullStream &stream = culling.streams[i];
+    wgpuComputePassEncoderSetBindGroup(pass, 0, stream.bindGroup, 0, nullptr);
+    wgpuComputePassEncoderSetPipeline(pass, culling.countPipeline);
+    wgpuComputePassEncoderDispatchWorkgroups(pass, stream.groupCount, 1, 1);
+    wgpuComputePassEncoderSetPipeline(pass, culling.scanPipeline);
+    wgpuComputePassEncoderDispatchWorkgroups(pass, 1, 1, 1);
+    wgpuComputePassEncoderSetPipeline(pass, culling.compactPipeline);
+    wgpuComputePassEncoderDispatchWorkgroups(pass, stream.groupCount, 1, 1);
+  }
+
+  wgpuComputePassEncoderEnd(pass);
+  wgpuComputePassEncoderRelease(pass);
+}
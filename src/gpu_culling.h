@@ -0,0 +1,74 @@
+#pragma once
+
+#include <cstdint>
+#include <webgpu/webgpu.h>
+
+class PipelineCache;
+struct CullRect;
+
+// ============================================================
+//  Culling na GPU
+// ============================================================
+
+constexpr uint32_t kMaxCullStreams = 4;
+
+// Argumenty wgpuRenderPassEncoderDrawIndexedIndirect (20 B) — zapisuje je
+// compute shader, CPU nie zna liczby widocznych instancji
+struct DrawIndexedIndirectArgs {
+  uint32_t indexCount;
+  uint32_t instanceCount;
+  uint32_t firstIndex;
+  int32_t baseVertex;
+  uint32_t firstInstance;
+};
+static_assert(sizeof(DrawIndexedIndirectArgs) == 20,
+              "DrawIndexedIndirectArgs layout");
+
+// Strumień instancji w buforze GPU (np. horda, cząsteczki). Widoczne
+// instancje trafiają w tej samej kolejności do visibleBuffer, a ich liczba
+// do indirectBuffer.
+struct GpuCullStream {
+  WGPUBuffer source = nullptr; // SpriteInstance[capacity], nie posiadany
+  uint32_t capacity = 0;
+  uint32_t groupCount = 0;             // workgroupy po 256 instancji
+  WGPUBuffer paramsBuffer = nullptr;   // Uniform
+  WGPUBuffer groupBuffer = nullptr;    // liczniki grup + początki
+  WGPUBuffer visibleBuffer = nullptr;  // SpriteInstance[capacity] (Vertex)
+  WGPUBuffer indirectBuffer = nullptr; // DrawIndexedIndirectArgs (Indirect)
+  WGPUBindGroup bindGroup = nullptr;
+};
+
+// Frustum culling i kompaktowanie instancji w compute passie: dla każdego
+// strumienia grupa 256 wątków testuje AABB instancji z prostokątem widoku
+// i liczy widoczne (skan w grupie), jedna grupa skanuje liczniki grup i
+// zapisuje argumenty rysowania, a potem każda grupa przepisuje swoje
+// widoczne instancje pod własny początek. Kolejność instancji zostaje
+// zachowana (blending alfa), a instancje o zerowym rozmiarze (martwe
+// cząsteczki) odpadają. Sprite pass rysuje wynik przez
+// spriteBatchDrawIndirect — dane encji nie wracają na CPU.
+struct GpuCulling {
+  WGPUDevice device = nullptr;
+  GpuCullStream streams[kMaxCullStreams];
+  uint32_t streamCount = 0;
+  // Z PipelineCache, nie posiadane
+  WGPUBindGroupLayout layout = nullptr;
+  WGPUComputePipeline countPipeline = nullptr;
+  WGPUComputePipeline scanPipeline = nullptr;
+  WGPUComputePipeline compactPipeline = nullptr;
+};
+
+bool createGpuCulling(WGPUDevice device, PipelineCache &pipelines,
+                      GpuCulling &culling);
+void releaseGpuCulling(GpuCulling &culling);
+
+// Dodaje strumień (bufor z usage Storage) i zwraca jego indeks albo ~0u
+uint32_t gpuCullingAddStream(GpuCulling &culling, WGPUBuffer source,
+                             uint32_t capacity);
+
+// Prostokąt widoku klatki (cameraViewRect) dla wszystkich strumieni
+void gpuCullingPrepare(WGPUQueue queue, GpuCulling &culling,
+                       const CullRect &view);
+// Compute pass z cullingiem wszystkich strumieni — po passach, które
+// zapisują bufory źródłowe, przed sprite passem
+void gpuCullingEncode(WGPUCommandEncoder encoder, const GpuCulling &culling,
+                      const WGPUComputePassTimestampWrites *timestampWrites);
@@ -0,0 +1,156 @@
+#include "gpu_device.h"
+
+#include <iostream>
+
+// ============================================================
+//  Callbacks
+// ============================================================
+
+// Callback wywoływany po znalezieniu adaptera GPU
+static void onAdapterRequestEnded(WGPURequestAdapterStatus status,
+                                  WGPUAdapter adapter, char const *message,
+                                  void *userdata) {
+  if (status != WGPURequestAdapterStatus_Success) {
+    std::cerr << "Could not get WebGPU adapter: " << (message ? message : "")
+              << std::endl;
+    *static_cast<WGPUAdapter *>(userdata) = nullptr;
+    return;
+  }
+  *static_cast<WGPUAdapter *>(userdata) = adapter;
+}
+
+// Callback wywoływany po utworzeniu urządzenia GPU
+static void onDeviceRequestEnded(WGPURequestDeviceStatus status,
+                                 WGPUDevice device, char const *message,
+                                 void *userdata) {
+  if (status != WGPURequestDeviceStatus_Success) {
+    std::cerr << "Could not get WebGPU device: " << (message ? message : "")
+              << std::endl;
+    *static_cast<WGPUDevice *>(userdata) = nullptr;
+    return;
+  }
+  *static_cast<WGPUDevice *>(userdata) = device;
+}
+
+// Callback dla nieobsłużonych błędów urządzenia
+static void onUncapturedError(WGPUErrorType type, char const *message,
+                              void * /*userdata*/) {
+  std::cerr << "[WebGPU Error] type=" << type << ": "
+            << (message ? message : "(no message)") << std::endl;
+}
+
+// Callback dla utraty urządzenia
+static void onDeviceLost(WGPUDeviceLostReason reason, char const *message,
+                         void * /*userdata*/) {
+  std::cerr << "[WebGPU] Device lost! reason=" << reason << ": "
+            << (message ? message : "(no message)") << std::endl;
+}
+
+// ============================================================
+//  Pomocnicze funkcje
+// ============================================================
+
+// Nazwa typu adaptera
+static const char *adapterTypeName(WGPUAdapterType type) {
+  switch (type) {
+  case WGPUAdapterType_DiscreteGPU:
+    return "Discrete GPU";
+  case WGPUAdapterType_IntegratedGPU:
+    return "Integrated GPU";
+  case WGPUAdapterType_CPU:
+    return "CPU (software)";
+  default:
+    return "Unknown";
+  }
+}
+
+// Nazwa backendu graficznego
+static const char *backendTypeName(WGPUBackendType type) {
+  switch (type) {
+  case WGPUBackendType_D3D12:
+    return "Direct3D 12";
+  case WGPUBackendType_D3D11:
+    return "Direct3D 11";
+  case WGPUBackendType_Vulkan:
+    return "Vulkan";
+  case WGPUBackendType_Metal:
+    return "Metal";
+  case WGPUBackendType_OpenGL:
+    return "OpenGL";
+  case WGPUBackendType_OpenGLES:
+    return "OpenGL ES";
+  default:
+    return "Unknown";
+  }
+}
+
+// ============================================================
+//  Adapter i urządzenie
+// ============================================================
+
+WGPUAdapter requestAdapter(WGPUInstance instance,
+                           WGPUSurface compatibleSurface) {
+  WGPUAdapter adapter = nullptr;
+  WGPURequestAdapterOptions adapterOpts = {};
+  adapterOpts.nextInChain = nullptr;
+  adapterOpts.compatibleSurface = compatibleSurface;
+  adapterOpts.powerPreference = WGPUPowerPreference_HighPerformance;
+  adapterOpts.forceFallbackAdapter = false;
+  wgpuInstanceRequestAdapter(instance, &adapterOpts, onAdapterRequestEnded,
+                             &adapter);
+  if (adapter)
+    return adapter;
+
+  // Brak sprzętowego GPU — spróbuj adaptera programowego
+  std::cout << "No hardware adapter found, falling back to software adapter..."
+            << std::endl;
+  adapterOpts.forceFallbackAdapter = true;
+  wgpuInstanceRequestAdapter(instance, &adapterOpts, onAdapterRequestEnded,
+                             &adapter);
+  return adapter;
+}
+
+WGPUDevice requestDevice(WGPUAdapter adapter) {
+  WGPUDevice device = nullptr;
+  WGPUDeviceDescriptor deviceDesc = {};
+  deviceDesc.nextInChain = nullptr;
+  deviceDesc.label = "WarpEngine Device";
+  // Opcjonalne funkcje włączamy tylko, gdy adapter je obsługuje
+  // (TimestampQuery — pomiar czasu passów w profilerze)
+  WGPUFeatureName features[1];
+  size_t featureCount = 0;
+  if (wgpuAdapterHasFeature(adapter, WGPUFeatureName_TimestampQuery))
+    features[featureCount++] = WGPUFeatureName_TimestampQuery;
+  deviceDesc.requiredFeatureCount = featureCount;
+  deviceDesc.requiredFeatures = featureCount ? features : nullptr;
+  deviceDesc.requiredLimits = nullptr;
+  deviceDesc.defaultQueue.nextInChain = nullptr;
+  deviceDesc.defaultQueue.label = "Default Queue";
+  deviceDesc.deviceLostCallback = onDeviceLost;
+  deviceDesc.deviceLostUserdata = nullptr;
+
+  wgpuAdapterRequestDevice(adapter, &deviceDesc, onDeviceRequestEnded, &device);
+  if (!device)
+    return nullptr;
+
+  // Ustaw callback dla błędów
+  wgpuDeviceSetUncapturedErrorCallback(device, onUncapturedError, nullptr);
+  return device;
+}
+
+void printAdapterInfo(const WGPUAdapterProperties &props) {
+  std::cout << "==========================================" << std::endl;
+  std::cout << "  WarpEngine - GPU Info" << std::endl;
+  std::cout << "==========================================" << std::endl;
+  std::cout << "  GPU:      " << (props.name ? props.name : "N/A") << std::endl;
+  std::cout << "  Vendor:   " << (props.vendorName ? props.vendorName : "N/A")
+            << std::endl;
+  std::cout << "  Driver:   "
+            << (props.driverDescription ? props.driverDescription : "N/A")
+            << std::endl;
+  std::cout << "  Type:     " << adapterTypeName(props.adapterType)
+            << std::endl;
+  std::cout << "  Backend:  " << backendTypeName(props.backendType)
+            << std::endl;
+  std::cout << "==========================================" << std::endl;
+}
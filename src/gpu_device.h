@@ -0,0 +1,17 @@
+#pragma once
+
+#include <webgpu/webgpu.h>
+
+// Żąda adaptera GPU. Gdy nie ma sprzętowego adaptera (np. serwer CI bez GPU),
+// ponawia żądanie z forceFallbackAdapter — wgpu zwraca wtedy adapter
+// programowy (WGPUAdapterType_CPU, np. llvmpipe / WARP).
+// compatibleSurface może być nullptr (tryb headless).
+WGPUAdapter requestAdapter(WGPUInstance instance,
+                           WGPUSurface compatibleSurface);
+
+// Żąda urządzenia z adaptera i ustawia callback dla nieobsłużonych błędów.
+// Włącza WGPUFeatureName_TimestampQuery, jeśli adapter go obsługuje.
+WGPUDevice requestDevice(WGPUAdapter adapter);
+
+// Wypisuje nazwę, producenta, sterownik, typ i backend adaptera
+void printAdapterInfo(const WGPUAdapterProperties &props);
@@ -0,0 +1,475 @@
+#include "gpu_horde.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "gpu_particles.h"
+#include "pipeline_cache.h"
+#include "sprite_batch.h"
+
+// ============================================================
+//  WGSL (dokładany do particleEventsWgsl())
+// ============================================================
+
+static const char *hordeShaderSource = R"(
+struct Params {
+    player: vec2f,
+    dt: f32,
+    speed: f32,
+    worldMin: vec2f,
+    cellSize: f32,
+    radius: f32,
+    gridSize: vec2u,
+    agentCount: u32,
+    strength: f32,
+    worldMax: vec2f,
+    killRadius: f32,
+    seed: u32,
+    deathBurst: u32,
+    atlasFrame: u32,
+    _pad0: u32,
+    _pad1: u32,
+};
+
+struct Agent {
+    position: vec2f,
+    size: f32,
+    tint: u32,
+};
+
+@group(0) @binding(0) var<uniform> params: Params;
+@group(0) @binding(1) var<storage, read> agentsIn: array<Agent>;
+@group(0) @binding(2) var<storage, read_write> agentsOut: array<Agent>;
+// (komórka, pozycja agenta w komórce)
+@group(0) @binding(3) var<storage, read_write> agentCells: array<vec2u>;
+// [0, N): liczniki komórek, [N, 2N): początki komórek w sorted
+@group(0) @binding(4) var<storage, read_write> cells: array<atomic<u32>>;
+@group(0) @binding(5) var<storage, read_write> sorted: array<u32>;
+@group(0) @binding(6) var<storage, read_write> instances: array<Instance>;
+@group(0) @binding(7) var<storage, read_write> events: Events;
+
+fn cellCount() -> u32 {
+    return params.gridSize.x * params.gridSize.y;
+}
+
+fn cellCoord(p: vec2f) -> vec2i {
+    let c = vec2i(floor((p - params.worldMin) / params.cellSize));
+    return clamp(c, vec2i(0), vec2i(params.gridSize) - 1);
+}
+
+fn cellIndex(c: vec2i) -> u32 {
+    return u32(c.y) * params.gridSize.x + u32(c.x);
+}
+
+// 1. Zerowanie liczników komórek
+@compute @workgroup_size(64)
+fn cs_clear(@builtin(global_invocation_id) id: vec3u) {
+    if (id.x < cellCount()) {
+        atomicStore(&cells[id.x], 0u);
+    }
+}
+
+// 2. Zliczanie agentów w komórkach (atomicAdd zwraca pozycję w komórce)
+@compute @workgroup_size(64)
+fn cs_count(@builtin(global_invocation_id) id: vec3u) {
+    if (id.x >= params.agentCount) {
+        return;
+    }
+    let cell = cellIndex(cellCoord(agentsIn[id.x].position));
+    agentCells[id.x] = vec2u(cell, atomicAdd(&cells[cell], 1u));
+}
+
+// 3. Skan prefiksowy liczników — jedna grupa, każdy wątek sumuje swój
+// blok komórek, potem skan Hillisa-Steele'a po sumach bloków
+var<workgroup> partial: array<u32, 256>;
+
+@compute @workgroup_size(256)
+fn cs_scan(@builtin(local_invocation_index) lid: u32) {
+    let total = cellCount();
+    let perThread = (total + 255u) / 256u;
+    let begin = min(lid * perThread, total);
+    let end = min(begin + perThread, total);
+
+    var sum = 0u;
+    for (var c = begin; c < end; c++) {
+        sum += atomicLoad(&cells[c]);
+    }
+    partial[lid] = sum;
+    workgroupBarrier();
+    for (var offset = 1u; offset < 256u; offset <<= 1u) {
+        var value = 0u;
+        if (lid >= offset) {
+            value = partial[lid - offset];
+        }
+        workgroupBarrier();
+        partial[lid] += value;
+        workgroupBarrier();
+    }
+
+    var running = partial[lid] - sum;
+    for (var c = begin; c < end; c++) {
+        atomicStore(&cells[total + c], running);
+        running += atomicLoad(&cells[c]);
+    }
+}
+
+// 4. Indeksy agentów posortowane według komórek
+@compute @workgroup_size(64)
+fn cs_scatter(@builtin(global_invocation_id) id: vec3u) {
+    if (id.x >= params.agentCount) {
+        return;
+    }
+    let cell = agentCells[id.x];
+    sorted[atomicLoad(&cells[cellCount() + cell.x]) + cell.y] = id.x;
+}
+
+// 5. Pościg + separacja, nowa pozycja i instancja sprite'a
+@compute @workgroup_size(64)
+fn cs_steer(@builtin(global_invocation_id) id: vec3u) {
+    let i = id.x;
+    if (i >= params.agentCount) {
+        return;
+    }
+    var agent = agentsIn[i];
+
+    let toPlayer = params.player - agent.position;
+    let velocity = toPlayer * (params.speed / sqrt(dot(toPlayer, toPlayer) + 1e-4));
+
+    // Każda para rozpycha oba elementy po połowie (jak separationSystem)
+    var separation = vec2f(0.0);
+    let total = cellCount();
+    let center = cellCoord(agent.position);
+    let radiusSq = params.radius * params.radius;
+    for (var dy = -1; dy <= 1; dy++) {
+        for (var dx = -1; dx <= 1; dx++) {
+            let c = center + vec2i(dx, dy);
+            if (any(c < vec2i(0)) || any(c >= vec2i(params.gridSize))) {
+                continue;
+            }
+            let cell = cellIndex(c);
+            let start = atomicLoad(&cells[total + cell]);
+            let end = start + atomicLoad(&cells[cell]);
+            for (var k = start; k < end; k++) {
+                let j = sorted[k];
+                if (j == i) {
+                    continue;
+                }
+                let d = agentsIn[j].position - agent.position;
+                let distSq = dot(d, d);
+                if (distSq >= radiusSq) {
+                    continue;
+                }
+                let dist = sqrt(distSq) + 1e-4;
+                let overlap = params.radius - dist;
+                separation -= d * (0.5 * params.strength * overlap / dist);
+            }
+        }
+    }
+    agent.position += velocity * params.dt + separation;
+
+    // Dotknięcie gracza: wybuch cząsteczek i odrodzenie na krawędzi świata
+    if (distance(agent.position, params.player) < params.killRadius) {
+        if (params.deathBurst > 0u) {
+            var burst: Burst;
+            burst.position = agent.position;
+            burst.speed = 180.0;
+            burst.size = 3.0;
+            burst.count = params.deathBurst;
+            burst.first = 0u;
+            burst.color = agent.tint;
+            burst.life = 0.6;
+            appendBurst(burst);
+        }
+        let h = hash(params.seed ^ hash(i));
+        let t = f32(h & 0xffffu) / 65535.0;
+        let edge = mix(params.worldMin, params.worldMax, vec2f(t, t));
+        switch ((h >> 16u) & 3u) {
+            case 0u: { agent.position = vec2f(edge.x, params.worldMin.y); }
+            case 1u: { agent.position = vec2f(edge.x, params.worldMax.y); }
+            case 2u: { agent.position = vec2f(params.worldMin.x, edge.y); }
+            default: { agent.position = vec2f(params.worldMax.x, edge.y); }
+        }
+    }
+    agentsOut[i] = agent;
+
+    var sprite: Instance;
+    sprite.x = agent.position.x;
+    sprite.y = agent.position.y;
+    sprite.scaleX = agent.size;
+    sprite.scaleY = agent.size;
+    sprite.rotation = 0.0;
+    sprite.atlasIndex = params.atlasFrame;
+    sprite.tint = agent.tint;
+    instances[i] = sprite;
+}
+)";
+
+// Uniform — ten sam układ co struct Params w WGSL (80 B)
+struct HordeParams {
+  float player[2];
+  float dt;
+  float speed;
+  float worldMin[2];
+  float cellSize;
+  float radius;
+  uint32_t gridSize[2];
+  uint32_t agentCount;
+  float strength;
+  float worldMax[2];
+  float killRadius;
+  uint32_t seed;
+  uint32_t deathBurst;
+  uint32_t atlasFrame;
+  uint32_t padding[2];
+};
+static_assert(sizeof(HordeParams) == 80, "HordeParams layout");
+
+// Margines świata poza ekranem (tam odradzają się agenci)
+constexpr float kWorldMargin = 64.0f;
+
+// ============================================================
+//  Tworzenie
+// ============================================================
+
+static WGPUBuffer createBuffer(WGPUDevice device, const char *label,
+                               WGPUBufferUsageFlags usage, uint64_t size) {
+  WGPUBufferDescriptor desc = {};
+  desc.nextInChain = nullptr;
+  desc.label = label;
+  desc.usage = usage;
+  desc.size = size;
+  desc.mappedAtCreation = false;
+  return wgpuDeviceCreateBuffer(device, &desc);
+}
+
+bool createGpuHorde(WGPUDevice device, PipelineCache &pipelines,
+                    GpuParticles &particles, uint32_t agentCount,
+                    const GpuHordeSettings &settings, GpuHorde &horde) {
+  horde.device = device;
+  horde.settings = settings;
+  horde.agentCount = std::clamp(agentCount, 1u, 65535u * 64u);
+  horde.cellSize = std::max(16.0f, settings.radius);
+  horde.gridWidth = uint32_t(std::ceil(
+      (settings.worldWidth + 2.0f * kWorldMargin) / horde.cellSize));
+  horde.gridHeight = uint32_t(std::ceil(
+      (settings.worldHeight + 2.0f * kWorldMargin) / horde.cellSize));
+  const uint32_t cellCount = horde.gridWidth * horde.gridHeight;
+  particles.gpuBurstSize =
+      std::max(particles.gpuBurstSize, settings.deathBurst);
+
+  // 1. Bufory
+  const uint64_t agentBytes = uint64_t(horde.agentCount) * sizeof(GpuAgent);
+  const uint64_t agentCellBytes = uint64_t(horde.agentCount) * 8;
+  const uint64_t cellBytes = uint64_t(cellCount) * 2 * sizeof(uint32_t);
+  const uint64_t sortedBytes = uint64_t(horde.agentCount) * sizeof(uint32_t);
+  const uint64_t instanceBytes =
+      uint64_t(horde.agentCount) * sizeof(SpriteInstance);
+  const uint64_t eventBytes =
+      16 + kMaxParticleBursts * sizeof(ParticleBurst);
+  horde.paramsBuffer =
+      createBuffer(device, "Horde Params",
+                   WGPUBufferUsage_Uniform | WGPUBufferUsage_CopyDst,
+                   sizeof(HordeParams));
+  horde.agentBuffers[0] =
+      createBuffer(device, "Horde Agents A",
+                   WGPUBufferUsage_Storage | WGPUBufferUsage_CopyDst,
+                   agentBytes);
+  horde.agentBuffers[1] = createBuffer(device, "Horde Agents B",
+                                       WGPUBufferUsage_Storage, agentBytes);
+  horde.agentCellBuffer = createBuffer(device, "Horde Agent Cells",
+                                       WGPUBufferUsage_Storage, agentCellBytes);
+  horde.cellBuffer =
+      createBuffer(device, "Horde Cells", WGPUBufferUsage_Storage, cellBytes);
+  horde.sortedBuffer = createBuffer(device, "Horde Sorted Agents",
+                                    WGPUBufferUsage_Storage, sortedBytes);
+  horde.instanceBuffer =
+      createBuffer(device, "Horde Instances",
+                   WGPUBufferUsage_Storage | WGPUBufferUsage_Vertex,
+                   instanceBytes);
+
+  // 2. Layout i pipeline'y (jeden shader module, pięć entry pointów)
+  BindGroupLayoutDesc layoutDesc;
+  layoutDesc.label = "Horde Bind Group Layout";
+  layoutDesc.entries = {
+      BindingDesc::buffer(0, WGPUShaderStage_Compute,
+                          WGPUBufferBindingType_Uniform, sizeof(HordeParams)),
+      BindingDesc::buffer(1, WGPUShaderStage_Compute,
+                          WGPUBufferBindingType_ReadOnlyStorage,
+                          sizeof(GpuAgent)),
+      BindingDesc::buffer(2, WGPUShaderStage_Compute,
+                          WGPUBufferBindingType_Storage, sizeof(GpuAgent)),
+      BindingDesc::buffer(3, WGPUShaderStage_Compute,
+                          WGPUBufferBindingType_Storage, 8),
+      BindingDesc::buffer(4, WGPUShaderStage_Compute,
+                          WGPUBufferBindingType_Storage, sizeof(uint32_t)),
+      BindingDesc::buffer(5, WGPUShaderStage_Compute,
+                          WGPUBufferBindingType_Storage, sizeof(uint32_t)),
+      BindingDesc::buffer(6, WGPUShaderStage_Compute,
+                          WGPUBufferBindingType_Storage,
+                          sizeof(SpriteInstance)),
+      BindingDesc::buffer(7, WGPUShaderStage_Compute,
+                          WGPUBufferBindingType_Storage, eventBytes),
+  };
+  ComputePipelineDesc pipelineDesc;
+  pipelineDesc.label = "Horde Pipeline";
+  pipelineDesc.shaderSource = particleEventsWgsl() + hordeShaderSource;
+  pipelineDesc.bindGroups = {layoutDesc};
+  pipelineDesc.entryPoint = "cs_clear";
+  horde.clearPipeline = pipelines.computePipeline(pipelineDesc);
+  pipelineDesc.entryPoint = "cs_count";
+  horde.countPipeline = pipelines.computePipeline(pipelineDesc);
+  pipelineDesc.entryPoint = "cs_scan";
+  horde.scanPipeline = pipelines.computePipeline(pipelineDesc);
+  pipelineDesc.entryPoint = "cs_scatter";
+  horde.scatterPipeline = pipelines.computePipeline(pipelineDesc);
+  pipelineDesc.entryPoint = "cs_steer";
+  horde.steerPipeline = pipelines.computePipeline(pipelineDesc);
+  WGPUBindGroupLayout layout = pipelines.bindGroupLayout(layoutDesc);
+
+  if (!horde.paramsBuffer || !horde.agentBuffers[0] ||
+      !horde.agentBuffers[1] || !horde.agentCellBuffer || !horde.cellBuffer ||
+      !horde.sortedBuffer || !horde.instanceBuffer || !layout ||
+      !horde.clearPipeline || !horde.countPipeline || !horde.scanPipeline ||
+      !horde.scatterPipeline || !horde.steerPipeline) {
+    std::cerr << "Failed to create GPU horde!" << std::endl;
+    releaseGpuHorde(horde);
+    return false;
+  }
+
+  // 3. Bind groupy ping-pong: [k] czyta agentBuffers[k], pisze do [1 - k]
+  for (uint32_t k = 0; k < 2; ++k) {
+    WGPUBindGroupEntry entries[8] = {};
+    const WGPUBuffer buffers[8] = {
+        horde.paramsBuffer,     horde.agentBuffers[k],
+        horde.agentBuffers[1 - k], horde.agentCellBuffer,
+        horde.cellBuffer,       horde.sortedBuffer,
+        horde.instanceBuffer,   particles.eventBuffer};
+    const uint64_t sizes[8] = {sizeof(HordeParams), agentBytes, agentBytes,
+                               agentCellBytes,      cellBytes,  sortedBytes,
+                               instanceBytes,       eventBytes};
+    for (uint32_t b = 0; b < 8; ++b) {
+      entries[b].binding = b;
+      entries[b].buffer = buffers[b];
+      entries[b].offset = 0;
+      entries[b].size = sizes[b];
+    }
+    WGPUBindGroupDescriptor bindGroupDesc = {};
+    bindGroupDesc.nextInChain = nullptr;
+    bindGroupDesc.label = "Horde Bind Group";
+    bindGroupDesc.layout = layout;
+    bindGroupDesc.entryCount = 8;
+    bindGroupDesc.entries = entries;
+    horde.bindGroups[k] = wgpuDeviceCreateBindGroup(device, &bindGroupDesc);
+    if (!horde.bindGroups[k]) {
+      std::cerr << "Failed to create horde bind group!" << std::endl;
+      releaseGpuHorde(horde);
+      return false;
+    }
+  }
+
+  // 4. Pozycje startowe (jedyny transfer agentów CPU → GPU)
+  std::vector<GpuAgent> agents(horde.agentCount);
+  uint32_t seed = 0x9E3779B9u;
+  auto nextRandom = [&seed]() {
+    seed = seed * 1664525u + 1013904223u;
+    return float(seed >> 8) / float(1u << 24);
+  };
+  for (GpuAgent &agent : agents) {
+    agent.position[0] = nextRandom() * settings.worldWidth;
+    agent.position[1] = nextRandom() * settings.worldHeight;
+    agent.size = 5.0f + nextRandom() * 6.0f;
+    agent.tint = packColor(255, uint8_t(96 + nextRandom() * 96), 32);
+  }
+  WGPUQueue queue = wgpuDeviceGetQueue(device);
+  wgpuQueueWriteBuffer(queue, horde.agentBuffers[0], 0, agents.data(),
+                       agentBytes);
+  wgpuQueueRelease(queue);
+  horde.current = 0;
+
+  std::cout << "GPU horde created (" << horde.agentCount << " agents, grid "
+            << horde.gridWidth << "x" << horde.gridHeight << ")."
+            << std::endl;
+  return true;
+}
+
+void releaseGpuHorde(GpuHorde &horde) {
+  for (WGPUBindGroup bindGroup : horde.bindGroups)
+    if (bindGroup)
+      wgpuBindGroupRelease(bindGroup);
+  const WGPUBuffer buffers[] = {horde.instanceBuffer,  horde.sortedBuffer,
+                                horde.cellBuffer,      horde.agentCellBuffer,
+                                horde.agentBuffers[1], horde.agentBuffers[0],
+                                horde.paramsBuffer};
+  for (WGPUBuffer buffer : buffers)
+    if (buffer)
+      wgpuBufferRelease(buffer);
+  horde = {};
+}
+
+// ============================================================
+//  Klatka
+// ============================================================
+
+void gpuHordePrepare(WGPUQueue queue, GpuHorde &horde, float playerX,
+                     float playerY, float tickSeconds, uint32_t ticks) {
+  const GpuHordeSettings &settings = horde.settings;
+  HordeParams params = {};
+  params.player[0] = playerX;
+  params.player[1] = playerY;
+  params.dt = tickSeconds;
+  params.speed = settings.speed;
+  params.worldMin[0] = -kWorldMargin;
+  params.worldMin[1] = -kWorldMargin;
+  params.cellSize = horde.cellSize;
+  params.radius = settings.radius;
+  params.gridSize[0] = horde.gridWidth;
+  params.gridSize[1] = horde.gridHeight;
+  params.agentCount = horde.agentCount;
+  params.strength = settings.strength;
+  params.worldMax[0] = settings.worldWidth + kWorldMargin;
+  params.worldMax[1] = settings.worldHeight + kWorldMargin;
+  params.killRadius = settings.killRadius;
+  params.seed = horde.frameIndex++ * 2246822519u;
+  params.deathBurst = settings.deathBurst;
+  params.atlasFrame = settings.atlasFrame;
+  wgpuQueueWriteBuffer(queue, horde.paramsBuffer, 0, &params, sizeof(params));
+  horde.ticks = ticks;
+}
+
+void gpuHordeEncode(WGPUCommandEncoder encoder, GpuHorde &horde,
+                    const WGPUComputePassTimestampWrites *timestampWrites) {
+  if (horde.ticks == 0)
+    return;
+
+  WGPUComputePassDescriptor passDesc = {};
+  passDesc.nextInChain = nullptr;
+  passDesc.label = "Horde Pass";
+  passDesc.timestampWrites = timestampWrites;
+  WGPUComputePassEncoder pass =
+      wgpuCommandEncoderBeginComputePass(encoder, &passDesc);
+
+  const uint32_t agentGroups = (horde.agentCount + 63) / 64;
+  const uint32_t cellGroups = (horde.gridWidth * horde.gridHeight + 63) / 64;
+  // Ticki stałego kroku tej klatki (parametry wspólne, pozycje ping-pong)
+  for (uint32_t tick = 0; tick < horde.ticks; ++tick) {
+    wgpuComputePassEncoderSetBindGroup(pass, 0, horde.bindGroups[horde.current],
+                                       0, nullptr);
+    wgpuComputePassEncoderSetPipeline(pass, horde.clearPipeline);
+    wgpuComputePassEncoderDispatchWorkgroups(pass, cellGroups, 1, 1);
+    wgpuComputePassEncoderSetPipeline(pass, horde.countPipeline);
+    wgpuComputePassEncoderDispatchWorkgroups(pass, agentGroups, 1, 1);
+    wgpuComputePassEncoderSetPipeline(pass, horde.scanPipeline);
+    wgpuComputePassEncoderDispatchWorkgroups(pass, 1, 1, 1);
+    wgpuComputePassEncoderSetPipeline(pass, horde.scatterPipeline);
+    wgpuComputePassEncoderDispatchWorkgroups(pass, agentGroups, 1, 1);
+    wgpuComputePassEncoderSetPipeline(pass, horde.steerPipeline);
+    wgpuComputePassEncoderDispatchWorkgroups(pass, agentGroups, 1, 1);
+    horde.current = 1 - horde.current;
+  }
+
+  wgpuComputePassEncoderEnd(pass);
+  wgpuComputePassEncoderRelease(pass);
+}
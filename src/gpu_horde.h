@@ -0,0 +1,73 @@
+#pragma once
+
+#include <cstdint>
+#include <webgpu/webgpu.h>
+
+class PipelineCache;
+struct GpuParticles;
+
+// Agent hordy w buforze storage (16 B)
+struct GpuAgent {
+  float position[2];
+  float size;
+  uint32_t tint;
+};
+static_assert(sizeof(GpuAgent) == 16, "GpuAgent layout");
+
+struct GpuHordeSettings {
+  float worldWidth = 800.0f;  // siatka pokrywa [0, width] x [0, height]
+  float worldHeight = 600.0f; // (+ margines), poza nią agenci są
+                              // przypisani do skrajnych komórek
+  float speed = 60.0f;        // prędkość pościgu (px/s)
+  float radius = 12.0f;       // promień separacji (<= rozmiar komórki)
+  float strength = 0.5f;      // siła rozpychania
+  float killRadius = 24.0f;   // dotknięcie gracza: wybuch i odrodzenie
+  uint32_t deathBurst = 48;   // cząsteczki na śmierć (0 = bez wybuchu)
+  uint32_t atlasFrame = 0;
+};
+
+// Horda wrogów w całości na GPU: w każdym ticku compute pass buduje siatkę
+// (zliczanie + skan + rozrzut indeksów), a potem jeden wątek na agenta
+// liczy pościg za graczem, separację z sąsiadami z 3x3 komórek, zapisuje
+// nową pozycję i instancję sprite'a. Agent, który dotknie gracza, wybucha
+// cząsteczkami (appendBurst do GpuParticles) i odradza się na krawędzi.
+// Pozycje są w dwóch buforach na zmianę — odczyt sąsiadów nie ściga się
+// z zapisem.
+struct GpuHorde {
+  WGPUDevice device = nullptr;
+  GpuHordeSettings settings;
+  uint32_t agentCount = 0;
+  uint32_t gridWidth = 0;
+  uint32_t gridHeight = 0;
+  float cellSize = 16.0f;
+  WGPUBuffer paramsBuffer = nullptr;   // Uniform
+  WGPUBuffer agentBuffers[2] = {};     // GpuAgent[agentCount] (ping-pong)
+  WGPUBuffer agentCellBuffer = nullptr; // (komórka, pozycja w komórce)
+  WGPUBuffer cellBuffer = nullptr;      // liczniki komórek + początki
+  WGPUBuffer sortedBuffer = nullptr;    // indeksy agentów wg komórek
+  WGPUBuffer instanceBuffer = nullptr;  // SpriteInstance[agentCount]
+  WGPUBindGroup bindGroups[2] = {};     // [0]: 0 → 1, [1]: 1 → 0
+  uint32_t current = 0; // bufor z aktualnymi pozycjami
+  // Z PipelineCache, nie posiadane
+  WGPUComputePipeline clearPipeline = nullptr;
+  WGPUComputePipeline countPipeline = nullptr;
+  WGPUComputePipeline scanPipeline = nullptr;
+  WGPUComputePipeline scatterPipeline = nullptr;
+  WGPUComputePipeline steerPipeline = nullptr;
+  uint32_t ticks = 0; // ticki do zakodowania w bieżącej klatce
+  uint32_t frameIndex = 0;
+};
+
+// Agenci startują w losowych punktach świata (deterministyczny seed).
+// Wybuchy śmierci trafiają do particles (musi żyć dłużej niż horda).
+bool createGpuHorde(WGPUDevice device, PipelineCache &pipelines,
+                    GpuParticles &particles, uint32_t agentCount,
+                    const GpuHordeSettings &settings, GpuHorde &horde);
+void releaseGpuHorde(GpuHorde &horde);
+
+// Parametry klatki: pozycja gracza i liczba ticków stałego kroku
+void gpuHordePrepare(WGPUQueue queue, GpuHorde &horde, float playerX,
+                     float playerY, float tickSeconds, uint32_t ticks);
+// Compute pass z ticks krokami symulacji (przed gpuParticlesEncode)
+void gpuHordeEncode(WGPUCommandEncoder encoder, GpuHorde &horde,
+                    const WGPUComputePassTimestampWrites *timestampWrites);
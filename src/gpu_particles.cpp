@@ -0,0 +1,388 @@
+#include "gpu_particles.h"
+
+#include <algorithm>
+#include <iostream>
+
+#include "pipeline_cache.h"
+#include "sprite_batch.h"
+
+// ============================================================
+//  WGSL
+// ============================================================
+
+static const char *particleCommonSource = R"(
+// Wybuch: pozycja, prędkość, rozmiar, liczba i pierwszy slot pierścienia
+struct Burst {
+    position: vec2f,
+    speed: f32,
+    size: f32,
+    count: u32,
+    first: u32,
+    color: u32,
+    life: f32,
+};
+
+// burstCount zeruje CPU co klatkę, head (następny slot) rośnie stale
+struct Events {
+    burstCount: atomic<u32>,
+    head: atomic<u32>,
+    _pad0: u32,
+    _pad1: u32,
+    bursts: array<Burst, 64>,
+};
+
+// Układ SpriteInstance (28 B) — same skalary, bez wyrównania vec2
+struct Instance {
+    x: f32,
+    y: f32,
+    scaleX: f32,
+    scaleY: f32,
+    rotation: f32,
+    atlasIndex: u32,
+    tint: u32,
+};
+
+fn hash(x: u32) -> u32 {
+    let state = x * 747796405u + 2891336453u;
+    let word = ((state >> ((state >> 28u) + 4u)) ^ state) * 277803737u;
+    return (word >> 22u) ^ word;
+}
+
+fn appendBurst(burst: Burst) {
+    let index = atomicAdd(&events.burstCount, 1u);
+    if (index >= 64u) {
+        return;
+    }
+    var stored = burst;
+    stored.first = atomicAdd(&events.head, burst.count);
+    events.bursts[index] = stored;
+}
+)";
+
+static const char *particleShaderSource = R"(
+struct Params {
+    dt: f32,
+    seed: u32,
+    capacity: u32,
+    cpuBurstCount: u32,
+    drag: f32,
+    atlasFrame: u32,
+    _pad0: u32,
+    _pad1: u32,
+};
+
+struct Particle {
+    position: vec2f,
+    velocity: vec2f,
+    life: f32,
+    maxLife: f32,
+    size: f32,
+    color: u32,
+};
+
+@group(0) @binding(0) var<uniform> params: Params;
+@group(0) @binding(1) var<storage, read_write> particles: array<Particle>;
+@group(0) @binding(2) var<storage, read_write> events: Events;
+@group(0) @binding(3) var<storage, read_write> instances: array<Instance>;
+
+// 1. Sloty pierścienia dla wybuchów zgłoszonych przez CPU
+@compute @workgroup_size(64)
+fn cs_allocate(@builtin(global_invocation_id) id: vec3u) {
+    if (id.x >= params.cpuBurstCount) {
+        return;
+    }
+    events.bursts[id.x].first = atomicAdd(&events.head, events.bursts[id.x].count);
+}
+
+// 2. Emisja: x = cząsteczka wybuchu, y = indeks wybuchu
+@compute @workgroup_size(64)
+fn cs_emit(@builtin(global_invocation_id) id: vec3u) {
+    if (id.y >= min(atomicLoad(&events.burstCount), 64u)) {
+        return;
+    }
+    let burst = events.bursts[id.y];
+    if (id.x >= burst.count) {
+        return;
+    }
+    let h = hash(params.seed ^ hash(id.y * 65537u + id.x));
+    let angle = f32(h & 0xffffu) / 65535.0 * 6.2831853;
+    let speed = burst.speed * (0.25 + 0.75 * f32(h >> 16u) / 65535.0);
+
+    var p: Particle;
+    p.position = burst.position;
+    p.velocity = vec2f(cos(angle), sin(angle)) * speed;
+    p.maxLife = burst.life * (0.5 + 0.5 * f32(hash(h) & 0xffffu) / 65535.0);
+    p.life = p.maxLife;
+    p.size = burst.size;
+    p.color = burst.color;
+    particles[(burst.first + id.x) % params.capacity] = p;
+}
+
+// 3. Symulacja i instancje (martwa cząsteczka = quad o skali 0)
+@compute @workgroup_size(64)
+fn cs_update(@builtin(global_invocation_id) id: vec3u) {
+    let i = id.x;
+    if (i >= params.capacity) {
+        return;
+    }
+    var p = particles[i];
+    if (p.life > 0.0) {
+        p.velocity *= max(1.0 - params.drag * params.dt, 0.0);
+        p.position += p.velocity * params.dt;
+        p.life -= params.dt;
+        particles[i] = p;
+    }
+
+    let t = clamp(p.life / max(p.maxLife, 1e-4), 0.0, 1.0);
+    var color = unpack4x8unorm(p.color);
+    color.a *= t;
+
+    var sprite: Instance;
+    sprite.x = p.position.x;
+    sprite.y = p.position.y;
+    sprite.scaleX = p.size * t;
+    sprite.scaleY = p.size * t;
+    sprite.rotation = 0.0;
+    sprite.atlasIndex = params.atlasFrame;
+    sprite.tint = pack4x8unorm(color);
+    instances[i] = sprite;
+}
+)";
+
+// Uniform z parametrami klatki (32 B)
+struct ParticleParams {
+  float dt;
+  uint32_t seed;
+  uint32_t capacity;
+  uint32_t cpuBurstCount;
+  float drag;
+  uint32_t atlasFrame;
+  uint32_t padding[2];
+};
+
+// Nagłówek bufora zdarzeń (przed tablicą wybuchów)
+struct ParticleEventHeader {
+  uint32_t burstCount;
+  uint32_t head;
+  uint32_t padding[2];
+};
+
+struct GpuParticle {
+  float position[2];
+  float velocity[2];
+  float life;
+  float maxLife;
+  float size;
+  uint32_t color;
+};
+
+const std::string &particleEventsWgsl() {
+  static const std::string source = particleCommonSource;
+  return source;
+}
+
+// ============================================================
+//  Tworzenie
+// ============================================================
+
+static WGPUBuffer createBuffer(WGPUDevice device, const char *label,
+                               WGPUBufferUsageFlags usage, uint64_t size) {
+  WGPUBufferDescriptor desc = {};
+  desc.nextInChain = nullptr;
+  desc.label = label;
+  desc.usage = usage;
+  desc.size = size;
+  desc.mappedAtCreation = false;
+  return wgpuDeviceCreateBuffer(device, &desc);
+}
+
+bool createGpuParticles(WGPUDevice device, PipelineCache &pipelines,
+                        uint32_t capacity, GpuParticles &particles) {
+  // Limit wymiaru dispatchu: 65535 workgroup po 64 wątki
+  particles.device = device;
+  particles.capacity = std::clamp(capacity, 64u, 65535u * 64u);
+
+  // 1. Bufory (WebGPU zeruje je przy tworzeniu — wszystkie cząsteczki martwe)
+  const uint64_t eventBytes = sizeof(ParticleEventHeader) +
+                              kMaxParticleBursts * sizeof(ParticleBurst);
+  particles.paramsBuffer =
+      createBuffer(device, "Particle Params",
+                   WGPUBufferUsage_Uniform | WGPUBufferUsage_CopyDst,
+                   sizeof(ParticleParams));
+  particles.particleBuffer =
+      createBuffer(device, "Particles", WGPUBufferUsage_Storage,
+                   uint64_t(particles.capacity) * sizeof(GpuParticle));
+  particles.eventBuffer =
+      createBuffer(device, "Particle Events",
+                   WGPUBufferUsage_Storage | WGPUBufferUsage_CopyDst,
+                   eventBytes);
+  particles.instanceBuffer =
+      createBuffer(device, "Particle Instances",
+                   WGPUBufferUsage_Storage | WGPUBufferUsage_Vertex,
+                   uint64_t(particles.capacity) * sizeof(SpriteInstance));
+
+  // 2. Layout i pipeline'y (wspólny shader module, trzy entry pointy)
+  BindGroupLayoutDesc layoutDesc;
+  layoutDesc.label = "Particle Bind Group Layout";
+  layoutDesc.entries = {
+      BindingDesc::buffer(0, WGPUShaderStage_Compute,
+                          WGPUBufferBindingType_Uniform,
+                          sizeof(ParticleParams)),
+      BindingDesc::buffer(1, WGPUShaderStage_Compute,
+                          WGPUBufferBindingType_Storage, sizeof(GpuParticle)),
+      BindingDesc::buffer(2, WGPUShaderStage_Compute,
+                          WGPUBufferBindingType_Storage, eventBytes),
+      BindingDesc::buffer(3, WGPUShaderStage_Compute,
+                          WGPUBufferBindingType_Storage,
+                          sizeof(SpriteInstance)),
+  };
+  ComputePipelineDesc pipelineDesc;
+  pipelineDesc.label = "Particle Pipeline";
+  pipelineDesc.shaderSource =
+      std::string(particleCommonSource) + particleShaderSource;
+  pipelineDesc.bindGroups = {layoutDesc};
+  pipelineDesc.entryPoint = "cs_allocate";
+  particles.allocatePipeline = pipelines.computePipeline(pipelineDesc);
+  pipelineDesc.entryPoint = "cs_emit";
+  particles.emitPipeline = pipelines.computePipeline(pipelineDesc);
+  pipelineDesc.entryPoint = "cs_update";
+  particles.updatePipeline = pipelines.computePipeline(pipelineDesc);
+  WGPUBindGroupLayout layout = pipelines.bindGroupLayout(layoutDesc);
+
+  if (!particles.paramsBuffer || !particles.particleBuffer ||
+      !particles.eventBuffer || !particles.instanceBuffer || !layout ||
+      !particles.allocatePipeline || !particles.emitPipeline ||
+      !particles.updatePipeline) {
+    std::cerr << "Failed to create GPU particles!" << std::endl;
+    releaseGpuParticles(particles);
+    return false;
+  }
+
+  // 3. Bind group
+  WGPUBindGroupEntry entries[4] = {};
+  entries[0].binding = 0;
+  entries[0].buffer = particles.paramsBuffer;
+  entries[0].size = sizeof(ParticleParams);
+  entries[1].binding = 1;
+  entries[1].buffer = particles.particleBuffer;
+  entries[1].size = uint64_t(particles.capacity) * sizeof(GpuParticle);
+  entries[2].binding = 2;
+  entries[2].buffer = particles.eventBuffer;
+  entries[2].size = eventBytes;
+  entries[3].binding = 3;
+  entries[3].buffer = particles.instanceBuffer;
+  entries[3].size = uint64_t(particles.capacity) * sizeof(SpriteInstance);
+
+  WGPUBindGroupDescriptor bindGroupDesc = {};
+  bindGroupDesc.nextInChain = nullptr;
+  bindGroupDesc.label = "Particle Bind Group";
+  bindGroupDesc.layout = layout;
+  bindGroupDesc.entryCount = 4;
+  bindGroupDesc.entries = entries;
+  particles.bindGroup = wgpuDeviceCreateBindGroup(device, &bindGroupDesc);
+  if (!particles.bindGroup) {
+    std::cerr << "Failed to create particle bind group!" << std::endl;
+    releaseGpuParticles(particles);
+    return false;
+  }
+
+  std::cout << "GPU particles created (capacity " << particles.capacity
+            << ")." << std::endl;
+  return true;
+}
+
+void releaseGpuParticles(GpuParticles &particles) {
+  if (particles.bindGroup)
+    wgpuBindGroupRelease(particles.bindGroup);
+  if (particles.instanceBuffer)
+    wgpuBufferRelease(particles.instanceBuffer);
+  if (particles.eventBuffer)
+    wgpuBufferRelease(particles.eventBuffer);
+  if (particles.particleBuffer)
+    wgpuBufferRelease(particles.particleBuffer);
+  if (particles.paramsBuffer)
+    wgpuBufferRelease(particles.paramsBuffer);
+  particles = {};
+}
+
+// ============================================================
+//  Klatka
+// ============================================================
+
+void gpuParticlesBurst(GpuParticles &particles, float x, float y,
+                       uint32_t count, uint32_t color, float speed,
+                       float life, float size) {
+  ParticleBurst burst = {};
+  burst.position[0] = x;
+  burst.position[1] = y;
+  burst.speed = speed;
+  burst.size = size;
+  burst.count = std::min(count, particles.capacity);
+  burst.color = color;
+  burst.life = life;
+  particles.pendingBursts.push_back(burst);
+}
+
+void gpuParticlesPrepare(WGPUQueue queue, GpuParticles &particles, float dt) {
+  // Wybuchy CPU ponad limit klatki czekają na następną
+  const uint32_t cpuBursts = std::min(
+      uint32_t(particles.pendingBursts.size()), kMaxParticleBursts);
+  uint32_t largestBurst = particles.gpuBurstSize;
+  for (uint32_t i = 0; i < cpuBursts; ++i)
+    largestBurst = std::max(largestBurst, particles.pendingBursts[i].count);
+
+  // Nagłówek: tylko burstCount — head żyje na GPU między klatkami
+  const uint32_t burstCount = cpuBursts;
+  wgpuQueueWriteBuffer(queue, particles.eventBuffer, 0, &burstCount,
+                       sizeof(burstCount));
+  if (cpuBursts > 0) {
+    wgpuQueueWriteBuffer(queue, particles.eventBuffer,
+                         sizeof(ParticleEventHeader),
+                         particles.pendingBursts.data(),
+                         cpuBursts * sizeof(ParticleBurst));
+    particles.pendingBursts.erase(particles.pendingBursts.begin(),
+                                  particles.pendingBursts.begin() + cpuBursts);
+  }
+
+  ParticleParams params = {};
+  params.dt = dt;
+  params.seed = particles.frameIndex++ * 2654435761u;
+  params.capacity = particles.capacity;
+  params.cpuBurstCount = cpuBursts;
+  params.drag = particles.drag;
+  params.atlasFrame = particles.atlasFrame;
+  wgpuQueueWriteBuffer(queue, particles.paramsBuffer, 0, &params,
+                       sizeof(params));
+
+  particles.cpuBurstCount = cpuBursts;
+  particles.emitDispatchX = (largestBurst + 63) / 64;
+}
+
+void gpuParticlesEncode(WGPUCommandEncoder encoder,
+                        const GpuParticles &particles,
+                        const WGPUComputePassTimestampWrites *timestampWrites) {
+  WGPUComputePassDescriptor passDesc = {};
+  passDesc.nextInChain = nullptr;
+  passDesc.label = "Particle Pass";
+  passDesc.timestampWrites = timestampWrites;
+  WGPUComputePassEncoder pass =
+      wgpuCommandEncoderBeginComputePass(encoder, &passDesc);
+  wgpuComputePassEncoderSetBindGroup(pass, 0, particles.bindGroup, 0, nullptr);
+
+  // Kolejne dispatche w passie widzą zapisy poprzednich
+  if (particles.cpuBurstCount > 0) {
+    wgpuComputePassEncoderSetPipeline(pass, particles.allocatePipeline);
+    wgpuComputePassEncoderDispatchWorkgroups(pass, 1, 1, 1);
+  }
+  if (particles.emitDispatchX > 0) {
+    wgpuComputePassEncoderSetPipeline(pass, particles.emitPipeline);
+    wgpuComputePassEncoderDispatchWorkgroups(pass, particles.emitDispatchX,
+                                             kMaxParticleBursts, 1);
+  }
+  wgpuComputePassEncoderSetPipeline(pass, particles.updatePipeline);
+  wgpuComputePassEncoderDispatchWorkgroups(pass, (particles.capacity + 63) / 64,
+                                           1, 1);
+
+  wgpuComputePassEncoderEnd(pass);
+  wgpuComputePassEncoderRelease(pass);
+}
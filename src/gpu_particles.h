@@ -0,0 +1,74 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <webgpu/webgpu.h>
+
+class PipelineCache;
+
+// ============================================================
+//  Cząsteczki na GPU
+// ============================================================
+
+constexpr uint32_t kMaxParticleBursts = 64; // wybuchy na klatkę (CPU + GPU)
+
+// Wybuch cząsteczek (32 B) — ten sam układ co struct Burst w WGSL
+struct ParticleBurst {
+  float position[2];
+  float speed;    // maksymalna prędkość początkowa (px/s)
+  float size;     // rozmiar cząsteczki (px)
+  uint32_t count; // liczba cząsteczek
+  uint32_t first; // pozycja w pierścieniu — przydzielana na GPU
+  uint32_t color; // RGBA8 jak SpriteInstance::tint
+  float life;     // czas życia (s)
+};
+static_assert(sizeof(ParticleBurst) == 32, "ParticleBurst layout");
+
+// Pierścień cząsteczek symulowany w compute shaderach. Wybuchy zgłasza CPU
+// (gpuParticlesBurst) albo inne shadery (appendBurst w WGSL, np. śmierć
+// wroga w GpuHorde); cząsteczki dostają kolejne sloty pierścienia, więc
+// najstarsze są nadpisywane. Update zapisuje SpriteInstance[] prosto do
+// bufora czytanego przez vertex shader — bez odczytu na CPU.
+struct GpuParticles {
+  WGPUDevice device = nullptr;
+  uint32_t capacity = 0;
+  uint32_t atlasFrame = 0;  // klatka atlasu rysowana dla każdej cząsteczki
+  float drag = 2.0f;        // wytracanie prędkości (1/s)
+  uint32_t gpuBurstSize = 0; // największy wybuch zgłaszany przez shadery
+  WGPUBuffer paramsBuffer = nullptr;   // Uniform
+  WGPUBuffer particleBuffer = nullptr; // Particle[capacity]
+  WGPUBuffer eventBuffer = nullptr;    // nagłówek + ParticleBurst[64]
+  WGPUBuffer instanceBuffer = nullptr; // SpriteInstance[capacity] (Vertex)
+  WGPUBindGroup bindGroup = nullptr;
+  // Z PipelineCache, nie posiadane
+  WGPUComputePipeline allocatePipeline = nullptr;
+  WGPUComputePipeline emitPipeline = nullptr;
+  WGPUComputePipeline updatePipeline = nullptr;
+  std::vector<ParticleBurst> pendingBursts; // zgłoszone przez CPU
+  uint32_t cpuBurstCount = 0;  // wysłane w bieżącej klatce
+  uint32_t emitDispatchX = 0;  // workgroupy na wybuch w bieżącej klatce
+  uint32_t frameIndex = 0;
+};
+
+bool createGpuParticles(WGPUDevice device, PipelineCache &pipelines,
+                        uint32_t capacity, GpuParticles &particles);
+void releaseGpuParticles(GpuParticles &particles);
+
+// Zgłasza wybuch z CPU (trafi na GPU w najbliższym gpuParticlesPrepare)
+void gpuParticlesBurst(GpuParticles &particles, float x, float y,
+                       uint32_t count, uint32_t color, float speed = 240.0f,
+                       float life = 0.8f, float size = 4.0f);
+
+// Zapisuje parametry klatki i wybuchy CPU do buforów (przed submit)
+void gpuParticlesPrepare(WGPUQueue queue, GpuParticles &particles, float dt);
+// Compute pass: przydział slotów, emisja, symulacja i zapis instancji.
+// Musi być zakodowany po passach, które zgłaszają wybuchy z GPU.
+void gpuParticlesEncode(WGPUCommandEncoder encoder,
+                        const GpuParticles &particles,
+                        const WGPUComputePassTimestampWrites *timestampWrites);
+
+// Deklaracje WGSL dla shaderów zgłaszających wybuchy: struct Burst,
+// Events, Instance, hash() i appendBurst(). Shader musi sam zadeklarować
+// `events: Events` jako storage read_write (bufor GpuParticles::eventBuffer).
+const std::string &particleEventsWgsl();
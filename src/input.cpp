@@ -0,0 +1,153 @@
+#include "input.h"
+
+#include <GLFW/glfw3.h>
+
+#include "profiler.h"
+
+bool InputState::keyHeld(int key) const {
+  if (key < 0 || uint32_t(key) >= kInputKeyCount)
+    return false;
+  return keysDown[size_t(key)] || keysPressed[size_t(key)];
+}
+
+bool InputState::keyPressed(int key) const {
+  if (key < 0 || uint32_t(key) >= kInputKeyCount)
+    return false;
+  return keysPressed[size_t(key)];
+}
+
+// ============================================================
+//  Callbacki GLFW (wątek główny)
+// ============================================================
+
+static InputSystem *inputFromWindow(GLFWwindow *window) {
+  return static_cast<InputSystem *>(glfwGetWindowUserPointer(window));
+}
+
+static void keyCallback(GLFWwindow *window, int key, int, int action, int) {
+  // Autopowtarzanie nie zmienia stanu klawisza
+  if (key == GLFW_KEY_UNKNOWN || action == GLFW_REPEAT)
+    return;
+  InputEvent event;
+  event.timeNs = profilerNowNs();
+  event.type = action == GLFW_PRESS ? InputEventType::KeyDown
+                                    : InputEventType::KeyUp;
+  event.code = key;
+  inputFromWindow(window)->push(event);
+}
+
+static void mouseButtonCallback(GLFWwindow *window, int button, int action,
+                                int) {
+  InputEvent event;
+  event.timeNs = profilerNowNs();
+  event.type = action == GLFW_PRESS ? InputEventType::ButtonDown
+                                    : InputEventType::ButtonUp;
+  event.code = button;
+  inputFromWindow(window)->push(event);
+}
+
+static void cursorPosCallback(GLFWwindow *window, double x, double y) {
+  InputEvent event;
+  event.timeNs = profilerNowNs();
+  event.type = InputEventType::MouseMove;
+  event.x = float(x);
+  event.y = float(y);
+  inputFromWindow(window)->push(event);
+}
+
+// ============================================================
+//  InputSystem
+// ============================================================
+
+InputSystem::~InputSystem() { detach(); }
+
+void InputSystem::attach(GLFWwindow *window) {
+  detach();
+  m_window = window;
+  // Próbki bez alokacji w trakcie gry (aż do pełnej kolejki na klatkę)
+  m_unpresented.reserve(kQueueCapacity);
+  m_latencyMs.reserve(kLatencyWindow);
+  glfwSetWindowUserPointer(window, this);
+  glfwSetKeyCallback(window, keyCallback);
+  glfwSetMouseButtonCallback(window, mouseButtonCallback);
+  glfwSetCursorPosCallback(window, cursorPosCallback);
+}
+
+void InputSystem::detach() {
+  if (!m_window)
+    return;
+  glfwSetKeyCallback(m_window, nullptr);
+  glfwSetMouseButtonCallback(m_window, nullptr);
+  glfwSetCursorPosCallback(m_window, nullptr);
+  glfwSetWindowUserPointer(m_window, nullptr);
+  m_window = nullptr;
+}
+
+bool InputSystem::push(const InputEvent &event) {
+  ++m_stats.events;
+  // Ruch kursora przy prawie pełnej kolejce przepada pierwszy: zostaje
+  // miejsce na puszczenie klawisza, a pozycję poprawi następny ruch
+  const bool reserved = event.type == InputEventType::MouseMove &&
+                        m_events.size() >= kQueueCapacity - kQueueReserve;
+  if (reserved || !m_events.push(event)) {
+    ++m_stats.droppedEvents;
+    return false;
+  }
+  return true;
+}
+
+const InputState &InputSystem::advance(uint64_t untilNs) {
+  m_state.keysPressed.reset();
+  m_state.buttonsPressed.reset();
+  // Zdarzenia późniejsze niż koniec ticku czekają na następny tick
+  for (const InputEvent *event = m_events.front();
+       event && event->timeNs <= untilNs; event = m_events.front()) {
+    const size_t code = size_t(uint32_t(event->code));
+    switch (event->type) {
+    case InputEventType::KeyDown:
+    case InputEventType::KeyUp:
+      if (code < kInputKeyCount) {
+        const bool down = event->type == InputEventType::KeyDown;
+        m_state.keysDown[code] = down;
+        if (down)
+          m_state.keysPressed[code] = true;
+        m_unpresented.push_back(event->timeNs);
+      }
+      break;
+    case InputEventType::ButtonDown:
+    case InputEventType::ButtonUp:
+      if (code < kInputButtonCount) {
+        const bool down = event->type == InputEventType::ButtonDown;
+        m_state.buttonsDown[code] = down;
+        if (down)
+          m_state.buttonsPressed[code] = true;
+        m_unpresented.push_back(event->timeNs);
+      }
+      break;
+    case InputEventType::MouseMove:
+      m_state.mouseX = event->x;
+      m_state.mouseY = event->y;
+      break;
+    }
+    m_events.pop();
+  }
+  return m_state;
+}
+
+void InputSystem::framePresented(uint64_t presentNs) {
+  for (uint64_t eventNs : m_unpresented) {
+    const double latencyMs = double(presentNs - eventNs) * 1e-6;
+    if (m_latencyMs.size() < kLatencyWindow) {
+      m_latencyMs.push_back(latencyMs);
+    } else {
+      m_latencyMs[m_latencyNext] = latencyMs;
+      m_latencyNext = (m_latencyNext + 1) % kLatencyWindow;
+    }
+  }
+  m_stats.presentedEvents += m_unpresented.size();
+  m_unpresented.clear();
+}
+
+FrameTimeSummary InputSystem::latencySummary() const {
+  return summarizeFrameTimes(m_latencyMs);
+}
@@ -0,0 +1,109 @@
+#pragma once
+
+#include <bitset>
+#include <cstdint>
+#include <vector>
+
+#include "bench_report.h"
+#include "spsc_ring.h"
+
+struct GLFWwindow;
+
+// ============================================================
+//  Wejście
+// ============================================================
+
+constexpr uint32_t kInputKeyCount = 512; // kody klawiszy GLFW (< 512)
+constexpr uint32_t kInputButtonCount = 8;
+
+enum class InputEventType : uint8_t {
+  KeyDown,
+  KeyUp,
+  ButtonDown,
+  ButtonUp,
+  MouseMove,
+};
+
+// Zdarzenie z callbacku GLFW ze znacznikiem czasu (profilerNowNs)
+struct InputEvent {
+  uint64_t timeNs = 0;
+  InputEventType type = InputEventType::KeyDown;
+  int32_t code = 0; // klawisz / przycisk GLFW
+  float x = 0.0f;   // kursor w pikselach okna (MouseMove)
+  float y = 0.0f;
+};
+
+// Stan wejścia widziany przez jeden tick symulacji
+struct InputState {
+  std::bitset<kInputKeyCount> keysDown;    // wciśnięte na końcu ticku
+  std::bitset<kInputKeyCount> keysPressed; // wciśnięte w trakcie ticku
+  std::bitset<kInputButtonCount> buttonsDown;
+  std::bitset<kInputButtonCount> buttonsPressed;
+  float mouseX = 0.0f;
+  float mouseY = 0.0f;
+
+  // Trzymany albo choć na chwilę wciśnięty w tym ticku — szybkie
+  // stuknięcie między klatkami też porusza postacią
+  bool keyHeld(int key) const;
+  // Zbocze wciśnięcia w tym ticku
+  bool keyPressed(int key) const;
+};
+
+struct InputStats {
+  uint64_t events = 0;        // zdarzenia odebrane z callbacków
+  uint64_t droppedEvents = 0; // pełna kolejka (najpierw MouseMove)
+  uint64_t presentedEvents = 0; // zdarzenia z pomiarem opóźnienia
+};
+
+// Zdarzenia klawiatury i myszy trafiają z callbacków GLFW (wątek główny,
+// w glfwPollEvents) do kolejki SPSC ze znacznikiem czasu, a symulacja w
+// stałym kroku (wątek puli) zdejmuje w każdym ticku zdarzenia do jego
+// końca. Wejście nie jest więc próbkowane raz na klatkę: wciśnięcie i
+// puszczenie klawisza między klatkami nie ginie, a kolejne ticki tej
+// samej klatki widzą zdarzenia w kolejności ich czasu.
+//
+// Opóźnienie wejścia: czas od zdarzenia (zmiana klawisza / przycisku)
+// do prezentacji klatki, której ticki je zużyły. advance() i
+// framePresented() nie mogą działać równocześnie (symulacja kończy się
+// przed prezentacją klatki). Rozkład liczony jest z ostatnich
+// kLatencyWindow próbek — pamięć nie rośnie z długością sesji.
+class InputSystem {
+public:
+  InputSystem() = default;
+  ~InputSystem();
+  InputSystem(const InputSystem &) = delete;
+  InputSystem &operator=(const InputSystem &) = delete;
+
+  // Podpina callbacki klawiatury i myszy (user pointer okna)
+  void attach(GLFWwindow *window);
+  void detach();
+
+  // Producent (callbacki). false, gdy kolejka jest pełna. MouseMove nie
+  // zajmuje ostatnich kQueueReserve miejsc — zgubione KeyUp / ButtonUp
+  // zostawiłoby klawisz wciśnięty, a zgubiony ruch nadrabia następny.
+  bool push(const InputEvent &event);
+
+  // Konsument (tick symulacji): stosuje zdarzenia z timeNs <= untilNs
+  const InputState &advance(uint64_t untilNs);
+  const InputState &state() const { return m_state; }
+
+  // Po prezentacji klatki (wątek główny): próbki opóźnienia zdarzeń
+  // zużytych przez jej ticki
+  void framePresented(uint64_t presentNs);
+  // Rozkład opóźnienia wejście → prezentacja (ms, ostatnie próbki)
+  FrameTimeSummary latencySummary() const;
+  const InputStats &stats() const { return m_stats; }
+
+private:
+  static constexpr uint32_t kQueueCapacity = 1024;
+  static constexpr uint32_t kQueueReserve = 256; // tylko klawisze/przyciski
+  static constexpr uint32_t kLatencyWindow = 4096;
+
+  GLFWwindow *m_window = nullptr;
+  SpscRing<InputEvent, kQueueCapacity> m_events;
+  InputState m_state;
+  std::vector<uint64_t> m_unpresented; // czasy zużytych zdarzeń
+  std::vector<double> m_latencyMs; // pierścień ostatnich kLatencyWindow
+  uint32_t m_latencyNext = 0;       // następny slot do nadpisania
+  InputStats m_stats;
+};
@@ -0,0 +1,331 @@
+#include "job_system.h"
+
+#include <algorithm>
+#include <iostream>
+
+#include "memory_arena.h"
+#include "profiler.h"
+
+namespace {
+
+// Indeks wątku w puli (0 = wątek, który utworzył JobSystem)
+thread_local uint32_t t_threadIndex = 0;
+
+// Porcja parallelFor: wspólny opis + licznik niewykonanych porcji
+struct RangeJobContext {
+  const JobSystem::RangeFn *fn;
+  std::atomic<uint32_t> pending;
+};
+
+void executeRange(const Job &job, uint32_t threadIndex) {
+  auto *context =
+      static_cast<RangeJobContext *>(const_cast<void *>(job.context));
+  {
+    WARP_PROFILE_SCOPE("Job Chunk");
+    (*context->fn)(job.begin, job.end, threadIndex);
+  }
+  context->pending.fetch_sub(1, std::memory_order_release);
+}
+
+} // namespace
+
+// ============================================================
+//  WorkStealingDeque
+// ============================================================
+
+bool WorkStealingDeque::push(Job *job) {
+  const int64_t bottom = m_bottom.load(std::memory_order_relaxed);
+  const int64_t top = m_top.load(std::memory_order_acquire);
+  if (bottom - top >= kCapacity)
+    return false;
+  m_jobs[bottom & (kCapacity - 1)].store(job, std::memory_order_release);
+  std::atomic_thread_fence(std::memory_order_release);
+  m_bottom.store(bottom + 1, std::memory_order_relaxed);
+  return true;
+}
+
+Job *WorkStealingDeque::pop() {
+  const int64_t bottom = m_bottom.load(std::memory_order_relaxed) - 1;
+  m_bottom.store(bottom, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  int64_t top = m_top.load(std::memory_order_relaxed);
+
+  if (top > bottom) { // pusta
+    m_bottom.store(bottom + 1, std::memory_order_relaxed);
+    return nullptr;
+  }
+  Job *job = m_jobs[bottom & (kCapacity - 1)].load(std::memory_order_acquire);
+  if (top == bottom) {
+    // Ostatni element — wyścig ze złodziejami rozstrzyga CAS na top
+    if (!m_top.compare_exchange_strong(top, top + 1,
+                                       std::memory_order_seq_cst,
+                                       std::memory_order_relaxed))
+      job = nullptr;
+    m_bottom.store(bottom + 1, std::memory_order_relaxed);
+  }
+  return job;
+}
+
+Job *WorkStealingDeque::steal() {
+  int64_t top = m_top.load(std::memory_order_acquire);
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  const int64_t bottom = m_bottom.load(std::memory_order_acquire);
+  if (top >= bottom)
+    return nullptr;
+  Job *job = m_jobs[top & (kCapacity - 1)].load(std::memory_order_acquire);
+  if (!m_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst,
+                                     std::memory_order_relaxed))
+    return nullptr; // przegrany wyścig z właścicielem lub innym złodziejem
+  return job;
+}
+
+// ============================================================
+//  TaskGraph
+// ============================================================
+
+TaskGraph::TaskId TaskGraph::add(const char *name, TaskFn fn) {
+  Node node;
+  node.name = name;
+  node.fn = std::move(fn);
+  m_nodes.push_back(std::move(node));
+  m_validated = false;
+  return TaskId(m_nodes.size() - 1);
+}
+
+void TaskGraph::depend(TaskId task, TaskId dependency) {
+  m_nodes[dependency].successors.push_back(task);
+  ++m_nodes[task].dependencyCount;
+  m_validated = false;
+}
+
+void TaskGraph::clear() {
+  m_nodes.clear();
+  m_validated = false;
+}
+
+bool TaskGraph::validate() const {
+  std::vector<uint32_t> remaining(m_nodes.size());
+  std::vector<TaskId> ready;
+  for (TaskId i = 0; i < m_nodes.size(); ++i) {
+    remaining[i] = m_nodes[i].dependencyCount;
+    if (remaining[i] == 0)
+      ready.push_back(i);
+  }
+  uint32_t visited = 0;
+  while (!ready.empty()) {
+    const TaskId task = ready.back();
+    ready.pop_back();
+    ++visited;
+    for (TaskId successor : m_nodes[task].successors)
+      if (--remaining[successor] == 0)
+        ready.push_back(successor);
+  }
+  return visited == m_nodes.size();
+}
+
+void TaskGraph::executeNode(const Job &job, uint32_t threadIndex) {
+  auto *graph = static_cast<TaskGraph *>(const_cast<void *>(job.context));
+  const Node &node = graph->m_nodes[job.begin];
+  profilerBeginScope(node.name);
+  node.fn(threadIndex);
+  profilerEndScope();
+
+  // Zwolnij następników, których wszystkie zależności są już spełnione
+  for (TaskId successor : node.successors)
+    if (graph->m_remaining[successor].fetch_sub(
+            1, std::memory_order_acq_rel) == 1)
+      graph->m_jobs->push(&graph->m_nodeJobs[successor]);
+  graph->m_unfinished.fetch_sub(1, std::memory_order_release);
+}
+
+// ============================================================
+//  JobSystem
+// ============================================================
+
+JobSystem::JobSystem(uint32_t workerCount) {
+  if (workerCount == 0) {
+    const uint32_t cores = std::thread::hardware_concurrency();
+    workerCount = cores > 1 ? cores - 1 : 0;
+  }
+  t_threadIndex = 0;
+  m_queues.reserve(workerCount + 1);
+  for (uint32_t i = 0; i <= workerCount; ++i)
+    m_queues.push_back(std::make_unique<WorkStealingDeque>());
+  m_workers.reserve(workerCount);
+  for (uint32_t i = 0; i < workerCount; ++i)
+    m_workers.emplace_back(&JobSystem::workerLoop, this, i + 1);
+}
+
+JobSystem::~JobSystem() {
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_quit = true;
+  }
+  m_wake.notify_all();
+  for (std::thread &worker : m_workers)
+    worker.join();
+}
+
+uint32_t JobSystem::currentThreadIndex() { return t_threadIndex; }
+
+void JobSystem::push(Job *job) {
+  // Licznik przed kolejką — złodziej nie może go zmniejszyć poniżej zera
+  m_queuedJobs.fetch_add(1, std::memory_order_seq_cst);
+  if (!m_queues[currentThreadIndex()]->push(job)) {
+    m_queuedJobs.fetch_sub(1, std::memory_order_relaxed);
+    job->execute(*job, currentThreadIndex()); // kolejka pełna
+    return;
+  }
+  // Budzenie tylko, gdy ktoś śpi — worker przed zaśnięciem zwiększa
+  // m_sleepers i pod mutexem sprawdza m_queuedJobs, więc nie zgubi zadania
+  if (m_sleepers.load(std::memory_order_seq_cst) > 0) {
+    { std::lock_guard<std::mutex> lock(m_mutex); }
+    m_wake.notify_one();
+  }
+}
+
+void JobSystem::submitBackground(Job *job) {
+  if (m_workers.empty()) {
+    job->execute(*job, currentThreadIndex());
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> lock(m_backgroundMutex);
+    m_backgroundJobs.push_back(job);
+    m_backgroundCount.fetch_add(1, std::memory_order_relaxed);
+  }
+  m_queuedJobs.fetch_add(1, std::memory_order_seq_cst);
+  if (m_sleepers.load(std::memory_order_seq_cst) > 0) {
+    { std::lock_guard<std::mutex> lock(m_mutex); }
+    m_wake.notify_one();
+  }
+}
+
+Job *JobSystem::findJob(uint32_t threadIndex, bool allowBackground) {
+  Job *job = m_queues[threadIndex]->pop();
+  if (!job) {
+    const uint32_t queueCount = uint32_t(m_queues.size());
+    for (uint32_t i = 1; i < queueCount && !job; ++i) {
+      job = m_queues[(threadIndex + i) % queueCount]->steal();
+      if (job)
+        m_steals.fetch_add(1, std::memory_order_relaxed);
+    }
+  }
+  if (!job && allowBackground &&
+      m_backgroundCount.load(std::memory_order_relaxed) > 0) {
+    std::lock_guard<std::mutex> lock(m_backgroundMutex);
+    if (m_backgroundHead < m_backgroundJobs.size()) {
+      job = m_backgroundJobs[m_backgroundHead++];
+      m_backgroundCount.fetch_sub(1, std::memory_order_relaxed);
+      if (m_backgroundHead == m_backgroundJobs.size()) {
+        m_backgroundJobs.clear();
+        m_backgroundHead = 0;
+      }
+    }
+  }
+  if (job)
+    m_queuedJobs.fetch_sub(1, std::memory_order_relaxed);
+  return job;
+}
+
+void JobSystem::helpUntilZero(const std::atomic<uint32_t> &counter) {
+  const uint32_t threadIndex = currentThreadIndex();
+  while (counter.load(std::memory_order_acquire) != 0) {
+    if (Job *job = findJob(threadIndex))
+      job->execute(*job, threadIndex);
+    else
+      std::this_thread::yield();
+  }
+}
+
+void JobSystem::workerLoop(uint32_t threadIndex) {
+  t_threadIndex = threadIndex;
+  uint32_t idleSpins = 0;
+  for (;;) {
+    if (Job *job = findJob(threadIndex, true)) {
+      job->execute(*job, threadIndex);
+      idleSpins = 0;
+      continue;
+    }
+    // Krótkie aktywne czekanie — zadania grafu przychodzą seriami
+    if (++idleSpins < 64) {
+      std::this_thread::yield();
+      continue;
+    }
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_sleepers.fetch_add(1, std::memory_order_seq_cst);
+    m_wake.wait(lock, [&] {
+      return m_quit || m_queuedJobs.load(std::memory_order_seq_cst) > 0;
+    });
+    m_sleepers.fetch_sub(1, std::memory_order_relaxed);
+    if (m_quit)
+      return;
+    idleSpins = 0;
+  }
+}
+
+void JobSystem::parallelFor(uint32_t count, uint32_t grainSize,
+                            const RangeFn &fn) {
+  if (count == 0)
+    return;
+  grainSize = std::max(grainSize, 1u);
+  const uint32_t chunkCount = (count + grainSize - 1) / grainSize;
+
+  // Mało pracy albo brak workerów — wykonaj na miejscu
+  if (chunkCount == 1 || m_workers.empty()) {
+    for (uint32_t begin = 0; begin < count; begin += grainSize)
+      fn(begin, std::min(begin + grainSize, count), currentThreadIndex());
+    return;
+  }
+
+  // Opisy porcji w pamięci roboczej wątku — żyją do helpUntilZero, a
+  // zagnieżdżone parallelFor wykonane w międzyczasie zwalniają swoje
+  // przed powrotem
+  ScratchScope scratch;
+  RangeJobContext context{&fn, {chunkCount}};
+  Job *chunks = scratch.arena().allocateArray<Job>(chunkCount);
+  for (uint32_t i = 0; i < chunkCount; ++i) {
+    chunks[i].execute = executeRange;
+    chunks[i].context = &context;
+    chunks[i].begin = i * grainSize;
+    chunks[i].end = std::min(chunks[i].begin + grainSize, count);
+  }
+  // Od końca — właściciel zdejmuje z dołu, więc sam zaczyna od porcji 0,
+  // a złodzieje biorą porcje z drugiego końca zakresu
+  for (uint32_t i = chunkCount; i-- > 0;)
+    push(&chunks[i]);
+
+  helpUntilZero(context.pending);
+}
+
+bool JobSystem::run(TaskGraph &graph) {
+  const uint32_t count = graph.size();
+  if (count == 0)
+    return true;
+  if (!graph.m_validated) {
+    if (!graph.validate()) {
+      std::cerr << "Task graph contains a cycle!" << std::endl;
+      return false;
+    }
+    graph.m_validated = true;
+    graph.m_nodeJobs.assign(count, Job{});
+    graph.m_remaining = std::make_unique<std::atomic<uint32_t>[]>(count);
+    for (uint32_t i = 0; i < count; ++i) {
+      graph.m_nodeJobs[i].execute = TaskGraph::executeNode;
+      graph.m_nodeJobs[i].context = &graph;
+      graph.m_nodeJobs[i].begin = i;
+    }
+  }
+
+  graph.m_jobs = this;
+  graph.m_unfinished.store(count, std::memory_order_relaxed);
+  for (uint32_t i = 0; i < count; ++i)
+    graph.m_remaining[i].store(graph.m_nodes[i].dependencyCount,
+                               std::memory_order_relaxed);
+  for (uint32_t i = 0; i < count; ++i)
+    if (graph.m_nodes[i].dependencyCount == 0)
+      push(&graph.m_nodeJobs[i]);
+
+  helpUntilZero(graph.m_unfinished);
+  return true;
+}
@@ -0,0 +1,144 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class JobSystem;
+
+// Jednostka pracy w kolejkach wątków. Nie jest właścicielem danych —
+// obiekt Job musi żyć, dopóki nie zostanie wykonany.
+struct Job {
+  void (*execute)(const Job &job, uint32_t threadIndex) = nullptr;
+  const void *context = nullptr;
+  uint32_t begin = 0;
+  uint32_t end = 0;
+};
+
+// Kolejka Chase-Lev: właściciel dokłada i zdejmuje zadania z dołu (LIFO,
+// ciepłe cache), pozostałe wątki kradną z góry. Stała pojemność — gdy
+// kolejka jest pełna, push zwraca false i zadanie wykonuje się od razu.
+class WorkStealingDeque {
+public:
+  static constexpr int64_t kCapacity = 4096; // potęga dwójki
+
+  bool push(Job *job); // tylko właściciel
+  Job *pop();          // tylko właściciel
+  Job *steal();        // dowolny wątek
+
+private:
+  alignas(64) std::atomic<int64_t> m_top{0};
+  alignas(64) std::atomic<int64_t> m_bottom{0};
+  alignas(64) std::atomic<Job *> m_jobs[kCapacity] = {};
+};
+
+// Graf zadań jednej klatki (DAG). Budowany raz, uruchamiany co klatkę przez
+// JobSystem::run — zadania bez zależności startują od razu, pozostałe po
+// zakończeniu wszystkich poprzedników.
+class TaskGraph {
+public:
+  using TaskFn = std::function<void(uint32_t threadIndex)>;
+  using TaskId = uint32_t;
+
+  // name: literał (trafia do profilera jako nazwa zakresu)
+  TaskId add(const char *name, TaskFn fn);
+  // task startuje dopiero po zakończeniu dependency
+  void depend(TaskId task, TaskId dependency);
+  void clear();
+
+  uint32_t size() const { return uint32_t(m_nodes.size()); }
+
+private:
+  friend class JobSystem;
+
+  struct Node {
+    const char *name = nullptr;
+    TaskFn fn;
+    std::vector<TaskId> successors;
+    uint32_t dependencyCount = 0;
+  };
+
+  static void executeNode(const Job &job, uint32_t threadIndex);
+  // Sortowanie topologiczne — false, gdy graf ma cykl
+  bool validate() const;
+
+  std::vector<Node> m_nodes;
+  bool m_validated = false;
+
+  // Stan wykonania (ustawiany przez JobSystem::run)
+  JobSystem *m_jobs = nullptr;
+  std::vector<Job> m_nodeJobs;
+  std::unique_ptr<std::atomic<uint32_t>[]> m_remaining; // zależności
+  std::atomic<uint32_t> m_unfinished{0};
+};
+
+// Stała pula wątków roboczych z kolejkami Chase-Lev i kradzieżą pracy.
+// Wątek, który czeka na wynik (parallelFor, run), wykonuje w tym czasie
+// zadania z kolejek — zagnieżdżone parallelFor wewnątrz zadań grafu nie
+// blokują wątków.
+//
+// parallelFor i run wywołuje się z wątku, który utworzył JobSystem, albo
+// z wnętrza zadań.
+class JobSystem {
+public:
+  // Funkcja porcji: [begin, end) + indeks wątku (0 = wątek główny)
+  using RangeFn = std::function<void(uint32_t begin, uint32_t end,
+                                     uint32_t threadIndex)>;
+
+  // workerCount = 0 → liczba rdzeni - 1
+  explicit JobSystem(uint32_t workerCount = 0);
+  ~JobSystem();
+
+  JobSystem(const JobSystem &) = delete;
+  JobSystem &operator=(const JobSystem &) = delete;
+
+  // Liczba wątków wykonujących pracę (workery + wątek główny)
+  uint32_t threadCount() const { return uint32_t(m_workers.size()) + 1; }
+
+  // Dzieli [0, count) na porcje po grainSize i czeka na ich wykonanie
+  void parallelFor(uint32_t count, uint32_t grainSize, const RangeFn &fn);
+
+  // Wykonuje cały graf i czeka na jego zakończenie. Zwraca false (bez
+  // uruchamiania czegokolwiek), gdy graf zawiera cykl.
+  bool run(TaskGraph &graph);
+
+  // Zadanie w tle (np. dekodowanie assetów) z dowolnego wątku, bez
+  // czekania na wynik. Wykonują je tylko workery, gdy w kolejkach nie ma
+  // pracy klatki — wątek główny nigdy. Bez workerów wykonuje się od razu
+  // na wątku wołającym. Job musi żyć do zakończenia execute.
+  void submitBackground(Job *job);
+
+  // Liczba udanych kradzieży (statystyka równoważenia obciążenia)
+  uint64_t stealCount() const { return m_steals.load(); }
+
+private:
+  friend class TaskGraph;
+
+  void workerLoop(uint32_t threadIndex);
+  // Dokłada zadanie do kolejki bieżącego wątku i budzi uśpione workery
+  void push(Job *job);
+  // Najpierw własna kolejka, potem kradzież od pozostałych wątków, a na
+  // końcu (tylko bezczynny worker) zadania w tle
+  Job *findJob(uint32_t threadIndex, bool allowBackground = false);
+  // Wykonuje cudze zadania, dopóki licznik nie spadnie do zera
+  void helpUntilZero(const std::atomic<uint32_t> &counter);
+  static uint32_t currentThreadIndex();
+
+  std::vector<std::thread> m_workers;
+  std::vector<std::unique_ptr<WorkStealingDeque>> m_queues; // [threadIndex]
+  std::atomic<uint32_t> m_queuedJobs{0}; // także zadania w tle
+  std::vector<Job *> m_backgroundJobs;     // FIFO pod m_backgroundMutex
+  size_t m_backgroundHead = 0;
+  std::atomic<uint32_t> m_backgroundCount{0};
+  std::mutex m_backgroundMutex;
+  std::atomic<uint32_t> m_sleepers{0};
+  std::atomic<uint64_t> m_steals{0};
+  std::mutex m_mutex;
+  std::condition_variable m_wake;
+  bool m_quit = false;
+};
@@ -1,308 +1,373 @@
 #include <GLFW/glfw3.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
 #include <iostream>
+#include <memory>
 #include <string>
+#include <vector>
 #include <webgpu/webgpu.h>
 #include <webgpu/wgpu.h>
 
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 
+#include "asset_manager.h"
+#include "audio_mixer.h"
+#include "bench_report.h"
+#include "camera.h"
+#include "dynamic_resolution.h"
+#include "entity_store.h"
+#include "fixed_timestep.h"
+#include "flow_field.h"
+#include "frame_ring.h"
+#include "game_systems.h"
+#include "gpu_culling.h"
+#include "gpu_device.h"
+#include "gpu_horde.h"
+#include "gpu_particles.h"
+#include "input.h"
+#include "job_system.h"
+#include "memory_arena.h"
+#include "offscreen_target.h"
+#include "pipeline_cache.h"
+#include "profiler.h"
+#include "render_bundles.h"
+#include "render_graph.h"
+#include "sprite_batch.h"
+#include "swapchain.h"
+#include "text_renderer.h"
+#include "texture_atlas.h"
+#include "tilemap.h"
 #include "wgpu_surface.h"
+#include "world_snapshot.h"
 
 // ============================================================
 //  Struktury danych
 // ============================================================
 
-// Uniform buffer przesyłany do GPU — macierz projekcji + pozycja gracza
-struct PlayerUniforms {
-  glm::mat4 projection; // 64 bytes (4×4 floats)
-  float position[2];    // x, y — 8 bytes
-  float _pad[2];        // wyrównanie do 16 bajtów (std140)
-}; // total: 80 bytes
-
-// ============================================================
-//  Callbacks
-// ============================================================
-
-// Callback wywoływany po znalezieniu adaptera GPU
-void onAdapterRequestEnded(WGPURequestAdapterStatus status, WGPUAdapter adapter,
-                           char const *message, void *userdata) {
-  if (status != WGPURequestAdapterStatus_Success) {
-    std::cerr << "Could not get WebGPU adapter: " << (message ? message : "")
-              << std::endl;
-    *static_cast<WGPUAdapter *>(userdata) = nullptr;
-    return;
-  }
-  *static_cast<WGPUAdapter *>(userdata) = adapter;
-}
-
-// Callback wywoływany po utworzeniu urządzenia GPU
-void onDeviceRequestEnded(WGPURequestDeviceStatus status, WGPUDevice device,
-                          char const *message, void *userdata) {
-  if (status != WGPURequestDeviceStatus_Success) {
-    std::cerr << "Could not get WebGPU device: " << (message ? message : "")
-              << std::endl;
-    *static_cast<WGPUDevice *>(userdata) = nullptr;
-    return;
-  }
-  *static_cast<WGPUDevice *>(userdata) = device;
-}
-
-// Callback dla nieobsłużonych błędów urządzenia
-void onUncapturedError(WGPUErrorType type, char const *message,
-                       void * /*userdata*/) {
-  std::cerr << "[WebGPU Error] type=" << type << ": "
-            << (message ? message : "(no message)") << std::endl;
-}
-
-// Callback dla utraty urządzenia
-void onDeviceLost(WGPUDeviceLostReason reason, char const *message,
-                  void * /*userdata*/) {
-  std::cerr << "[WebGPU] Device lost! reason=" << reason << ": "
-            << (message ? message : "(no message)") << std::endl;
-}
+// Opcje uruchomienia z linii poleceń
+struct LaunchOptions {
+  bool headless = false;         // render do tekstury offscreen, bez okna
+  uint32_t frameCount = 600;     // liczba klatek w trybie headless
+  uint32_t width = 800;
+  uint32_t height = 600;
+  const char *dumpPath = nullptr; // zapis ostatniej klatki do pliku PPM
+  uint32_t enemyCount = 0;       // liczba wrogów hordy (test wydajności)
+  uint32_t gpuHordeCount = 0;    // horda symulowana w compute shaderach
+  bool gpuCulling = true;        // culling hordy i cząsteczek na GPU
+  uint32_t particleCapacity = 0; // pierścień cząsteczek GPU (0 = wyłączony)
+  float damageNumberRate = 0.0f; // liczby obrażeń na sekundę (test tekstu)
+  float particleBurstRate = 0.0f; // wybuchy cząsteczek na sekundę (skrypt)
+  uint32_t seed = 12345u;         // ziarno losowania encji i zdarzeń
+  double tickRate = 60.0;        // częstotliwość symulacji (Hz)
+  WGPUPresentMode presentMode = WGPUPresentMode_Fifo;
+  double dynamicResTargetMs = 0.0; // docelowy czas GPU (0 = stała skala)
+  const char *tracePath = nullptr; // zapis profilu w formacie Chrome trace
+  const char *reportPath = nullptr; // raport czasów klatek JSON (WarpBench)
+  uint32_t warmupFrames = 0;        // klatki pominięte w raporcie
+  const char *atlasPath = nullptr; // atlas .watl (WarpAtlas); brak = biały
+  uint32_t uploadBudgetMB = 4;     // przesyłanie assetów na GPU na klatkę
+  const char *mapPath = nullptr;   // mapa .wmap (WarpMap); brak = szachownica
+  // Plik rozgrzewki pipeline'ów (nullptr = wyłączony, "--pipeline-cache none")
+  const char *pipelineCachePath = "pipeline_cache.bin";
+  // Wyjście miksera audio: "null" albo plik .wav (nullptr = bez dźwięku)
+  const char *audioOutput = nullptr;
+  double rewindSeconds = 0.0;      // historia zrzutów świata (0 = brak)
+  uint32_t snapshotBudgetMB = 128; // pamięć pierścienia zrzutów
+  const char *loadSnapshotPath = nullptr; // start ze zrzutu .wsnp
+  const char *saveSnapshotPath = nullptr; // zrzut .wsnp przy wyjściu
+};
 
 // ============================================================
 //  Pomocnicze funkcje
 // ============================================================
 
-// Nazwa typu adaptera
-const char *adapterTypeName(WGPUAdapterType type) {
-  switch (type) {
-  case WGPUAdapterType_DiscreteGPU:
-    return "Discrete GPU";
-  case WGPUAdapterType_IntegratedGPU:
-    return "Integrated GPU";
-  case WGPUAdapterType_CPU:
-    return "CPU (software)";
-  default:
-    return "Unknown";
+bool parseLaunchOptions(int argc, char **argv, LaunchOptions &options) {
+  for (int i = 1; i < argc; ++i) {
+    std::string arg = argv[i];
+    if (arg == "--headless") {
+      options.headless = true;
+    } else if (arg == "--frames" && i + 1 < argc) {
+      options.frameCount = uint32_t(std::strtoul(argv[++i], nullptr, 10));
+    } else if (arg == "--dump" && i + 1 < argc) {
+      options.dumpPath = argv[++i];
+    } else if (arg == "--enemies" && i + 1 < argc) {
+      options.enemyCount = uint32_t(std::strtoul(argv[++i], nullptr, 10));
+    } else if (arg == "--gpu-horde" && i + 1 < argc) {
+      options.gpuHordeCount = uint32_t(std::strtoul(argv[++i], nullptr, 10));
+    } else if (arg == "--gpu-cull") {
+      options.gpuCulling = true;
+    } else if (arg == "--no-gpu-cull") {
+      options.gpuCulling = false;
+    } else if (arg == "--damage-numbers" && i + 1 < argc) {
+      options.damageNumberRate =
+          std::max(0.0f, std::strtof(argv[++i], nullptr));
+    } else if (arg == "--bursts" && i + 1 < argc) {
+      options.particleBurstRate =
+          std::max(0.0f, std::strtof(argv[++i], nullptr));
+    } else if (arg == "--seed" && i + 1 < argc) {
+      options.seed = uint32_t(std::strtoul(argv[++i], nullptr, 10));
+    } else if (arg == "--report" && i + 1 < argc) {
+      options.reportPath = argv[++i];
+    } else if (arg == "--warmup" && i + 1 < argc) {
+      options.warmupFrames = uint32_t(std::strtoul(argv[++i], nullptr, 10));
+    } else if (arg == "--particles" && i + 1 < argc) {
+      options.particleCapacity =
+          uint32_t(std::strtoul(argv[++i], nullptr, 10));
+    } else if (arg == "--tick-rate" && i + 1 < argc) {
+      options.tickRate = std::max(1.0, std::strtod(argv[++i], nullptr));
+    } else if (arg == "--atlas" && i + 1 < argc) {
+      options.atlasPath = argv[++i];
+    } else if (arg == "--upload-budget" && i + 1 < argc) {
+      options.uploadBudgetMB =
+          std::max(1u, uint32_t(std::strtoul(argv[++i], nullptr, 10)));
+    } else if (arg == "--map" && i + 1 < argc) {
+      options.mapPath = argv[++i];
+    } else if (arg == "--pipeline-cache" && i + 1 < argc) {
+      options.pipelineCachePath = argv[++i];
+      if (std::strcmp(options.pipelineCachePath, "none") == 0)
+        options.pipelineCachePath = nullptr;
+    } else if (arg == "--dynamic-res" && i + 1 < argc) {
+      options.dynamicResTargetMs =
+          std::max(0.0, std::strtod(argv[++i], nullptr));
+    } else if (arg == "--audio" && i + 1 < argc) {
+      options.audioOutput = argv[++i];
+    } else if (arg == "--rewind" && i + 1 < argc) {
+      options.rewindSeconds = std::max(0.0, std::strtod(argv[++i], nullptr));
+    } else if (arg == "--snapshot-budget" && i + 1 < argc) {
+      options.snapshotBudgetMB =
+          std::max(1u, uint32_t(std::strtoul(argv[++i], nullptr, 10)));
+    } else if (arg == "--load-snapshot" && i + 1 < argc) {
+      options.loadSnapshotPath = argv[++i];
+    } else if (arg == "--save-snapshot" && i + 1 < argc) {
+      options.saveSnapshotPath = argv[++i];
+    } else if (arg == "--trace" && i + 1 < argc) {
+      options.tracePath = argv[++i];
+    } else if (arg == "--present" && i + 1 < argc) {
+      std::string mode = argv[++i];
+      if (mode == "fifo")
+        options.presentMode = WGPUPresentMode_Fifo;
+      else if (mode == "mailbox")
+        options.presentMode = WGPUPresentMode_Mailbox;
+      else if (mode == "immediate")
+        options.presentMode = WGPUPresentMode_Immediate;
+      else {
+        std::cerr << "Unknown present mode: " << mode << std::endl;
+        return false;
+      }
+    } else {
+      std::cerr << "Unknown option: " << arg << "\n"
+                << "Usage: WarpEngine [--headless] [--frames N] "
+                   "[--dump frame.ppm] [--enemies N]\n"
+                   "                  [--tick-rate HZ] "
+                   "[--present fifo|mailbox|immediate]\n"
+                   "                  [--trace trace.json] "
+                   "[--atlas sprites.watl] [--map arena.wmap]\n"
+                   "                  [--pipeline-cache file|none] "
+                   "[--gpu-horde N] [--particles N]\n"
+                   "                  [--damage-numbers PER_SECOND] "
+                   "[--bursts PER_SECOND] [--seed N]\n"
+                   "                  [--report report.json] "
+                   "[--warmup N] [--upload-budget MB]\n"
+                   "                  [--dynamic-res TARGET_GPU_MS] "
+                   "[--gpu-cull|--no-gpu-cull]\n"
+                   "                  [--audio null|FILE.wav] "
+                   "[--rewind SECONDS] [--snapshot-budget MB]\n"
+                   "                  [--load-snapshot FILE.wsnp] "
+                   "[--save-snapshot FILE.wsnp]"
+                << std::endl;
+      return false;
+    }
   }
+  // Horda GPU i wybuchy ze skryptu potrzebują pierścienia cząsteczek.
+  // Symulacja zawsze obejmuje całą pojemność; rysowanie też, jeśli
+  // wyłączono culling (--no-gpu-cull)
+  if ((options.gpuHordeCount > 0 || options.particleBurstRate > 0.0f) &&
+      options.particleCapacity == 0)
+    options.particleCapacity = 1u << 18;
+  return true;
 }
 
-// Nazwa backendu graficznego
-const char *backendTypeName(WGPUBackendType type) {
-  switch (type) {
-  case WGPUBackendType_D3D12:
-    return "Direct3D 12";
-  case WGPUBackendType_D3D11:
-    return "Direct3D 11";
-  case WGPUBackendType_Vulkan:
-    return "Vulkan";
-  case WGPUBackendType_Metal:
-    return "Metal";
-  case WGPUBackendType_OpenGL:
-    return "OpenGL";
-  case WGPUBackendType_OpenGLES:
-    return "OpenGL ES";
+// Nazwa trybu prezentacji (do logów)
+const char *presentModeName(WGPUPresentMode mode) {
+  switch (mode) {
+  case WGPUPresentMode_Fifo:
+    return "Fifo";
+  case WGPUPresentMode_FifoRelaxed:
+    return "FifoRelaxed";
+  case WGPUPresentMode_Immediate:
+    return "Immediate";
+  case WGPUPresentMode_Mailbox:
+    return "Mailbox";
   default:
     return "Unknown";
   }
 }
 
 // ============================================================
-//  WGSL Shader
-// ============================================================
-
-const char *shaderSource = R"(
-struct PlayerUniforms {
-    projection: mat4x4<f32>,
-    position: vec2f,
-};
-
-@group(0) @binding(0) var<uniform> player: PlayerUniforms;
-
-struct VertexOutput {
-    @builtin(position) position: vec4f,
-    @location(0) color: vec3f,
-};
-
-@vertex
-fn vs_main(@builtin(vertex_index) vertexIndex: u32) -> VertexOutput {
-    var pos = array<vec2f, 3>(
-        vec2f(400.0, 100.0),   // góra (środek)
-        vec2f(100.0, 500.0),   // lewy dół
-        vec2f(700.0, 500.0)    // prawy dół
-    );
-
-    var out: VertexOutput;
-    out.position = player.projection * vec4f(pos[vertexIndex] + player.position, 0.0, 1.0);
-    out.color = vec3f(1.0, 0.0, 0.0); // czerwony
-    return out;
-}
-
-@fragment
-fn fs_main(in: VertexOutput) -> @location(0) vec4f {
-    return vec4f(in.color, 1.0);
-}
-)";
-
-// ============================================================
-//  Pipeline Creation
+//  Main
 // ============================================================
 
-WGPURenderPipeline createPipeline(WGPUDevice device,
-                                  WGPUTextureFormat surfaceFormat,
-                                  WGPUBindGroupLayout bindGroupLayout) {
-  // 1. Shader module z kodu WGSL
-  WGPUShaderModuleWGSLDescriptor wgslDesc = {};
-  wgslDesc.chain.next = nullptr;
-  wgslDesc.chain.sType = WGPUSType_ShaderModuleWGSLDescriptor;
-  wgslDesc.code = shaderSource;
-
-  WGPUShaderModuleDescriptor shaderDesc = {};
-  shaderDesc.nextInChain = &wgslDesc.chain;
-  shaderDesc.label = "Triangle Shader";
-  shaderDesc.hintCount = 0;
-  shaderDesc.hints = nullptr;
-
-  WGPUShaderModule shaderModule =
-      wgpuDeviceCreateShaderModule(device, &shaderDesc);
-  if (!shaderModule) {
-    std::cerr << "Failed to create shader module!" << std::endl;
-    return nullptr;
-  }
-
-  // 2. Tworzenie explicit pipeline layout z bind group layout
-  WGPUPipelineLayoutDescriptor layoutDesc = {};
-  layoutDesc.nextInChain = nullptr;
-  layoutDesc.label = "Pipeline Layout";
-  layoutDesc.bindGroupLayoutCount = 1;
-  layoutDesc.bindGroupLayouts = &bindGroupLayout;
-
-  WGPUPipelineLayout pipelineLayout =
-      wgpuDeviceCreatePipelineLayout(device, &layoutDesc);
-
-  // 3. Color target state (format musi pasować do surface)
-  WGPUBlendState blendState = {};
-  blendState.color.srcFactor = WGPUBlendFactor_SrcAlpha;
-  blendState.color.dstFactor = WGPUBlendFactor_OneMinusSrcAlpha;
-  blendState.color.operation = WGPUBlendOperation_Add;
-  blendState.alpha.srcFactor = WGPUBlendFactor_One;
-  blendState.alpha.dstFactor = WGPUBlendFactor_Zero;
-  blendState.alpha.operation = WGPUBlendOperation_Add;
-
-  WGPUColorTargetState colorTarget = {};
-  colorTarget.nextInChain = nullptr;
-  colorTarget.format = surfaceFormat;
-  colorTarget.blend = &blendState;
-  colorTarget.writeMask = WGPUColorWriteMask_All;
-
-  // 4. Fragment state
-  WGPUFragmentState fragmentState = {};
-  fragmentState.nextInChain = nullptr;
-  fragmentState.module = shaderModule;
-  fragmentState.entryPoint = "fs_main";
-  fragmentState.constantCount = 0;
-  fragmentState.constants = nullptr;
-  fragmentState.targetCount = 1;
-  fragmentState.targets = &colorTarget;
-
-  // 5. Pipeline descriptor
-  WGPURenderPipelineDescriptor pipelineDesc = {};
-  pipelineDesc.nextInChain = nullptr;
-  pipelineDesc.label = "Triangle Pipeline";
-  pipelineDesc.layout = pipelineLayout;
-
-  // Vertex state (brak buforów — pozycje hardkodowane w shaderze)
-  pipelineDesc.vertex.nextInChain = nullptr;
-  pipelineDesc.vertex.module = shaderModule;
-  pipelineDesc.vertex.entryPoint = "vs_main";
-  pipelineDesc.vertex.constantCount = 0;
-  pipelineDesc.vertex.constants = nullptr;
-  pipelineDesc.vertex.bufferCount = 0;
-  pipelineDesc.vertex.buffers = nullptr;
-
-  // Primitive state
-  pipelineDesc.primitive.nextInChain = nullptr;
-  pipelineDesc.primitive.topology = WGPUPrimitiveTopology_TriangleList;
-  pipelineDesc.primitive.stripIndexFormat = WGPUIndexFormat_Undefined;
-  pipelineDesc.primitive.frontFace = WGPUFrontFace_CCW;
-  pipelineDesc.primitive.cullMode = WGPUCullMode_None;
-
-  // Multisample state
-  pipelineDesc.multisample.nextInChain = nullptr;
-  pipelineDesc.multisample.count = 1;
-  pipelineDesc.multisample.mask = ~0u;
-  pipelineDesc.multisample.alphaToCoverageEnabled = false;
-
-  // Fragment
-  pipelineDesc.fragment = &fragmentState;
-
-  // Brak depth/stencil
-  pipelineDesc.depthStencil = nullptr;
-
-  WGPURenderPipeline pipeline =
-      wgpuDeviceCreateRenderPipeline(device, &pipelineDesc);
-
-  // Shader module i pipeline layout już nie są potrzebne po utworzeniu
-  // pipeline'u
-  wgpuShaderModuleRelease(shaderModule);
-  wgpuPipelineLayoutRelease(pipelineLayout);
-
-  if (!pipeline) {
-    std::cerr << "Failed to create render pipeline!" << std::endl;
-  } else {
-    std::cout << "Render pipeline created successfully." << std::endl;
-  }
 
-  return pipeline;
-}
+int main(int argc, char **argv) {
+  LaunchOptions options;
+  if (!parseLaunchOptions(argc, argv, options))
+    return -1;
 
-// ============================================================
-//  Main
-// ============================================================
+  // Format koloru celu renderowania: headless BGRA8, w oknie format
+  // wybrany przez swapchain (krok 8)
+  WGPUTextureFormat colorFormat = WGPUTextureFormat_BGRA8Unorm;
 
-int main() {
-  // ── 1. Inicjalizacja GLFW ────────────────────────────────
-  if (!glfwInit()) {
+  WGPUInstance instance = nullptr;
+  GLFWwindow *window = nullptr;
+  // Zdarzenia z callbacków okna dla ticków symulacji
+  InputSystem input;
+  WGPUSurface surface = nullptr;
+  WGPUAdapter adapter = nullptr;
+  WGPUDevice device = nullptr;
+  WGPUQueue queue = nullptr;
+  Swapchain swapchain;
+  OffscreenTarget offscreen;
+  FrameRing frameRing;
+  std::unique_ptr<PipelineCache> pipelineCache;
+  WGPUBindGroupLayout bindGroupLayout = nullptr; // z pipelineCache
+  // Bind group kamery dla każdego slotu pierścienia (+ wersja bufora slotu)
+  WGPUBindGroup cameraBindGroups[kFramesInFlight] = {};
+  uint32_t cameraBindGroupVersions[kFramesInFlight] = {};
+  SpriteBatch spriteBatch;
+  // Warstwy statyczne: nagrywane do render bundle na wątkach roboczych
+  std::unique_ptr<RenderBundleSet> bundles;
+  WGPUBuffer staticCameraBuffer = nullptr;
+  WGPUBindGroup staticCameraBindGroup = nullptr;
+  // Tekst: font, napisy świata i HUD (kamera w pikselach ekranu)
+  TextRenderer text;
+  WGPUBuffer hudCameraBuffer = nullptr;
+  WGPUBindGroup hudCameraBindGroup = nullptr;
+  SpriteBatch backgroundBatch;
+  TextureAtlas atlas;
+  // Atlas z pliku wczytywany w tle; do podmiany rysuje atlas jednolity
+  std::unique_ptr<AssetManager> assets;
+  AssetHandle pendingAtlas;
+  AssetHandle loadedAtlas;
+  const TextureAtlas *currentAtlas = &atlas;
+  Tilemap tilemap;
+  GpuProfiler gpuProfiler;
+  // Symulacja na GPU: cząsteczki (blending addytywny) i horda
+  GpuParticles particles;
+  GpuHorde gpuHorde;
+  SpriteBatch particleBatch;
+  // Widoczne instancje hordy i cząsteczek (rysowane pośrednio)
+  GpuCulling gpuCulling;
+  uint32_t hordeCullStream = ~0u;
+  uint32_t particleCullStream = ~0u;
+  // Dynamiczna rozdzielczość: scena w skali, HUD w rozdzielczości wyjścia
+  ScaledScene scaledScene;
+  DynamicResolution dynamicRes;
+  // Passy klatki i tekstury tymczasowe
+  std::unique_ptr<RenderGraph> renderGraph;
+  // Mikser SFX na własnym wątku (--audio)
+  std::unique_ptr<AudioMixer> audio;
+  SoundId burstSound = kInvalidSound;
+  SoundId hitSound = kInvalidSound;
+  // Historia zrzutów świata do cofania (--rewind)
+  std::unique_ptr<SnapshotRing> snapshots;
+
+  // Zwalnia wszystkie utworzone zasoby (w odwrotnej kolejności)
+  auto cleanup = [&]() {
+    audio.reset();
+    renderGraph.reset();
+    releaseScaledScene(scaledScene);
+    releaseGpuCulling(gpuCulling);
+    releaseGpuHorde(gpuHorde);
+    releaseGpuParticles(particles);
+    releaseSpriteBatch(particleBatch);
+    releaseGpuProfiler(gpuProfiler);
+    releaseTextRenderer(text);
+    if (hudCameraBindGroup)
+      wgpuBindGroupRelease(hudCameraBindGroup);
+    if (hudCameraBuffer)
+      wgpuBufferRelease(hudCameraBuffer);
+    bundles.reset();
+    releaseTilemap(tilemap);
+    pendingAtlas.reset();
+    loadedAtlas.reset();
+    assets.reset();
+    releaseTextureAtlas(atlas);
+    releaseSpriteBatch(backgroundBatch);
+    if (staticCameraBindGroup)
+      wgpuBindGroupRelease(staticCameraBindGroup);
+    if (staticCameraBuffer)
+      wgpuBufferRelease(staticCameraBuffer);
+    releaseSpriteBatch(spriteBatch);
+    for (WGPUBindGroup cameraBindGroup : cameraBindGroups)
+      if (cameraBindGroup)
+        wgpuBindGroupRelease(cameraBindGroup);
+    pipelineCache.reset();
+    releaseFrameRing(frameRing);
+    releaseOffscreenTarget(offscreen);
+    releaseSwapchain(swapchain);
+    if (queue)
+      wgpuQueueRelease(queue);
+    if (device)
+      wgpuDeviceRelease(device);
+    if (surface)
+      wgpuSurfaceRelease(surface);
+    if (adapter)
+      wgpuAdapterRelease(adapter);
+    if (instance)
+      wgpuInstanceRelease(instance);
+    input.detach();
+    if (window)
+      glfwDestroyWindow(window);
+    if (!options.headless)
+      glfwTerminate();
+  };
+
+  // ── 1. Inicjalizacja GLFW (pomijana w trybie headless) ───
+  if (!options.headless && !glfwInit()) {
     std::cerr << "Failed to initialize GLFW!" << std::endl;
     return -1;
   }
 
   // ── 2. Tworzenie instancji WebGPU ────────────────────────
-  WGPUInstance instance = wgpuCreateInstance(nullptr);
+  instance = wgpuCreateInstance(nullptr);
   if (!instance) {
     std::cerr << "Failed to create WebGPU instance!" << std::endl;
-    glfwTerminate();
+    cleanup();
     return -1;
   }
 
-  // ── 3. Tworzenie okna GLFW (bez kontekstu OpenGL) ────────
-  glfwWindowHint(GLFW_CLIENT_API, GLFW_NO_API);
-  GLFWwindow *window = glfwCreateWindow(
-      800, 600, "WarpEngine | Initializing...", nullptr, nullptr);
-  if (!window) {
-    std::cerr << "Failed to create GLFW window!" << std::endl;
-    wgpuInstanceRelease(instance);
-    glfwTerminate();
-    return -1;
-  }
-
-  // ── 4. Tworzenie Surface (platforma macOS / Windows) ─────
-  WGPUSurface surface = createSurfaceForWindow(instance, window);
-  if (!surface) {
-    std::cerr << "Failed to create WebGPU surface!" << std::endl;
-    glfwDestroyWindow(window);
-    wgpuInstanceRelease(instance);
-    glfwTerminate();
-    return -1;
+  if (!options.headless) {
+    // ── 3. Tworzenie okna GLFW (bez kontekstu OpenGL) ──────
+    glfwWindowHint(GLFW_CLIENT_API, GLFW_NO_API);
+    window = glfwCreateWindow(int(options.width), int(options.height),
+                              "WarpEngine | Initializing...", nullptr,
+                              nullptr);
+    if (!window) {
+      std::cerr << "Failed to create GLFW window!" << std::endl;
+      cleanup();
+      return -1;
+    }
+    input.attach(window);
+
+    // ── 4. Tworzenie Surface (macOS / Windows / Linux) ─────
+    surface = createSurfaceForWindow(instance, window);
+    if (!surface) {
+      std::cerr << "Failed to create WebGPU surface!" << std::endl;
+      cleanup();
+      return -1;
+    }
   }
 
   // ── 5. Żądanie adaptera GPU ──────────────────────────────
-  WGPUAdapter adapter = nullptr;
-  WGPURequestAdapterOptions adapterOpts = {};
-  adapterOpts.nextInChain = nullptr;
-  adapterOpts.compatibleSurface = surface;
-  adapterOpts.powerPreference = WGPUPowerPreference_HighPerformance;
-  wgpuInstanceRequestAdapter(instance, &adapterOpts, onAdapterRequestEnded,
-                             &adapter);
+  adapter = requestAdapter(instance, surface);
   if (!adapter) {
     std::cerr << "Failed to get a WebGPU adapter!" << std::endl;
-    wgpuSurfaceRelease(surface);
-    wgpuInstanceRelease(instance);
-    glfwDestroyWindow(window);
-    glfwTerminate();
+    cleanup();
     return -1;
   }
 
@@ -310,217 +375,615 @@ int main() {
   WGPUAdapterProperties props = {};
   props.nextInChain = nullptr;
   wgpuAdapterGetProperties(adapter, &props);
-
-  std::cout << "==========================================" << std::endl;
-  std::cout << "  WarpEngine - GPU Info" << std::endl;
-  std::cout << "==========================================" << std::endl;
-  std::cout << "  GPU:      " << (props.name ? props.name : "N/A") << std::endl;
-  std::cout << "  Vendor:   " << (props.vendorName ? props.vendorName : "N/A")
-            << std::endl;
-  std::cout << "  Driver:   "
-            << (props.driverDescription ? props.driverDescription : "N/A")
-            << std::endl;
-  std::cout << "  Type:     " << adapterTypeName(props.adapterType)
-            << std::endl;
-  std::cout << "  Backend:  " << backendTypeName(props.backendType)
-            << std::endl;
-  std::cout << "==========================================" << std::endl;
+  printAdapterInfo(props);
+  const std::string adapterName = props.name ? props.name : "Unknown GPU";
 
   // Ustaw tytuł okna z nazwą GPU
-  std::string windowTitle =
-      "WarpEngine | " + std::string(props.name ? props.name : "Unknown GPU");
-  glfwSetWindowTitle(window, windowTitle.c_str());
+  if (window) {
+    std::string windowTitle =
+        "WarpEngine | " + std::string(props.name ? props.name : "Unknown GPU");
+    glfwSetWindowTitle(window, windowTitle.c_str());
+  }
 
   // ── 7. Żądanie urządzenia (Device) ──────────────────────
-  WGPUDevice device = nullptr;
-  WGPUDeviceDescriptor deviceDesc = {};
-  deviceDesc.nextInChain = nullptr;
-  deviceDesc.label = "WarpEngine Device";
-  deviceDesc.requiredFeatureCount = 0;
-  deviceDesc.requiredFeatures = nullptr;
-  deviceDesc.requiredLimits = nullptr;
-  deviceDesc.defaultQueue.nextInChain = nullptr;
-  deviceDesc.defaultQueue.label = "Default Queue";
-  deviceDesc.deviceLostCallback = onDeviceLost;
-  deviceDesc.deviceLostUserdata = nullptr;
-
-  wgpuAdapterRequestDevice(adapter, &deviceDesc, onDeviceRequestEnded, &device);
+  device = requestDevice(adapter);
   if (!device) {
     std::cerr << "Failed to get a WebGPU device!" << std::endl;
-    wgpuSurfaceRelease(surface);
-    wgpuAdapterRelease(adapter);
-    wgpuInstanceRelease(instance);
-    glfwDestroyWindow(window);
-    glfwTerminate();
+    cleanup();
     return -1;
   }
 
-  // Ustaw callback dla błędów
-  wgpuDeviceSetUncapturedErrorCallback(device, onUncapturedError, nullptr);
-
   // Pobierz kolejkę (queue)
-  WGPUQueue queue = wgpuDeviceGetQueue(device);
+  queue = wgpuDeviceGetQueue(device);
   if (!queue) {
     std::cerr << "Failed to get WebGPU queue!" << std::endl;
-    wgpuDeviceRelease(device);
-    wgpuSurfaceRelease(surface);
-    wgpuAdapterRelease(adapter);
-    wgpuInstanceRelease(instance);
-    glfwDestroyWindow(window);
-    glfwTerminate();
+    cleanup();
     return -1;
   }
 
   std::cout << "\nDevice and Queue acquired successfully!" << std::endl;
 
-  // ── 8. Konfiguracja Surface ──────────────────────────────
-  WGPUSurfaceConfiguration surfConfig = {};
-  surfConfig.nextInChain = nullptr;
-  surfConfig.device = device;
-  surfConfig.format = WGPUTextureFormat_BGRA8Unorm;
-  surfConfig.usage = WGPUTextureUsage_RenderAttachment;
-  surfConfig.viewFormatCount = 0;
-  surfConfig.viewFormats = nullptr;
-  surfConfig.alphaMode = WGPUCompositeAlphaMode_Auto;
-  surfConfig.width = 800;
-  surfConfig.height = 600;
-  surfConfig.presentMode = WGPUPresentMode_Fifo;
-
-  wgpuSurfaceConfigure(surface, &surfConfig);
-  std::cout << "Surface configured (800x600, BGRA8Unorm, Fifo)." << std::endl;
-
-  // ── 9. Tworzenie Uniform Buffer i Bind Group ─────────────
-  PlayerUniforms playerUniforms = {};
-  playerUniforms.projection =
-      glm::ortho(0.0f, 800.0f, 600.0f, 0.0f, -1.0f, 1.0f);
-  playerUniforms.position[0] = 0.0f;
-  playerUniforms.position[1] = 0.0f;
-  playerUniforms._pad[0] = 0.0f;
-  playerUniforms._pad[1] = 0.0f;
-
-  // Uniform buffer (Uniform | CopyDst)
-  WGPUBufferDescriptor uniformBufDesc = {};
-  uniformBufDesc.nextInChain = nullptr;
-  uniformBufDesc.label = "Player Uniform Buffer";
-  uniformBufDesc.usage = WGPUBufferUsage_Uniform | WGPUBufferUsage_CopyDst;
-  uniformBufDesc.size = sizeof(PlayerUniforms);
-  uniformBufDesc.mappedAtCreation = false;
-  WGPUBuffer uniformBuffer = wgpuDeviceCreateBuffer(device, &uniformBufDesc);
-
-  // Bind group layout (jeden wpis: buffer uniform, widoczny w vertex shader)
-  WGPUBindGroupLayoutEntry bglEntry = {};
-  bglEntry.nextInChain = nullptr;
-  bglEntry.binding = 0;
-  bglEntry.visibility = WGPUShaderStage_Vertex;
-  bglEntry.buffer.nextInChain = nullptr;
-  bglEntry.buffer.type = WGPUBufferBindingType_Uniform;
-  bglEntry.buffer.hasDynamicOffset = false;
-  bglEntry.buffer.minBindingSize = sizeof(PlayerUniforms);
-  // Zeruj inne typy bindingów
-  bglEntry.sampler.type = WGPUSamplerBindingType_Undefined;
-  bglEntry.texture.sampleType = WGPUTextureSampleType_Undefined;
-  bglEntry.storageTexture.access = WGPUStorageTextureAccess_Undefined;
-
-  WGPUBindGroupLayoutDescriptor bglDesc = {};
-  bglDesc.nextInChain = nullptr;
-  bglDesc.label = "Player Bind Group Layout";
-  bglDesc.entryCount = 1;
-  bglDesc.entries = &bglEntry;
-  WGPUBindGroupLayout bindGroupLayout =
-      wgpuDeviceCreateBindGroupLayout(device, &bglDesc);
-
-  // Bind group — łączy bufor z layoutem
-  WGPUBindGroupEntry bgEntry = {};
-  bgEntry.nextInChain = nullptr;
-  bgEntry.binding = 0;
-  bgEntry.buffer = uniformBuffer;
-  bgEntry.offset = 0;
-  bgEntry.size = sizeof(PlayerUniforms);
-  bgEntry.sampler = nullptr;
-  bgEntry.textureView = nullptr;
-
-  WGPUBindGroupDescriptor bgDesc = {};
-  bgDesc.nextInChain = nullptr;
-  bgDesc.label = "Player Bind Group";
-  bgDesc.layout = bindGroupLayout;
-  bgDesc.entryCount = 1;
-  bgDesc.entries = &bgEntry;
-  WGPUBindGroup bindGroup = wgpuDeviceCreateBindGroup(device, &bgDesc);
-
-  // ── 10. Tworzenie Render Pipeline ────────────────────────
-  WGPURenderPipeline pipeline =
-      createPipeline(device, WGPUTextureFormat_BGRA8Unorm, bindGroupLayout);
-  if (!pipeline) {
-    wgpuBindGroupRelease(bindGroup);
-    wgpuBindGroupLayoutRelease(bindGroupLayout);
-    wgpuBufferRelease(uniformBuffer);
-    wgpuSurfaceUnconfigure(surface);
-    wgpuQueueRelease(queue);
-    wgpuDeviceRelease(device);
-    wgpuSurfaceRelease(surface);
-    wgpuAdapterRelease(adapter);
-    wgpuInstanceRelease(instance);
-    glfwDestroyWindow(window);
-    glfwTerminate();
+  // ── 8. Konfiguracja Swapchain / celu offscreen ───────────
+  // Rozmiar wyjścia: framebuffer okna (na HiDPI większy niż okno)
+  uint32_t outputWidth = options.width;
+  uint32_t outputHeight = options.height;
+  if (options.headless) {
+    if (!createOffscreenTarget(device, options.width, options.height,
+                               colorFormat, offscreen)) {
+      cleanup();
+      return -1;
+    }
+    std::cout << "Offscreen target created (" << options.width << "x"
+              << options.height << ", BGRA8Unorm)." << std::endl;
+  } else {
+    int framebufferWidth = 0, framebufferHeight = 0;
+    glfwGetFramebufferSize(window, &framebufferWidth, &framebufferHeight);
+    if (framebufferWidth > 0 && framebufferHeight > 0) {
+      outputWidth = uint32_t(framebufferWidth);
+      outputHeight = uint32_t(framebufferHeight);
+    }
+    if (!createSwapchain(surface, adapter, device, outputWidth, outputHeight,
+                         options.presentMode, swapchain)) {
+      cleanup();
+      return -1;
+    }
+    colorFormat = swapchain.config.format;
+    if (swapchain.config.presentMode != options.presentMode)
+      std::cout << "Present mode " << presentModeName(options.presentMode)
+                << " not supported, using Fifo." << std::endl;
+    std::cout << "Present mode: "
+              << presentModeName(swapchain.config.presentMode) << std::endl;
+  }
+
+  // ── 9. Pierścień zasobów klatki i Bind Group Layout ─────
+  // Kamera podąża za graczem (start: środek ekranu, jak gracz)
+  Camera2D camera;
+  camera.viewportSize = glm::vec2(float(outputWidth), float(outputHeight));
+  camera.position = camera.viewportSize * 0.5f;
+  CameraUniforms cameraUniforms = cameraBuildUniforms(camera);
+
+  // Dane dynamiczne jednej klatki: uniformy kamery + instancje sprite'ów
+  auto frameBytesNeeded = [&](size_t spriteCount) {
+    return uint64_t(frameRing.uniformAlignment) + sizeof(CameraUniforms) +
+           uint64_t(spriteCount) * sizeof(SpriteInstance);
+  };
+  if (!createFrameRing(device, frameBytesNeeded(options.enemyCount + 1),
+                       frameRing)) {
+    cleanup();
     return -1;
   }
 
-  // ── 11. Pętla renderowania (Triangle + WASD) ─────────────
-  std::cout << "\nWarpEngine started! Use WASD to move. Rendering..."
-            << std::endl;
+  // Cache pipeline'ów: najpierw zestaw z poprzednich uruchomień, potem
+  // pipeline'y tej konfiguracji — wszystko kompiluje się przed pętlą gry
+  pipelineCache = std::make_unique<PipelineCache>(device);
+  if (options.pipelineCachePath) {
+    const uint32_t warmed =
+        pipelineCache->loadWarmupFile(options.pipelineCachePath);
+    if (warmed)
+      std::cout << "Pipeline cache: " << warmed << " pipelines warmed from "
+                << options.pipelineCachePath << std::endl;
+  }
 
-  while (!glfwWindowShouldClose(window)) {
-    glfwPollEvents();
+  // Bind group layout (jeden wpis: buffer uniform z dynamicznym offsetem,
+  // widoczny w vertex shader). Offset wskazuje alokację w buforze klatki.
+  BindGroupLayoutDesc cameraLayoutDesc;
+  cameraLayoutDesc.label = "Camera Bind Group Layout";
+  cameraLayoutDesc.entries = {
+      BindingDesc::buffer(0, WGPUShaderStage_Vertex,
+                          WGPUBufferBindingType_Uniform,
+                          sizeof(CameraUniforms), true),
+  };
+  bindGroupLayout = pipelineCache->bindGroupLayout(cameraLayoutDesc);
+  pipelineCache->warmup({spritePipelineDesc(colorFormat, cameraLayoutDesc)});
+
+  // Bind group — łączy bufor slotu pierścienia z layoutem. Tworzony na nowo,
+  // gdy slot zrealokuje bufor (zmiana FrameSlot::version).
+  auto updateCameraBindGroup = [&](uint32_t slotIndex) {
+    const FrameSlot &slot = frameRing.slots[slotIndex];
+    if (cameraBindGroups[slotIndex] &&
+        cameraBindGroupVersions[slotIndex] == slot.version)
+      return;
+    if (cameraBindGroups[slotIndex])
+      wgpuBindGroupRelease(cameraBindGroups[slotIndex]);
+
+    WGPUBindGroupEntry bgEntry = {};
+    bgEntry.nextInChain = nullptr;
+    bgEntry.binding = 0;
+    bgEntry.buffer = slot.buffer;
+    bgEntry.offset = 0;
+    bgEntry.size = sizeof(CameraUniforms);
+    bgEntry.sampler = nullptr;
+    bgEntry.textureView = nullptr;
+
+    WGPUBindGroupDescriptor bgDesc = {};
+    bgDesc.nextInChain = nullptr;
+    bgDesc.label = "Camera Bind Group";
+    bgDesc.layout = bindGroupLayout;
+    bgDesc.entryCount = 1;
+    bgDesc.entries = &bgEntry;
+    cameraBindGroups[slotIndex] = wgpuDeviceCreateBindGroup(device, &bgDesc);
+    cameraBindGroupVersions[slotIndex] = slot.version;
+  };
+
+  // ── 10. Tworzenie Sprite Batch (pipeline + bufory) ───────
+  if (!createSpriteBatch(device, *pipelineCache, colorFormat,
+                         cameraLayoutDesc, options.enemyCount + 1,
+                         spriteBatch)) {
+    cleanup();
+    return -1;
+  }
 
-    // ── Obsługa klawiatury (WASD) ──────────────────────────
-    const float speed = 5.0f;
-    if (glfwGetKey(window, GLFW_KEY_W) == GLFW_PRESS)
-      playerUniforms.position[1] -= speed;
-    if (glfwGetKey(window, GLFW_KEY_S) == GLFW_PRESS)
-      playerUniforms.position[1] += speed;
-    if (glfwGetKey(window, GLFW_KEY_A) == GLFW_PRESS)
-      playerUniforms.position[0] -= speed;
-    if (glfwGetKey(window, GLFW_KEY_D) == GLFW_PRESS)
-      playerUniforms.position[0] += speed;
+  // Atlas startowy: jedna biała klatka (sam kolor tint). Atlas z pliku
+  // (--atlas) wczytuje AssetManager w tle i podmienia go w trakcie gry.
+  if (!createSolidTextureAtlas(device, queue, spriteBatch.atlasLayout,
+                               atlas)) {
+    cleanup();
+    return -1;
+  }
+  spriteBatchSetAtlas(spriteBatch, atlas);
+
+  // Trwały bufor kamery z własnym bind groupem (poza pierścieniem klatki)
+  auto createCameraBinding = [&](const char *label,
+                                 const CameraUniforms &uniforms,
+                                 WGPUBuffer &buffer,
+                                 WGPUBindGroup &bindGroup) {
+    WGPUBufferDescriptor bufferDesc = {};
+    bufferDesc.nextInChain = nullptr;
+    bufferDesc.label = label;
+    bufferDesc.usage = WGPUBufferUsage_Uniform | WGPUBufferUsage_CopyDst;
+    bufferDesc.size = sizeof(CameraUniforms);
+    bufferDesc.mappedAtCreation = false;
+    buffer = wgpuDeviceCreateBuffer(device, &bufferDesc);
+    if (!buffer) {
+      std::cerr << "Failed to create " << label << " buffer!" << std::endl;
+      return false;
+    }
+    wgpuQueueWriteBuffer(queue, buffer, 0, &uniforms, sizeof(uniforms));
+
+    WGPUBindGroupEntry bgEntry = {};
+    bgEntry.binding = 0;
+    bgEntry.buffer = buffer;
+    bgEntry.offset = 0;
+    bgEntry.size = sizeof(CameraUniforms);
+    WGPUBindGroupDescriptor bgDesc = {};
+    bgDesc.nextInChain = nullptr;
+    bgDesc.label = label;
+    bgDesc.layout = bindGroupLayout;
+    bgDesc.entryCount = 1;
+    bgDesc.entries = &bgEntry;
+    bindGroup = wgpuDeviceCreateBindGroup(device, &bgDesc);
+    return bindGroup != nullptr;
+  };
+
+  // ── 10a. Warstwy w render bundle'ach (tło) ───────────────
+  // Bundle nie może używać pierścienia klatki (inny bufor w każdym slocie),
+  // więc warstwy statyczne czytają kamerę z własnego, trwałego bufora
+  if (!createCameraBinding("Static Camera", cameraUniforms,
+                           staticCameraBuffer, staticCameraBindGroup)) {
+    cleanup();
+    return -1;
+  }
 
-    // Prześlij zaktualizowaną pozycję do GPU
-    wgpuQueueWriteBuffer(queue, uniformBuffer, 0, &playerUniforms,
-                         sizeof(playerUniforms));
+  bundles = std::make_unique<RenderBundleSet>(device, colorFormat);
+  // Mapa kafelkowa zastępuje szachownicę — jej chunki są strumieniowane
+  // za kamerą, więc nie trafiają do bundle'a
+  if (options.mapPath &&
+      !loadTilemap(device, options.mapPath, atlas, tilemap)) {
+    cleanup();
+    return -1;
+  }
+  // Podłoga w szachownicę: biała klatka, po podmianie atlasu "floor"
+  const float backgroundTileSize = 32.0f;
+  const uint32_t backgroundColumns =
+      uint32_t(options.width / backgroundTileSize) + 1;
+  const uint32_t backgroundRows =
+      uint32_t(options.height / backgroundTileSize) + 1;
+  auto fillBackground = [&](const TextureAtlas &floorAtlas,
+                            uint32_t floorFrame) {
+    spriteBatchClear(backgroundBatch);
+    for (uint32_t y = 0; y < backgroundRows; ++y) {
+      for (uint32_t x = 0; x < backgroundColumns; ++x) {
+        SpriteInstance tile = {};
+        tile.position[0] = (float(x) + 0.5f) * backgroundTileSize;
+        tile.position[1] = (float(y) + 0.5f) * backgroundTileSize;
+        tile.scale[0] = tile.scale[1] = backgroundTileSize;
+        tile.atlasIndex = floorFrame;
+        tile.tint = (x + y) % 2 ? packColor(20, 20, 60) : packColor(26, 26, 72);
+        spriteBatchAdd(backgroundBatch, tile);
+      }
+    }
+    spriteBatchUpload(queue, backgroundBatch);
+    spriteBatchSetAtlas(backgroundBatch, floorAtlas);
+  };
+  uint32_t backgroundLayer = ~0u;
+  if (!options.mapPath) {
+    if (!createSpriteBatch(device, *pipelineCache, colorFormat,
+                           cameraLayoutDesc,
+                           backgroundColumns * backgroundRows,
+                           backgroundBatch)) {
+      cleanup();
+      return -1;
+    }
+    fillBackground(atlas, atlasFindFrame(atlas, "white"));
+
+    backgroundLayer =
+        bundles->addLayer("Background", [&](WGPURenderBundleEncoder encoder) {
+          const uint32_t zeroOffset = 0;
+          wgpuRenderBundleEncoderSetBindGroup(
+              encoder, 0, staticCameraBindGroup, 1, &zeroOffset);
+          spriteBatchRecordBundle(encoder, backgroundBatch);
+        });
+  }
 
-    // 9a. Pobierz bieżącą teksturę z surface
-    WGPUSurfaceTexture surfaceTexture = {};
-    wgpuSurfaceGetCurrentTexture(surface, &surfaceTexture);
+  // Tekst: wbudowany font; HUD rysowany kamerą w pikselach ekranu
+  Camera2D hudCamera;
+  hudCamera.viewportSize = camera.viewportSize;
+  hudCamera.position = hudCamera.viewportSize * 0.5f;
+  if (!createTextRenderer(device, queue, *pipelineCache, colorFormat,
+                          cameraLayoutDesc, text) ||
+      !createCameraBinding("HUD Camera", cameraBuildUniforms(hudCamera),
+                           hudCameraBuffer, hudCameraBindGroup)) {
+    cleanup();
+    return -1;
+  }
+  TextStyle hudStyle;
+  hudStyle.size = 14.0f;
+  const TextLabelId timeLabel =
+      textCreateLabel(text, TextSpace::Screen, "TIME 00:00", 8.0f, 8.0f,
+                      hudStyle);
+  const TextLabelId fpsLabel =
+      textCreateLabel(text, TextSpace::Screen, "FPS", 8.0f, 28.0f, hudStyle);
+  const TextLabelId spritesLabel = textCreateLabel(
+      text, TextSpace::Screen, "SPRITES", 8.0f, 48.0f, hudStyle);
+  FloatingNumbers floatingNumbers;
+
+  // Pomiar czasu passów GPU (gdy adapter obsługuje timestamp queries)
+  if (!createGpuProfiler(device, gpuProfiler)) {
+    cleanup();
+    return -1;
+  }
 
-    if (surfaceTexture.status != WGPUSurfaceGetCurrentTextureStatus_Success) {
-      std::cerr << "Failed to get current surface texture!" << std::endl;
-      break;
+  // Dynamiczna rozdzielczość: regulator potrzebuje czasów GPU klatek
+  if (options.dynamicResTargetMs > 0.0) {
+    if (!gpuProfiler.supported) {
+      std::cout << "Dynamic resolution needs timestamp queries, rendering "
+                   "at native resolution." << std::endl;
+    } else if (!createScaledScene(device, *pipelineCache, colorFormat,
+                                  outputWidth, outputHeight, scaledScene)) {
+      cleanup();
+      return -1;
+    } else {
+      dynamicRes.targetGpuMs = options.dynamicResTargetMs;
     }
+  }
 
-    // 9b. Stwórz widok tekstury
-    WGPUTextureViewDescriptor viewDesc = {};
-    viewDesc.nextInChain = nullptr;
-    viewDesc.label = "Surface Texture View";
-    viewDesc.format = WGPUTextureFormat_BGRA8Unorm;
-    viewDesc.dimension = WGPUTextureViewDimension_2D;
-    viewDesc.baseMipLevel = 0;
-    viewDesc.mipLevelCount = 1;
-    viewDesc.baseArrayLayer = 0;
-    viewDesc.arrayLayerCount = 1;
-    viewDesc.aspect = WGPUTextureAspect_All;
-    WGPUTextureView textureView =
-        wgpuTextureCreateView(surfaceTexture.texture, &viewDesc);
-
-    // 9c. Stwórz command encoder
-    WGPUCommandEncoderDescriptor encoderDesc = {};
-    encoderDesc.nextInChain = nullptr;
-    encoderDesc.label = "Command Encoder";
-    WGPUCommandEncoder encoder =
-        wgpuDeviceCreateCommandEncoder(device, &encoderDesc);
+  // ── 10b. Symulacja na GPU (cząsteczki + horda) ───────────
+  // Pozycje i instancje zostają w buforach storage; sprite'y rysowane są
+  // prosto z nich (spriteBatchDrawInstances), bez odczytu na CPU
+  if (options.particleCapacity > 0) {
+    if (!createGpuParticles(device, *pipelineCache, options.particleCapacity,
+                            particles) ||
+        !createSpriteBatch(device, *pipelineCache, colorFormat,
+                           cameraLayoutDesc, 1, particleBatch,
+                           BlendMode::Additive)) {
+      cleanup();
+      return -1;
+    }
+    spriteBatchSetAtlas(particleBatch, atlas);
+  }
+  if (options.gpuHordeCount > 0) {
+    GpuHordeSettings hordeSettings;
+    hordeSettings.worldWidth = float(options.width);
+    hordeSettings.worldHeight = float(options.height);
+    if (!createGpuHorde(device, *pipelineCache, particles,
+                        options.gpuHordeCount, hordeSettings, gpuHorde)) {
+      cleanup();
+      return -1;
+    }
+  }
+  // Culling na GPU: widoczne instancje kompaktowane w compute passie,
+  // liczbę instancji do rysowania zapisuje GPU (DrawIndexedIndirect).
+  // Domyślnie włączony — bez niego rysowany jest cały pierścień cząsteczek
+  // (martwe jako quady o zerowym rozmiarze), czyli O(pojemność) wierzchołków
+  // na klatkę nawet przy pustym pierścieniu.
+  if (options.gpuCulling && (gpuHorde.agentCount || particles.capacity)) {
+    if (!createGpuCulling(device, *pipelineCache, gpuCulling)) {
+      cleanup();
+      return -1;
+    }
+    if (gpuHorde.agentCount)
+      hordeCullStream = gpuCullingAddStream(
+          gpuCulling, gpuHorde.instanceBuffer, gpuHorde.agentCount);
+    if (particles.capacity)
+      particleCullStream = gpuCullingAddStream(
+          gpuCulling, particles.instanceBuffer, particles.capacity);
+    if ((gpuHorde.agentCount && hordeCullStream == ~0u) ||
+        (particles.capacity && particleCullStream == ~0u)) {
+      cleanup();
+      return -1;
+    }
+  }
 
-    // 9d. Rozpocznij render pass — czyszczenie kolorem granatowym
+  // ── 10c. Encje: gracz + horda wrogów ─────────────────────
+  JobSystem jobs;
+  // Pamięć tymczasowa klatki (dowolny wątek), zwalniana po submit
+  FrameArena frameArena(1u << 20);
+  EnemyBroadPhase enemyBroadPhase;
+  // Pole przepływu po kafelkach mapy — wspólne dla całej hordy. Bez mapy
+  // nie ma przeszkód, więc wrogowie idą prosto do gracza.
+  std::unique_ptr<FlowField> flowField;
+  if (tilemap.view.header) {
+    const TilemapFileHeader &mapHeader = *tilemap.view.header;
+    flowField = std::make_unique<FlowField>(
+        jobs, mapHeader.chunksX * mapHeader.chunkSize,
+        mapHeader.chunksY * mapHeader.chunkSize, mapHeader.tileSize);
+    flowField->setBlockedMask(tilemapBlockedMask(tilemap.view));
+    // Headless: przebieg nie może zależeć od czasu budowy pola w tle
+    flowField->setSynchronous(options.headless);
+  }
+  EntityStore entities;
+  const EntityHandle player = entities.create(
+      Component_Position | Component_Velocity | Component_Sprite | Tag_Player);
+  entities.f32(player, Column_PositionX) = float(options.width) * 0.5f;
+  entities.f32(player, Column_PositionY) = float(options.height) * 0.5f;
+  entities.f32(player, Column_SpriteSize) = 48.0f;
+  entities.u32(player, Column_SpriteTint) = packColor(255, 0, 0);
+  entities.u32(player, Column_SpriteLayer) = 1; // nad wrogami (warstwa 0)
+
+  uint32_t seed = options.seed;
+  auto nextRandom = [&seed]() {
+    seed = seed * 1664525u + 1013904223u;
+    return float(seed >> 8) / float(1u << 24);
+  };
+  for (uint32_t i = 0; i < options.enemyCount; ++i) {
+    const EntityHandle enemy =
+        entities.create(Component_Position | Component_Velocity |
+                        Component_Health | Component_Sprite | Tag_Enemy);
+    entities.f32(enemy, Column_PositionX) = nextRandom() * float(options.width);
+    entities.f32(enemy, Column_PositionY) =
+        nextRandom() * float(options.height);
+    entities.f32(enemy, Column_Health) = 10.0f;
+    entities.f32(enemy, Column_SpriteSize) = 6.0f + nextRandom() * 10.0f;
+    entities.f32(enemy, Column_SpriteRotation) = nextRandom() * 6.2831853f;
+    entities.u32(enemy, Column_SpriteTint) =
+        packColor(uint8_t(64 + nextRandom() * 191), 200,
+                  uint8_t(64 + nextRandom() * 191));
+    entities.u32(enemy, Column_SpriteAtlas) = seed % atlas.frameCount;
+  }
+  storePreviousPositionsSystem(entities);
+
+  // Numer ticku świata (zapisywany w zrzutach; cofa się razem ze światem)
+  uint64_t worldTick = 0;
+  // Start ze zrzutu: encje, tick i stan losowania z pliku .wsnp. Gracz
+  // jest pierwszą encją, więc uchwyt pozostaje ważny dla zrzutów
+  // zapisanych przez ten sam plik wykonywalny.
+  if (options.loadSnapshotPath) {
+    std::vector<uint8_t> bytes;
+    if (!readWorldSnapshotFile(options.loadSnapshotPath, bytes) ||
+        !restoreWorldSnapshot(bytes.data(), bytes.size(), entities, worldTick,
+                              seed)) {
+      cleanup();
+      return -1;
+    }
+    if (!entities.isAlive(player) ||
+        !(entities.mask(player) & Tag_Player)) {
+      std::cerr << "Snapshot has no player entity" << std::endl;
+      cleanup();
+      return -1;
+    }
+    std::cout << "Loaded world snapshot: tick " << worldTick << ", "
+              << entities.size() << " entities" << std::endl;
+  }
+  if (options.rewindSeconds > 0.0)
+    snapshots = std::make_unique<SnapshotRing>(
+        uint64_t(options.rewindSeconds * options.tickRate),
+        size_t(options.snapshotBudgetMB) << 20,
+        uint32_t(options.tickRate));
+
+  // ── 10d. Assety wczytywane w tle ─────────────────────────
+  // Plik czyta wątek I/O, waliduje worker puli, a piksele trafiają na GPU
+  // porcjami w kolejnych klatkach — pętla gry nie czeka na dysk
+  if (options.atlasPath) {
+    assets = std::make_unique<AssetManager>(
+        device, queue, jobs, uint64_t(options.uploadBudgetMB) << 20);
+    pendingAtlas = assets->loadAtlas(options.atlasPath,
+                                     spriteBatch.atlasLayout,
+                                     AssetPriority::Critical);
+  }
+  // Podmiana atlasu: batche, klatki encji, hordy, cząsteczek i mapy
+  auto applyAtlas = [&](const TextureAtlas &loaded) {
+    currentAtlas = &loaded;
+    spriteBatchSetAtlas(spriteBatch, loaded);
+    if (particles.capacity) {
+      spriteBatchSetAtlas(particleBatch, loaded);
+      const uint32_t particleFrame = atlasFindFrame(loaded, "particle");
+      if (particleFrame != kInvalidAtlasFrame)
+        particles.atlasFrame = particleFrame;
+    }
+    const uint32_t enemyFrame = atlasFindFrame(loaded, "enemy");
+    if (gpuHorde.agentCount && enemyFrame != kInvalidAtlasFrame)
+      gpuHorde.settings.atlasFrame = enemyFrame;
+    // Bez klatki "floor" tło zostaje na białej klatce atlasu startowego
+    const uint32_t floorFrame = atlasFindFrame(loaded, "floor");
+    if (backgroundLayer != ~0u && floorFrame != kInvalidAtlasFrame) {
+      fillBackground(loaded, floorFrame);
+      bundles->markDirty(backgroundLayer);
+    }
+    if (tilemap.view.header)
+      tilemapSetAtlas(tilemap, loaded);
+
+    // Klatka "player" z atlasu (jeśli istnieje) rysowana bez barwienia
+    const uint32_t playerFrame = atlasFindFrame(loaded, "player");
+    if (playerFrame != kInvalidAtlasFrame) {
+      entities.u32(player, Column_SpriteAtlas) = playerFrame;
+      entities.u32(player, Column_SpriteTint) = packColor(255, 255, 255);
+    }
+    // parseAtlas odrzuca atlas bez klatek; sprawdzenie chroni przed
+    // dzieleniem przez zero, gdyby atlas trafił tu inną drogą
+    if (loaded.frameCount == 0)
+      return;
+    entities.forEachChunk(
+        Component_Sprite | Tag_Enemy, [&](const ChunkView &chunk) {
+          uint32_t *frames = chunk.u32(Column_SpriteAtlas);
+          for (uint32_t i = 0; i < chunk.count; ++i) {
+            nextRandom();
+            frames[i] = seed % loaded.frameCount;
+          }
+        });
+  };
+  // Headless: atlas gotowy przed pierwszą klatką — przebieg (i zrzut
+  // klatki) nie zależy od tempa dysku
+  if (options.headless && pendingAtlas.valid() &&
+      assets->wait(pendingAtlas) == AssetState::Ready) {
+    applyAtlas(*assets->atlas(pendingAtlas));
+    loadedAtlas = std::move(pendingAtlas);
+  }
+
+  // Jeden tick symulacji: sterowanie, systemy gry, kolizje. Tick może
+  // działać na dowolnym wątku puli; wejście to zdarzenia z kolejki
+  // InputSystem do końca ticku (inputUntilNs).
+  const float playerSpeed = 300.0f; // px/s
+  uint32_t burstRequests = 0; // wybuchy ze spacji (wykonuje wątek główny)
+  uint32_t rewindRequests = 0; // cofnięcia klawiszem R (wątek główny)
+  auto simulationTick = [&](float dt, uint64_t inputUntilNs) {
+    WARP_PROFILE_SCOPE("Simulation Tick");
+    const InputState &inputState = input.advance(inputUntilNs);
+    glm::vec2 moveInput(0.0f);
+    if (inputState.keyHeld(GLFW_KEY_W))
+      moveInput.y -= 1.0f;
+    if (inputState.keyHeld(GLFW_KEY_S))
+      moveInput.y += 1.0f;
+    if (inputState.keyHeld(GLFW_KEY_A))
+      moveInput.x -= 1.0f;
+    if (inputState.keyHeld(GLFW_KEY_D))
+      moveInput.x += 1.0f;
+    // Spacja: wybuch 100k cząsteczek w miejscu gracza (na zboczu)
+    if (inputState.keyPressed(GLFW_KEY_SPACE))
+      ++burstRequests;
+    // R: cofnięcie świata o 2 s (po grafie klatki — Frame Resources czyta
+    // liczbę encji równolegle z symulacją)
+    if (inputState.keyPressed(GLFW_KEY_R))
+      ++rewindRequests;
+    // Zoom przed zadaniem Pack Instances (zależy od symulacji)
+    float zoomInput = 0.0f;
+    if (inputState.keyHeld(GLFW_KEY_E))
+      zoomInput += 1.0f;
+    if (inputState.keyHeld(GLFW_KEY_Q))
+      zoomInput -= 1.0f;
+    if (zoomInput != 0.0f)
+      cameraSetZoom(camera, camera.zoom * std::exp(zoomInput * dt));
+
+    storePreviousPositionsSystem(entities);
+
+    entities.f32(player, Column_VelocityX) = moveInput.x * playerSpeed;
+    entities.f32(player, Column_VelocityY) = moveInput.y * playerSpeed;
+
+    const glm::vec2 playerPos(entities.f32(player, Column_PositionX),
+                              entities.f32(player, Column_PositionY));
+    if (flowField) {
+      flowField->update(playerPos);
+      flowFieldSeekSystem(entities, *flowField, playerPos, 60.0f);
+    } else {
+      seekTargetSystem(entities, playerPos, 60.0f);
+    }
+    integrateVelocitySystem(entities, dt);
+    buildEnemyGridSystem(entities, enemyBroadPhase);
+    separationSystem(entities, enemyBroadPhase, jobs, 12.0f, 0.5f);
+
+    // Zrzut stanu po ticku (seed zmienia tylko wątek główny poza grafem)
+    ++worldTick;
+    if (snapshots)
+      snapshots->capture(entities, worldTick, seed);
+  };
+
+  FixedTimestep timestep;
+  timestep.tickSeconds = 1.0 / options.tickRate;
+
+  // ── 10e. Graf zadań klatki ───────────────────────────────
+  //   Simulation ──────────┐
+  //   Frame Resources ─────┴─→ Pack Instances
+  //   Record Bundles (niezależne)
+  // Wejście (przed grafem) i kodowanie (po nim) zostają na wątku głównym.
+  uint32_t frameTicks = 0;
+  float frameAlpha = 1.0f;
+  uint64_t inputSampleNs = 0; // ostatnie pobranie zdarzeń okna
+  bool frameResourcesReady = false;
+  uint32_t cameraOffset = 0;
+  FrameAllocation cameraAllocation = {};
+  float frameDt = 0.0f;
+  SpriteDrawList spriteDrawList;
+
+  TaskGraph frameGraph;
+  const TaskGraph::TaskId simulationTask =
+      frameGraph.add("Simulation", [&](uint32_t) {
+        // Ticki klatki rozłożone wstecz od pobrania zdarzeń co krok —
+        // ostatni tick zużywa wszystko, co już przyszło
+        const uint64_t tickNs = uint64_t(timestep.tickSeconds * 1e9);
+        for (uint32_t t = 0; t < frameTicks; ++t) {
+          const uint64_t back = uint64_t(frameTicks - 1 - t) * tickNs;
+          simulationTick(float(timestep.tickSeconds),
+                         inputSampleNs > back ? inputSampleNs - back : 0);
+        }
+      });
+  // Slot pierścienia tej klatki — równolegle z symulacją (na GPU czeka
+  // wcześniej wątek główny: frameRingWaitForSlot)
+  const TaskGraph::TaskId frameResourcesTask =
+      frameGraph.add("Frame Resources", [&](uint32_t) {
+        frameResourcesReady = frameRingBeginFrame(
+            frameRing, frameBytesNeeded(entities.size()));
+        if (!frameResourcesReady)
+          return;
+        updateCameraBindGroup(frameRing.current);
+        cameraAllocation =
+            frameRingAllocateUniform(frameRing, sizeof(CameraUniforms));
+        cameraOffset = uint32_t(cameraAllocation.offset);
+      });
+  // Kamera za interpolowaną pozycją gracza, potem widoczne sprite'y
+  // (culling + sortowanie kluczy) do bufora klatki
+  const TaskGraph::TaskId packTask =
+      frameGraph.add("Pack Instances", [&](uint32_t) {
+        if (!frameResourcesReady)
+          return;
+        const float prevX = entities.f32(player, Column_PrevPositionX);
+        const float prevY = entities.f32(player, Column_PrevPositionY);
+        const glm::vec2 playerPos(
+            prevX + (entities.f32(player, Column_PositionX) - prevX) *
+                        frameAlpha,
+            prevY + (entities.f32(player, Column_PositionY) - prevY) *
+                        frameAlpha);
+        cameraFollow(camera, playerPos, frameDt);
+        cameraUniforms = cameraBuildUniforms(camera);
+        std::memcpy(cameraAllocation.data, &cameraUniforms,
+                    sizeof(cameraUniforms));
+
+        packSpritesSystem(entities, spriteBatch, frameAlpha,
+                          cameraViewRect(camera), currentAtlas->framePages,
+                          frameArena, spriteDrawList);
+        spriteBatchUploadFrame(frameRing, spriteBatch);
+      });
+  frameGraph.depend(packTask, simulationTask);
+  frameGraph.depend(packTask, frameResourcesTask);
+  // Warstwy bundle'i: nagrywane ponownie tylko po oznaczeniu jako brudne
+  frameGraph.add("Record Bundles",
+                 [&](uint32_t) { bundles->recordDirty(jobs); });
+
+  // ── 10f. Graf renderowania ───────────────────────────────
+  //   Horde Compute ─→ Particle Compute ─→ [GPU Cull] ─→ Sprite Pass ─→ Output
+  //   z dynamiczną rozdzielczością: Sprite Pass ─→ Scene Color (tymczasowa)
+  //   ─→ Upscale Pass ─→ Output; headless z --dump: Output ─→ Readback
+  // Kolejność wynika z zadeklarowanych zasobów; graf odrzuca passy bez
+  // odbiorcy i przydziela tekstury tymczasowe z puli (przebudowa tylko po
+  // zmianie rozmiaru wyjścia).
+  renderGraph = std::make_unique<RenderGraph>(device);
+  RenderGraphResource outputTexture = kInvalidGraphResource;
+  bool dumpFrame = false;
+
+  // Render pass czyszczący cel kolorem granatowym (z pomiarem GPU)
+  auto beginColorPass = [&](WGPUCommandEncoder encoder, WGPUTextureView view,
+                            const char *label) {
     WGPURenderPassColorAttachment colorAttachment = {};
     colorAttachment.nextInChain = nullptr;
-    colorAttachment.view = textureView;
+    colorAttachment.view = view;
     colorAttachment.resolveTarget = nullptr;
     colorAttachment.loadOp = WGPULoadOp_Clear;
     colorAttachment.storeOp = WGPUStoreOp_Store;
@@ -528,57 +991,717 @@ int main() {
 
     WGPURenderPassDescriptor renderPassDesc = {};
     renderPassDesc.nextInChain = nullptr;
-    renderPassDesc.label = "Clear Screen Pass";
+    renderPassDesc.label = label;
     renderPassDesc.colorAttachmentCount = 1;
     renderPassDesc.colorAttachments = &colorAttachment;
     renderPassDesc.depthStencilAttachment = nullptr;
     renderPassDesc.occlusionQuerySet = nullptr;
-    renderPassDesc.timestampWrites = nullptr;
+    renderPassDesc.timestampWrites = gpuProfilerRenderPass(gpuProfiler, label);
+    return wgpuCommandEncoderBeginRenderPass(encoder, &renderPassDesc);
+  };
+  // HUD kamerą w pikselach ekranu — zawsze w rozdzielczości wyjścia
+  auto drawHud = [&](WGPURenderPassEncoder renderPass) {
+    const uint32_t hudOffset = 0;
+    wgpuRenderPassEncoderSetBindGroup(renderPass, 0, hudCameraBindGroup, 1,
+                                      &hudOffset);
+    textDraw(renderPass, text, TextSpace::Screen);
+  };
+
+  // Instancje z bufora GPU: wszystkie albo (z --gpu-cull) tylko widoczne,
+  // z liczbą z bufora argumentów
+  auto drawGpuInstances = [&](WGPURenderPassEncoder renderPass,
+                              const SpriteBatch &batch, WGPUBuffer buffer,
+                              uint32_t count, uint32_t cullStream) {
+    if (cullStream == ~0u) {
+      spriteBatchDrawInstances(renderPass, batch, buffer, 0, count);
+      return;
+    }
+    const GpuCullStream &stream = gpuCulling.streams[cullStream];
+    spriteBatchDrawIndirect(renderPass, batch, stream.visibleBuffer,
+                            stream.capacity, stream.indirectBuffer, 0);
+  };
+
+  auto buildRenderGraph = [&]() {
+    renderGraph->clear();
+    outputTexture = renderGraph->importTexture("Output");
+    const RenderGraphResource hordeInstances =
+        renderGraph->importBuffer("Horde Instances");
+    const RenderGraphResource particleEvents =
+        renderGraph->importBuffer("Particle Events");
+    const RenderGraphResource particleInstances =
+        renderGraph->importBuffer("Particle Instances");
+    const RenderGraphResource visibleInstances =
+        renderGraph->importBuffer("Visible Instances");
+    const bool scaled = scaledScene.device != nullptr;
+    const RenderGraphResource sceneColor =
+        scaled ? renderGraph->createTexture(
+                     "Scene Color",
+                     {scaledScene.width, scaledScene.height, colorFormat})
+               : outputTexture;
+
+    // Compute: horda (zgłasza wybuchy), potem cząsteczki
+    if (gpuHorde.agentCount) {
+      const RenderGraph::PassId pass = renderGraph->addPass(
+          "Horde Compute", [&](WGPUCommandEncoder encoder, const RenderGraph &) {
+            gpuHordeEncode(encoder, gpuHorde,
+                           gpuProfilerComputePass(gpuProfiler,
+                                                  "Horde Compute"));
+          });
+      renderGraph->write(pass, hordeInstances, WGPUTextureUsage_None);
+      renderGraph->write(pass, particleEvents, WGPUTextureUsage_None);
+    }
+    if (particles.capacity) {
+      const RenderGraph::PassId pass = renderGraph->addPass(
+          "Particle Compute",
+          [&](WGPUCommandEncoder encoder, const RenderGraph &) {
+            gpuParticlesEncode(
+                encoder, particles,
+                gpuProfilerComputePass(gpuProfiler, "Particle Compute"));
+          });
+      renderGraph->read(pass, particleEvents, WGPUTextureUsage_None);
+      renderGraph->write(pass, particleInstances, WGPUTextureUsage_None);
+    }
+    // Culling i kompaktowanie instancji do widocznych
+    if (gpuCulling.streamCount) {
+      const RenderGraph::PassId pass = renderGraph->addPass(
+          "GPU Cull", [&](WGPUCommandEncoder encoder, const RenderGraph &) {
+            gpuCullingEncode(encoder, gpuCulling,
+                             gpuProfilerComputePass(gpuProfiler, "GPU Cull"));
+          });
+      if (gpuHorde.agentCount)
+        renderGraph->read(pass, hordeInstances, WGPUTextureUsage_None);
+      if (particles.capacity)
+        renderGraph->read(pass, particleInstances, WGPUTextureUsage_None);
+      renderGraph->write(pass, visibleInstances, WGPUTextureUsage_None);
+    }
+
+    // Świat; przy dynamicznej rozdzielczości do przeskalowanego
+    // fragmentu tekstury sceny, a HUD rysuje dopiero pass skalowania
+    const RenderGraph::PassId spritePass = renderGraph->addPass(
+        "Sprite Pass", [&, sceneColor, scaled](WGPUCommandEncoder encoder,
+                                               const RenderGraph &graph) {
+          WGPURenderPassEncoder renderPass =
+              beginColorPass(encoder, graph.view(sceneColor), "Sprite Pass");
+          if (scaled)
+            scaledSceneSetViewport(renderPass, scaledScene, dynamicRes.scale);
+
+          // Najpierw warstwy statyczne z bundle'i (zerują stan passa),
+          // potem bind group kamery, widoczne chunki mapy, horda GPU,
+          // sprite'y CPU jednym draw callem i na końcu cząsteczki
+          // (addytywnie)
+          bundles->execute(renderPass);
+          wgpuRenderPassEncoderSetBindGroup(
+              renderPass, 0, cameraBindGroups[frameRing.current], 1,
+              &cameraOffset);
+          tilemapDraw(renderPass, tilemap, spriteBatch);
+          if (gpuHorde.agentCount)
+            drawGpuInstances(renderPass, spriteBatch, gpuHorde.instanceBuffer,
+                             gpuHorde.agentCount, hordeCullStream);
+          // Lista rysowania: batch = zakres jednego pipeline'u
+          // (0: spriteBatch)
+          for (const DrawBatch &drawBatch : spriteDrawList.drawList.batches)
+            spriteBatchDrawRange(renderPass, spriteBatch, drawBatch.first,
+                                 drawBatch.count);
+          if (particles.capacity)
+            drawGpuInstances(renderPass, particleBatch,
+                             particles.instanceBuffer, particles.capacity,
+                             particleCullStream);
+          // Tekst na wierzchu: jeden draw na przestrzeń (świat, potem HUD)
+          textDraw(renderPass, text, TextSpace::World);
+          if (!scaled)
+            drawHud(renderPass);
+          wgpuRenderPassEncoderEnd(renderPass);
+          wgpuRenderPassEncoderRelease(renderPass);
+        });
+    renderGraph->write(spritePass, sceneColor);
+    if (gpuCulling.streamCount) {
+      renderGraph->read(spritePass, visibleInstances, WGPUTextureUsage_None);
+    } else {
+      if (gpuHorde.agentCount)
+        renderGraph->read(spritePass, hordeInstances, WGPUTextureUsage_None);
+      if (particles.capacity)
+        renderGraph->read(spritePass, particleInstances,
+                          WGPUTextureUsage_None);
+    }
 
-    WGPURenderPassEncoder renderPass =
-        wgpuCommandEncoderBeginRenderPass(encoder, &renderPassDesc);
+    // Skalowanie: scena rozciągnięta na cały cel wyjścia, HUD w natywnej
+    // rozdzielczości
+    if (scaled) {
+      const RenderGraph::PassId upscalePass = renderGraph->addPass(
+          "Upscale Pass", [&, sceneColor](WGPUCommandEncoder encoder,
+                                          const RenderGraph &graph) {
+            WGPURenderPassEncoder renderPass = beginColorPass(
+                encoder, graph.view(outputTexture), "Upscale Pass");
+            scaledSceneDrawUpscale(renderPass, scaledScene,
+                                   graph.view(sceneColor));
+            drawHud(renderPass);
+            wgpuRenderPassEncoderEnd(renderPass);
+            wgpuRenderPassEncoderRelease(renderPass);
+          });
+      renderGraph->read(upscalePass, sceneColor);
+      renderGraph->write(upscalePass, outputTexture);
+    }
+
+    // Ostatnia klatka headless: kopia obrazu do bufora readback
+    if (options.headless && options.dumpPath) {
+      const RenderGraph::PassId readbackPass = renderGraph->addPass(
+          "Readback", [&](WGPUCommandEncoder encoder, const RenderGraph &) {
+            if (dumpFrame)
+              encodeOffscreenReadback(encoder, offscreen);
+          });
+      renderGraph->read(readbackPass, outputTexture, WGPUTextureUsage_CopySrc);
+      renderGraph->keep(readbackPass);
+    }
+    return renderGraph->compile();
+  };
+  if (!buildRenderGraph()) {
+    cleanup();
+    return -1;
+  }
 
-    // Ustaw pipeline i bind group, rysuj trójkąt
-    wgpuRenderPassEncoderSetPipeline(renderPass, pipeline);
-    wgpuRenderPassEncoderSetBindGroup(renderPass, 0, bindGroup, 0, nullptr);
-    wgpuRenderPassEncoderDraw(renderPass, 3, 1, 0, 0);
+  // Nowy rozmiar framebuffera: kamery świata i HUD, cel sceny i graf
+  auto resizeOutput = [&](uint32_t width, uint32_t height) {
+    camera.viewportSize = glm::vec2(float(width), float(height));
+    hudCamera.viewportSize = camera.viewportSize;
+    hudCamera.position = hudCamera.viewportSize * 0.5f;
+    const CameraUniforms hudUniforms = cameraBuildUniforms(hudCamera);
+    wgpuQueueWriteBuffer(queue, hudCameraBuffer, 0, &hudUniforms,
+                         sizeof(hudUniforms));
+    if (!scaledScene.device)
+      return true;
+    scaledSceneResize(scaledScene, width, height);
+    return buildRenderGraph();
+  };
+
+  // ── 10g. Dźwięk (mikser programowy) ──────────────────────
+  // Efekty są syntetyzowane — silnik nie ma jeszcze assetów audio.
+  // Gra tylko wrzuca komendy do kolejki; miksuje wątek audio.
+  if (options.audioOutput) {
+    audio = std::make_unique<AudioMixer>();
+    SoundDesc burstDesc;
+    burstDesc.name = "Burst";
+    burstDesc.samples = audioSynthNoiseBurst(kAudioSampleRate, 0.6f, seed);
+    burstDesc.maxInstances = 16;
+    burstDesc.priority = 1; // wybuch nie ustępuje trafieniom
+    SoundDesc hitDesc;
+    hitDesc.name = "Hit";
+    hitDesc.samples = audioSynthBlip(22050, 0.12f, 880.0f);
+    hitDesc.sampleRate = 22050;
+    hitDesc.maxInstances = 32;
+    burstSound = audio->addSound(std::move(burstDesc));
+    hitSound = audio->addSound(std::move(hitDesc));
+    const bool toFile = std::strcmp(options.audioOutput, "null") != 0;
+    if (burstSound == kInvalidSound || hitSound == kInvalidSound ||
+        !audio->start(toFile ? AudioOutput::File : AudioOutput::Null,
+                      toFile ? options.audioOutput : nullptr)) {
+      cleanup();
+      return -1;
+    }
+  }
+  // Panorama dźwięku z pozycji x w widoku kamery. Bez nextRandom() —
+  // włączony dźwięk nie zmienia przebiegu symulacji.
+  auto playSound = [&](SoundId sound, float worldX, float volume,
+                       float pitch) {
+    if (!audio)
+      return;
+    const CullRect view = cameraViewRect(camera);
+    SoundParams params;
+    params.volume = volume;
+    params.pan = std::clamp(
+        (worldX - view.minX) / std::max(view.maxX - view.minX, 1.0f) * 2.0f -
+            1.0f,
+        -1.0f, 1.0f);
+    params.pitch = pitch;
+    audio->play(sound, params);
+  };
+
+  // ── 11. Pętla renderowania (Sprite'y + WASD) ─────────────
+  if (options.headless)
+    std::cout << "\nWarpEngine started headless! Rendering "
+              << options.frameCount << " frames..." << std::endl;
+  else
+    std::cout << "\nWarpEngine started! Use WASD to move, Q/E to zoom"
+              << (particles.capacity ? ", Space for a particle burst" : "")
+              << (snapshots ? ", R to rewind 2 s" : "")
+              << ". Rendering..." << std::endl;
+
+  using Clock = std::chrono::steady_clock;
+  std::vector<double> frameTimesMs;
+  frameTimesMs.reserve(options.headless ? options.frameCount : 0);
+
+  // Raport (--report): czasy CPU/GPU wszystkich klatek, nie tylko historii
+  if (options.reportPath)
+    profilerBeginCapture(options.headless ? options.frameCount : 0);
+
+  Clock::time_point lastFrameStart = Clock::now();
+  double fpsSeconds = 0.0;
+  uint32_t fpsFrames = 0;
+  float damageNumberBudget = 0.0f;
+  float particleBurstBudget = 0.0f;
+  for (uint32_t frame = 0;; ++frame) {
+    if (options.headless ? frame >= options.frameCount
+                         : glfwWindowShouldClose(window))
+      break;
+    const Clock::time_point frameStart = Clock::now();
+    const double frameSeconds =
+        std::chrono::duration<double>(frameStart - lastFrameStart).count();
+    lastFrameStart = frameStart;
+    profilerBeginFrame(frame);
+    gpuProfilerBeginFrame(gpuProfiler, frame);
+    WARP_PROFILE_SCOPE("Frame");
+
+    // ── Wejście (wątek główny — wymóg GLFW) ────────────────
+    // Callbacki wkładają zdarzenia ze znacznikiem czasu do kolejki
+    // InputSystem; zużywają je ticki symulacji
+    if (window) {
+      WARP_PROFILE_SCOPE("Input");
+      glfwPollEvents();
+    }
 
-    wgpuRenderPassEncoderEnd(renderPass);
-    wgpuRenderPassEncoderRelease(renderPass);
+    // 9a. Pobierz bieżący cel renderowania (swapchain lub offscreen) —
+    // przed grafem klatki, więc pominięta klatka nie zajmuje slotu
+    // pierścienia ani nie przesuwa symulacji
+    SwapchainFrame surfaceFrame;
+    WGPUTextureView outputView = offscreen.view;
+    if (surface) {
+      WARP_PROFILE_SCOPE("Acquire Surface");
+      int framebufferWidth = 0, framebufferHeight = 0;
+      glfwGetFramebufferSize(window, &framebufferWidth, &framebufferHeight);
+      // Okno zminimalizowane: nie ma czego rysować — czekaj na zdarzenia
+      if (framebufferWidth == 0 || framebufferHeight == 0) {
+        ++swapchain.skippedFrames;
+        glfwWaitEvents();
+        profilerEndFrame();
+        continue;
+      }
+      if (swapchainResize(swapchain, uint32_t(framebufferWidth),
+                          uint32_t(framebufferHeight)) &&
+          !resizeOutput(swapchain.config.width, swapchain.config.height))
+        break;
+      const SwapchainStatus status = swapchainAcquire(swapchain, surfaceFrame);
+      if (status == SwapchainStatus::Failed)
+        break;
+      if (status == SwapchainStatus::Skipped) {
+        profilerEndFrame();
+        continue;
+      }
+      outputView = surfaceFrame.view;
+    }
+    // Zdarzenia z czasu oczekiwania na teksturę (Fifo) trafią jeszcze do
+    // ticków tej klatki
+    if (window) {
+      WARP_PROFILE_SCOPE("Input");
+      glfwPollEvents();
+    }
+    inputSampleNs = profilerNowNs();
+
+    // ── Assety: porcja przesyłania w budżecie klatki ───────
+    if (assets) {
+      assets->update();
+      const AssetState atlasState =
+          pendingAtlas.valid() ? assets->state(pendingAtlas)
+                               : AssetState::Cancelled;
+      if (atlasState == AssetState::Ready) {
+        applyAtlas(*assets->atlas(pendingAtlas));
+        loadedAtlas = std::move(pendingAtlas);
+      } else if (atlasState == AssetState::Failed) {
+        std::cerr << "Could not load atlas, keeping the solid atlas"
+                  << std::endl;
+        pendingAtlas.reset();
+      }
+    }
 
-    // 9e. Zakończ komendę i wyślij do kolejki
+    // ── Symulacja w stałym kroku + przygotowanie klatki ────
+    // Headless: dokładnie jeden tick na klatkę — symulacja nie jest
+    // ograniczona zegarem ściennym i pozostaje deterministyczna (pary
+    // separacji sumowane w kolejności porcji, pole przepływu budowane
+    // synchronicznie — wynik nie zależy od podziału pracy między wątki)
+    frameTicks = fixedTimestepAdvance(
+        timestep, options.headless ? timestep.tickSeconds : frameSeconds);
+    frameAlpha = options.headless ? 1.0f : fixedTimestepAlpha(timestep);
+    frameDt = options.headless ? float(timestep.tickSeconds)
+                               : float(frameSeconds);
+    // Poll tylko na wątku głównym — callbacki mapowania (profiler, pierścień)
+    // nie mogą się wykonać na workerze równolegle z resztą klatki
+    frameRingWaitForSlot(frameRing);
+    if (!jobs.run(frameGraph))
+      break;
+    if (!frameResourcesReady) {
+      std::cerr << "Failed to begin frame ring slot!" << std::endl;
+      break;
+    }
+    for (; burstRequests > 0; --burstRequests) {
+      if (particles.capacity)
+        gpuParticlesBurst(particles, entities.f32(player, Column_PositionX),
+                          entities.f32(player, Column_PositionY), 100000,
+                          packColor(255, 160, 48));
+      playSound(burstSound, entities.f32(player, Column_PositionX), 0.8f,
+                1.0f);
+    }
+    // Cofnięcie do zrzutu sprzed 2 s (albo najstarszego w historii);
+    // kolejne ticki nadpisują nowszą część historii
+    if (rewindRequests > 0 && snapshots && !snapshots->empty()) {
+      const uint64_t back = uint64_t(2.0 * options.tickRate) * rewindRequests;
+      const uint64_t target =
+          std::max(snapshots->oldestTick(),
+                   worldTick > back ? worldTick - back : 0);
+      snapshots->rewind(target, entities, worldTick, seed);
+    }
+    rewindRequests = 0;
+    // Warstwy bundle'i czytają kamerę z trwałego bufora — ta sama klatka
+    wgpuQueueWriteBuffer(queue, staticCameraBuffer, 0, &cameraUniforms,
+                         sizeof(cameraUniforms));
+    // Chunki mapy wokół nowej pozycji kamery (tylko brakujące)
+    if (tilemap.view.header) {
+      WARP_PROFILE_SCOPE("Tilemap Stream");
+      tilemapStream(queue, tilemap, cameraViewRect(camera));
+    }
+
+    // ── Tekst: HUD i liczby obrażeń (przepisywane tylko zmiany) ──
+    {
+      WARP_PROFILE_SCOPE("Text");
+      char line[64];
+      const uint32_t seconds =
+          uint32_t(double(timestep.tickCount) * timestep.tickSeconds);
+      std::snprintf(line, sizeof(line), "TIME %02u:%02u", seconds / 60,
+                    seconds % 60);
+      textSetString(text, timeLabel, line);
+      fpsSeconds += frameSeconds;
+      ++fpsFrames;
+      if (fpsSeconds >= 0.25) {
+        std::snprintf(line, sizeof(line), "FPS %u",
+                      uint32_t(double(fpsFrames) / fpsSeconds + 0.5));
+        textSetString(text, fpsLabel, line);
+        fpsSeconds = 0.0;
+        fpsFrames = 0;
+      }
+      std::snprintf(line, sizeof(line), "SPRITES %u/%u",
+                    spriteDrawList.visible, spriteDrawList.total);
+      textSetString(text, spritesLabel, line);
+
+      // Liczby obrażeń nad losowymi widocznymi sprite'ami
+      damageNumberBudget += options.damageNumberRate * frameDt;
+      for (; damageNumberBudget >= 1.0f; damageNumberBudget -= 1.0f) {
+        if (spriteBatch.instances.empty())
+          continue;
+        const size_t count = spriteBatch.instances.size();
+        const SpriteInstance &target =
+            spriteBatch.instances[size_t(nextRandom() * float(count)) % count];
+        const uint32_t value = 1 + uint32_t(nextRandom() * 999.0f);
+        floatingNumberSpawn(text, floatingNumbers, target.position[0],
+                            target.position[1] - target.scale[1],
+                            value,
+                            value > 900 ? packColor(255, 80, 40)
+                                        : packColor(255, 230, 120));
+        // Mocniejsze trafienie: głośniej i niżej
+        playSound(hitSound, target.position[0], value > 900 ? 0.5f : 0.25f,
+                  1.2f - 0.4f * float(value) / 1000.0f);
+      }
+      floatingNumbersUpdate(text, floatingNumbers, frameDt);
+      textUpload(queue, text);
+    }
+    // Wybuchy cząsteczek ze skryptu (--bursts) w losowych miejscach widoku
+    particleBurstBudget += options.particleBurstRate * frameDt;
+    for (; particleBurstBudget >= 1.0f; particleBurstBudget -= 1.0f) {
+      const CullRect view = cameraViewRect(camera);
+      const float x = view.minX + nextRandom() * (view.maxX - view.minX);
+      const float y = view.minY + nextRandom() * (view.maxY - view.minY);
+      gpuParticlesBurst(particles, x, y, 10000, packColor(255, 160, 48));
+      playSound(burstSound, x, 0.4f, 1.0f);
+    }
+    // Parametry compute passów (horda goni gracza po jego ostatnim ticku;
+    // brak interpolacji — rysowany jest stan po ostatnim ticku)
+    if (gpuHorde.agentCount)
+      gpuHordePrepare(queue, gpuHorde, entities.f32(player, Column_PositionX),
+                      entities.f32(player, Column_PositionY),
+                      float(timestep.tickSeconds), frameTicks);
+    if (particles.capacity)
+      gpuParticlesPrepare(queue, particles,
+                          options.headless ? float(timestep.tickSeconds)
+                                           : float(frameSeconds));
+    if (gpuCulling.streamCount)
+      gpuCullingPrepare(queue, gpuCulling, cameraViewRect(camera));
+
+    // Skala sceny z ostatnich czasów GPU (dynamiczna rozdzielczość)
+    if (scaledScene.device) {
+      dynamicResolutionUpdate(dynamicRes, frame, profilerLatestGpuFrame());
+      scaledScenePrepare(queue, scaledScene, dynamicRes.scale);
+    }
+    renderGraph->setImportedView(outputTexture, outputView);
+    // Ostatnia klatka headless trafia do pliku (pass Readback)
+    dumpFrame = options.headless && options.dumpPath &&
+                frame + 1 == options.frameCount;
+
+    // 9b. Stwórz command encoder
+    profilerBeginScope("Encode");
+    WGPUCommandEncoderDescriptor encoderDesc = {};
+    encoderDesc.nextInChain = nullptr;
+    encoderDesc.label = "Command Encoder";
+    WGPUCommandEncoder encoder =
+        wgpuDeviceCreateCommandEncoder(device, &encoderDesc);
+
+    // Dane klatki: staging → bufor GPU (przed passami, które je czytają)
+    frameRingFlush(frameRing, encoder);
+
+    // 9c. Passy grafu renderowania (compute, świat, skalowanie, odczyt)
+    renderGraph->execute(encoder);
+    gpuProfilerResolve(gpuProfiler, encoder);
+
+    // 9d. Zakończ komendę i wyślij do kolejki
     WGPUCommandBufferDescriptor cmdBufDesc = {};
     cmdBufDesc.nextInChain = nullptr;
     cmdBufDesc.label = "Render Command Buffer";
     WGPUCommandBuffer cmdBuf = wgpuCommandEncoderFinish(encoder, &cmdBufDesc);
+    profilerEndScope();
 
-    wgpuQueueSubmit(queue, 1, &cmdBuf);
-
-    // 9f. Prezentuj na ekranie
-    wgpuSurfacePresent(surface);
+    {
+      WARP_PROFILE_SCOPE("Submit");
+      wgpuQueueSubmit(queue, 1, &cmdBuf);
+    }
+    gpuProfilerAfterSubmit(gpuProfiler);
+    frameRingAfterSubmit(frameRing);
+
+    // 9e. Prezentuj na ekranie albo (headless) poczekaj na GPU, żeby czas
+    // klatki obejmował faktyczne renderowanie. W oknie nieblokujący poll
+    // dostarcza callbacki mapowania (np. timestampy profilera).
+    if (surface) {
+      WARP_PROFILE_SCOPE("Present");
+      swapchainPresent(swapchain, surfaceFrame);
+      input.framePresented(profilerNowNs());
+      wgpuDevicePoll(device, false, nullptr);
+    } else {
+      WARP_PROFILE_SCOPE("GPU Wait");
+      wgpuDevicePoll(device, true, nullptr);
+    }
 
-    // 9g. Zwolnij zasoby tego frame'a
+    // 9f. Zwolnij zasoby tego frame'a
+    frameArena.reset();
     wgpuCommandBufferRelease(cmdBuf);
     wgpuCommandEncoderRelease(encoder);
-    wgpuTextureViewRelease(textureView);
-    wgpuTextureRelease(surfaceTexture.texture);
+
+    if (dumpFrame) {
+      std::vector<uint8_t> pixels;
+      if (readOffscreenPixels(device, offscreen, pixels) &&
+          writePpm(options.dumpPath, offscreen.width, offscreen.height,
+                   pixels))
+        std::cout << "Frame written to " << options.dumpPath << std::endl;
+    }
+
+    if (options.headless)
+      frameTimesMs.push_back(
+          std::chrono::duration<double, std::milli>(Clock::now() - frameStart)
+              .count());
+    profilerEndFrame();
+  }
+
+  // Dokończ oczekujące odczyty timestampów, potem historia i trace
+  if (device)
+    wgpuDevicePoll(device, true, nullptr);
+  std::vector<FrameStats> history(kFrameHistorySize);
+  history.resize(profilerFrameHistory(history.data(), history.size()));
+  double cpuTotal = 0.0, gpuTotal = 0.0;
+  uint32_t gpuFrames = 0;
+  for (const FrameStats &stats : history) {
+    cpuTotal += stats.cpuMs;
+    if (stats.gpuMs >= 0.0) {
+      gpuTotal += stats.gpuMs;
+      ++gpuFrames;
+    }
+  }
+  if (!history.empty()) {
+    std::cout << "\nProfiler (last " << history.size() << " frames)"
+              << " | cpu avg: " << cpuTotal / double(history.size()) << " ms";
+    if (gpuFrames)
+      std::cout << " | gpu avg: " << gpuTotal / double(gpuFrames) << " ms";
+    std::cout << std::endl;
+  }
+  if (options.tracePath && profilerWriteChromeTrace(options.tracePath))
+    std::cout << "Trace written to " << options.tracePath << std::endl;
+
+  // Raport benchmarku: percentyle po rozgrzewce (kompilacja pipeline'ów,
+  // wczytywanie i pierwsze przesyłania nie zawyżają p99)
+  if (options.reportPath) {
+    const std::vector<FrameStats> &captured = profilerCapturedFrames();
+    std::vector<double> cpuMs, gpuMs;
+    double cpuTotalMs = 0.0;
+    for (size_t i = options.warmupFrames; i < captured.size(); ++i) {
+      cpuMs.push_back(captured[i].cpuMs);
+      cpuTotalMs += captured[i].cpuMs;
+      if (captured[i].gpuMs >= 0.0)
+        gpuMs.push_back(captured[i].gpuMs);
+    }
+    BenchResult result;
+    result.name = "headless";
+    result.adapter = adapterName;
+    result.frames = uint32_t(cpuMs.size());
+    result.entities = uint64_t(entities.size()) + gpuHorde.agentCount;
+    result.cpu = summarizeFrameTimes(std::move(cpuMs));
+    result.gpu = summarizeFrameTimes(std::move(gpuMs));
+    if (cpuTotalMs > 0.0)
+      result.entitiesPerSecond =
+          double(result.entities) * result.frames / (cpuTotalMs / 1000.0);
+    if (writeBenchReport(options.reportPath, {result}))
+      std::cout << "Report written to " << options.reportPath << " | cpu p50 "
+                << result.cpu.p50 << " ms, p99 " << result.cpu.p99
+                << " ms" << std::endl;
+  }
+
+  // Podsumowanie czasów klatek w trybie headless
+  if (!frameTimesMs.empty()) {
+    double total = 0.0;
+    for (double ms : frameTimesMs)
+      total += ms;
+    std::sort(frameTimesMs.begin(), frameTimesMs.end());
+    std::cout << "\nFrames: " << frameTimesMs.size()
+              << " | avg: " << total / double(frameTimesMs.size()) << " ms"
+              << " | min: " << frameTimesMs.front() << " ms"
+              << " | max: " << frameTimesMs.back() << " ms"
+              << " | sim ticks: " << timestep.tickCount << std::endl;
+  }
+  const PipelineCache::Stats &cacheStats = pipelineCache->stats();
+  std::cout << "Pipeline cache: " << cacheStats.misses << " compiled ("
+            << cacheStats.compileMs << " ms, warmup " << cacheStats.warmupMs
+            << " ms) | hits: " << cacheStats.hits << std::endl;
+  if (options.pipelineCachePath && pipelineCache->dirty() &&
+      pipelineCache->saveWarmupFile(options.pipelineCachePath))
+    std::cout << "Pipeline cache saved to " << options.pipelineCachePath
+              << std::endl;
+  std::cout << "Job system: " << jobs.threadCount() << " threads | "
+            << jobs.stealCount() << " steals" << std::endl;
+  const RenderGraphStats &graphStats = renderGraph->stats();
+  std::cout << "Render graph: " << graphStats.passes << " passes ("
+            << graphStats.culledPasses << " culled) | transient textures: "
+            << graphStats.transientTextures << " in "
+            << graphStats.physicalTextures << " pooled ("
+            << graphStats.physicalBytes / 1024 << " KB of "
+            << graphStats.transientBytes / 1024 << " KB) | compiles: "
+            << graphStats.compiles << std::endl;
+  std::cout << "Render bundles: " << bundles->layerCount() << " layers | "
+            << bundles->totalRecords() << " recordings" << std::endl;
+  if (spriteDrawList.totalSum > 0)
+    std::cout << "Culling: "
+              << 100.0 * double(spriteDrawList.visibleSum) /
+                     double(spriteDrawList.totalSum)
+              << "% sprites visible | last frame " << spriteDrawList.visible
+              << "/" << spriteDrawList.total << " in "
+              << spriteDrawList.drawList.batches.size() << " draw batches ("
+              << spriteDrawList.drawList.sortPasses << " radix passes)"
+              << std::endl;
+  if (tilemap.view.header)
+    std::cout << "Tilemap: " << tilemap.resident.size() << " chunks resident"
+              << " (peak " << tilemap.peakResident << ") | loads: "
+              << tilemap.chunkLoads << ", unloads: " << tilemap.chunkUnloads
+              << " | uploaded " << tilemap.bytesUploaded / 1024 << " KB"
+              << std::endl;
+  if (flowField) {
+    const FlowFieldStats &flowStats = flowField->stats();
+    std::cout << "Flow field: " << flowStats.builds << " builds (avg "
+              << (flowStats.builds
+                      ? flowStats.totalBuildMs / double(flowStats.builds)
+                      : 0.0)
+              << " ms, max " << flowStats.maxBuildMs << " ms) | coalesced "
+              << "target changes: " << flowStats.coalesced << std::endl;
+  }
+  std::cout << "Text: " << text.labels.size() - text.freeLabels.size()
+            << " labels | glyphs written: " << text.glyphsWritten
+            << " | shaping cache hits: " << text.runCacheHits
+            << ", misses: " << text.runCacheMisses << std::endl;
+  const MemoryStats frameMemory = frameArena.stats();
+  const MemoryStats scratchMemory = scratchArenaStats();
+  const MemoryStats &readbackMemory = gpuProfiler.readbacks.stats();
+  std::cout << "Memory: frame arena peak " << frameMemory.peakBytes / 1024
+            << " KB of " << frameMemory.capacityBytes / 1024 << " KB ("
+            << frameMemory.fallbackCount << " heap fallbacks) | scratch peak "
+            << scratchMemory.peakBytes / 1024 << " KB ("
+            << scratchMemory.fallbackCount << " heap fallbacks) | readback "
+            << "pool fallbacks: " << readbackMemory.fallbackCount << std::endl;
+  if (assets) {
+    const AssetStats assetStats = assets->stats();
+    std::cout << "Assets: " << assetStats.ready << "/" << assetStats.requested
+              << " ready (" << assetStats.failed << " failed, "
+              << assetStats.cancelled << " cancelled) | read "
+              << assetStats.bytesRead / 1024 << " KB | uploaded "
+              << assetStats.bytesUploaded / 1024 << " KB (peak "
+              << assetStats.peakFrameUploadBytes / 1024 << " KB/frame)";
+    if (assetStats.ready)
+      std::cout << " | avg latency "
+                << assetStats.totalLatencyMs / assetStats.ready << " ms";
+    std::cout << std::endl;
+  }
+  if (surface)
+    std::cout << "Swapchain: " << swapchain.config.width << "x"
+              << swapchain.config.height << " | reconfigurations: "
+              << swapchain.reconfigures << " | skipped frames: "
+              << swapchain.skippedFrames << std::endl;
+  if (window) {
+    const InputStats &inputStats = input.stats();
+    const FrameTimeSummary latency = input.latencySummary();
+    std::cout << "Input: " << inputStats.events << " events ("
+              << inputStats.droppedEvents << " dropped)";
+    if (latency.samples)
+      std::cout << " | input-to-present latency p50 " << latency.p50
+                << " ms, p95 " << latency.p95 << " ms, max " << latency.max
+                << " ms (" << latency.samples << " samples)";
+    std::cout << std::endl;
+  }
+  if (audio) {
+    audio->stop();
+    const AudioStats audioStats = audio->stats();
+    std::cout << "Audio: " << audioStats.blocks << " blocks ("
+              << audioStats.lateBlocks << " late) | mix avg "
+              << audioStats.avgMixUs << " us, max " << audioStats.maxMixUs
+              << " us | voices: " << audioStats.voicesStarted
+              << " started, peak " << audioStats.peakVoices << "/"
+              << kMaxAudioVoices << ", " << audioStats.voicesStolen
+              << " stolen, " << audioStats.instanceCapped
+              << " instance-capped, " << audioStats.rejected
+              << " rejected | dropped commands: "
+              << audioStats.droppedCommands << std::endl;
+  }
+  if (snapshots && snapshots->stats().captures) {
+    const SnapshotRingStats &snapshotStats = snapshots->stats();
+    const double captures = double(snapshotStats.captures);
+    std::cout << "Snapshots: " << snapshotStats.captures << " captures ("
+              << snapshotStats.keyframes << " keyframes, "
+              << snapshotStats.skipped << " skipped) | capture avg "
+              << snapshotStats.totalCaptureMs / captures << " ms, max "
+              << snapshotStats.maxCaptureMs << " ms | "
+              << snapshotStats.rawBytes / snapshotStats.captures / 1024
+              << " KB raw -> "
+              << snapshotStats.encodedBytes / snapshotStats.captures / 1024
+              << " KB/tick | history: " << snapshots->entryCount()
+              << " ticks ("
+              << double(snapshots->newestTick() - snapshots->oldestTick()) /
+                     options.tickRate
+              << " s), " << (snapshots->storedBytes() >> 20) << "/"
+              << (snapshots->budgetBytes() >> 20) << " MB | rewinds: "
+              << snapshotStats.restores << std::endl;
+  }
+  if (dynamicRes.frames)
+    std::cout << "Dynamic resolution: target " << dynamicRes.targetGpuMs
+              << " ms | scale avg "
+              << dynamicRes.scaleSum / double(dynamicRes.frames) << ", min "
+              << dynamicRes.lowestScale << ", last " << dynamicRes.scale
+              << " | adjustments: " << dynamicRes.adjustments << std::endl;
+  std::cout << "Frame ring: peak " << frameRing.peakBytes / 1024 << " KB/frame"
+            << " | GPU waits: " << frameRing.fenceWaits << std::endl;
+
+  // Zrzut końcowego stanu. W trybie headless --load-snapshot z tymi samymi
+  // opcjami odtwarza dalszy przebieg encji bit w bit (symulacja nie zależy
+  // od podziału pracy między wątki). Poza zrzutem zostaje stan GPU (horda,
+  // cząsteczki) i wejście z okna — okienkowy przebieg się nie powtórzy.
+  if (options.saveSnapshotPath) {
+    std::vector<uint8_t> bytes;
+    captureWorldSnapshot(entities, worldTick, seed, bytes);
+    if (writeWorldSnapshotFile(options.saveSnapshotPath, bytes))
+      std::cout << "World snapshot: " << options.saveSnapshotPath << " (tick "
+                << worldTick << ", " << bytes.size() / 1024 << " KB)"
+                << std::endl;
   }
 
   // ── 12. Sprzątanie zasobów ───────────────────────────────
   std::cout << "\nShutting down WarpEngine..." << std::endl;
-
-  wgpuRenderPipelineRelease(pipeline);
-  wgpuBindGroupRelease(bindGroup);
-  wgpuBindGroupLayoutRelease(bindGroupLayout);
-  wgpuBufferRelease(uniformBuffer);
-  wgpuSurfaceUnconfigure(surface);
-  wgpuQueueRelease(queue);
-  wgpuDeviceRelease(device);
-  wgpuSurfaceRelease(surface);
-  wgpuAdapterRelease(adapter);
-  wgpuInstanceRelease(instance);
-  glfwDestroyWindow(window);
-  glfwTerminate();
+  cleanup();
 
   std::cout << "Goodbye!" << std::endl;
   return 0;
@@ -0,0 +1,90 @@
+#include "mapped_file.h"
+
+#include <iostream>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifdef _WIN32
+
+bool mapFile(const char *path, MappedFile &file) {
+  HANDLE handle = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr,
+                              OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+  if (handle == INVALID_HANDLE_VALUE) {
+    std::cerr << "Could not open file: " << path << std::endl;
+    return false;
+  }
+  LARGE_INTEGER size;
+  if (!GetFileSizeEx(handle, &size) || size.QuadPart == 0) {
+    std::cerr << "Empty or unreadable file: " << path << std::endl;
+    CloseHandle(handle);
+    return false;
+  }
+  HANDLE mapping =
+      CreateFileMappingA(handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+  const void *view =
+      mapping ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+  if (!view) {
+    std::cerr << "Could not map file: " << path << std::endl;
+    if (mapping)
+      CloseHandle(mapping);
+    CloseHandle(handle);
+    return false;
+  }
+  file.data = static_cast<const uint8_t *>(view);
+  file.size = size_t(size.QuadPart);
+  file.fileHandle = handle;
+  file.mappingHandle = mapping;
+  return true;
+}
+
+void unmapFile(MappedFile &file) {
+  if (file.data)
+    UnmapViewOfFile(file.data);
+  if (file.mappingHandle)
+    CloseHandle(file.mappingHandle);
+  if (file.fileHandle)
+    CloseHandle(file.fileHandle);
+  file = {};
+}
+
+#else
+
+bool mapFile(const char *path, MappedFile &file) {
+  const int fd = open(path, O_RDONLY);
+  if (fd < 0) {
+    std::cerr << "Could not open file: " << path << std::endl;
+    return false;
+  }
+  struct stat info;
+  if (fstat(fd, &info) != 0 || info.st_size == 0) {
+    std::cerr << "Empty or unreadable file: " << path << std::endl;
+    close(fd);
+    return false;
+  }
+  void *view =
+      mmap(nullptr, size_t(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd); // mapowanie pozostaje ważne po zamknięciu deskryptora
+  if (view == MAP_FAILED) {
+    std::cerr << "Could not map file: " << path << std::endl;
+    return false;
+  }
+  file.data = static_cast<const uint8_t *>(view);
+  file.size = size_t(info.st_size);
+  return true;
+}
+
+void unmapFile(MappedFile &file) {
+  if (file.data)
+    munmap(const_cast<uint8_t *>(file.data), file.size);
+  file = {};
+}
+
+#endif
@@ -0,0 +1,18 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// Plik zmapowany w pamięci tylko do odczytu (mmap / MapViewOfFile).
+// Strony są ładowane przez system na żądanie — brak kopiowania do bufora.
+struct MappedFile {
+  const uint8_t *data = nullptr;
+  size_t size = 0;
+#ifdef _WIN32
+  void *fileHandle = nullptr;
+  void *mappingHandle = nullptr;
+#endif
+};
+
+bool mapFile(const char *path, MappedFile &file);
+void unmapFile(MappedFile &file);
@@ -0,0 +1,177 @@
+#include "memory_arena.h"
+
+#include <algorithm>
+
+// Bloki aren wyrównane do linii cache
+constexpr size_t kArenaBlockAlignment = 64;
+
+static uint8_t *allocateBlock(size_t capacity) {
+  if (capacity == 0)
+    return nullptr;
+  return static_cast<uint8_t *>(
+      ::operator new(capacity, std::align_val_t(kArenaBlockAlignment)));
+}
+
+static void freeBlock(uint8_t *block) {
+  if (block)
+    ::operator delete(block, std::align_val_t(kArenaBlockAlignment));
+}
+
+// Nowy rozmiar bloku: szczyt zaokrąglony w górę do 64 KB
+static size_t grownCapacity(uint64_t peakBytes) {
+  constexpr size_t kGranularity = 64 * 1024;
+  return (size_t(peakBytes) + kGranularity - 1) / kGranularity * kGranularity;
+}
+
+static size_t alignUp(size_t value, size_t alignment) {
+  return (value + alignment - 1) & ~(alignment - 1);
+}
+
+// ============================================================
+//  LinearArena
+// ============================================================
+
+LinearArena::LinearArena(size_t capacity)
+    : m_block(allocateBlock(capacity)), m_capacity(capacity) {
+  m_stats.capacityBytes = capacity;
+}
+
+LinearArena::~LinearArena() {
+  rewind({});
+  freeBlock(m_block);
+}
+
+void *LinearArena::allocate(size_t size, size_t alignment) {
+  const size_t offset = alignUp(m_offset, alignment);
+  void *result;
+  if (offset + size <= m_capacity && alignment <= kArenaBlockAlignment) {
+    result = m_block + offset;
+    m_offset = offset + size;
+  } else {
+    // Blok pełny — alokacja z heapu, zwalniana przy rewind
+    result = ::operator new(size, std::align_val_t(alignment));
+    m_fallbacks.push_back({result, size, alignment});
+    m_fallbackLiveBytes += size;
+    ++m_stats.fallbackCount;
+    m_stats.fallbackBytes += size;
+  }
+  m_stats.usedBytes = m_offset + m_fallbackLiveBytes;
+  m_stats.peakBytes = std::max(m_stats.peakBytes, m_stats.usedBytes);
+  return result;
+}
+
+void LinearArena::rewind(const ArenaMarker &marker) {
+  // Fallbacki zaalokowane po markerze
+  while (m_fallbacks.size() > marker.fallbackCount) {
+    const Fallback &fallback = m_fallbacks.back();
+    ::operator delete(fallback.memory, std::align_val_t(fallback.alignment));
+    m_fallbackLiveBytes -= fallback.size;
+    m_fallbacks.pop_back();
+  }
+  m_offset = marker.offset;
+  m_stats.usedBytes = m_offset + m_fallbackLiveBytes;
+
+  // Arena pusta i za mała na szczyt — jeden większy blok zamiast
+  // fallbacków w kolejnych klatkach
+  if (m_offset == 0 && m_fallbacks.empty() &&
+      m_stats.peakBytes > m_capacity) {
+    freeBlock(m_block);
+    m_capacity = grownCapacity(m_stats.peakBytes);
+    m_block = allocateBlock(m_capacity);
+    m_stats.capacityBytes = m_capacity;
+  }
+}
+
+// ============================================================
+//  FrameArena
+// ============================================================
+
+FrameArena::FrameArena(size_t capacity)
+    : m_block(allocateBlock(capacity)), m_capacity(capacity) {
+  m_stats.capacityBytes = capacity;
+}
+
+FrameArena::~FrameArena() {
+  reset();
+  freeBlock(m_block);
+}
+
+void *FrameArena::allocate(size_t size, size_t alignment) {
+  // Rezerwacja z zapasem na wyrównanie — jeden fetch_add bez pętli CAS
+  const size_t reserved = size + alignment - 1;
+  const size_t offset = m_offset.fetch_add(reserved, std::memory_order_relaxed);
+  if (offset + reserved <= m_capacity && alignment <= kArenaBlockAlignment)
+    return m_block + alignUp(offset, alignment);
+
+  // Blok pełny — alokacja z heapu, zwalniana przy resecie
+  void *result = ::operator new(size, std::align_val_t(alignment));
+  std::lock_guard<std::mutex> lock(m_fallbackMutex);
+  m_fallbacks.emplace_back(result, alignment);
+  m_fallbackFrameBytes += size;
+  ++m_stats.fallbackCount;
+  m_stats.fallbackBytes += size;
+  return result;
+}
+
+void FrameArena::reset() {
+  std::lock_guard<std::mutex> lock(m_fallbackMutex);
+  const size_t used =
+      std::min(m_offset.load(std::memory_order_relaxed), m_capacity) +
+      m_fallbackFrameBytes;
+  m_stats.usedBytes = used;
+  m_stats.peakBytes = std::max(m_stats.peakBytes, uint64_t(used));
+
+  for (const auto &[memory, alignment] : m_fallbacks)
+    ::operator delete(memory, std::align_val_t(alignment));
+  m_fallbacks.clear();
+  m_fallbackFrameBytes = 0;
+  m_offset.store(0, std::memory_order_relaxed);
+
+  if (m_stats.peakBytes > m_capacity) {
+    freeBlock(m_block);
+    m_capacity = grownCapacity(m_stats.peakBytes);
+    m_block = allocateBlock(m_capacity);
+    m_stats.capacityBytes = m_capacity;
+  }
+}
+
+MemoryStats FrameArena::stats() const {
+  std::lock_guard<std::mutex> lock(m_fallbackMutex);
+  return m_stats;
+}
+
+// ============================================================
+//  Pamięć robocza wątków
+// ============================================================
+
+constexpr size_t kScratchArenaCapacity = 256 * 1024;
+
+// Areny należą do rejestru, nie do thread_local — liczniki przeżywają
+// zakończone wątki, a wątek tylko wskazuje na swoją
+static std::mutex g_scratchMutex;
+static std::vector<std::unique_ptr<LinearArena>> g_scratchArenas;
+
+LinearArena &scratchArena() {
+  thread_local LinearArena *arena = nullptr;
+  if (!arena) {
+    std::lock_guard<std::mutex> lock(g_scratchMutex);
+    g_scratchArenas.push_back(
+        std::make_unique<LinearArena>(kScratchArenaCapacity));
+    arena = g_scratchArenas.back().get();
+  }
+  return *arena;
+}
+
+MemoryStats scratchArenaStats() {
+  std::lock_guard<std::mutex> lock(g_scratchMutex);
+  MemoryStats total;
+  for (const std::unique_ptr<LinearArena> &arena : g_scratchArenas) {
+    const MemoryStats &stats = arena->stats();
+    total.usedBytes += stats.usedBytes;
+    total.peakBytes += stats.peakBytes;
+    total.capacityBytes += stats.capacityBytes;
+    total.fallbackCount += stats.fallbackCount;
+    total.fallbackBytes += stats.fallbackBytes;
+  }
+  return total;
+}
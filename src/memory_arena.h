@@ -0,0 +1,197 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <utility>
+#include <vector>
+
+// Liczniki alokatora (wypisywane na końcu działania)
+struct MemoryStats {
+  uint64_t usedBytes = 0;     // zajęte w tej chwili (z fallbackami)
+  uint64_t peakBytes = 0;     // maksimum od startu
+  uint64_t capacityBytes = 0; // rozmiar bloku / puli
+  uint64_t fallbackCount = 0; // alokacje obsłużone przez malloc / new
+  uint64_t fallbackBytes = 0;
+};
+
+// ============================================================
+//  Arena liniowa
+// ============================================================
+
+// Punkt powrotu areny (ScratchScope, zagnieżdżone użycia)
+struct ArenaMarker {
+  size_t offset = 0;
+  size_t fallbackCount = 0;
+};
+
+// Bump allocator w jednym bloku, bez zwalniania pojedynczych alokacji —
+// pamięć wraca przy rewind/reset. Gdy blok się skończy, alokacja idzie do
+// malloc (liczona jako fallback) i jest zwalniana razem z resztą. Po
+// opróżnieniu blok rośnie do szczytowego zużycia, więc w stałym rytmie
+// pracy fallbacki znikają po pierwszych klatkach. Nie jest thread-safe.
+class LinearArena {
+public:
+  explicit LinearArena(size_t capacity = 0);
+  ~LinearArena();
+  LinearArena(const LinearArena &) = delete;
+  LinearArena &operator=(const LinearArena &) = delete;
+
+  void *allocate(size_t size, size_t alignment = alignof(std::max_align_t));
+  // Niezainicjalizowana tablica (typy trywialne)
+  template <typename T> T *allocateArray(size_t count) {
+    return static_cast<T *>(allocate(count * sizeof(T), alignof(T)));
+  }
+
+  ArenaMarker mark() const { return {m_offset, m_fallbacks.size()}; }
+  void rewind(const ArenaMarker &marker);
+  void reset() { rewind({}); }
+
+  const MemoryStats &stats() const { return m_stats; }
+
+private:
+  uint8_t *m_block = nullptr;
+  size_t m_capacity = 0;
+  size_t m_offset = 0;
+  struct Fallback {
+    void *memory;
+    size_t size;
+    size_t alignment;
+  };
+  std::vector<Fallback> m_fallbacks;
+  size_t m_fallbackLiveBytes = 0;
+  MemoryStats m_stats;
+};
+
+// ============================================================
+//  Arena klatki
+// ============================================================
+
+// Pamięć ważna do końca bieżącej klatki: dane tymczasowe systemów, które
+// nie muszą przeżyć klatki. Alokacja to jeden atomowy fetch_add (dowolny
+// wątek puli), reset po wysłaniu klatki na wątku głównym, gdy zadania są
+// zakończone. Przepełnienie jak w LinearArena: malloc pod mutexem, a przy
+// resecie blok rośnie do szczytu.
+class FrameArena {
+public:
+  explicit FrameArena(size_t capacity);
+  ~FrameArena();
+  FrameArena(const FrameArena &) = delete;
+  FrameArena &operator=(const FrameArena &) = delete;
+
+  void *allocate(size_t size, size_t alignment = alignof(std::max_align_t));
+  template <typename T> T *allocateArray(size_t count) {
+    return static_cast<T *>(allocate(count * sizeof(T), alignof(T)));
+  }
+
+  void reset();
+  MemoryStats stats() const;
+
+private:
+  uint8_t *m_block = nullptr;
+  size_t m_capacity = 0;
+  std::atomic<size_t> m_offset{0};
+  mutable std::mutex m_fallbackMutex;
+  std::vector<std::pair<void *, size_t>> m_fallbacks; // blok, wyrównanie
+  size_t m_fallbackFrameBytes = 0;
+  MemoryStats m_stats;
+};
+
+// ============================================================
+//  Pamięć robocza wątków
+// ============================================================
+
+// Arena robocza bieżącego wątku (tworzona przy pierwszym użyciu). Tylko
+// przez ScratchScope — zagnieżdżone zakresy zwalniają pamięć w kolejności
+// odwrotnej, także gdy wątek czekający wykonuje w środku inne zadania.
+LinearArena &scratchArena();
+// Suma liczników aren roboczych wszystkich wątków
+MemoryStats scratchArenaStats();
+
+class ScratchScope {
+public:
+  ScratchScope() : m_arena(scratchArena()), m_marker(m_arena.mark()) {}
+  ~ScratchScope() { m_arena.rewind(m_marker); }
+  ScratchScope(const ScratchScope &) = delete;
+  ScratchScope &operator=(const ScratchScope &) = delete;
+
+  LinearArena &arena() { return m_arena; }
+
+private:
+  LinearArena &m_arena;
+  ArenaMarker m_marker;
+};
+
+// ============================================================
+//  Pula obiektów
+// ============================================================
+
+// Pula stałej pojemności w jednym bloku, wolne sloty na liście
+// jednokierunkowej — create/destroy w O(1) bez wywołań alokatora. Po
+// wyczerpaniu obiekty są tworzone przez new (liczone jako fallback) i
+// rozpoznawane przy destroy po adresie. Nie jest thread-safe.
+template <typename T> class ObjectPool {
+public:
+  explicit ObjectPool(uint32_t capacity)
+      : m_slots(std::make_unique<Slot[]>(capacity)), m_capacity(capacity) {
+    for (uint32_t i = 0; i < capacity; ++i)
+      m_slots[i].next = i + 1 < capacity ? &m_slots[i + 1] : nullptr;
+    m_free = capacity ? &m_slots[0] : nullptr;
+    m_stats.capacityBytes = uint64_t(capacity) * sizeof(Slot);
+  }
+  ObjectPool(const ObjectPool &) = delete;
+  ObjectPool &operator=(const ObjectPool &) = delete;
+
+  template <typename... Args> T *create(Args &&...args) {
+    T *object;
+    if (m_free) {
+      Slot *slot = m_free;
+      m_free = slot->next;
+      object = new (slot->storage) T{std::forward<Args>(args)...};
+    } else {
+      object = new T{std::forward<Args>(args)...};
+      ++m_stats.fallbackCount;
+      m_stats.fallbackBytes += sizeof(T);
+    }
+    m_stats.usedBytes += sizeof(T);
+    if (m_stats.usedBytes > m_stats.peakBytes)
+      m_stats.peakBytes = m_stats.usedBytes;
+    return object;
+  }
+
+  void destroy(T *object) {
+    if (!object)
+      return;
+    m_stats.usedBytes -= sizeof(T);
+    if (!owns(object)) {
+      delete object;
+      return;
+    }
+    object->~T();
+    Slot *slot = reinterpret_cast<Slot *>(object);
+    slot->next = m_free;
+    m_free = slot;
+  }
+
+  bool owns(const T *object) const {
+    const auto *bytes = reinterpret_cast<const uint8_t *>(object);
+    const auto *begin = reinterpret_cast<const uint8_t *>(m_slots.get());
+    return bytes >= begin && bytes < begin + m_capacity * sizeof(Slot);
+  }
+
+  const MemoryStats &stats() const { return m_stats; }
+
+private:
+  union Slot {
+    Slot *next;
+    alignas(T) uint8_t storage[sizeof(T)];
+  };
+
+  std::unique_ptr<Slot[]> m_slots;
+  uint32_t m_capacity = 0;
+  Slot *m_free = nullptr;
+  MemoryStats m_stats;
+};
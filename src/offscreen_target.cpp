@@ -0,0 +1,166 @@
+#include "offscreen_target.h"
+
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <utility>
+#include <webgpu/wgpu.h>
+
+bool createOffscreenTarget(WGPUDevice device, uint32_t width, uint32_t height,
+                           WGPUTextureFormat format, OffscreenTarget &target) {
+  if (format != WGPUTextureFormat_RGBA8Unorm &&
+      format != WGPUTextureFormat_BGRA8Unorm) {
+    std::cerr << "Offscreen target supports only RGBA8/BGRA8 formats!"
+              << std::endl;
+    return false;
+  }
+
+  target.format = format;
+  target.width = width;
+  target.height = height;
+  target.bytesPerRow = (width * 4 + 255) & ~255u;
+
+  // Tekstura docelowa (RenderAttachment | CopySrc)
+  WGPUTextureDescriptor texDesc = {};
+  texDesc.nextInChain = nullptr;
+  texDesc.label = "Offscreen Target";
+  texDesc.usage = WGPUTextureUsage_RenderAttachment | WGPUTextureUsage_CopySrc;
+  texDesc.dimension = WGPUTextureDimension_2D;
+  texDesc.size = {width, height, 1};
+  texDesc.format = format;
+  texDesc.mipLevelCount = 1;
+  texDesc.sampleCount = 1;
+  texDesc.viewFormatCount = 0;
+  texDesc.viewFormats = nullptr;
+  target.texture = wgpuDeviceCreateTexture(device, &texDesc);
+  if (!target.texture) {
+    std::cerr << "Failed to create offscreen texture!" << std::endl;
+    return false;
+  }
+
+  WGPUTextureViewDescriptor viewDesc = {};
+  viewDesc.nextInChain = nullptr;
+  viewDesc.label = "Offscreen Target View";
+  viewDesc.format = format;
+  viewDesc.dimension = WGPUTextureViewDimension_2D;
+  viewDesc.baseMipLevel = 0;
+  viewDesc.mipLevelCount = 1;
+  viewDesc.baseArrayLayer = 0;
+  viewDesc.arrayLayerCount = 1;
+  viewDesc.aspect = WGPUTextureAspect_All;
+  target.view = wgpuTextureCreateView(target.texture, &viewDesc);
+
+  // Bufor do odczytu klatki (MapRead | CopyDst)
+  WGPUBufferDescriptor bufDesc = {};
+  bufDesc.nextInChain = nullptr;
+  bufDesc.label = "Offscreen Readback Buffer";
+  bufDesc.usage = WGPUBufferUsage_MapRead | WGPUBufferUsage_CopyDst;
+  bufDesc.size = uint64_t(target.bytesPerRow) * height;
+  bufDesc.mappedAtCreation = false;
+  target.readbackBuffer = wgpuDeviceCreateBuffer(device, &bufDesc);
+
+  if (!target.view || !target.readbackBuffer) {
+    std::cerr << "Failed to create offscreen view/readback buffer!"
+              << std::endl;
+    releaseOffscreenTarget(target);
+    return false;
+  }
+  return true;
+}
+
+void releaseOffscreenTarget(OffscreenTarget &target) {
+  if (target.readbackBuffer)
+    wgpuBufferRelease(target.readbackBuffer);
+  if (target.view)
+    wgpuTextureViewRelease(target.view);
+  if (target.texture)
+    wgpuTextureRelease(target.texture);
+  target = {};
+}
+
+void encodeOffscreenReadback(WGPUCommandEncoder encoder,
+                             const OffscreenTarget &target) {
+  WGPUImageCopyTexture src = {};
+  src.nextInChain = nullptr;
+  src.texture = target.texture;
+  src.mipLevel = 0;
+  src.origin = {0, 0, 0};
+  src.aspect = WGPUTextureAspect_All;
+
+  WGPUImageCopyBuffer dst = {};
+  dst.nextInChain = nullptr;
+  dst.buffer = target.readbackBuffer;
+  dst.layout.nextInChain = nullptr;
+  dst.layout.offset = 0;
+  dst.layout.bytesPerRow = target.bytesPerRow;
+  dst.layout.rowsPerImage = target.height;
+
+  WGPUExtent3D copySize = {target.width, target.height, 1};
+  wgpuCommandEncoderCopyTextureToBuffer(encoder, &src, &dst, &copySize);
+}
+
+// Stan mapowania przekazywany do callbacka wgpuBufferMapAsync
+struct MapRequest {
+  bool done = false;
+  WGPUBufferMapAsyncStatus status = WGPUBufferMapAsyncStatus_Unknown;
+};
+
+static void onBufferMapped(WGPUBufferMapAsyncStatus status, void *userdata) {
+  MapRequest *request = static_cast<MapRequest *>(userdata);
+  request->status = status;
+  request->done = true;
+}
+
+bool readOffscreenPixels(WGPUDevice device, const OffscreenTarget &target,
+                         std::vector<uint8_t> &rgba) {
+  const size_t size = size_t(target.bytesPerRow) * target.height;
+
+  MapRequest request;
+  wgpuBufferMapAsync(target.readbackBuffer, WGPUMapMode_Read, 0, size,
+                     onBufferMapped, &request);
+  while (!request.done)
+    wgpuDevicePoll(device, true, nullptr);
+
+  if (request.status != WGPUBufferMapAsyncStatus_Success) {
+    std::cerr << "Failed to map readback buffer! status=" << request.status
+              << std::endl;
+    return false;
+  }
+
+  const uint8_t *mapped = static_cast<const uint8_t *>(
+      wgpuBufferGetConstMappedRange(target.readbackBuffer, 0, size));
+  const size_t rowBytes = size_t(target.width) * 4;
+  rgba.resize(rowBytes * target.height);
+  for (uint32_t y = 0; y < target.height; ++y)
+    std::memcpy(rgba.data() + y * rowBytes, mapped + y * target.bytesPerRow,
+                rowBytes);
+  wgpuBufferUnmap(target.readbackBuffer);
+
+  if (target.format == WGPUTextureFormat_BGRA8Unorm) {
+    for (size_t i = 0; i < rgba.size(); i += 4)
+      std::swap(rgba[i], rgba[i + 2]);
+  }
+  return true;
+}
+
+bool writePpm(const char *path, uint32_t width, uint32_t height,
+              const std::vector<uint8_t> &rgba) {
+  FILE *file = std::fopen(path, "wb");
+  if (!file) {
+    std::cerr << "Failed to open " << path << " for writing!" << std::endl;
+    return false;
+  }
+  std::fprintf(file, "P6\n%u %u\n255\n", width, height);
+  std::vector<uint8_t> row(size_t(width) * 3);
+  for (uint32_t y = 0; y < height; ++y) {
+    const uint8_t *src = rgba.data() + size_t(y) * width * 4;
+    for (uint32_t x = 0; x < width; ++x) {
+      row[x * 3 + 0] = src[x * 4 + 0];
+      row[x * 3 + 1] = src[x * 4 + 1];
+      row[x * 3 + 2] = src[x * 4 + 2];
+    }
+    std::fwrite(row.data(), 1, row.size(), file);
+  }
+  std::fclose(file);
+  return true;
+}
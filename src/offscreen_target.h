@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include <webgpu/webgpu.h>
+
+// Cel renderowania poza ekranem (tryb headless): tekstura RenderAttachment +
+// bufor MapRead do odczytu klatki na CPU.
+struct OffscreenTarget {
+  WGPUTexture texture = nullptr;
+  WGPUTextureView view = nullptr;
+  WGPUBuffer readbackBuffer = nullptr;
+  WGPUTextureFormat format = WGPUTextureFormat_Undefined;
+  uint32_t width = 0;
+  uint32_t height = 0;
+  uint32_t bytesPerRow = 0; // wyrównane do 256 B (wymóg copyTextureToBuffer)
+};
+
+// Tworzy teksturę i bufor readback. Obsługiwane formaty: RGBA8 / BGRA8.
+bool createOffscreenTarget(WGPUDevice device, uint32_t width, uint32_t height,
+                           WGPUTextureFormat format, OffscreenTarget &target);
+void releaseOffscreenTarget(OffscreenTarget &target);
+
+// Dopisuje do encodera kopię tekstury do bufora readback
+void encodeOffscreenReadback(WGPUCommandEncoder encoder,
+                             const OffscreenTarget &target);
+
+// Mapuje bufor readback (blokująco, przez wgpuDevicePoll) i zwraca piksele
+// jako ciasno upakowane RGBA8 (bez paddingu wierszy, BGRA zamienione na RGBA)
+bool readOffscreenPixels(WGPUDevice device, const OffscreenTarget &target,
+                         std::vector<uint8_t> &rgba);
+
+// Zapisuje piksele RGBA8 do pliku PPM (P6, kanał alfa pomijany)
+bool writePpm(const char *path, uint32_t width, uint32_t height,
+              const std::vector<uint8_t> &rgba);
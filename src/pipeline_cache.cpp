@@ -0,0 +1,658 @@
+#include "pipeline_cache.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+
+// ============================================================
+//  Serializacja opisów
+// ============================================================
+
+// Ten sam zapis służy za rekord pliku rozgrzewki (z etykietami) i za klucz
+// cache'a (bez etykiet — identyczny stan pod inną nazwą to ten sam obiekt)
+
+namespace {
+
+constexpr uint32_t kWarmupFileVersion = 1;
+constexpr uint32_t kRecordRender = 0;
+constexpr uint32_t kRecordCompute = 1;
+
+// FNV-1a 64-bit
+uint64_t hashBytes(const std::string &bytes) {
+  uint64_t hash = 14695981039346656037ull;
+  for (unsigned char c : bytes) {
+    hash ^= c;
+    hash *= 1099511628211ull;
+  }
+  return hash;
+}
+
+struct ByteWriter {
+  std::string out;
+  void u32(uint32_t value) { out.append(reinterpret_cast<char *>(&value), 4); }
+  void u64(uint64_t value) { out.append(reinterpret_cast<char *>(&value), 8); }
+  void str(const std::string &value) {
+    u32(uint32_t(value.size()));
+    out.append(value);
+  }
+};
+
+struct ByteReader {
+  const char *data;
+  size_t size;
+  size_t pos = 0;
+  bool ok = true;
+
+  uint32_t u32() {
+    uint32_t value = 0;
+    read(&value, 4);
+    return value;
+  }
+  uint64_t u64() {
+    uint64_t value = 0;
+    read(&value, 8);
+    return value;
+  }
+  std::string str() {
+    const uint32_t length = u32();
+    if (!ok || length > size - pos) {
+      ok = false;
+      return {};
+    }
+    std::string value(data + pos, length);
+    pos += length;
+    return value;
+  }
+  void read(void *target, size_t bytes) {
+    if (!ok || bytes > size - pos) {
+      ok = false;
+      return;
+    }
+    std::memcpy(target, data + pos, bytes);
+    pos += bytes;
+  }
+};
+
+void writeBindGroupLayout(ByteWriter &w, const BindGroupLayoutDesc &desc,
+                          bool labels) {
+  w.str(labels ? desc.label : std::string());
+  w.u32(uint32_t(desc.entries.size()));
+  for (const BindingDesc &e : desc.entries) {
+    w.u32(e.binding);
+    w.u32(e.visibility);
+    w.u32(e.bufferType);
+    w.u32(e.hasDynamicOffset);
+    w.u64(e.minBindingSize);
+    w.u32(e.samplerType);
+    w.u32(e.textureSampleType);
+    w.u32(e.textureDimension);
+    w.u32(e.storageAccess);
+    w.u32(e.storageFormat);
+  }
+}
+
+BindGroupLayoutDesc readBindGroupLayout(ByteReader &r) {
+  BindGroupLayoutDesc desc;
+  desc.label = r.str();
+  const uint32_t count = r.u32();
+  for (uint32_t i = 0; i < count && r.ok; ++i) {
+    BindingDesc e;
+    e.binding = r.u32();
+    e.visibility = r.u32();
+    e.bufferType = WGPUBufferBindingType(r.u32());
+    e.hasDynamicOffset = r.u32() != 0;
+    e.minBindingSize = r.u64();
+    e.samplerType = WGPUSamplerBindingType(r.u32());
+    e.textureSampleType = WGPUTextureSampleType(r.u32());
+    e.textureDimension = WGPUTextureViewDimension(r.u32());
+    e.storageAccess = WGPUStorageTextureAccess(r.u32());
+    e.storageFormat = WGPUTextureFormat(r.u32());
+    desc.entries.push_back(e);
+  }
+  return desc;
+}
+
+void writeBindGroups(ByteWriter &w,
+                     const std::vector<BindGroupLayoutDesc> &bindGroups,
+                     bool labels) {
+  w.u32(uint32_t(bindGroups.size()));
+  for (const BindGroupLayoutDesc &group : bindGroups)
+    writeBindGroupLayout(w, group, labels);
+}
+
+std::vector<BindGroupLayoutDesc> readBindGroups(ByteReader &r) {
+  std::vector<BindGroupLayoutDesc> groups;
+  const uint32_t count = r.u32();
+  for (uint32_t i = 0; i < count && r.ok; ++i)
+    groups.push_back(readBindGroupLayout(r));
+  return groups;
+}
+
+std::string serialize(const RenderPipelineDesc &desc, bool labels) {
+  ByteWriter w;
+  w.u32(kRecordRender);
+  w.str(labels ? desc.label : std::string());
+  w.str(desc.shaderSource);
+  w.str(desc.vertexEntry);
+  w.str(desc.fragmentEntry);
+  writeBindGroups(w, desc.bindGroups, labels);
+  w.u32(uint32_t(desc.vertexBuffers.size()));
+  for (const VertexBufferDesc &buffer : desc.vertexBuffers) {
+    w.u64(buffer.arrayStride);
+    w.u32(buffer.stepMode);
+    w.u32(uint32_t(buffer.attributes.size()));
+    for (const WGPUVertexAttribute &attribute : buffer.attributes) {
+      w.u32(attribute.format);
+      w.u64(attribute.offset);
+      w.u32(attribute.shaderLocation);
+    }
+  }
+  w.u32(desc.colorFormat);
+  w.u32(uint32_t(desc.blend));
+  w.u32(desc.topology);
+  return w.out;
+}
+
+std::string serialize(const ComputePipelineDesc &desc, bool labels) {
+  ByteWriter w;
+  w.u32(kRecordCompute);
+  w.str(labels ? desc.label : std::string());
+  w.str(desc.shaderSource);
+  w.str(desc.entryPoint);
+  writeBindGroups(w, desc.bindGroups, labels);
+  return w.out;
+}
+
+RenderPipelineDesc readRenderPipeline(ByteReader &r) {
+  RenderPipelineDesc desc;
+  desc.label = r.str();
+  desc.shaderSource = r.str();
+  desc.vertexEntry = r.str();
+  desc.fragmentEntry = r.str();
+  desc.bindGroups = readBindGroups(r);
+  const uint32_t bufferCount = r.u32();
+  for (uint32_t i = 0; i < bufferCount && r.ok; ++i) {
+    VertexBufferDesc buffer;
+    buffer.arrayStride = r.u64();
+    buffer.stepMode = WGPUVertexStepMode(r.u32());
+    const uint32_t attributeCount = r.u32();
+    for (uint32_t a = 0; a < attributeCount && r.ok; ++a) {
+      WGPUVertexAttribute attribute = {};
+      attribute.format = WGPUVertexFormat(r.u32());
+      attribute.offset = r.u64();
+      attribute.shaderLocation = r.u32();
+      buffer.attributes.push_back(attribute);
+    }
+    desc.vertexBuffers.push_back(std::move(buffer));
+  }
+  desc.colorFormat = WGPUTextureFormat(r.u32());
+  desc.blend = BlendMode(r.u32());
+  desc.topology = WGPUPrimitiveTopology(r.u32());
+  return desc;
+}
+
+ComputePipelineDesc readComputePipeline(ByteReader &r) {
+  ComputePipelineDesc desc;
+  desc.label = r.str();
+  desc.shaderSource = r.str();
+  desc.entryPoint = r.str();
+  desc.bindGroups = readBindGroups(r);
+  return desc;
+}
+
+WGPUBlendState blendState(BlendMode mode) {
+  WGPUBlendState state = {};
+  state.color.operation = WGPUBlendOperation_Add;
+  state.alpha.operation = WGPUBlendOperation_Add;
+  state.alpha.srcFactor = WGPUBlendFactor_One;
+  state.alpha.dstFactor = WGPUBlendFactor_Zero;
+  switch (mode) {
+  case BlendMode::Additive:
+    state.color.srcFactor = WGPUBlendFactor_SrcAlpha;
+    state.color.dstFactor = WGPUBlendFactor_One;
+    break;
+  case BlendMode::Premultiplied:
+    state.color.srcFactor = WGPUBlendFactor_One;
+    state.color.dstFactor = WGPUBlendFactor_OneMinusSrcAlpha;
+    state.alpha.dstFactor = WGPUBlendFactor_OneMinusSrcAlpha;
+    break;
+  default: // Alpha (Opaque nie używa blend state)
+    state.color.srcFactor = WGPUBlendFactor_SrcAlpha;
+    state.color.dstFactor = WGPUBlendFactor_OneMinusSrcAlpha;
+    break;
+  }
+  return state;
+}
+
+double millisecondsSince(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration<double, std::milli>(
+             std::chrono::steady_clock::now() - start)
+      .count();
+}
+
+} // namespace
+
+size_t PipelineCache::StateKeyHash::operator()(const std::string &key) const {
+  return size_t(hashBytes(key));
+}
+
+// ============================================================
+//  BindingDesc
+// ============================================================
+
+BindingDesc BindingDesc::buffer(uint32_t binding,
+                                WGPUShaderStageFlags visibility,
+                                WGPUBufferBindingType type,
+                                uint64_t minBindingSize,
+                                bool hasDynamicOffset) {
+  BindingDesc desc;
+  desc.binding = binding;
+  desc.visibility = visibility;
+  desc.bufferType = type;
+  desc.minBindingSize = minBindingSize;
+  desc.hasDynamicOffset = hasDynamicOffset;
+  return desc;
+}
+
+BindingDesc BindingDesc::texture(uint32_t binding,
+                                 WGPUShaderStageFlags visibility,
+                                 WGPUTextureSampleType sampleType,
+                                 WGPUTextureViewDimension dimension) {
+  BindingDesc desc;
+  desc.binding = binding;
+  desc.visibility = visibility;
+  desc.textureSampleType = sampleType;
+  desc.textureDimension = dimension;
+  return desc;
+}
+
+BindingDesc BindingDesc::sampler(uint32_t binding,
+                                 WGPUShaderStageFlags visibility,
+                                 WGPUSamplerBindingType type) {
+  BindingDesc desc;
+  desc.binding = binding;
+  desc.visibility = visibility;
+  desc.samplerType = type;
+  return desc;
+}
+
+BindingDesc BindingDesc::storageTexture(uint32_t binding,
+                                        WGPUShaderStageFlags visibility,
+                                        WGPUStorageTextureAccess access,
+                                        WGPUTextureFormat format,
+                                        WGPUTextureViewDimension dimension) {
+  BindingDesc desc;
+  desc.binding = binding;
+  desc.visibility = visibility;
+  desc.storageAccess = access;
+  desc.storageFormat = format;
+  desc.textureDimension = dimension;
+  return desc;
+}
+
+// ============================================================
+//  PipelineCache
+// ============================================================
+
+PipelineCache::PipelineCache(WGPUDevice device) : m_device(device) {}
+
+PipelineCache::~PipelineCache() {
+  for (auto &[key, cached] : m_renderPipelines)
+    wgpuRenderPipelineRelease(cached.pipeline);
+  for (auto &[key, cached] : m_computePipelines)
+    wgpuComputePipelineRelease(cached.pipeline);
+  for (auto &[key, layout] : m_pipelineLayouts)
+    wgpuPipelineLayoutRelease(layout);
+  for (auto &[key, layout] : m_bindGroupLayouts)
+    wgpuBindGroupLayoutRelease(layout);
+  for (auto &[key, module] : m_shaderModules)
+    wgpuShaderModuleRelease(module);
+}
+
+WGPUShaderModule PipelineCache::shaderModule(const std::string &label,
+                                             const std::string &source) {
+  auto it = m_shaderModules.find(source);
+  if (it != m_shaderModules.end())
+    return it->second;
+
+  WGPUShaderModuleWGSLDescriptor wgslDesc = {};
+  wgslDesc.chain.next = nullptr;
+  wgslDesc.chain.sType = WGPUSType_ShaderModuleWGSLDescriptor;
+  wgslDesc.code = source.c_str();
+
+  WGPUShaderModuleDescriptor shaderDesc = {};
+  shaderDesc.nextInChain = &wgslDesc.chain;
+  shaderDesc.label = label.c_str();
+  shaderDesc.hintCount = 0;
+  shaderDesc.hints = nullptr;
+
+  WGPUShaderModule module = wgpuDeviceCreateShaderModule(m_device, &shaderDesc);
+  if (!module) {
+    std::cerr << "Failed to create shader module: " << label << std::endl;
+    return nullptr;
+  }
+  m_shaderModules.emplace(source, module);
+  return module;
+}
+
+WGPUBindGroupLayout
+PipelineCache::bindGroupLayout(const BindGroupLayoutDesc &desc) {
+  ByteWriter w;
+  writeBindGroupLayout(w, desc, false);
+  auto it = m_bindGroupLayouts.find(w.out);
+  if (it != m_bindGroupLayouts.end())
+    return it->second;
+
+  std::vector<WGPUBindGroupLayoutEntry> entries(desc.entries.size());
+  for (size_t i = 0; i < entries.size(); ++i) {
+    const BindingDesc &src = desc.entries[i];
+    WGPUBindGroupLayoutEntry &dst = entries[i];
+    dst = {};
+    dst.binding = src.binding;
+    dst.visibility = src.visibility;
+    dst.buffer.type = src.bufferType;
+    dst.buffer.hasDynamicOffset = src.hasDynamicOffset;
+    dst.buffer.minBindingSize = src.minBindingSize;
+    dst.sampler.type = src.samplerType;
+    dst.texture.sampleType = src.textureSampleType;
+    dst.texture.multisampled = false;
+    dst.storageTexture.access = src.storageAccess;
+    dst.storageTexture.format = src.storageFormat;
+    // Wymiar widoku dotyczy albo tekstury, albo storage texture
+    if (src.storageAccess != WGPUStorageTextureAccess_Undefined)
+      dst.storageTexture.viewDimension = src.textureDimension;
+    else
+      dst.texture.viewDimension = src.textureDimension;
+  }
+
+  WGPUBindGroupLayoutDescriptor layoutDesc = {};
+  layoutDesc.nextInChain = nullptr;
+  layoutDesc.label = desc.label.c_str();
+  layoutDesc.entryCount = entries.size();
+  layoutDesc.entries = entries.data();
+  WGPUBindGroupLayout layout =
+      wgpuDeviceCreateBindGroupLayout(m_device, &layoutDesc);
+  if (!layout) {
+    std::cerr << "Failed to create bind group layout: " << desc.label
+              << std::endl;
+    return nullptr;
+  }
+  m_bindGroupLayouts.emplace(std::move(w.out), layout);
+  return layout;
+}
+
+WGPUPipelineLayout PipelineCache::pipelineLayout(
+    const std::vector<BindGroupLayoutDesc> &bindGroups) {
+  ByteWriter w;
+  writeBindGroups(w, bindGroups, false);
+  auto it = m_pipelineLayouts.find(w.out);
+  if (it != m_pipelineLayouts.end())
+    return it->second;
+
+  std::vector<WGPUBindGroupLayout> layouts;
+  for (const BindGroupLayoutDesc &group : bindGroups) {
+    WGPUBindGroupLayout layout = bindGroupLayout(group);
+    if (!layout)
+      return nullptr;
+    layouts.push_back(layout);
+  }
+
+  WGPUPipelineLayoutDescriptor layoutDesc = {};
+  layoutDesc.nextInChain = nullptr;
+  layoutDesc.label = "Cached Pipeline Layout";
+  layoutDesc.bindGroupLayoutCount = layouts.size();
+  layoutDesc.bindGroupLayouts = layouts.data();
+  WGPUPipelineLayout layout =
+      wgpuDeviceCreatePipelineLayout(m_device, &layoutDesc);
+  if (layout)
+    m_pipelineLayouts.emplace(std::move(w.out), layout);
+  return layout;
+}
+
+WGPURenderPipeline
+PipelineCache::renderPipeline(const RenderPipelineDesc &desc) {
+  std::string key = serialize(desc, false);
+  auto it = m_renderPipelines.find(key);
+  if (it != m_renderPipelines.end()) {
+    ++m_stats.hits;
+    if (!m_loadingWarmup && !m_warmupRecords[it->second.record].used)
+      markUsed(it->second.record, serialize(desc, true));
+    return it->second.pipeline;
+  }
+
+  const auto start = std::chrono::steady_clock::now();
+  WGPUShaderModule module = shaderModule(desc.label, desc.shaderSource);
+  WGPUPipelineLayout layout = pipelineLayout(desc.bindGroups);
+  if (!module || !layout)
+    return nullptr;
+
+  // 1. Bufory wierzchołków
+  std::vector<WGPUVertexBufferLayout> vertexBuffers(desc.vertexBuffers.size());
+  for (size_t i = 0; i < vertexBuffers.size(); ++i) {
+    vertexBuffers[i].arrayStride = desc.vertexBuffers[i].arrayStride;
+    vertexBuffers[i].stepMode = desc.vertexBuffers[i].stepMode;
+    vertexBuffers[i].attributeCount = desc.vertexBuffers[i].attributes.size();
+    vertexBuffers[i].attributes = desc.vertexBuffers[i].attributes.data();
+  }
+
+  // 2. Color target + blend
+  const WGPUBlendState blend = blendState(desc.blend);
+  WGPUColorTargetState colorTarget = {};
+  colorTarget.nextInChain = nullptr;
+  colorTarget.format = desc.colorFormat;
+  colorTarget.blend = desc.blend == BlendMode::Opaque ? nullptr : &blend;
+  colorTarget.writeMask = WGPUColorWriteMask_All;
+
+  WGPUFragmentState fragmentState = {};
+  fragmentState.nextInChain = nullptr;
+  fragmentState.module = module;
+  fragmentState.entryPoint = desc.fragmentEntry.c_str();
+  fragmentState.constantCount = 0;
+  fragmentState.constants = nullptr;
+  fragmentState.targetCount = 1;
+  fragmentState.targets = &colorTarget;
+
+  // 3. Pipeline descriptor
+  WGPURenderPipelineDescriptor pipelineDesc = {};
+  pipelineDesc.nextInChain = nullptr;
+  pipelineDesc.label = desc.label.c_str();
+  pipelineDesc.layout = layout;
+
+  pipelineDesc.vertex.nextInChain = nullptr;
+  pipelineDesc.vertex.module = module;
+  pipelineDesc.vertex.entryPoint = desc.vertexEntry.c_str();
+  pipelineDesc.vertex.constantCount = 0;
+  pipelineDesc.vertex.constants = nullptr;
+  pipelineDesc.vertex.bufferCount = vertexBuffers.size();
+  pipelineDesc.vertex.buffers = vertexBuffers.data();
+
+  pipelineDesc.primitive.nextInChain = nullptr;
+  pipelineDesc.primitive.topology = desc.topology;
+  pipelineDesc.primitive.stripIndexFormat = WGPUIndexFormat_Undefined;
+  pipelineDesc.primitive.frontFace = WGPUFrontFace_CCW;
+  pipelineDesc.primitive.cullMode = WGPUCullMode_None;
+
+  pipelineDesc.multisample.nextInChain = nullptr;
+  pipelineDesc.multisample.count = 1;
+  pipelineDesc.multisample.mask = ~0u;
+  pipelineDesc.multisample.alphaToCoverageEnabled = false;
+
+  pipelineDesc.fragment = &fragmentState;
+  pipelineDesc.depthStencil = nullptr;
+
+  WGPURenderPipeline pipeline =
+      wgpuDeviceCreateRenderPipeline(m_device, &pipelineDesc);
+  if (!pipeline) {
+    std::cerr << "Failed to create render pipeline: " << desc.label
+              << std::endl;
+    return nullptr;
+  }
+
+  ++m_stats.misses;
+  m_stats.compileMs += millisecondsSince(start);
+  m_renderPipelines.emplace(std::move(key),
+                            CachedPipeline<WGPURenderPipeline>{
+                                pipeline, addRecord(serialize(desc, true))});
+  return pipeline;
+}
+
+WGPUComputePipeline
+PipelineCache::computePipeline(const ComputePipelineDesc &desc) {
+  std::string key = serialize(desc, false);
+  auto it = m_computePipelines.find(key);
+  if (it != m_computePipelines.end()) {
+    ++m_stats.hits;
+    if (!m_loadingWarmup && !m_warmupRecords[it->second.record].used)
+      markUsed(it->second.record, serialize(desc, true));
+    return it->second.pipeline;
+  }
+
+  const auto start = std::chrono::steady_clock::now();
+  WGPUShaderModule module = shaderModule(desc.label, desc.shaderSource);
+  WGPUPipelineLayout layout = pipelineLayout(desc.bindGroups);
+  if (!module || !layout)
+    return nullptr;
+
+  WGPUComputePipelineDescriptor pipelineDesc = {};
+  pipelineDesc.nextInChain = nullptr;
+  pipelineDesc.label = desc.label.c_str();
+  pipelineDesc.layout = layout;
+  pipelineDesc.compute.nextInChain = nullptr;
+  pipelineDesc.compute.module = module;
+  pipelineDesc.compute.entryPoint = desc.entryPoint.c_str();
+  pipelineDesc.compute.constantCount = 0;
+  pipelineDesc.compute.constants = nullptr;
+
+  WGPUComputePipeline pipeline =
+      wgpuDeviceCreateComputePipeline(m_device, &pipelineDesc);
+  if (!pipeline) {
+    std::cerr << "Failed to create compute pipeline: " << desc.label
+              << std::endl;
+    return nullptr;
+  }
+
+  ++m_stats.misses;
+  m_stats.compileMs += millisecondsSince(start);
+  m_computePipelines.emplace(std::move(key),
+                             CachedPipeline<WGPUComputePipeline>{
+                                 pipeline, addRecord(serialize(desc, true))});
+  return pipeline;
+}
+
+void PipelineCache::warmup(const std::vector<RenderPipelineDesc> &pipelines) {
+  const auto start = std::chrono::steady_clock::now();
+  const Stats before = m_stats;
+  for (const RenderPipelineDesc &desc : pipelines)
+    renderPipeline(desc);
+  // Rozgrzewka nie jest "trafieniem" z punktu widzenia gry
+  m_stats.hits = before.hits;
+  m_stats.warmupMs += millisecondsSince(start);
+}
+
+// ============================================================
+//  Plik rozgrzewki
+// ============================================================
+
+uint32_t PipelineCache::addRecord(std::string record) {
+  // Rekordy z pliku czekają na pierwsze żądanie w tej sesji
+  m_warmupRecords.push_back({std::move(record), !m_loadingWarmup});
+  if (!m_loadingWarmup)
+    m_dirty = true;
+  return uint32_t(m_warmupRecords.size() - 1);
+}
+
+void PipelineCache::markUsed(uint32_t record, std::string labeled) {
+  // Pierwsze żądanie w sesji ustala etykietę zapisywaną w pliku — rekord
+  // wczytany ze starą etykietą jest podmieniany
+  WarmupRecord &entry = m_warmupRecords[record];
+  entry.used = true;
+  if (entry.bytes != labeled) {
+    entry.bytes = std::move(labeled);
+    m_dirty = true;
+  }
+}
+
+bool PipelineCache::dirty() const {
+  if (m_dirty)
+    return true;
+  // Nieużyte rekordy z pliku (zmieniony shader, etykieta, format) —
+  // zapis je usunie
+  for (const WarmupRecord &record : m_warmupRecords)
+    if (!record.used)
+      return true;
+  return false;
+}
+
+uint32_t PipelineCache::loadWarmupFile(const char *path) {
+  FILE *file = std::fopen(path, "rb");
+  if (!file)
+    return 0; // pierwsze uruchomienie — nic do rozgrzania
+
+  std::string bytes;
+  char buffer[16384];
+  size_t read;
+  while ((read = std::fread(buffer, 1, sizeof(buffer), file)) > 0)
+    bytes.append(buffer, read);
+  std::fclose(file);
+
+  ByteReader r{bytes.data(), bytes.size()};
+  char magic[4] = {};
+  r.read(magic, 4);
+  const uint32_t version = r.u32();
+  const uint32_t count = r.u32();
+  if (!r.ok || std::memcmp(magic, "WPLC", 4) != 0 ||
+      version != kWarmupFileVersion) {
+    std::cerr << "Ignoring invalid pipeline warmup file: " << path
+              << std::endl;
+    return 0;
+  }
+
+  const auto start = std::chrono::steady_clock::now();
+  const uint32_t hitsBefore = m_stats.hits;
+  uint32_t warmed = 0;
+  m_loadingWarmup = true;
+  for (uint32_t i = 0; i < count && r.ok; ++i) {
+    const std::string record = r.str();
+    ByteReader recordReader{record.data(), record.size()};
+    const uint32_t kind = recordReader.u32();
+    bool created = false;
+    if (kind == kRecordRender) {
+      RenderPipelineDesc desc = readRenderPipeline(recordReader);
+      created = recordReader.ok && renderPipeline(desc);
+    } else if (kind == kRecordCompute) {
+      ComputePipelineDesc desc = readComputePipeline(recordReader);
+      created = recordReader.ok && computePipeline(desc);
+    }
+    warmed += created ? 1 : 0;
+  }
+  m_loadingWarmup = false;
+  m_stats.hits = hitsBefore;
+  m_stats.warmupMs += millisecondsSince(start);
+  return warmed;
+}
+
+bool PipelineCache::saveWarmupFile(const char *path) const {
+  ByteWriter w;
+  w.out.append("WPLC", 4);
+  w.u32(kWarmupFileVersion);
+  // Tylko pipeline'y zażądane w tej sesji — nieaktualne opisy wypadają
+  uint32_t count = 0;
+  for (const WarmupRecord &record : m_warmupRecords)
+    count += record.used ? 1 : 0;
+  w.u32(count);
+  for (const WarmupRecord &record : m_warmupRecords)
+    if (record.used)
+      w.str(record.bytes);
+
+  FILE *file = std::fopen(path, "wb");
+  if (!file) {
+    std::cerr << "Could not write pipeline warmup file: " << path
+              << std::endl;
+    return false;
+  }
+  const bool ok = std::fwrite(w.out.data(), 1, w.out.size(), file) ==
+                  w.out.size();
+  std::fclose(file);
+  return ok;
+}
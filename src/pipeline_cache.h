@@ -0,0 +1,159 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <webgpu/webgpu.h>
+
+// ============================================================
+//  Opisy stanu (wartości — da się je haszować i zapisać na dysk)
+// ============================================================
+
+// Jeden wpis bind group layoutu. Pole typu, które nie jest Undefined,
+// wybiera rodzaj bindingu (bufor / sampler / tekstura / storage texture).
+struct BindingDesc {
+  uint32_t binding = 0;
+  WGPUShaderStageFlags visibility = WGPUShaderStage_None;
+  WGPUBufferBindingType bufferType = WGPUBufferBindingType_Undefined;
+  bool hasDynamicOffset = false;
+  uint64_t minBindingSize = 0;
+  WGPUSamplerBindingType samplerType = WGPUSamplerBindingType_Undefined;
+  WGPUTextureSampleType textureSampleType = WGPUTextureSampleType_Undefined;
+  WGPUTextureViewDimension textureDimension =
+      WGPUTextureViewDimension_Undefined;
+  WGPUStorageTextureAccess storageAccess = WGPUStorageTextureAccess_Undefined;
+  WGPUTextureFormat storageFormat = WGPUTextureFormat_Undefined;
+
+  static BindingDesc buffer(uint32_t binding, WGPUShaderStageFlags visibility,
+                            WGPUBufferBindingType type,
+                            uint64_t minBindingSize,
+                            bool hasDynamicOffset = false);
+  static BindingDesc texture(uint32_t binding, WGPUShaderStageFlags visibility,
+                             WGPUTextureSampleType sampleType,
+                             WGPUTextureViewDimension dimension);
+  static BindingDesc sampler(uint32_t binding, WGPUShaderStageFlags visibility,
+                             WGPUSamplerBindingType type);
+  static BindingDesc storageTexture(uint32_t binding,
+                                    WGPUShaderStageFlags visibility,
+                                    WGPUStorageTextureAccess access,
+                                    WGPUTextureFormat format,
+                                    WGPUTextureViewDimension dimension);
+};
+
+struct BindGroupLayoutDesc {
+  std::string label;
+  std::vector<BindingDesc> entries;
+};
+
+struct VertexBufferDesc {
+  uint64_t arrayStride = 0;
+  WGPUVertexStepMode stepMode = WGPUVertexStepMode_Vertex;
+  std::vector<WGPUVertexAttribute> attributes;
+};
+
+enum class BlendMode : uint32_t {
+  Opaque,        // bez mieszania
+  Alpha,         // src * a + dst * (1 - a)
+  Additive,      // src * a + dst
+  Premultiplied, // src + dst * (1 - a)
+};
+
+struct RenderPipelineDesc {
+  std::string label;
+  std::string shaderSource; // WGSL
+  std::string vertexEntry = "vs_main";
+  std::string fragmentEntry = "fs_main";
+  std::vector<BindGroupLayoutDesc> bindGroups; // kolejno grupy 0..N-1
+  std::vector<VertexBufferDesc> vertexBuffers;
+  WGPUTextureFormat colorFormat = WGPUTextureFormat_BGRA8Unorm;
+  BlendMode blend = BlendMode::Alpha;
+  WGPUPrimitiveTopology topology = WGPUPrimitiveTopology_TriangleList;
+};
+
+struct ComputePipelineDesc {
+  std::string label;
+  std::string shaderSource;
+  std::string entryPoint = "cs_main";
+  std::vector<BindGroupLayoutDesc> bindGroups;
+};
+
+// ============================================================
+//  PipelineCache
+// ============================================================
+
+// Deduplikuje shader modules, bind group layouty, pipeline layouty i
+// pipeline'y po pełnym opisie stanu (bez etykiet; hasz tylko wybiera
+// kubełek, trafienie porównuje cały opis). Zwracane obiekty należą do
+// cache'a (nie wolno ich zwalniać) i żyją do jego zniszczenia.
+//
+// Każdy pipeline zażądany w sesji trafia do pliku rozgrzewki: przy
+// następnym starcie loadWarmupFile() kompiluje zapisany zestaw podczas
+// ładowania, więc pierwsze użycie w grze to już trafienie w cache.
+// Rekordy z pliku, o które sesja nie poprosiła, nie są zapisywane ponownie.
+class PipelineCache {
+public:
+  struct Stats {
+    uint32_t hits = 0;
+    uint32_t misses = 0; // faktyczne kompilacje pipeline'ów
+    double compileMs = 0.0;
+    double warmupMs = 0.0;
+  };
+
+  explicit PipelineCache(WGPUDevice device);
+  ~PipelineCache();
+  PipelineCache(const PipelineCache &) = delete;
+  PipelineCache &operator=(const PipelineCache &) = delete;
+
+  WGPUBindGroupLayout bindGroupLayout(const BindGroupLayoutDesc &desc);
+  WGPURenderPipeline renderPipeline(const RenderPipelineDesc &desc);
+  WGPUComputePipeline computePipeline(const ComputePipelineDesc &desc);
+
+  // Kompiluje zadeklarowany zestaw z góry (np. w trakcie ekranu ładowania)
+  void warmup(const std::vector<RenderPipelineDesc> &pipelines);
+
+  // Plik rozgrzewki: opisy pipeline'ów zażądanych w tej sesji.
+  // load zwraca liczbę rozgrzanych pipeline'ów (0, gdy brak pliku).
+  uint32_t loadWarmupFile(const char *path);
+  bool saveWarmupFile(const char *path) const;
+  // true, gdy zapis zmieni plik: nowe pipeline'y albo nieużyte rekordy
+  bool dirty() const;
+
+  const Stats &stats() const { return m_stats; }
+
+private:
+  // Klucz to zserializowany opis; równość porównuje całe bajty
+  struct StateKeyHash {
+    size_t operator()(const std::string &key) const;
+  };
+  template <typename Pipeline> struct CachedPipeline {
+    Pipeline pipeline = nullptr;
+    uint32_t record = 0; // indeks w m_warmupRecords
+  };
+  struct WarmupRecord {
+    std::string bytes; // opis z etykietami
+    bool used = false; // zażądany w tej sesji (poza rozgrzewką z pliku)
+  };
+
+  WGPUShaderModule shaderModule(const std::string &label,
+                                const std::string &source);
+  WGPUPipelineLayout pipelineLayout(
+      const std::vector<BindGroupLayoutDesc> &bindGroups);
+  uint32_t addRecord(std::string record);
+  void markUsed(uint32_t record, std::string labeled);
+
+  template <typename T>
+  using StateMap = std::unordered_map<std::string, T, StateKeyHash>;
+
+  WGPUDevice m_device = nullptr;
+  StateMap<WGPUShaderModule> m_shaderModules; // klucz: źródło WGSL
+  StateMap<WGPUBindGroupLayout> m_bindGroupLayouts;
+  StateMap<WGPUPipelineLayout> m_pipelineLayouts;
+  StateMap<CachedPipeline<WGPURenderPipeline>> m_renderPipelines;
+  StateMap<CachedPipeline<WGPUComputePipeline>> m_computePipelines;
+  // Opisy pipeline'ów w kolejności kompilacji (plik)
+  std::vector<WarmupRecord> m_warmupRecords;
+  bool m_loadingWarmup = false;
+  bool m_dirty = false; // nowe pipeline'y od wczytania
+  Stats m_stats;
+};
@@ -0,0 +1,430 @@
+#include "profiler.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+// ============================================================
+//  Bufory zdarzeń CPU
+// ============================================================
+
+namespace {
+
+constexpr uint32_t kThreadRingSize = 1 << 15; // zdarzeń na wątek (potęga 2)
+constexpr uint32_t kMaxScopeDepth = 64;
+constexpr uint32_t kGpuEventRingSize = 1 << 12;
+constexpr uint32_t kGpuTraceThreadId = 1000; // osobny "wątek" w trace
+
+struct ProfileEvent {
+  const char *name;
+  uint64_t beginNs;
+  uint64_t endNs;
+  uint64_t frameIndex;
+  uint32_t depth;
+};
+
+// Każdy wątek pisze tylko do własnego pierścienia — brak synchronizacji na
+// gorącej ścieżce. Rejestr pierścieni chroni mutex (tylko przy pierwszym
+// zakresie wątku i przy eksporcie).
+struct ThreadRing {
+  uint32_t threadId = 0;
+  uint32_t depth = 0;
+  uint64_t head = 0; // liczba zapisanych zdarzeń (indeks = head & mask)
+  const char *openNames[kMaxScopeDepth] = {};
+  uint64_t openBegins[kMaxScopeDepth] = {};
+  ProfileEvent events[kThreadRingSize];
+};
+
+struct GpuEvent {
+  const char *name;
+  uint64_t beginNs; // już na osi czasu CPU
+  uint64_t endNs;
+  uint64_t frameIndex;
+};
+
+std::mutex g_registryMutex;
+std::vector<std::unique_ptr<ThreadRing>> g_threadRings;
+thread_local ThreadRing *t_ring = nullptr;
+
+std::atomic<uint64_t> g_currentFrame{0};
+const auto g_epoch = std::chrono::steady_clock::now();
+
+// Historia klatek (wątek główny + callback mapowania — też wątek główny:
+// wgpuDevicePoll woła tylko pętla główna, patrz frameRingWaitForSlot)
+FrameStats g_frameHistory[kFrameHistorySize];
+uint64_t g_frameHistoryHead = 0;
+uint64_t g_frameBeginNs = 0;
+bool g_capturing = false;
+FrameStats g_latestGpuFrame;
+bool g_hasLatestGpuFrame = false;
+std::vector<FrameStats> g_capturedFrames;
+
+GpuEvent g_gpuEvents[kGpuEventRingSize];
+uint64_t g_gpuEventHead = 0;
+
+ThreadRing *threadRing() {
+  if (t_ring)
+    return t_ring;
+  auto ring = std::make_unique<ThreadRing>();
+  std::lock_guard<std::mutex> lock(g_registryMutex);
+  ring->threadId = static_cast<uint32_t>(g_threadRings.size());
+  t_ring = ring.get();
+  g_threadRings.push_back(std::move(ring));
+  return t_ring;
+}
+
+FrameStats *findFrame(uint64_t frameIndex) {
+  uint64_t count = std::min<uint64_t>(g_frameHistoryHead, kFrameHistorySize);
+  for (uint64_t i = 0; i < count; ++i) {
+    FrameStats &stats =
+        g_frameHistory[(g_frameHistoryHead - 1 - i) % kFrameHistorySize];
+    if (stats.frameIndex == frameIndex)
+      return &stats;
+  }
+  return nullptr;
+}
+
+// Odczyty GPU spóźniają się o kilka klatek — szukanie od końca
+FrameStats *findCapturedFrame(uint64_t frameIndex) {
+  for (auto it = g_capturedFrames.rbegin(); it != g_capturedFrames.rend();
+       ++it) {
+    if (it->frameIndex == frameIndex)
+      return &*it;
+    if (it->frameIndex < frameIndex)
+      break;
+  }
+  return nullptr;
+}
+
+} // namespace
+
+uint64_t profilerNowNs() {
+  return static_cast<uint64_t>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(
+          std::chrono::steady_clock::now() - g_epoch)
+          .count());
+}
+
+void profilerBeginScope(const char *name) {
+  ThreadRing *ring = threadRing();
+  if (ring->depth < kMaxScopeDepth) {
+    ring->openNames[ring->depth] = name;
+    ring->openBegins[ring->depth] = profilerNowNs();
+  }
+  ++ring->depth;
+}
+
+void profilerEndScope() {
+  ThreadRing *ring = t_ring;
+  if (!ring || ring->depth == 0)
+    return;
+  --ring->depth;
+  if (ring->depth >= kMaxScopeDepth)
+    return; // zbyt głęboko zagnieżdżony zakres nie był zapisany
+
+  ProfileEvent &event = ring->events[ring->head & (kThreadRingSize - 1)];
+  event.name = ring->openNames[ring->depth];
+  event.beginNs = ring->openBegins[ring->depth];
+  event.endNs = profilerNowNs();
+  event.frameIndex = g_currentFrame.load(std::memory_order_relaxed);
+  event.depth = ring->depth;
+  ++ring->head;
+}
+
+// ============================================================
+//  Klatki
+// ============================================================
+
+// Wpis klatki powstaje już na jej początku — timestampy GPU mogą wrócić
+// (headless: poll z czekaniem) zanim klatka się zakończy
+void profilerBeginFrame(uint64_t frameIndex) {
+  g_currentFrame.store(frameIndex, std::memory_order_relaxed);
+  g_frameBeginNs = profilerNowNs();
+  FrameStats &stats = g_frameHistory[g_frameHistoryHead % kFrameHistorySize];
+  stats = FrameStats{};
+  stats.frameIndex = frameIndex;
+  ++g_frameHistoryHead;
+}
+
+void profilerEndFrame() {
+  if (g_frameHistoryHead == 0)
+    return;
+  FrameStats &stats =
+      g_frameHistory[(g_frameHistoryHead - 1) % kFrameHistorySize];
+  stats.cpuMs = (profilerNowNs() - g_frameBeginNs) / 1.0e6;
+  if (g_capturing)
+    g_capturedFrames.push_back(stats);
+}
+
+size_t profilerFrameHistory(FrameStats *out, size_t maxCount) {
+  uint64_t count = std::min<uint64_t>(g_frameHistoryHead, kFrameHistorySize);
+  count = std::min<uint64_t>(count, maxCount);
+  uint64_t first = g_frameHistoryHead - count;
+  for (uint64_t i = 0; i < count; ++i)
+    out[i] = g_frameHistory[(first + i) % kFrameHistorySize];
+  return static_cast<size_t>(count);
+}
+
+void profilerBeginCapture(size_t expectedFrames) {
+  g_capturedFrames.clear();
+  g_capturedFrames.reserve(expectedFrames);
+  g_capturing = true;
+}
+
+const std::vector<FrameStats> &profilerCapturedFrames() {
+  return g_capturedFrames;
+}
+
+const FrameStats *profilerLatestGpuFrame() {
+  return g_hasLatestGpuFrame ? &g_latestGpuFrame : nullptr;
+}
+
+// ============================================================
+//  Eksport Chrome trace
+// ============================================================
+
+bool profilerWriteChromeTrace(const char *path) {
+  FILE *file = std::fopen(path, "w");
+  if (!file) {
+    std::cerr << "Could not open trace file: " << path << std::endl;
+    return false;
+  }
+
+  // Zdarzenia "X" (complete): ts i dur w mikrosekundach
+  bool first = true;
+  auto writeEvent = [&](const char *name, uint64_t beginNs, uint64_t endNs,
+                        uint32_t tid, uint64_t frameIndex) {
+    std::fprintf(file,
+                 "%s\n{\"name\":\"%s\",\"ph\":\"X\",\"pid\":0,\"tid\":%u,"
+                 "\"ts\":%.3f,\"dur\":%.3f,\"args\":{\"frame\":%llu}}",
+                 first ? "" : ",", name, tid, beginNs / 1000.0,
+                 (endNs - beginNs) / 1000.0,
+                 static_cast<unsigned long long>(frameIndex));
+    first = false;
+  };
+
+  std::fprintf(file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[");
+  {
+    std::lock_guard<std::mutex> lock(g_registryMutex);
+    for (const auto &ring : g_threadRings) {
+      std::fprintf(file,
+                   "%s\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,"
+                   "\"tid\":%u,\"args\":{\"name\":\"%s %u\"}}",
+                   first ? "" : ",", ring->threadId,
+                   ring->threadId == 0 ? "Main" : "Worker", ring->threadId);
+      first = false;
+
+      uint64_t count = std::min<uint64_t>(ring->head, kThreadRingSize);
+      for (uint64_t i = ring->head - count; i < ring->head; ++i) {
+        const ProfileEvent &e = ring->events[i & (kThreadRingSize - 1)];
+        writeEvent(e.name, e.beginNs, e.endNs, ring->threadId, e.frameIndex);
+      }
+    }
+  }
+
+  std::fprintf(file,
+               "%s\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,"
+               "\"tid\":%u,\"args\":{\"name\":\"GPU\"}}",
+               first ? "" : ",", kGpuTraceThreadId);
+  first = false;
+  uint64_t gpuCount = std::min<uint64_t>(g_gpuEventHead, kGpuEventRingSize);
+  for (uint64_t i = g_gpuEventHead - gpuCount; i < g_gpuEventHead; ++i) {
+    const GpuEvent &e = g_gpuEvents[i % kGpuEventRingSize];
+    writeEvent(e.name, e.beginNs, e.endNs, kGpuTraceThreadId, e.frameIndex);
+  }
+
+  std::fprintf(file, "\n]}\n");
+  bool ok = std::ferror(file) == 0;
+  std::fclose(file);
+  return ok;
+}
+
+// ============================================================
+//  GPU timestamp queries
+// ============================================================
+
+static WGPUBuffer createQueryBuffer(WGPUDevice device, const char *label,
+                                    uint64_t size, WGPUBufferUsageFlags usage) {
+  WGPUBufferDescriptor desc = {};
+  desc.nextInChain = nullptr;
+  desc.label = label;
+  desc.size = size;
+  desc.usage = usage;
+  desc.mappedAtCreation = false;
+  return wgpuDeviceCreateBuffer(device, &desc);
+}
+
+bool createGpuProfiler(WGPUDevice device, GpuProfiler &profiler) {
+  profiler.device = device;
+  profiler.supported =
+      wgpuDeviceHasFeature(device, WGPUFeatureName_TimestampQuery);
+  if (!profiler.supported) {
+    std::cout << "GPU profiler: timestamp queries not supported" << std::endl;
+    return true; // profiler CPU działa dalej, GPU to no-op
+  }
+
+  const uint64_t bufferSize = kMaxGpuPasses * 2 * sizeof(uint64_t);
+  for (GpuProfilerSlot &slot : profiler.slots) {
+    WGPUQuerySetDescriptor queryDesc = {};
+    queryDesc.nextInChain = nullptr;
+    queryDesc.label = "Profiler Timestamps";
+    queryDesc.type = WGPUQueryType_Timestamp;
+    queryDesc.count = kMaxGpuPasses * 2;
+    slot.querySet = wgpuDeviceCreateQuerySet(device, &queryDesc);
+    slot.resolveBuffer = createQueryBuffer(
+        device, "Profiler Resolve", bufferSize,
+        WGPUBufferUsage_QueryResolve | WGPUBufferUsage_CopySrc);
+    slot.readbackBuffer =
+        createQueryBuffer(device, "Profiler Readback", bufferSize,
+                          WGPUBufferUsage_MapRead | WGPUBufferUsage_CopyDst);
+    if (!slot.querySet || !slot.resolveBuffer || !slot.readbackBuffer) {
+      std::cerr << "Could not create GPU profiler resources!" << std::endl;
+      releaseGpuProfiler(profiler);
+      return false;
+    }
+  }
+  return true;
+}
+
+void releaseGpuProfiler(GpuProfiler &profiler) {
+  for (GpuProfilerSlot &slot : profiler.slots) {
+    if (slot.readbackBuffer)
+      wgpuBufferRelease(slot.readbackBuffer);
+    if (slot.resolveBuffer)
+      wgpuBufferRelease(slot.resolveBuffer);
+    if (slot.querySet)
+      wgpuQuerySetRelease(slot.querySet);
+    slot = GpuProfilerSlot{};
+  }
+  profiler.current = nullptr;
+  profiler.supported = false;
+}
+
+void gpuProfilerBeginFrame(GpuProfiler &profiler, uint64_t frameIndex) {
+  profiler.current = nullptr;
+  if (!profiler.supported)
+    return;
+
+  // Slot wciąż mapowany = GPU/readback nie nadąża. Pomijamy pomiar tej
+  // klatki zamiast czekać — profiler nie może zatrzymywać pętli.
+  GpuProfilerSlot &slot = profiler.slots[profiler.nextSlot];
+  if (slot.mapping)
+    return;
+  profiler.nextSlot = (profiler.nextSlot + 1) % kGpuProfilerSlots;
+
+  slot.passCount = 0;
+  slot.frameIndex = frameIndex;
+  profiler.current = &slot;
+}
+
+const WGPURenderPassTimestampWrites *
+gpuProfilerRenderPass(GpuProfiler &profiler, const char *name) {
+  GpuProfilerSlot *slot = profiler.current;
+  if (!slot || slot->passCount >= kMaxGpuPasses)
+    return nullptr;
+
+  uint32_t pass = slot->passCount++;
+  slot->passNames[pass] = name;
+  WGPURenderPassTimestampWrites &writes = profiler.writes[pass];
+  writes.querySet = slot->querySet;
+  writes.beginningOfPassWriteIndex = pass * 2;
+  writes.endOfPassWriteIndex = pass * 2 + 1;
+  return &writes;
+}
+
+const WGPUComputePassTimestampWrites *
+gpuProfilerComputePass(GpuProfiler &profiler, const char *name) {
+  const WGPURenderPassTimestampWrites *render =
+      gpuProfilerRenderPass(profiler, name);
+  if (!render)
+    return nullptr;
+  const uint32_t pass = uint32_t(render - profiler.writes);
+  WGPUComputePassTimestampWrites &writes = profiler.computeWrites[pass];
+  writes.querySet = render->querySet;
+  writes.beginningOfPassWriteIndex = render->beginningOfPassWriteIndex;
+  writes.endOfPassWriteIndex = render->endOfPassWriteIndex;
+  return &writes;
+}
+
+void gpuProfilerResolve(GpuProfiler &profiler, WGPUCommandEncoder encoder) {
+  GpuProfilerSlot *slot = profiler.current;
+  if (!slot || slot->passCount == 0)
+    return;
+
+  uint32_t queryCount = slot->passCount * 2;
+  uint64_t size = queryCount * sizeof(uint64_t);
+  wgpuCommandEncoderResolveQuerySet(encoder, slot->querySet, 0, queryCount,
+                                    slot->resolveBuffer, 0);
+  wgpuCommandEncoderCopyBufferToBuffer(encoder, slot->resolveBuffer, 0,
+                                       slot->readbackBuffer, 0, size);
+}
+
+static void onTimestampsMapped(WGPUBufferMapAsyncStatus status,
+                               void *userdata) {
+  GpuReadback *readback = static_cast<GpuReadback *>(userdata);
+  GpuProfiler &profiler = *readback->profiler;
+  GpuProfilerSlot &slot = *readback->slot;
+  profiler.readbacks.destroy(readback);
+  slot.mapping = false;
+  if (status != WGPUBufferMapAsyncStatus_Success)
+    return;
+
+  uint64_t size = slot.passCount * 2 * sizeof(uint64_t);
+  const uint64_t *ticks = static_cast<const uint64_t *>(
+      wgpuBufferGetConstMappedRange(slot.readbackBuffer, 0, size));
+  if (!ticks) {
+    wgpuBufferUnmap(slot.readbackBuffer);
+    return;
+  }
+
+  // Timestampy GPU mają własną oś czasu — kotwiczymy pierwszy pass klatki
+  // w chwili wysłania jej na CPU, żeby trace pokazywał je obok siebie.
+  const double period = profiler.timestampPeriodNs;
+  const uint64_t origin = ticks[0];
+  double gpuNs = 0.0;
+  for (uint32_t pass = 0; pass < slot.passCount; ++pass) {
+    uint64_t begin = ticks[pass * 2];
+    uint64_t end = ticks[pass * 2 + 1];
+    if (end < begin || begin < origin)
+      continue; // niepoprawny odczyt (np. reset licznika)
+
+    GpuEvent &event = g_gpuEvents[g_gpuEventHead++ % kGpuEventRingSize];
+    event.name = slot.passNames[pass];
+    event.beginNs =
+        slot.submitNs + static_cast<uint64_t>((begin - origin) * period);
+    event.endNs = slot.submitNs + static_cast<uint64_t>((end - origin) * period);
+    event.frameIndex = slot.frameIndex;
+    gpuNs += (end - begin) * period;
+  }
+  wgpuBufferUnmap(slot.readbackBuffer);
+
+  if (FrameStats *stats = findFrame(slot.frameIndex))
+    stats->gpuMs = gpuNs / 1.0e6;
+  if (FrameStats *stats = findCapturedFrame(slot.frameIndex))
+    stats->gpuMs = gpuNs / 1.0e6;
+  if (!g_hasLatestGpuFrame ||
+      slot.frameIndex >= g_latestGpuFrame.frameIndex) {
+    g_latestGpuFrame.frameIndex = slot.frameIndex;
+    g_latestGpuFrame.gpuMs = gpuNs / 1.0e6;
+    g_hasLatestGpuFrame = true;
+  }
+}
+
+void gpuProfilerAfterSubmit(GpuProfiler &profiler) {
+  GpuProfilerSlot *slot = profiler.current;
+  profiler.current = nullptr;
+  if (!slot || slot->passCount == 0)
+    return;
+
+  slot->submitNs = profilerNowNs();
+  slot->mapping = true;
+  uint64_t size = slot->passCount * 2 * sizeof(uint64_t);
+  wgpuBufferMapAsync(slot->readbackBuffer, WGPUMapMode_Read, 0, size,
+                     onTimestampsMapped,
+                     profiler.readbacks.create(&profiler, slot));
+}
@@ -0,0 +1,127 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <webgpu/webgpu.h>
+
+#include "memory_arena.h"
+
+// ============================================================
+//  Profiler CPU (zakresy) + GPU (timestamp queries)
+// ============================================================
+
+// Zakresy CPU trafiają do bufora pierścieniowego wątku (bez blokad na
+// gorącej ścieżce). Ustaw WARP_PROFILER=0, aby makra znikały z kodu.
+#ifndef WARP_PROFILER
+#define WARP_PROFILER 1
+#endif
+
+uint64_t profilerNowNs();
+
+void profilerBeginScope(const char *name);
+void profilerEndScope();
+
+class ProfileScope {
+public:
+  explicit ProfileScope(const char *name) { profilerBeginScope(name); }
+  ~ProfileScope() { profilerEndScope(); }
+  ProfileScope(const ProfileScope &) = delete;
+  ProfileScope &operator=(const ProfileScope &) = delete;
+};
+
+#if WARP_PROFILER
+#define WARP_PROFILE_CONCAT_(a, b) a##b
+#define WARP_PROFILE_CONCAT(a, b) WARP_PROFILE_CONCAT_(a, b)
+#define WARP_PROFILE_SCOPE(name)                                               \
+  ProfileScope WARP_PROFILE_CONCAT(profileScope_, __LINE__)(name)
+#else
+#define WARP_PROFILE_SCOPE(name) ((void)0)
+#endif
+
+// Statystyki jednej klatki (historia krocząca ostatnich klatek)
+struct FrameStats {
+  uint64_t frameIndex = 0;
+  double cpuMs = 0.0;
+  double gpuMs = -1.0; // -1 = brak pomiaru GPU (jeszcze lub wcale)
+};
+
+constexpr size_t kFrameHistorySize = 240;
+
+void profilerBeginFrame(uint64_t frameIndex);
+void profilerEndFrame();
+
+// Kopiuje historię klatek (od najstarszej) i zwraca liczbę wpisów
+size_t profilerFrameHistory(FrameStats *out, size_t maxCount);
+
+// Najnowsza klatka z odczytanym czasem GPU (timestampy wracają kilka
+// klatek później); nullptr, gdy jeszcze żadnej nie zmierzono
+const FrameStats *profilerLatestGpuFrame();
+
+// Zapis wszystkich kolejnych klatek, poza kroczącą historią (benchmarki).
+// Czas GPU uzupełniany jest, gdy wróci odczyt timestampów.
+void profilerBeginCapture(size_t expectedFrames);
+const std::vector<FrameStats> &profilerCapturedFrames();
+
+// Zapisuje wszystkie zdarzenia z buforów w formacie Chrome trace_event
+// (chrome://tracing, Perfetto). Wołać, gdy workery są bezczynne.
+bool profilerWriteChromeTrace(const char *path);
+
+// ============================================================
+//  GPU
+// ============================================================
+
+constexpr uint32_t kGpuProfilerSlots = 4; // klatki "w locie" z pomiarami
+constexpr uint32_t kMaxGpuPasses = 16;    // passy mierzone na klatkę
+
+struct GpuProfilerSlot {
+  WGPUQuerySet querySet = nullptr;
+  WGPUBuffer resolveBuffer = nullptr;  // QueryResolve | CopySrc
+  WGPUBuffer readbackBuffer = nullptr; // MapRead | CopyDst
+  const char *passNames[kMaxGpuPasses] = {};
+  uint32_t passCount = 0;
+  uint64_t frameIndex = 0;
+  uint64_t submitNs = 0; // czas CPU wysłania klatki (oś czasu trace)
+  bool mapping = false;  // czeka na wgpuBufferMapAsync
+};
+
+struct GpuProfiler;
+
+// Kontekst callbacka mapowania (z puli profilera)
+struct GpuReadback {
+  GpuProfiler *profiler;
+  GpuProfilerSlot *slot;
+};
+
+// Pomiar czasu passów przez WGPUQuerySet. Gdy urządzenie nie ma
+// WGPUFeatureName_TimestampQuery, wszystkie funkcje są no-op.
+struct GpuProfiler {
+  WGPUDevice device = nullptr;
+  bool supported = false;
+  double timestampPeriodNs = 1.0; // ns na jednostkę timestampu
+  GpuProfilerSlot slots[kGpuProfilerSlots];
+  GpuProfilerSlot *current = nullptr; // slot bieżącej klatki
+  uint32_t nextSlot = 0;
+  WGPURenderPassTimestampWrites writes[kMaxGpuPasses] = {};
+  WGPUComputePassTimestampWrites computeWrites[kMaxGpuPasses] = {};
+  // Jeden kontekst na mapowany slot — bez alokacji w każdej klatce
+  ObjectPool<GpuReadback> readbacks{kGpuProfilerSlots};
+};
+
+bool createGpuProfiler(WGPUDevice device, GpuProfiler &profiler);
+void releaseGpuProfiler(GpuProfiler &profiler);
+
+// Rezerwuje slot dla klatki (pomija pomiar, gdy wszystkie sloty czekają)
+void gpuProfilerBeginFrame(GpuProfiler &profiler, uint64_t frameIndex);
+// Zwraca timestampWrites dla render passa albo nullptr (brak wsparcia,
+// brak wolnego slotu lub przekroczony kMaxGpuPasses)
+const WGPURenderPassTimestampWrites *
+gpuProfilerRenderPass(GpuProfiler &profiler, const char *name);
+// To samo dla compute passa
+const WGPUComputePassTimestampWrites *
+gpuProfilerComputePass(GpuProfiler &profiler, const char *name);
+// Rozwiązuje zapytania do bufora i kopiuje je do bufora readback
+void gpuProfilerResolve(GpuProfiler &profiler, WGPUCommandEncoder encoder);
+// Po wgpuQueueSubmit: mapuje bufor readback (wynik przyjdzie w callbacku
+// podczas wgpuDevicePoll)
+void gpuProfilerAfterSubmit(GpuProfiler &profiler);
@@ -0,0 +1,93 @@
+#include "render_bundles.h"
+
+#include <iostream>
+
+#include "job_system.h"
+#include "profiler.h"
+
+RenderBundleSet::RenderBundleSet(WGPUDevice device,
+                                 WGPUTextureFormat colorFormat)
+    : m_device(device), m_colorFormat(colorFormat) {}
+
+RenderBundleSet::~RenderBundleSet() {
+  for (RenderBundleLayer &layer : m_layers)
+    if (layer.bundle)
+      wgpuRenderBundleRelease(layer.bundle);
+}
+
+uint32_t RenderBundleSet::addLayer(const char *name, BundleRecordFn record) {
+  RenderBundleLayer layer;
+  layer.name = name;
+  layer.record = std::move(record);
+  m_layers.push_back(std::move(layer));
+  return uint32_t(m_layers.size() - 1);
+}
+
+uint32_t RenderBundleSet::recordDirty(JobSystem &jobs) {
+  m_dirtyLayers.clear();
+  for (uint32_t i = 0; i < m_layers.size(); ++i)
+    if (m_layers[i].dirty)
+      m_dirtyLayers.push_back(i);
+  if (m_dirtyLayers.empty())
+    return 0;
+
+  WARP_PROFILE_SCOPE("Record Bundles");
+  // Jedna warstwa na porcję; każdy wątek pisze tylko do swojej warstwy
+  jobs.parallelFor(
+      uint32_t(m_dirtyLayers.size()), 1,
+      [&](uint32_t begin, uint32_t end, uint32_t) {
+        for (uint32_t i = begin; i < end; ++i) {
+          RenderBundleLayer &layer = m_layers[m_dirtyLayers[i]];
+          WARP_PROFILE_SCOPE("Record Bundle");
+
+          WGPURenderBundleEncoderDescriptor encoderDesc = {};
+          encoderDesc.nextInChain = nullptr;
+          encoderDesc.label = layer.name.c_str();
+          encoderDesc.colorFormatCount = 1;
+          encoderDesc.colorFormats = &m_colorFormat;
+          encoderDesc.depthStencilFormat = WGPUTextureFormat_Undefined;
+          encoderDesc.sampleCount = 1;
+          encoderDesc.depthReadOnly = false;
+          encoderDesc.stencilReadOnly = false;
+          WGPURenderBundleEncoder encoder =
+              wgpuDeviceCreateRenderBundleEncoder(m_device, &encoderDesc);
+          if (!encoder)
+            continue;
+
+          layer.record(encoder);
+
+          WGPURenderBundleDescriptor bundleDesc = {};
+          bundleDesc.nextInChain = nullptr;
+          bundleDesc.label = layer.name.c_str();
+          WGPURenderBundle bundle =
+              wgpuRenderBundleEncoderFinish(encoder, &bundleDesc);
+          wgpuRenderBundleEncoderRelease(encoder);
+
+          if (layer.bundle)
+            wgpuRenderBundleRelease(layer.bundle);
+          layer.bundle = bundle;
+          layer.dirty = bundle == nullptr;
+        }
+      });
+
+  uint32_t recorded = 0;
+  for (uint32_t index : m_dirtyLayers) {
+    if (m_layers[index].dirty)
+      std::cerr << "Failed to record render bundle: "
+                << m_layers[index].name << std::endl;
+    else
+      ++recorded;
+  }
+  m_totalRecords += recorded;
+  return recorded;
+}
+
+void RenderBundleSet::execute(WGPURenderPassEncoder pass) {
+  m_visible.clear();
+  for (const RenderBundleLayer &layer : m_layers)
+    if (layer.visible && layer.bundle)
+      m_visible.push_back(layer.bundle);
+  if (!m_visible.empty())
+    wgpuRenderPassEncoderExecuteBundles(pass, m_visible.size(),
+                                        m_visible.data());
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+#include <webgpu/webgpu.h>
+
+class JobSystem;
+
+// Nagrywa rysowanie warstwy. Wywoływana na wątku roboczym — może czytać
+// dane warstwy, ale nie może ich zmieniać ani dotykać innych warstw.
+using BundleRecordFn = std::function<void(WGPURenderBundleEncoder encoder)>;
+
+struct RenderBundleLayer {
+  std::string name;
+  BundleRecordFn record;
+  WGPURenderBundle bundle = nullptr;
+  bool dirty = true;
+  bool visible = true;
+};
+
+// Warstwy statyczne lub rzadko zmieniane (tło, UI, warstwy cząsteczek)
+// nagrane raz do WGPURenderBundle i odtwarzane co klatkę jednym
+// wgpuRenderPassEncoderExecuteBundles. Ponownie nagrywane są tylko warstwy
+// oznaczone jako brudne — równolegle, po jednej na wątek JobSystem.
+//
+// Bundle zapamiętuje bufory i bind groupy, a nie ich zawartość: dane
+// zmieniane przez wgpuQueueWriteBuffer nie wymagają ponownego nagrania,
+// natomiast podmiana bufora (np. wzrost pojemności) — tak.
+class RenderBundleSet {
+public:
+  RenderBundleSet(WGPUDevice device, WGPUTextureFormat colorFormat);
+  ~RenderBundleSet();
+  RenderBundleSet(const RenderBundleSet &) = delete;
+  RenderBundleSet &operator=(const RenderBundleSet &) = delete;
+
+  // Warstwy odtwarzane są w kolejności dodania
+  uint32_t addLayer(const char *name, BundleRecordFn record);
+  void markDirty(uint32_t layer) { m_layers[layer].dirty = true; }
+  void setVisible(uint32_t layer, bool visible) {
+    m_layers[layer].visible = visible;
+  }
+
+  // Nagrywa brudne warstwy na wątkach roboczych i czeka na zakończenie.
+  // Zwraca liczbę nagranych warstw.
+  uint32_t recordDirty(JobSystem &jobs);
+
+  // Odtwarza widoczne warstwy. Po execute stan passa (pipeline, bind
+  // groupy, bufory) jest wyzerowany — kolejne rysowanie musi go ustawić.
+  void execute(WGPURenderPassEncoder pass);
+
+  uint32_t layerCount() const { return uint32_t(m_layers.size()); }
+  uint32_t totalRecords() const { return m_totalRecords; }
+
+private:
+  WGPUDevice m_device = nullptr;
+  WGPUTextureFormat m_colorFormat = WGPUTextureFormat_Undefined;
+  std::vector<RenderBundleLayer> m_layers;
+  std::vector<uint32_t> m_dirtyLayers;     // bufor roboczy recordDirty
+  std::vector<WGPURenderBundle> m_visible; // bufor roboczy execute
+  uint32_t m_totalRecords = 0;
+};
@@ -0,0 +1,392 @@
+#include "render_graph.h"
+
+#include <algorithm>
+#include <functional>
+#include <iostream>
+#include <queue>
+
+#include "profiler.h"
+
+// Bajty na piksel (statystyki pamięci puli)
+static uint32_t bytesPerPixel(WGPUTextureFormat format) {
+  switch (format) {
+  case WGPUTextureFormat_RGBA16Float:
+    return 8;
+  default:
+    return 4; // RGBA8 / BGRA8 (także sRGB), Depth32Float
+  }
+}
+
+static bool sameDesc(const TransientTextureDesc &a,
+                     const TransientTextureDesc &b) {
+  return a.width == b.width && a.height == b.height && a.format == b.format;
+}
+
+RenderGraph::RenderGraph(WGPUDevice device) : m_device(device) {}
+
+RenderGraph::~RenderGraph() {
+  for (PhysicalTexture &physical : m_pool)
+    releasePhysical(physical);
+}
+
+// ============================================================
+//  Deklaracje
+// ============================================================
+
+RenderGraphResource RenderGraph::importTexture(const char *name) {
+  Resource resource;
+  resource.name = name;
+  resource.imported = true;
+  m_resources.push_back(resource);
+  m_compiled = false;
+  return RenderGraphResource(m_resources.size() - 1);
+}
+
+RenderGraphResource RenderGraph::importBuffer(const char *name) {
+  Resource resource;
+  resource.name = name;
+  resource.imported = true;
+  resource.texture = false;
+  m_resources.push_back(resource);
+  m_compiled = false;
+  return RenderGraphResource(m_resources.size() - 1);
+}
+
+RenderGraphResource RenderGraph::createTexture(const char *name,
+                                               const TransientTextureDesc &desc) {
+  Resource resource;
+  resource.name = name;
+  resource.desc = desc;
+  m_resources.push_back(resource);
+  m_compiled = false;
+  return RenderGraphResource(m_resources.size() - 1);
+}
+
+RenderGraph::PassId RenderGraph::addPass(const char *name,
+                                         RenderGraphPassFn execute) {
+  Pass pass;
+  pass.name = name;
+  pass.execute = std::move(execute);
+  m_passes.push_back(std::move(pass));
+  m_compiled = false;
+  return PassId(m_passes.size() - 1);
+}
+
+void RenderGraph::read(PassId pass, RenderGraphResource resource,
+                       WGPUTextureUsageFlags usage) {
+  m_passes[pass].reads.push_back({resource, usage});
+  m_resources[resource].usage |= usage;
+  m_compiled = false;
+}
+
+void RenderGraph::write(PassId pass, RenderGraphResource resource,
+                        WGPUTextureUsageFlags usage) {
+  m_passes[pass].writes.push_back({resource, usage});
+  m_resources[resource].usage |= usage;
+  m_resources[resource].writers.push_back(pass);
+  m_compiled = false;
+}
+
+void RenderGraph::keep(PassId pass) {
+  m_passes[pass].keep = true;
+  m_compiled = false;
+}
+
+void RenderGraph::clear() {
+  m_resources.clear();
+  m_passes.clear();
+  m_order.clear();
+  m_compiled = false;
+}
+
+// ============================================================
+//  Kompilacja
+// ============================================================
+
+bool RenderGraph::compile() {
+  // Tekstura nie może być w jednym passie załącznikiem i wejściem
+  for (const Pass &pass : m_passes) {
+    for (const Access &read : pass.reads) {
+      if (!m_resources[read.resource].texture)
+        continue;
+      for (const Access &write : pass.writes) {
+        if (write.resource == read.resource) {
+          std::cerr << "Render graph: pass " << pass.name
+                    << " reads and writes " << m_resources[read.resource].name
+                    << std::endl;
+          return false;
+        }
+      }
+    }
+  }
+
+  std::vector<bool> live;
+  cull(live);
+  if (!order(live) || !allocate())
+    return false;
+  m_compiled = true;
+  ++m_stats.compiles;
+  return true;
+}
+
+// Od passów z wynikiem widocznym poza grafem wstecz po zależnościach
+void RenderGraph::cull(std::vector<bool> &live) const {
+  live.assign(m_passes.size(), false);
+  std::vector<bool> needed(m_resources.size(), false);
+  std::vector<PassId> pending;
+  auto markLive = [&](PassId pass) {
+    if (!live[pass]) {
+      live[pass] = true;
+      pending.push_back(pass);
+    }
+  };
+  for (PassId pass = 0; pass < m_passes.size(); ++pass) {
+    bool root = m_passes[pass].keep;
+    for (const Access &write : m_passes[pass].writes)
+      root |= m_resources[write.resource].imported;
+    if (root)
+      markLive(pass);
+  }
+
+  while (!pending.empty()) {
+    const PassId pass = pending.back();
+    pending.pop_back();
+    for (const Access &read : m_passes[pass].reads) {
+      if (needed[read.resource])
+        continue;
+      needed[read.resource] = true;
+      for (PassId writer : m_resources[read.resource].writers)
+        markLive(writer);
+    }
+    // Wcześniejsi pisarze tego samego zasobu — pass może dopisywać do
+    // ich wyniku (LoadOp_Load), więc zostają
+    for (const Access &write : m_passes[pass].writes)
+      for (PassId writer : m_resources[write.resource].writers)
+        if (writer < pass)
+          markLive(writer);
+  }
+}
+
+// Sortowanie topologiczne żywych passów; przy remisie kolejność dodania
+bool RenderGraph::order(const std::vector<bool> &live) {
+  const size_t passCount = m_passes.size();
+  std::vector<std::vector<PassId>> successors(passCount);
+  std::vector<uint32_t> remaining(passCount, 0);
+  auto addEdge = [&](PassId from, PassId to) {
+    successors[from].push_back(to);
+    ++remaining[to];
+  };
+  for (PassId pass = 0; pass < passCount; ++pass) {
+    if (!live[pass])
+      continue;
+    // Czytelnik po wszystkich pisarzach zasobu
+    for (const Access &read : m_passes[pass].reads)
+      for (PassId writer : m_resources[read.resource].writers)
+        if (writer != pass && live[writer])
+          addEdge(writer, pass);
+    // Kolejni pisarze w kolejności dodania
+    for (const Access &write : m_passes[pass].writes) {
+      PassId previous = ~0u;
+      for (PassId writer : m_resources[write.resource].writers) {
+        if (writer == pass)
+          break;
+        if (live[writer])
+          previous = writer;
+      }
+      if (previous != ~0u)
+        addEdge(previous, pass);
+    }
+  }
+
+  std::priority_queue<PassId, std::vector<PassId>, std::greater<PassId>>
+      ready;
+  uint32_t liveCount = 0;
+  for (PassId pass = 0; pass < passCount; ++pass) {
+    if (!live[pass])
+      continue;
+    ++liveCount;
+    if (remaining[pass] == 0)
+      ready.push(pass);
+  }
+  m_order.clear();
+  while (!ready.empty()) {
+    const PassId pass = ready.top();
+    ready.pop();
+    m_order.push_back(pass);
+    for (PassId successor : successors[pass])
+      if (--remaining[successor] == 0)
+        ready.push(successor);
+  }
+  if (m_order.size() != liveCount) {
+    std::cerr << "Render graph has a dependency cycle!" << std::endl;
+    m_order.clear();
+    return false;
+  }
+  m_stats.passes = liveCount;
+  m_stats.culledPasses = uint32_t(passCount) - liveCount;
+  return true;
+}
+
+// Czas życia tekstur tymczasowych w planie i przydział z puli: tekstura,
+// której ostatni pass już minął, trafia do kolejnego zasobu o tym samym
+// opisie i usage
+bool RenderGraph::allocate() {
+  struct Lifetime {
+    RenderGraphResource resource;
+    uint32_t first;
+    uint32_t last;
+  };
+  std::vector<Lifetime> lifetimes;
+  std::vector<uint32_t> lifetimeIndex(m_resources.size(), ~0u);
+  for (uint32_t step = 0; step < m_order.size(); ++step) {
+    const Pass &pass = m_passes[m_order[step]];
+    auto touch = [&](const Access &access) {
+      const Resource &resource = m_resources[access.resource];
+      if (resource.imported)
+        return;
+      uint32_t &index = lifetimeIndex[access.resource];
+      if (index == ~0u) {
+        index = uint32_t(lifetimes.size());
+        lifetimes.push_back({access.resource, step, step});
+      }
+      lifetimes[index].last = step;
+    };
+    for (const Access &read : pass.reads)
+      touch(read);
+    for (const Access &write : pass.writes)
+      touch(write);
+  }
+
+  for (Resource &resource : m_resources)
+    resource.physical = ~0u;
+  for (PhysicalTexture &physical : m_pool)
+    physical.used = false;
+
+  m_stats.transientTextures = uint32_t(lifetimes.size());
+  m_stats.transientBytes = 0;
+  // lifetimes są już posortowane po pierwszym użyciu
+  for (const Lifetime &lifetime : lifetimes) {
+    Resource &resource = m_resources[lifetime.resource];
+    m_stats.transientBytes += uint64_t(resource.desc.width) *
+                              resource.desc.height *
+                              bytesPerPixel(resource.desc.format);
+    uint32_t chosen = ~0u;
+    for (uint32_t i = 0; i < m_pool.size(); ++i) {
+      const PhysicalTexture &physical = m_pool[i];
+      if (sameDesc(physical.desc, resource.desc) &&
+          physical.usage == resource.usage &&
+          (!physical.used || physical.busyUntil < lifetime.first)) {
+        chosen = i;
+        break;
+      }
+    }
+    if (chosen == ~0u) {
+      PhysicalTexture physical;
+      physical.desc = resource.desc;
+      physical.usage = resource.usage;
+      if (!createPhysical(physical)) {
+        std::cerr << "Render graph: failed to create texture "
+                  << resource.name << std::endl;
+        return false;
+      }
+      chosen = uint32_t(m_pool.size());
+      m_pool.push_back(physical);
+    }
+    m_pool[chosen].used = true;
+    m_pool[chosen].busyUntil = lifetime.last;
+    resource.physical = chosen;
+  }
+
+  // Tekstury poprzednich planów (np. sprzed zmiany rozmiaru) są zwalniane
+  std::vector<uint32_t> remap(m_pool.size(), ~0u);
+  size_t kept = 0;
+  for (size_t i = 0; i < m_pool.size(); ++i) {
+    if (!m_pool[i].used) {
+      releasePhysical(m_pool[i]);
+      continue;
+    }
+    remap[i] = uint32_t(kept);
+    m_pool[kept++] = m_pool[i];
+  }
+  m_pool.resize(kept);
+  m_stats.physicalTextures = uint32_t(kept);
+  m_stats.physicalBytes = 0;
+  for (const PhysicalTexture &physical : m_pool)
+    m_stats.physicalBytes += uint64_t(physical.desc.width) *
+                             physical.desc.height *
+                             bytesPerPixel(physical.desc.format);
+  for (Resource &resource : m_resources)
+    if (resource.physical != ~0u)
+      resource.physical = remap[resource.physical];
+  return true;
+}
+
+bool RenderGraph::createPhysical(PhysicalTexture &physical) {
+  WGPUTextureDescriptor texDesc = {};
+  texDesc.nextInChain = nullptr;
+  texDesc.label = "Render Graph Transient";
+  texDesc.usage = physical.usage;
+  texDesc.dimension = WGPUTextureDimension_2D;
+  texDesc.size = {physical.desc.width, physical.desc.height, 1};
+  texDesc.format = physical.desc.format;
+  texDesc.mipLevelCount = 1;
+  texDesc.sampleCount = 1;
+  texDesc.viewFormatCount = 0;
+  texDesc.viewFormats = nullptr;
+  physical.texture = wgpuDeviceCreateTexture(m_device, &texDesc);
+  if (!physical.texture)
+    return false;
+
+  WGPUTextureViewDescriptor viewDesc = {};
+  viewDesc.nextInChain = nullptr;
+  viewDesc.label = "Render Graph Transient View";
+  viewDesc.format = physical.desc.format;
+  viewDesc.dimension = WGPUTextureViewDimension_2D;
+  viewDesc.baseMipLevel = 0;
+  viewDesc.mipLevelCount = 1;
+  viewDesc.baseArrayLayer = 0;
+  viewDesc.arrayLayerCount = 1;
+  viewDesc.aspect = WGPUTextureAspect_All;
+  physical.view = wgpuTextureCreateView(physical.texture, &viewDesc);
+  if (!physical.view) {
+    releasePhysical(physical);
+    return false;
+  }
+  ++m_stats.texturesCreated;
+  return true;
+}
+
+void RenderGraph::releasePhysical(PhysicalTexture &physical) {
+  if (physical.view)
+    wgpuTextureViewRelease(physical.view);
+  if (physical.texture)
+    wgpuTextureRelease(physical.texture);
+  physical.view = nullptr;
+  physical.texture = nullptr;
+}
+
+// ============================================================
+//  Wykonanie
+// ============================================================
+
+void RenderGraph::setImportedView(RenderGraphResource resource,
+                                  WGPUTextureView view) {
+  m_resources[resource].importedView = view;
+}
+
+void RenderGraph::execute(WGPUCommandEncoder encoder) {
+  if (!m_compiled)
+    return;
+  for (PassId pass : m_order) {
+    profilerBeginScope(m_passes[pass].name);
+    m_passes[pass].execute(encoder, *this);
+    profilerEndScope();
+  }
+}
+
+WGPUTextureView RenderGraph::view(RenderGraphResource resource) const {
+  const Resource &entry = m_resources[resource];
+  if (entry.imported)
+    return entry.importedView;
+  return entry.physical != ~0u ? m_pool[entry.physical].view : nullptr;
+}
@@ -0,0 +1,141 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+#include <webgpu/webgpu.h>
+
+// ============================================================
+//  Graf renderowania klatki
+// ============================================================
+
+using RenderGraphResource = uint32_t;
+constexpr RenderGraphResource kInvalidGraphResource = ~0u;
+
+// Tekstura tymczasowa grafu. Usage wynika z deklaracji passów
+// (suma wszystkich odczytów i zapisów).
+struct TransientTextureDesc {
+  uint32_t width = 0;
+  uint32_t height = 0;
+  WGPUTextureFormat format = WGPUTextureFormat_Undefined;
+};
+
+struct RenderGraphStats {
+  uint32_t passes = 0;       // passy w planie
+  uint32_t culledPasses = 0; // odrzucone (wynik nieużywany)
+  uint32_t transientTextures = 0;  // tekstury tymczasowe zadeklarowane
+  uint32_t physicalTextures = 0;   // faktycznie utworzone po aliasingu
+  uint64_t transientBytes = 0; // suma rozmiarów bez aliasingu
+  uint64_t physicalBytes = 0;  // pamięć tekstur w puli
+  uint32_t compiles = 0;
+  uint32_t texturesCreated = 0; // wszystkie utworzenia (także po resize)
+};
+
+class RenderGraph;
+// Koduje pass do encodera klatki (render lub compute pass albo kopie).
+// Widoki tekstur zasobów daje graph.view().
+using RenderGraphPassFn =
+    std::function<void(WGPUCommandEncoder encoder, const RenderGraph &graph)>;
+
+// Passy deklarują, które zasoby czytają i zapisują; kolejność wykonania
+// wynika z danych (czytelnik zasobu po wszystkich jego pisarzach, pisarze
+// w kolejności dodania), a nie z kolejności dodania passów. Passy, których
+// wyniki nie trafiają do zasobów importowanych (cel wyjścia, bufory spoza
+// grafu) ani do passów keep(), są odrzucane.
+//
+// Tekstury tymczasowe żyją od pierwszego do ostatniego passa, który ich
+// używa. Tekstury o tym samym rozmiarze, formacie i usage z rozłącznymi
+// czasami życia dzielą jeden WGPUTexture z puli — WebGPU nie ma
+// aliasingu pamięci między zasobami, więc graf aliasuje całe tekstury.
+// Bariery wstawia sam WebGPU; graf pilnuje tylko, żeby pass nie czytał
+// i nie zapisywał tego samego zasobu.
+//
+// Graf buduje się raz (i po zmianie rozmiaru wyjścia), compile() planuje
+// wykonanie, a co klatkę setImportedView() + execute().
+class RenderGraph {
+public:
+  using PassId = uint32_t;
+
+  explicit RenderGraph(WGPUDevice device);
+  ~RenderGraph();
+  RenderGraph(const RenderGraph &) = delete;
+  RenderGraph &operator=(const RenderGraph &) = delete;
+
+  // Zasoby spoza grafu: tekstura (widok podawany co klatkę) albo bufor
+  // (tylko do wyznaczenia zależności)
+  RenderGraphResource importTexture(const char *name);
+  RenderGraphResource importBuffer(const char *name);
+  RenderGraphResource createTexture(const char *name,
+                                    const TransientTextureDesc &desc);
+
+  // name: literał (trafia do profilera jako nazwa zakresu)
+  PassId addPass(const char *name, RenderGraphPassFn execute);
+  void read(PassId pass, RenderGraphResource resource,
+            WGPUTextureUsageFlags usage = WGPUTextureUsage_TextureBinding);
+  void write(PassId pass, RenderGraphResource resource,
+             WGPUTextureUsageFlags usage = WGPUTextureUsage_RenderAttachment);
+  // Pass ze skutkiem poza grafem (np. kopia do odczytu na CPU)
+  void keep(PassId pass);
+
+  // Usuwa passy i zasoby; tekstury zostają w puli do następnego compile()
+  void clear();
+  // Odrzuca nieużywane passy, ustala kolejność i przydziela tekstury.
+  // false, gdy graf ma cykl albo pass czyta i zapisuje ten sam zasób.
+  bool compile();
+
+  void setImportedView(RenderGraphResource resource, WGPUTextureView view);
+  // Koduje passy planu w kolejności (wątek główny)
+  void execute(WGPUCommandEncoder encoder);
+
+  WGPUTextureView view(RenderGraphResource resource) const;
+  const RenderGraphStats &stats() const { return m_stats; }
+
+private:
+  struct Resource {
+    const char *name = nullptr;
+    bool imported = false;
+    bool texture = true;
+    TransientTextureDesc desc;
+    WGPUTextureUsageFlags usage = WGPUTextureUsage_None;
+    WGPUTextureView importedView = nullptr;
+    std::vector<PassId> writers; // w kolejności dodania
+    uint32_t physical = ~0u;     // tekstura z puli (tymczasowe)
+  };
+
+  struct Access {
+    RenderGraphResource resource;
+    WGPUTextureUsageFlags usage;
+  };
+
+  struct Pass {
+    const char *name = nullptr;
+    RenderGraphPassFn execute;
+    std::vector<Access> reads;
+    std::vector<Access> writes;
+    bool keep = false;
+  };
+
+  // Tekstura puli; `busyUntil` = ostatni pass planu, który jej używa
+  struct PhysicalTexture {
+    TransientTextureDesc desc;
+    WGPUTextureUsageFlags usage = WGPUTextureUsage_None;
+    WGPUTexture texture = nullptr;
+    WGPUTextureView view = nullptr;
+    uint32_t busyUntil = 0;
+    bool used = false; // przydzielona w bieżącym planie
+  };
+
+  void cull(std::vector<bool> &live) const;
+  bool order(const std::vector<bool> &live);
+  bool allocate();
+  bool createPhysical(PhysicalTexture &physical);
+  static void releasePhysical(PhysicalTexture &physical);
+
+  WGPUDevice m_device = nullptr;
+  std::vector<Resource> m_resources;
+  std::vector<Pass> m_passes;
+  std::vector<PassId> m_order; // plan wykonania (passy żywe)
+  std::vector<PhysicalTexture> m_pool;
+  bool m_compiled = false;
+  RenderGraphStats m_stats;
+};
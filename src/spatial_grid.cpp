@@ -0,0 +1,73 @@
+#include "spatial_grid.h"
+
+#include "job_system.h"
+
+void SpatialGrid::build(const float *xs, const float *ys, uint32_t count) {
+  // Rozmiar tablicy kubełków: potęga dwójki >= 2 * liczba elementów,
+  // podzielona na siatkę W×H z W = H lub W = 2H
+  uint32_t shiftX = 3, shiftY = 3;
+  while ((1u << (shiftX + shiftY)) < count * 2) {
+    if (shiftX == shiftY)
+      ++shiftX;
+    else
+      ++shiftY;
+  }
+  const uint32_t tableSize = 1u << (shiftX + shiftY);
+  m_tableSize = tableSize;
+  m_wrapShiftX = shiftX;
+  m_wrapMaskX = (1u << shiftX) - 1;
+  m_wrapMaskY = (1u << shiftY) - 1;
+
+  m_bucketStart.assign(size_t(tableSize) + 1, 0);
+  m_itemBucket.resize(count);
+  m_items.resize(count);
+  m_x.resize(count);
+  m_y.resize(count);
+  m_cellX.resize(count);
+  m_cellY.resize(count);
+  m_inputCellX.resize(count);
+  m_inputCellY.resize(count);
+
+  // 1. Komórka i kubełek każdego elementu + liczność kubełków
+  for (uint32_t i = 0; i < count; ++i) {
+    const int32_t cx = cellCoord(xs[i]);
+    const int32_t cy = cellCoord(ys[i]);
+    const uint32_t bucket = bucketOf(cx, cy);
+    m_inputCellX[i] = cx;
+    m_inputCellY[i] = cy;
+    m_itemBucket[i] = bucket;
+    ++m_bucketStart[bucket + 1];
+  }
+
+  // 2. Suma prefiksowa → początek każdego kubełka
+  for (uint32_t b = 0; b < tableSize; ++b)
+    m_bucketStart[b + 1] += m_bucketStart[b];
+
+  // 3. Rozrzut (stabilny) — kursor zapisu startuje od początku kubełka
+  m_scatterCursor.assign(m_bucketStart.begin(), m_bucketStart.end() - 1);
+  for (uint32_t i = 0; i < count; ++i) {
+    const uint32_t slot = m_scatterCursor[m_itemBucket[i]]++;
+    m_items[slot] = i;
+    m_x[slot] = xs[i];
+    m_y[slot] = ys[i];
+    m_cellX[slot] = m_inputCellX[i];
+    m_cellY[slot] = m_inputCellY[i];
+  }
+}
+
+void SpatialGrid::findPairsParallel(
+    float radius, JobSystem &jobs,
+    std::vector<std::vector<GridPair>> &pairsPerRange) const {
+  pairsPerRange.resize((size() + kPairGrain - 1) / kPairGrain);
+  for (std::vector<GridPair> &pairs : pairsPerRange)
+    pairs.clear();
+
+  jobs.parallelFor(size(), kPairGrain,
+                   [&](uint32_t begin, uint32_t end, uint32_t) {
+                     std::vector<GridPair> &pairs =
+                         pairsPerRange[begin / kPairGrain];
+                     auto emit = [&pairs](uint32_t a, uint32_t b, float, float,
+                                          float) { pairs.push_back({a, b}); };
+                     forEachPairInRange(radius, begin, end, emit);
+                   });
+}
@@ -0,0 +1,213 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+class JobSystem;
+
+// Para sąsiadów zwracana przez wyszukiwanie par (indeksy elementów z build)
+struct GridPair {
+  uint32_t a;
+  uint32_t b;
+};
+
+// Broad-phase: haszowana siatka jednorodna przebudowywana co tick sortowaniem
+// przez zliczanie. Elementy są punktami (środki AABB); zapytania zwracają
+// indeksy z tablic przekazanych do build().
+//
+// Tablica kubełków to siatka W×H (potęgi dwójki) zawijana jak torus:
+// komórka (cx, cy) trafia do kubełka (cy mod H, cx mod W). Świat nie ma
+// granic, a sąsiednie komórki leżą obok siebie w pamięci. Komórki odległe
+// o wielokrotność W/H dzielą kubełek — odfiltrowuje je porównanie
+// współrzędnych komórki zapisanych przy każdym elemencie.
+class SpatialGrid {
+public:
+  static constexpr uint32_t kInvalid = ~0u;
+
+  explicit SpatialGrid(float cellSize = 32.0f) { setCellSize(cellSize); }
+
+  void setCellSize(float cellSize) {
+    m_cellSize = cellSize;
+    m_invCellSize = 1.0f / cellSize;
+  }
+  float cellSize() const { return m_cellSize; }
+  uint32_t size() const { return uint32_t(m_items.size()); }
+
+  // Przebudowa: liczenie elementów na kubełek, suma prefiksowa, rozrzut
+  void build(const float *xs, const float *ys, uint32_t count);
+
+  // Wywołuje fn(item) dla każdego elementu wewnątrz prostokąta
+  template <typename Fn>
+  void queryRange(float minX, float minY, float maxX, float maxY,
+                  Fn &&fn) const;
+
+  // Najbliższy element w promieniu maxRadius, dla którego accept(item)
+  // zwraca true (np. pomijanie martwych celów); kInvalid gdy brak
+  template <typename Accept>
+  uint32_t nearest(float x, float y, float maxRadius, Accept &&accept) const;
+  uint32_t nearest(float x, float y, float maxRadius) const {
+    return nearest(x, y, maxRadius, [](uint32_t) { return true; });
+  }
+
+  // Wywołuje fn(a, b, dx, dy, distSq) dla każdej pary w odległości < radius
+  // (radius <= cellSize). Każda para jest zwracana dokładnie raz.
+  template <typename Fn> void forEachPair(float radius, Fn &&fn) const {
+    forEachPairInRange(radius, 0, size(), fn);
+  }
+
+  // Równoległe wyszukiwanie par: posortowane elementy dzielone są na
+  // porcje po kPairGrain, a każda porcja dopisuje do własnego wektora
+  // (pairsPerRange[begin / kPairGrain]). Kolejność par po złączeniu
+  // wektorów nie zależy od tego, który wątek wykonał którą porcję.
+  static constexpr uint32_t kPairGrain = 2048;
+  void findPairsParallel(float radius, JobSystem &jobs,
+                         std::vector<std::vector<GridPair>> &pairsPerRange) const;
+
+private:
+  int32_t cellCoord(float v) const {
+    const float c = v * m_invCellSize;
+    const int32_t i = int32_t(c);
+    return i - (c < float(i)); // floor bez wywołania std::floor
+  }
+  uint32_t bucketOf(int32_t cx, int32_t cy) const {
+    return ((uint32_t(cy) & m_wrapMaskY) << m_wrapShiftX) |
+           (uint32_t(cx) & m_wrapMaskX);
+  }
+
+  // Pary dla posortowanych elementów [begin, end): ta sama komórka (dalsze
+  // elementy) + 4 komórki "do przodu", więc żadna para się nie powtarza
+  template <typename Fn>
+  void forEachPairInRange(float radius, uint32_t begin, uint32_t end,
+                          Fn &fn) const;
+
+  float m_cellSize = 0.0f;
+  float m_invCellSize = 0.0f;
+  uint32_t m_tableSize = 0;
+  uint32_t m_wrapMaskX = 0;  // szerokość tablicy kubełków - 1
+  uint32_t m_wrapMaskY = 0;  // wysokość tablicy kubełków - 1
+  uint32_t m_wrapShiftX = 0; // log2(szerokość)
+  std::vector<uint32_t> m_bucketStart; // tableSize + 1
+  std::vector<uint32_t> m_itemBucket;  // kubełek elementu (kolejność build)
+  // Elementy posortowane według kubełka (dane skopiowane dla lokalności)
+  std::vector<uint32_t> m_items;
+  std::vector<float> m_x;
+  std::vector<float> m_y;
+  std::vector<int32_t> m_cellX;
+  std::vector<int32_t> m_cellY;
+  // Bufory robocze build() (kolejność wejściowa)
+  std::vector<uint32_t> m_scatterCursor;
+  std::vector<int32_t> m_inputCellX;
+  std::vector<int32_t> m_inputCellY;
+};
+
+// ============================================================
+//  Implementacja szablonów
+// ============================================================
+
+template <typename Fn>
+void SpatialGrid::queryRange(float minX, float minY, float maxX, float maxY,
+                             Fn &&fn) const {
+  if (m_items.empty())
+    return;
+  const int32_t cx0 = cellCoord(minX), cx1 = cellCoord(maxX);
+  const int32_t cy0 = cellCoord(minY), cy1 = cellCoord(maxY);
+  for (int32_t cy = cy0; cy <= cy1; ++cy) {
+    for (int32_t cx = cx0; cx <= cx1; ++cx) {
+      const uint32_t bucket = bucketOf(cx, cy);
+      for (uint32_t s = m_bucketStart[bucket]; s < m_bucketStart[bucket + 1];
+           ++s) {
+        // Tylko elementy tej komórki — inne komórki z tego kubełka zostaną
+        // odwiedzone (lub nie) osobno, więc nic nie jest zgłaszane dwa razy
+        if (m_cellX[s] != cx || m_cellY[s] != cy)
+          continue;
+        if (m_x[s] >= minX && m_x[s] <= maxX && m_y[s] >= minY &&
+            m_y[s] <= maxY)
+          fn(m_items[s]);
+      }
+    }
+  }
+}
+
+template <typename Accept>
+uint32_t SpatialGrid::nearest(float x, float y, float maxRadius,
+                              Accept &&accept) const {
+  if (m_items.empty())
+    return kInvalid;
+  const int32_t ccx = cellCoord(x), ccy = cellCoord(y);
+  const int32_t maxRing = int32_t(std::ceil(maxRadius / m_cellSize)) + 1;
+  uint32_t best = kInvalid;
+  float bestDistSq = maxRadius * maxRadius;
+
+  // Przeszukiwanie pierścieni komórek wokół punktu, aż żaden dalszy
+  // pierścień nie może zawierać bliższego elementu
+  for (int32_t ring = 0; ring <= maxRing; ++ring) {
+    const float ringMin = float(ring - 1) * m_cellSize;
+    if (best != kInvalid && ringMin > 0.0f && ringMin * ringMin > bestDistSq)
+      break;
+    for (int32_t cy = ccy - ring; cy <= ccy + ring; ++cy) {
+      const bool edgeRow = cy == ccy - ring || cy == ccy + ring;
+      const int32_t step = edgeRow ? 1 : 2 * ring;
+      for (int32_t cx = ccx - ring; cx <= ccx + ring; cx += step) {
+        const uint32_t bucket = bucketOf(cx, cy);
+        for (uint32_t s = m_bucketStart[bucket];
+             s < m_bucketStart[bucket + 1]; ++s) {
+          if (m_cellX[s] != cx || m_cellY[s] != cy)
+            continue;
+          const float dx = m_x[s] - x, dy = m_y[s] - y;
+          const float distSq = dx * dx + dy * dy;
+          if (distSq < bestDistSq && accept(m_items[s])) {
+            bestDistSq = distSq;
+            best = m_items[s];
+          }
+        }
+      }
+    }
+  }
+  return best;
+}
+
+template <typename Fn>
+void SpatialGrid::forEachPairInRange(float radius, uint32_t begin,
+                                     uint32_t end, Fn &fn) const {
+  const float radiusSq = radius * radius;
+
+  // Sprawdza elementy [first, last) należące do komórek (x0..x1, ny)
+  auto visit = [&](uint32_t s, uint32_t first, uint32_t last, int32_t x0,
+                   int32_t x1, int32_t ny) {
+    const float x = m_x[s], y = m_y[s];
+    for (uint32_t t = first; t < last; ++t) {
+      if (m_cellY[t] != ny || m_cellX[t] < x0 || m_cellX[t] > x1)
+        continue;
+      const float dx = m_x[t] - x, dy = m_y[t] - y;
+      const float distSq = dx * dx + dy * dy;
+      if (distSq < radiusSq)
+        fn(m_items[s], m_items[t], dx, dy, distSq);
+    }
+  };
+
+  for (uint32_t s = begin; s < end; ++s) {
+    const int32_t cx = m_cellX[s], cy = m_cellY[s];
+    const uint32_t bucket = bucketOf(cx, cy);
+    const uint32_t column = bucket & m_wrapMaskX;
+
+    // Komórki "do przodu": ta sama (dalsze elementy), (cx+1, cy) oraz
+    // (cx-1..cx+1, cy+1) — każda para jest odwiedzana dokładnie raz.
+    // Poza krawędzią zawijania kubełki sąsiadów leżą ciągiem w pamięci.
+    if (column != 0 && column != m_wrapMaskX) {
+      visit(s, s + 1, m_bucketStart[bucket + 2], cx, cx + 1, cy);
+      const uint32_t below = bucketOf(cx, cy + 1);
+      visit(s, m_bucketStart[below - 1], m_bucketStart[below + 2], cx - 1,
+            cx + 1, cy + 1);
+    } else {
+      visit(s, s + 1, m_bucketStart[bucket + 1], cx, cx, cy);
+      const uint32_t right = bucketOf(cx + 1, cy);
+      visit(s, m_bucketStart[right], m_bucketStart[right + 1], cx + 1, cx + 1,
+            cy);
+      for (int32_t nx = cx - 1; nx <= cx + 1; ++nx) {
+        const uint32_t nb = bucketOf(nx, cy + 1);
+        visit(s, m_bucketStart[nb], m_bucketStart[nb + 1], nx, nx, cy + 1);
+      }
+    }
+  }
+}
@@ -0,0 +1,359 @@
+#include "sprite_batch.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <iostream>
+
+#include "frame_ring.h"
+#include "texture_atlas.h"
+
+// ============================================================
+//  WGSL Shader
+// ============================================================
+
+static const char *spriteShaderSource = R"(
+struct CameraUniforms {
+    viewProjection: mat4x4<f32>,
+    view: mat4x4<f32>,
+    projection: mat4x4<f32>,
+};
+
+@group(0) @binding(0) var<uniform> camera: CameraUniforms;
+
+// Atlas: strony jako warstwy tekstury + tablica klatek (UV, strona)
+struct AtlasFrame {
+    rect: vec4f, // u0, v0, u1, v1
+    page: u32,
+    _pad0: u32,
+    _pad1: u32,
+    _pad2: u32,
+};
+
+@group(1) @binding(0) var atlasTexture: texture_2d_array<f32>;
+@group(1) @binding(1) var atlasSampler: sampler;
+@group(1) @binding(2) var<storage, read> atlasFrames: array<AtlasFrame>;
+
+struct VertexInput {
+    // Wierzchołek quada (per-vertex)
+    @location(0) corner: vec2f,
+    @location(1) uv: vec2f,
+    // Dane instancji (per-instance)
+    @location(2) position: vec2f,
+    @location(3) scale: vec2f,
+    @location(4) rotation: f32,
+    @location(5) atlasIndex: u32,
+    @location(6) tint: vec4f,
+};
+
+struct VertexOutput {
+    @builtin(position) position: vec4f,
+    @location(0) uv: vec2f,
+    @location(1) color: vec4f,
+    @location(2) @interpolate(flat) page: u32,
+};
+
+@vertex
+fn vs_main(in: VertexInput) -> VertexOutput {
+    let c = cos(in.rotation);
+    let s = sin(in.rotation);
+    let local = in.corner * in.scale;
+    let world = vec2f(local.x * c - local.y * s, local.x * s + local.y * c) + in.position;
+
+    var out: VertexOutput;
+    out.position = camera.viewProjection * vec4f(world, 0.0, 1.0);
+    let frame = atlasFrames[min(in.atlasIndex, arrayLength(&atlasFrames) - 1u)];
+    out.uv = mix(frame.rect.xy, frame.rect.zw, in.uv);
+    out.color = in.tint;
+    out.page = frame.page;
+    return out;
+}
+
+@fragment
+fn fs_main(in: VertexOutput) -> @location(0) vec4f {
+    return textureSample(atlasTexture, atlasSampler, in.uv, in.page) * in.color;
+}
+)";
+
+// Wierzchołek quada jednostkowego: narożnik (-0.5..0.5) + UV
+struct QuadVertex {
+  float corner[2];
+  float uv[2];
+};
+
+static const QuadVertex quadVertices[4] = {
+    {{-0.5f, -0.5f}, {0.0f, 0.0f}},
+    {{0.5f, -0.5f}, {1.0f, 0.0f}},
+    {{0.5f, 0.5f}, {1.0f, 1.0f}},
+    {{-0.5f, 0.5f}, {0.0f, 1.0f}},
+};
+
+static const uint16_t quadIndices[6] = {0, 1, 2, 0, 2, 3};
+
+// ============================================================
+//  Pipeline
+// ============================================================
+
+RenderPipelineDesc spritePipelineDesc(WGPUTextureFormat colorFormat,
+                                      const BindGroupLayoutDesc &cameraLayout,
+                                      BlendMode blend) {
+  RenderPipelineDesc desc;
+  desc.label = "Sprite Pipeline";
+  desc.shaderSource = spriteShaderSource;
+  // Grupa 0: kamera, grupa 1: atlas
+  desc.bindGroups = {cameraLayout, atlasBindGroupLayoutDesc()};
+  desc.colorFormat = colorFormat;
+  desc.blend = blend;
+
+  // Układ buforów wierzchołków: slot 0 = quad, slot 1 = instancje
+  VertexBufferDesc quad;
+  quad.arrayStride = sizeof(QuadVertex);
+  quad.stepMode = WGPUVertexStepMode_Vertex;
+  quad.attributes = {
+      {WGPUVertexFormat_Float32x2, offsetof(QuadVertex, corner), 0},
+      {WGPUVertexFormat_Float32x2, offsetof(QuadVertex, uv), 1},
+  };
+
+  VertexBufferDesc instances;
+  instances.arrayStride = sizeof(SpriteInstance);
+  instances.stepMode = WGPUVertexStepMode_Instance;
+  instances.attributes = {
+      {WGPUVertexFormat_Float32x2, offsetof(SpriteInstance, position), 2},
+      {WGPUVertexFormat_Float32x2, offsetof(SpriteInstance, scale), 3},
+      {WGPUVertexFormat_Float32, offsetof(SpriteInstance, rotation), 4},
+      {WGPUVertexFormat_Uint32, offsetof(SpriteInstance, atlasIndex), 5},
+      {WGPUVertexFormat_Unorm8x4, offsetof(SpriteInstance, tint), 6},
+  };
+  desc.vertexBuffers = {quad, instances};
+  return desc;
+}
+
+// ============================================================
+//  Bufory
+// ============================================================
+
+static WGPUBuffer createBuffer(WGPUDevice device, const char *label,
+                               WGPUBufferUsageFlags usage, uint64_t size) {
+  WGPUBufferDescriptor desc = {};
+  desc.nextInChain = nullptr;
+  desc.label = label;
+  desc.usage = usage;
+  desc.size = size;
+  desc.mappedAtCreation = false;
+  return wgpuDeviceCreateBuffer(device, &desc);
+}
+
+bool createSpriteBatch(WGPUDevice device, PipelineCache &pipelines,
+                       WGPUTextureFormat colorFormat,
+                       const BindGroupLayoutDesc &cameraLayout,
+                       uint32_t capacity, SpriteBatch &batch,
+                       BlendMode blend) {
+  batch.device = device;
+  batch.capacity = std::max(capacity, 1u);
+  batch.instances.reserve(batch.capacity);
+
+  // Pipeline i layout atlasu należą do cache'a (ten sam opis = ten sam obiekt)
+  batch.atlasLayout = pipelines.bindGroupLayout(atlasBindGroupLayoutDesc());
+  batch.pipeline =
+      pipelines.renderPipeline(spritePipelineDesc(colorFormat, cameraLayout,
+                                                  blend));
+  batch.quadVertexBuffer =
+      createBuffer(device, "Sprite Quad Vertices",
+                   WGPUBufferUsage_Vertex | WGPUBufferUsage_CopyDst,
+                   sizeof(quadVertices));
+  batch.quadIndexBuffer =
+      createBuffer(device, "Sprite Quad Indices",
+                   WGPUBufferUsage_Index | WGPUBufferUsage_CopyDst,
+                   sizeof(quadIndices));
+  // Trwały bufor instancji powstaje dopiero przy pierwszym
+  // spriteBatchUpload — batch rysowany z FrameRing go nie potrzebuje
+
+  if (!batch.pipeline || !batch.atlasLayout || !batch.quadVertexBuffer || !batch.quadIndexBuffer) {
+    std::cerr << "Failed to create sprite batch!" << std::endl;
+    releaseSpriteBatch(batch);
+    return false;
+  }
+
+  WGPUQueue queue = wgpuDeviceGetQueue(device);
+  wgpuQueueWriteBuffer(queue, batch.quadVertexBuffer, 0, quadVertices,
+                       sizeof(quadVertices));
+  wgpuQueueWriteBuffer(queue, batch.quadIndexBuffer, 0, quadIndices,
+                       sizeof(quadIndices));
+  wgpuQueueRelease(queue);
+
+  std::cout << "Sprite batch created (capacity " << batch.capacity
+            << " instances)." << std::endl;
+  return true;
+}
+
+void releaseSpriteBatch(SpriteBatch &batch) {
+  if (batch.instanceBuffer)
+    wgpuBufferRelease(batch.instanceBuffer);
+  if (batch.quadIndexBuffer)
+    wgpuBufferRelease(batch.quadIndexBuffer);
+  if (batch.quadVertexBuffer)
+    wgpuBufferRelease(batch.quadVertexBuffer);
+  batch = {};
+}
+
+// ============================================================
+//  Instancje
+// ============================================================
+
+void spriteBatchMarkDirty(SpriteBatch &batch, uint32_t first, uint32_t count) {
+  if (count == 0)
+    return;
+  if (batch.dirtyBegin == batch.dirtyEnd) {
+    batch.dirtyBegin = first;
+    batch.dirtyEnd = first + count;
+  } else {
+    batch.dirtyBegin = std::min(batch.dirtyBegin, first);
+    batch.dirtyEnd = std::max(batch.dirtyEnd, first + count);
+  }
+}
+
+void spriteBatchSetAtlas(SpriteBatch &batch, const TextureAtlas &atlas) {
+  batch.atlasBindGroup = atlas.bindGroup;
+}
+
+uint32_t spriteBatchAdd(SpriteBatch &batch, const SpriteInstance &instance) {
+  const uint32_t index = uint32_t(batch.instances.size());
+  batch.instances.push_back(instance);
+  spriteBatchMarkDirty(batch, index, 1);
+  return index;
+}
+
+void spriteBatchSet(SpriteBatch &batch, uint32_t index,
+                    const SpriteInstance &instance) {
+  batch.instances[index] = instance;
+  spriteBatchMarkDirty(batch, index, 1);
+}
+
+void spriteBatchClear(SpriteBatch &batch) {
+  batch.instances.clear();
+  batch.dirtyBegin = batch.dirtyEnd = 0;
+}
+
+void spriteBatchUpload(WGPUQueue queue, SpriteBatch &batch) {
+  const uint32_t count = uint32_t(batch.instances.size());
+
+  // Brak bufora lub za mały — podwój pojemność i prześlij wszystko od nowa
+  if (!batch.instanceBuffer || count > batch.capacity) {
+    uint32_t newCapacity = batch.capacity;
+    while (newCapacity < count)
+      newCapacity *= 2;
+    WGPUBuffer newBuffer =
+        createBuffer(batch.device, "Sprite Instance Buffer",
+                     WGPUBufferUsage_Vertex | WGPUBufferUsage_CopyDst,
+                     uint64_t(newCapacity) * sizeof(SpriteInstance));
+    if (!newBuffer) {
+      std::cerr << "Failed to grow sprite instance buffer!" << std::endl;
+      return;
+    }
+    if (batch.instanceBuffer)
+      wgpuBufferRelease(batch.instanceBuffer);
+    batch.instanceBuffer = newBuffer;
+    batch.capacity = newCapacity;
+    batch.dirtyBegin = 0;
+    batch.dirtyEnd = count;
+  }
+
+  const uint32_t end = std::min(batch.dirtyEnd, count);
+  if (batch.dirtyBegin < end) {
+    wgpuQueueWriteBuffer(queue, batch.instanceBuffer,
+                         uint64_t(batch.dirtyBegin) * sizeof(SpriteInstance),
+                         batch.instances.data() + batch.dirtyBegin,
+                         size_t(end - batch.dirtyBegin) *
+                             sizeof(SpriteInstance));
+  }
+  batch.dirtyBegin = batch.dirtyEnd = 0;
+  batch.drawBuffer = batch.instanceBuffer;
+  batch.drawOffset = 0;
+}
+
+bool spriteBatchUploadFrame(FrameRing &ring, SpriteBatch &batch) {
+  const uint64_t size = batch.instances.size() * sizeof(SpriteInstance);
+  batch.drawBuffer = nullptr;
+  batch.drawOffset = 0;
+  if (size == 0)
+    return true;
+
+  FrameAllocation allocation = frameRingAllocate(ring, size);
+  if (!allocation.data)
+    return false;
+  std::memcpy(allocation.data, batch.instances.data(), size);
+  batch.drawBuffer = allocation.buffer;
+  batch.drawOffset = allocation.offset;
+  return true;
+}
+
+void spriteBatchDraw(WGPURenderPassEncoder pass, const SpriteBatch &batch) {
+  spriteBatchDrawInstances(pass, batch, batch.drawBuffer, batch.drawOffset,
+                           uint32_t(batch.instances.size()));
+}
+
+void spriteBatchDrawRange(WGPURenderPassEncoder pass,
+                          const SpriteBatch &batch, uint32_t first,
+                          uint32_t count) {
+  spriteBatchDrawInstances(pass, batch, batch.drawBuffer,
+                           batch.drawOffset +
+                               uint64_t(first) * sizeof(SpriteInstance),
+                           count);
+}
+
+// Pipeline, atlas, quad i zakres instancji (count = rozmiar zakresu)
+static void bindInstances(WGPURenderPassEncoder pass,
+                          const SpriteBatch &batch, WGPUBuffer buffer,
+                          uint64_t offset, uint32_t count) {
+  wgpuRenderPassEncoderSetPipeline(pass, batch.pipeline);
+  wgpuRenderPassEncoderSetBindGroup(pass, 1, batch.atlasBindGroup, 0, nullptr);
+  wgpuRenderPassEncoderSetVertexBuffer(pass, 0, batch.quadVertexBuffer, 0,
+                                       sizeof(quadVertices));
+  wgpuRenderPassEncoderSetVertexBuffer(
+      pass, 1, buffer, offset, uint64_t(count) * sizeof(SpriteInstance));
+  wgpuRenderPassEncoderSetIndexBuffer(pass, batch.quadIndexBuffer,
+                                      WGPUIndexFormat_Uint16, 0,
+                                      sizeof(quadIndices));
+}
+
+void spriteBatchDrawInstances(WGPURenderPassEncoder pass,
+                              const SpriteBatch &batch, WGPUBuffer buffer,
+                              uint64_t offset, uint32_t count) {
+  if (count == 0 || !buffer || !batch.atlasBindGroup)
+    return;
+
+  bindInstances(pass, batch, buffer, offset, count);
+  wgpuRenderPassEncoderDrawIndexed(pass, 6, count, 0, 0, 0);
+}
+
+void spriteBatchDrawIndirect(WGPURenderPassEncoder pass,
+                             const SpriteBatch &batch, WGPUBuffer buffer,
+                             uint32_t capacity, WGPUBuffer indirectBuffer,
+                             uint64_t indirectOffset) {
+  if (capacity == 0 || !buffer || !indirectBuffer || !batch.atlasBindGroup)
+    return;
+
+  bindInstances(pass, batch, buffer, 0, capacity);
+  wgpuRenderPassEncoderDrawIndexedIndirect(pass, indirectBuffer,
+                                           indirectOffset);
+}
+
+void spriteBatchRecordBundle(WGPURenderBundleEncoder encoder,
+                             const SpriteBatch &batch) {
+  const uint32_t count = uint32_t(batch.instances.size());
+  if (count == 0 || !batch.drawBuffer || !batch.atlasBindGroup)
+    return;
+
+  wgpuRenderBundleEncoderSetPipeline(encoder, batch.pipeline);
+  wgpuRenderBundleEncoderSetBindGroup(encoder, 1, batch.atlasBindGroup, 0,
+                                      nullptr);
+  wgpuRenderBundleEncoderSetVertexBuffer(encoder, 0, batch.quadVertexBuffer, 0,
+                                         sizeof(quadVertices));
+  wgpuRenderBundleEncoderSetVertexBuffer(
+      encoder, 1, batch.drawBuffer, batch.drawOffset,
+      uint64_t(count) * sizeof(SpriteInstance));
+  wgpuRenderBundleEncoderSetIndexBuffer(encoder, batch.quadIndexBuffer,
+                                        WGPUIndexFormat_Uint16, 0,
+                                        sizeof(quadIndices));
+  wgpuRenderBundleEncoderDrawIndexed(encoder, 6, count, 0, 0, 0);
+}
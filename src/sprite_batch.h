@@ -0,0 +1,108 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include <webgpu/webgpu.h>
+
+#include "pipeline_cache.h"
+
+struct FrameRing;
+struct TextureAtlas;
+
+// Dane jednej instancji sprite'a — ciasno upakowane (28 B) i czytane przez
+// vertex shader jako bufor z krokiem per-instancja
+struct SpriteInstance {
+  float position[2];   // środek sprite'a w przestrzeni świata
+  float scale[2];      // szerokość i wysokość w jednostkach świata
+  float rotation;      // obrót w radianach
+  uint32_t atlasIndex; // indeks klatki w atlasie tekstur
+  uint32_t tint;       // kolor RGBA8 (R w najmłodszym bajcie)
+};
+static_assert(sizeof(SpriteInstance) == 28, "SpriteInstance must stay packed");
+
+// Renderer sprite'ów: jeden quad (4 wierzchołki + 6 indeksów) rysowany N razy
+// jednym draw callem. Instancje pochodzą z trwałego bufora (przesyłany tylko
+// zmieniony zakres) albo — dla danych zmienianych co klatkę — z pierścienia
+// zasobów klatki (FrameRing).
+struct SpriteBatch {
+  WGPUDevice device = nullptr;
+  WGPURenderPipeline pipeline = nullptr;    // z PipelineCache, nie posiadany
+  WGPUBindGroupLayout atlasLayout = nullptr; // grupa 1, z PipelineCache
+  WGPUBindGroup atlasBindGroup = nullptr;    // z TextureAtlas, nie posiadany
+  WGPUBuffer quadVertexBuffer = nullptr;
+  WGPUBuffer quadIndexBuffer = nullptr;
+  WGPUBuffer instanceBuffer = nullptr;
+  uint32_t capacity = 0; // pojemność instanceBuffer (w instancjach)
+  std::vector<SpriteInstance> instances;
+  uint32_t dirtyBegin = 0; // zakres [dirtyBegin, dirtyEnd) do przesłania
+  uint32_t dirtyEnd = 0;
+  WGPUBuffer drawBuffer = nullptr; // źródło instancji dla spriteBatchDraw
+  uint64_t drawOffset = 0;
+};
+
+// Pakuje kolor RGBA (0..255) do formatu pola SpriteInstance::tint
+constexpr uint32_t packColor(uint8_t r, uint8_t g, uint8_t b, uint8_t a = 255) {
+  return uint32_t(r) | (uint32_t(g) << 8) | (uint32_t(b) << 16) |
+         (uint32_t(a) << 24);
+}
+
+// Pełny opis pipeline'u sprite'ów — do rozgrzewki PipelineCache przed
+// pierwszą klatką. cameraLayout: grupa 0 z macierzą projekcji.
+RenderPipelineDesc spritePipelineDesc(WGPUTextureFormat colorFormat,
+                                      const BindGroupLayoutDesc &cameraLayout,
+                                      BlendMode blend = BlendMode::Alpha);
+
+// Pipeline i layout grupy 1 (atlas) pochodzą z cache'a, który musi żyć
+// dłużej niż batch — patrz spriteBatchSetAtlas.
+bool createSpriteBatch(WGPUDevice device, PipelineCache &pipelines,
+                       WGPUTextureFormat colorFormat,
+                       const BindGroupLayoutDesc &cameraLayout,
+                       uint32_t capacity, SpriteBatch &batch,
+                       BlendMode blend = BlendMode::Alpha);
+void releaseSpriteBatch(SpriteBatch &batch);
+
+// Atlas, z którego rysowane są sprite'y (SpriteInstance::atlasIndex to
+// indeks klatki). Atlas musi powstać z layoutem batch.atlasLayout.
+void spriteBatchSetAtlas(SpriteBatch &batch, const TextureAtlas &atlas);
+
+// Dodaje instancję i zwraca jej indeks
+uint32_t spriteBatchAdd(SpriteBatch &batch, const SpriteInstance &instance);
+// Nadpisuje instancję o danym indeksie
+void spriteBatchSet(SpriteBatch &batch, uint32_t index,
+                    const SpriteInstance &instance);
+// Oznacza zakres instancji zmodyfikowanych bezpośrednio w batch.instances
+void spriteBatchMarkDirty(SpriteBatch &batch, uint32_t first, uint32_t count);
+void spriteBatchClear(SpriteBatch &batch);
+
+// Przesyła zmieniony zakres do GPU (powiększa bufor, gdy brakuje miejsca)
+void spriteBatchUpload(WGPUQueue queue, SpriteBatch &batch);
+// Kopiuje wszystkie instancje do pierścienia bieżącej klatki i rysuje z
+// niego. Zwraca false, gdy w klatce zabrakło miejsca (nic nie zostanie
+// narysowane).
+bool spriteBatchUploadFrame(FrameRing &ring, SpriteBatch &batch);
+// Rysuje wszystkie instancje jednym wgpuRenderPassEncoderDrawIndexed
+// (jeden bind atlasu na cały batch). Bind group kamery (grupa 0) musi być
+// już ustawiony.
+void spriteBatchDraw(WGPURenderPassEncoder pass, const SpriteBatch &batch);
+// Zakres [first, first + count) instancji batcha (np. DrawBatch listy
+// rysowania)
+void spriteBatchDrawRange(WGPURenderPassEncoder pass,
+                          const SpriteBatch &batch, uint32_t first,
+                          uint32_t count);
+// Rysuje count instancji z zewnętrznego bufora (np. wynik compute shadera
+// zapisany jako SpriteInstance[]) pipeline'em i atlasem batcha
+void spriteBatchDrawInstances(WGPURenderPassEncoder pass,
+                              const SpriteBatch &batch, WGPUBuffer buffer,
+                              uint64_t offset, uint32_t count);
+// Jak wyżej, ale liczbę instancji czyta GPU z argumentów
+// DrawIndexedIndirect w indirectBuffer (np. wynik GpuCulling); capacity =
+// rozmiar bufora instancji
+void spriteBatchDrawIndirect(WGPURenderPassEncoder pass,
+                             const SpriteBatch &batch, WGPUBuffer buffer,
+                             uint32_t capacity, WGPUBuffer indirectBuffer,
+                             uint64_t indirectOffset);
+// To samo rysowanie nagrane do render bundle (warstwy statyczne). Batch musi
+// rysować z trwałego bufora (spriteBatchUpload) — bufor klatki zmienia się
+// co klatkę. Bind group kamery ustawia kod nagrywający warstwę.
+void spriteBatchRecordBundle(WGPURenderBundleEncoder encoder,
+                             const SpriteBatch &batch);
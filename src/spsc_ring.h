@@ -0,0 +1,74 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+// ============================================================
+//  Kolejka SPSC
+// ============================================================
+
+// Pierścień jeden producent / jeden konsument bez blokad i bez alokacji:
+// push i pop kończą się w stałej liczbie kroków (wait-free), więc nadaje
+// się dla wątków, które nie mogą czekać (callbacki wejścia, wątek audio).
+// Indeksy rosną monotonicznie (przepełnienie uint32_t jest w porządku),
+// slot to indeks & (Capacity - 1). Każda strona trzyma kopię indeksu
+// drugiej strony i czyta jej atomik dopiero, gdy kopia mówi "pełno" /
+// "pusto" — w typowym przypadku bez ruchu linii cache między rdzeniami.
+template <typename T, uint32_t Capacity> class SpscRing {
+  static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0,
+                "SpscRing capacity must be a power of two");
+
+public:
+  // Producent. false, gdy kolejka jest pełna (element nie trafia do niej).
+  bool push(const T &value) {
+    const uint32_t tail = m_tail.load(std::memory_order_relaxed);
+    if (tail - m_headCache == Capacity) {
+      m_headCache = m_head.load(std::memory_order_acquire);
+      if (tail - m_headCache == Capacity)
+        return false;
+    }
+    m_items[tail & (Capacity - 1)] = value;
+    m_tail.store(tail + 1, std::memory_order_release);
+    return true;
+  }
+
+  // Konsument: najstarszy element bez zdejmowania (nullptr, gdy pusto).
+  // Wskaźnik jest ważny do pop().
+  const T *front() {
+    const uint32_t head = m_head.load(std::memory_order_relaxed);
+    if (head == m_tailCache) {
+      m_tailCache = m_tail.load(std::memory_order_acquire);
+      if (head == m_tailCache)
+        return nullptr;
+    }
+    return &m_items[head & (Capacity - 1)];
+  }
+  // Konsument: zdejmuje element zwrócony przez front()
+  void pop() {
+    m_head.store(m_head.load(std::memory_order_relaxed) + 1,
+                 std::memory_order_release);
+  }
+  bool pop(T &value) {
+    const T *item = front();
+    if (!item)
+      return false;
+    value = *item;
+    pop();
+    return true;
+  }
+
+  // Przybliżona liczba elementów (dowolny wątek)
+  uint32_t size() const {
+    const uint32_t head = m_head.load(std::memory_order_acquire);
+    return m_tail.load(std::memory_order_acquire) - head;
+  }
+  static constexpr uint32_t capacity() { return Capacity; }
+
+private:
+  // Strona konsumenta i producenta na osobnych liniach cache
+  alignas(64) std::atomic<uint32_t> m_head{0};
+  uint32_t m_tailCache = 0;
+  alignas(64) std::atomic<uint32_t> m_tail{0};
+  uint32_t m_headCache = 0;
+  alignas(64) T m_items[Capacity];
+};
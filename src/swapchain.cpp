@@ -0,0 +1,170 @@
+#include "swapchain.h"
+
+#include <iostream>
+
+#include "wgpu_surface.h"
+
+// Odpowiednik formatu bez konwersji sRGB (Undefined, gdy go nie ma)
+static WGPUTextureFormat linearTwin(WGPUTextureFormat format) {
+  switch (format) {
+  case WGPUTextureFormat_BGRA8UnormSrgb:
+    return WGPUTextureFormat_BGRA8Unorm;
+  case WGPUTextureFormat_RGBA8UnormSrgb:
+    return WGPUTextureFormat_RGBA8Unorm;
+  default:
+    return WGPUTextureFormat_Undefined;
+  }
+}
+
+// Nazwa formatu (do logów)
+static const char *formatName(WGPUTextureFormat format) {
+  switch (format) {
+  case WGPUTextureFormat_BGRA8Unorm:
+    return "BGRA8Unorm";
+  case WGPUTextureFormat_BGRA8UnormSrgb:
+    return "BGRA8UnormSrgb";
+  case WGPUTextureFormat_RGBA8Unorm:
+    return "RGBA8Unorm";
+  case WGPUTextureFormat_RGBA8UnormSrgb:
+    return "RGBA8UnormSrgb";
+  case WGPUTextureFormat_RGBA16Float:
+    return "RGBA16Float";
+  default:
+    return "Other";
+  }
+}
+
+static WGPUTextureFormat chooseSurfaceFormat(WGPUSurface surface,
+                                             WGPUAdapter adapter) {
+  WGPUSurfaceCapabilities caps = {};
+  caps.nextInChain = nullptr;
+  wgpuSurfaceGetCapabilities(surface, adapter, &caps);
+
+  WGPUTextureFormat format = wgpuSurfaceGetPreferredFormat(surface, adapter);
+  bool preferredSupported = false;
+  bool twinSupported = false;
+  const WGPUTextureFormat twin = linearTwin(format);
+  for (size_t i = 0; i < caps.formatCount; ++i) {
+    preferredSupported |= caps.formats[i] == format;
+    twinSupported |= twin != WGPUTextureFormat_Undefined &&
+                     caps.formats[i] == twin;
+  }
+  if (twinSupported)
+    format = twin;
+  else if (!preferredSupported && caps.formatCount > 0)
+    format = caps.formats[0];
+  wgpuSurfaceCapabilitiesFreeMembers(caps);
+  return format;
+}
+
+static void configure(Swapchain &swapchain) {
+  wgpuSurfaceConfigure(swapchain.surface, &swapchain.config);
+  swapchain.needsReconfigure = false;
+}
+
+bool createSwapchain(WGPUSurface surface, WGPUAdapter adapter,
+                     WGPUDevice device, uint32_t width, uint32_t height,
+                     WGPUPresentMode presentMode, Swapchain &swapchain) {
+  swapchain.surface = surface;
+  swapchain.adapter = adapter;
+
+  WGPUSurfaceConfiguration &config = swapchain.config;
+  config = {};
+  config.nextInChain = nullptr;
+  config.device = device;
+  config.format = chooseSurfaceFormat(surface, adapter);
+  config.usage = WGPUTextureUsage_RenderAttachment;
+  config.viewFormatCount = 0;
+  config.viewFormats = nullptr;
+  config.alphaMode = WGPUCompositeAlphaMode_Auto;
+  config.width = width;
+  config.height = height;
+  config.presentMode = choosePresentMode(surface, adapter, presentMode);
+  if (config.format == WGPUTextureFormat_Undefined) {
+    std::cerr << "Surface reports no supported texture format!" << std::endl;
+    swapchain = {};
+    return false;
+  }
+
+  configure(swapchain);
+  std::cout << "Swapchain configured (" << width << "x" << height << ", "
+            << formatName(config.format) << ")." << std::endl;
+  return true;
+}
+
+void releaseSwapchain(Swapchain &swapchain) {
+  if (swapchain.surface && swapchain.config.device)
+    wgpuSurfaceUnconfigure(swapchain.surface);
+  swapchain = {};
+}
+
+bool swapchainResize(Swapchain &swapchain, uint32_t width, uint32_t height) {
+  if (width == 0 || height == 0)
+    return false;
+  if (width == swapchain.config.width && height == swapchain.config.height &&
+      !swapchain.needsReconfigure)
+    return false;
+  swapchain.config.width = width;
+  swapchain.config.height = height;
+  configure(swapchain);
+  ++swapchain.reconfigures;
+  return true;
+}
+
+SwapchainStatus swapchainAcquire(Swapchain &swapchain, SwapchainFrame &frame) {
+  frame = {};
+  if (swapchain.needsReconfigure) {
+    configure(swapchain);
+    ++swapchain.reconfigures;
+  }
+
+  WGPUSurfaceTexture surfaceTexture = {};
+  wgpuSurfaceGetCurrentTexture(swapchain.surface, &surfaceTexture);
+  switch (surfaceTexture.status) {
+  case WGPUSurfaceGetCurrentTextureStatus_Success:
+    break;
+  case WGPUSurfaceGetCurrentTextureStatus_Timeout:
+  case WGPUSurfaceGetCurrentTextureStatus_Outdated:
+  case WGPUSurfaceGetCurrentTextureStatus_Lost:
+    // Rozmiar okna się zmienił albo surface wymaga ponownej konfiguracji —
+    // następna klatka pobierze teksturę z nowego łańcucha
+    if (surfaceTexture.texture)
+      wgpuTextureRelease(surfaceTexture.texture);
+    swapchain.needsReconfigure = true;
+    ++swapchain.skippedFrames;
+    return SwapchainStatus::Skipped;
+  default:
+    std::cerr << "Failed to get current surface texture (status "
+              << int(surfaceTexture.status) << ")!" << std::endl;
+    if (surfaceTexture.texture)
+      wgpuTextureRelease(surfaceTexture.texture);
+    return SwapchainStatus::Failed;
+  }
+  // Tekstura nadal działa, ale nie pasuje do okna — przekonfiguruj przed
+  // następną klatką
+  if (surfaceTexture.suboptimal)
+    swapchain.needsReconfigure = true;
+
+  WGPUTextureViewDescriptor viewDesc = {};
+  viewDesc.nextInChain = nullptr;
+  viewDesc.label = "Surface Texture View";
+  viewDesc.format = swapchain.config.format;
+  viewDesc.dimension = WGPUTextureViewDimension_2D;
+  viewDesc.baseMipLevel = 0;
+  viewDesc.mipLevelCount = 1;
+  viewDesc.baseArrayLayer = 0;
+  viewDesc.arrayLayerCount = 1;
+  viewDesc.aspect = WGPUTextureAspect_All;
+  frame.texture = surfaceTexture.texture;
+  frame.view = wgpuTextureCreateView(surfaceTexture.texture, &viewDesc);
+  return SwapchainStatus::Ready;
+}
+
+void swapchainPresent(Swapchain &swapchain, SwapchainFrame &frame) {
+  wgpuSurfacePresent(swapchain.surface);
+  if (frame.view)
+    wgpuTextureViewRelease(frame.view);
+  if (frame.texture)
+    wgpuTextureRelease(frame.texture);
+  frame = {};
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstdint>
+#include <webgpu/webgpu.h>
+
+// ============================================================
+//  Swapchain (konfiguracja surface okna)
+// ============================================================
+
+// Surface skonfigurowany w formacie preferowanym przez adapter. Rozmiar
+// śledzi framebuffer okna, a Outdated / Lost / Timeout przy pobieraniu
+// tekstury kończą się rekonfiguracją i pominięciem klatki, nie wyjściem.
+struct Swapchain {
+  WGPUSurface surface = nullptr; // nie posiadany
+  WGPUAdapter adapter = nullptr; // nie posiadany
+  WGPUSurfaceConfiguration config = {};
+  bool needsReconfigure = false; // np. po teksturze "suboptimal"
+  uint32_t reconfigures = 0;     // zmiany rozmiaru i odzyskania surface
+  uint32_t skippedFrames = 0;    // klatki bez tekstury
+};
+
+// Tekstura bieżącej klatki i jej widok (oba zwalnia swapchainPresent)
+struct SwapchainFrame {
+  WGPUTexture texture = nullptr;
+  WGPUTextureView view = nullptr;
+};
+
+enum class SwapchainStatus : uint8_t {
+  Ready,   // tekstura gotowa do renderowania
+  Skipped, // brak tekstury w tej klatce (surface zrekonfigurowany)
+  Failed,  // błąd nie do odzyskania (brak pamięci, utrata urządzenia)
+};
+
+// Wybiera format (preferowany przez surface; wariant sRGB zamieniany na
+// zwykły UNORM, gdy surface go obsługuje — kolory silnika są już w
+// przestrzeni wyjścia) i tryb prezentacji, po czym konfiguruje surface
+bool createSwapchain(WGPUSurface surface, WGPUAdapter adapter,
+                     WGPUDevice device, uint32_t width, uint32_t height,
+                     WGPUPresentMode presentMode, Swapchain &swapchain);
+void releaseSwapchain(Swapchain &swapchain);
+
+// Nowy rozmiar framebuffera. 0 × 0 (okno zminimalizowane) zostawia starą
+// konfigurację. Zwraca true, gdy surface został przekonfigurowany.
+bool swapchainResize(Swapchain &swapchain, uint32_t width, uint32_t height);
+
+// Pobiera teksturę klatki. Przy Timeout / Outdated / Lost rekonfiguruje
+// surface i zwraca Skipped — klatkę pomija się w całości.
+SwapchainStatus swapchainAcquire(Swapchain &swapchain, SwapchainFrame &frame);
+// Prezentuje klatkę i zwalnia jej teksturę oraz widok
+void swapchainPresent(Swapchain &swapchain, SwapchainFrame &frame);
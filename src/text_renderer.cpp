@@ -0,0 +1,464 @@
+#include "text_renderer.h"
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <iterator>
+
+#include "atlas_file.h"
+
+// ============================================================
+//  Wbudowany font 5x7
+// ============================================================
+
+// Wiersz = 5 bitów, najstarszy (bit 4) to lewa kolumna
+struct FontBitmap {
+  char code;
+  uint8_t rows[7];
+};
+
+static const FontBitmap fontBitmaps[] = {
+    {' ', {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}},
+    {'!', {0x04, 0x04, 0x04, 0x04, 0x04, 0x00, 0x04}},
+    {'%', {0x18, 0x19, 0x02, 0x04, 0x08, 0x13, 0x03}},
+    {'(', {0x02, 0x04, 0x08, 0x08, 0x08, 0x04, 0x02}},
+    {')', {0x08, 0x04, 0x02, 0x02, 0x02, 0x04, 0x08}},
+    {'+', {0x00, 0x04, 0x04, 0x1F, 0x04, 0x04, 0x00}},
+    {',', {0x00, 0x00, 0x00, 0x00, 0x0C, 0x04, 0x08}},
+    {'-', {0x00, 0x00, 0x00, 0x1F, 0x00, 0x00, 0x00}},
+    {'.', {0x00, 0x00, 0x00, 0x00, 0x00, 0x0C, 0x0C}},
+    {'/', {0x00, 0x01, 0x02, 0x04, 0x08, 0x10, 0x00}},
+    {'0', {0x0E, 0x11, 0x13, 0x15, 0x19, 0x11, 0x0E}},
+    {'1', {0x04, 0x0C, 0x04, 0x04, 0x04, 0x04, 0x0E}},
+    {'2', {0x0E, 0x11, 0x01, 0x02, 0x04, 0x08, 0x1F}},
+    {'3', {0x1F, 0x02, 0x04, 0x02, 0x01, 0x11, 0x0E}},
+    {'4', {0x02, 0x06, 0x0A, 0x12, 0x1F, 0x02, 0x02}},
+    {'5', {0x1F, 0x10, 0x1E, 0x01, 0x01, 0x11, 0x0E}},
+    {'6', {0x06, 0x08, 0x10, 0x1E, 0x11, 0x11, 0x0E}},
+    {'7', {0x1F, 0x01, 0x02, 0x04, 0x08, 0x08, 0x08}},
+    {'8', {0x0E, 0x11, 0x11, 0x0E, 0x11, 0x11, 0x0E}},
+    {'9', {0x0E, 0x11, 0x11, 0x0F, 0x01, 0x02, 0x0C}},
+    {':', {0x00, 0x0C, 0x0C, 0x00, 0x0C, 0x0C, 0x00}},
+    {'?', {0x0E, 0x11, 0x01, 0x02, 0x04, 0x00, 0x04}},
+    {'A', {0x0E, 0x11, 0x11, 0x11, 0x1F, 0x11, 0x11}},
+    {'B', {0x1E, 0x11, 0x11, 0x1E, 0x11, 0x11, 0x1E}},
+    {'C', {0x0E, 0x11, 0x10, 0x10, 0x10, 0x11, 0x0E}},
+    {'D', {0x1C, 0x12, 0x11, 0x11, 0x11, 0x12, 0x1C}},
+    {'E', {0x1F, 0x10, 0x10, 0x1E, 0x10, 0x10, 0x1F}},
+    {'F', {0x1F, 0x10, 0x10, 0x1E, 0x10, 0x10, 0x10}},
+    {'G', {0x0E, 0x11, 0x10, 0x17, 0x11, 0x11, 0x0F}},
+    {'H', {0x11, 0x11, 0x11, 0x1F, 0x11, 0x11, 0x11}},
+    {'I', {0x0E, 0x04, 0x04, 0x04, 0x04, 0x04, 0x0E}},
+    {'J', {0x07, 0x02, 0x02, 0x02, 0x02, 0x12, 0x0C}},
+    {'K', {0x11, 0x12, 0x14, 0x18, 0x14, 0x12, 0x11}},
+    {'L', {0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x1F}},
+    {'M', {0x11, 0x1B, 0x15, 0x15, 0x11, 0x11, 0x11}},
+    {'N', {0x11, 0x11, 0x19, 0x15, 0x13, 0x11, 0x11}},
+    {'O', {0x0E, 0x11, 0x11, 0x11, 0x11, 0x11, 0x0E}},
+    {'P', {0x1E, 0x11, 0x11, 0x1E, 0x10, 0x10, 0x10}},
+    {'Q', {0x0E, 0x11, 0x11, 0x11, 0x15, 0x12, 0x0D}},
+    {'R', {0x1E, 0x11, 0x11, 0x1E, 0x14, 0x12, 0x11}},
+    {'S', {0x0F, 0x10, 0x10, 0x0E, 0x01, 0x01, 0x1E}},
+    {'T', {0x1F, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04}},
+    {'U', {0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x0E}},
+    {'V', {0x11, 0x11, 0x11, 0x11, 0x11, 0x0A, 0x04}},
+    {'W', {0x11, 0x11, 0x11, 0x15, 0x15, 0x15, 0x0A}},
+    {'X', {0x11, 0x11, 0x0A, 0x04, 0x0A, 0x11, 0x11}},
+    {'Y', {0x11, 0x11, 0x11, 0x0A, 0x04, 0x04, 0x04}},
+    {'Z', {0x1F, 0x01, 0x02, 0x04, 0x08, 0x10, 0x1F}},
+};
+
+// Piksel fontu → kOversample x kOversample pikseli atlasu (mniej rozmycia
+// przy filtrowaniu liniowym i powiększeniu)
+constexpr uint32_t kOversample = 4;
+constexpr uint32_t kGlyphPadding = 2; // przezroczysty margines w atlasie
+constexpr uint32_t kFontPageSize = 256;
+
+bool createBitmapFont(WGPUDevice device, WGPUQueue queue,
+                      WGPUBindGroupLayout atlasLayout, BitmapFont &font) {
+  const uint32_t glyphWidth = 5 * kOversample;
+  const uint32_t glyphHeight = 7 * kOversample;
+  const uint32_t cellWidth = glyphWidth + kGlyphPadding * 2;
+  const uint32_t cellHeight = glyphHeight + kGlyphPadding * 2;
+  const uint32_t columns = kFontPageSize / cellWidth;
+
+  AtlasImage image;
+  image.pageSize = kFontPageSize;
+  image.pageCount = 1;
+  image.mipLevelCount = 1;
+  image.pixels.assign(atlasPageBytes(image.pageSize, 1), 0);
+
+  const float invSize = 1.0f / float(kFontPageSize);
+  const uint32_t glyphCount = uint32_t(std::size(fontBitmaps));
+  for (uint32_t g = 0; g < glyphCount; ++g) {
+    const FontBitmap &bitmap = fontBitmaps[g];
+    const uint32_t originX = (g % columns) * cellWidth + kGlyphPadding;
+    const uint32_t originY = (g / columns) * cellHeight + kGlyphPadding;
+    for (uint32_t y = 0; y < glyphHeight; ++y) {
+      const uint8_t row = bitmap.rows[y / kOversample];
+      for (uint32_t x = 0; x < glyphWidth; ++x) {
+        const bool on = (row >> (4 - x / kOversample)) & 1;
+        uint8_t *pixel =
+            image.pixels.data() +
+            (size_t(originY + y) * kFontPageSize + originX + x) * 4;
+        // Biały z alfą — kolor pochodzi z tint instancji
+        pixel[0] = pixel[1] = pixel[2] = 255;
+        pixel[3] = on ? 255 : 0;
+      }
+    }
+
+    AtlasFrame frame = {};
+    frame.nameOffset = uint32_t(image.names.size());
+    frame.page = 0;
+    frame.x = uint16_t(originX);
+    frame.y = uint16_t(originY);
+    frame.width = uint16_t(glyphWidth);
+    frame.height = uint16_t(glyphHeight);
+    frame.uvRect[0] = frame.x * invSize;
+    frame.uvRect[1] = frame.y * invSize;
+    frame.uvRect[2] = (frame.x + frame.width) * invSize;
+    frame.uvRect[3] = (frame.y + frame.height) * invSize;
+    image.frames.push_back(frame);
+    image.names.push_back(bitmap.code);
+    image.names.push_back('\0');
+  }
+
+  const std::vector<uint8_t> bytes = serializeAtlas(image);
+  AtlasView view;
+  if (!parseAtlas(bytes.data(), bytes.size(), view) ||
+      !uploadTextureAtlas(device, queue, atlasLayout, view, font.atlas)) {
+    std::cerr << "Failed to create font atlas!" << std::endl;
+    return false;
+  }
+
+  // Mapa znak → glif; małe litery jak wielkie, reszta jako '?'
+  uint32_t fallback = 0;
+  for (uint32_t g = 0; g < glyphCount; ++g)
+    if (fontBitmaps[g].code == '?')
+      fallback = g;
+  for (uint32_t c = 0; c < 128; ++c) {
+    font.glyphs[c].frame = fallback;
+    font.glyphs[c].advance = font.cellWidth + 1.0f;
+  }
+  for (uint32_t g = 0; g < glyphCount; ++g) {
+    const uint32_t code = uint32_t(fontBitmaps[g].code);
+    font.glyphs[code].frame = g;
+    if (code >= 'A' && code <= 'Z')
+      font.glyphs[code - 'A' + 'a'].frame = g;
+  }
+  font.glyphs[uint32_t(' ')].frame = kInvalidAtlasFrame;
+  return true;
+}
+
+void releaseBitmapFont(BitmapFont &font) {
+  releaseTextureAtlas(font.atlas);
+  font = {};
+}
+
+// ============================================================
+//  Shaping i zakresy instancji
+// ============================================================
+
+constexpr size_t kMaxCachedRuns = 4096;
+
+static const GlyphRun &shapeText(TextRenderer &text,
+                                 const std::string &string) {
+  auto it = text.runCache.find(string);
+  if (it != text.runCache.end()) {
+    ++text.runCacheHits;
+    return it->second;
+  }
+  ++text.runCacheMisses;
+
+  const BitmapFont &font = text.font;
+  GlyphRun run;
+  float penX = 0.0f, penY = 0.0f;
+  for (char c : string) {
+    if (c == '\n') {
+      run.width = std::max(run.width, penX - 1.0f);
+      penX = 0.0f;
+      penY += font.lineHeight;
+      continue;
+    }
+    const uint8_t code = uint8_t(c) < 128 ? uint8_t(c) : uint8_t('?');
+    const FontGlyph &glyph = font.glyphs[code];
+    if (glyph.frame != kInvalidAtlasFrame)
+      run.quads.push_back({penX, penY, glyph.frame});
+    penX += glyph.advance;
+  }
+  run.width = std::max(run.width, penX - 1.0f);
+  run.height = penY + font.cellHeight;
+  return text.runCache.emplace(string, std::move(run)).first->second;
+}
+
+static uint32_t allocateRange(TextRenderer &text, TextSpace space,
+                              uint32_t count) {
+  std::vector<TextRange> &freeRanges = text.freeRanges[uint32_t(space)];
+  for (size_t i = 0; i < freeRanges.size(); ++i) {
+    TextRange &range = freeRanges[i];
+    if (range.count < count)
+      continue;
+    const uint32_t first = range.first;
+    range.first += count;
+    range.count -= count;
+    if (range.count == 0)
+      freeRanges.erase(freeRanges.begin() + i);
+    return first;
+  }
+
+  // Brak pasującej dziury — nowe instancje na końcu (zerowa skala)
+  SpriteBatch &batch = text.batches[uint32_t(space)];
+  const uint32_t first = uint32_t(batch.instances.size());
+  batch.instances.resize(first + count, SpriteInstance{});
+  spriteBatchMarkDirty(batch, first, count);
+  return first;
+}
+
+static void freeRange(TextRenderer &text, TextSpace space, uint32_t first,
+                      uint32_t count) {
+  if (count == 0)
+    return;
+  SpriteBatch &batch = text.batches[uint32_t(space)];
+  std::fill(batch.instances.begin() + first,
+            batch.instances.begin() + first + count, SpriteInstance{});
+  spriteBatchMarkDirty(batch, first, count);
+
+  // Lista posortowana po first; sąsiednie zakresy są scalane, więc
+  // dłuższy napis mieści się w miejscu kilku zwolnionych krótszych
+  std::vector<TextRange> &freeRanges = text.freeRanges[uint32_t(space)];
+  auto next = std::lower_bound(
+      freeRanges.begin(), freeRanges.end(), first,
+      [](const TextRange &range, uint32_t at) { return range.first < at; });
+  if (next != freeRanges.begin() &&
+      std::prev(next)->first + std::prev(next)->count == first) {
+    auto previous = std::prev(next);
+    previous->count += count;
+    if (next != freeRanges.end() && first + count == next->first) {
+      previous->count += next->count;
+      freeRanges.erase(next);
+    }
+  } else if (next != freeRanges.end() && first + count == next->first) {
+    next->first = first;
+    next->count += count;
+  } else {
+    freeRanges.insert(next, {first, count});
+  }
+
+  // Wolny zakres na końcu bufora skraca batch — po fali liczb obrażeń
+  // nie zostają tysiące pustych instancji do narysowania
+  const TextRange &last = freeRanges.back();
+  if (last.first + last.count == batch.instances.size()) {
+    batch.instances.resize(last.first);
+    freeRanges.pop_back();
+  }
+}
+
+static void markDirty(TextRenderer &text, TextLabelId id) {
+  TextLabel &label = text.labels[id];
+  if (!label.dirty) {
+    label.dirty = true;
+    text.dirtyLabels.push_back(id);
+  }
+}
+
+// Zapewnia zakres na glify run (przeniesienie, gdy się nie mieści)
+static void assignRun(TextRenderer &text, TextLabel &label,
+                      const GlyphRun &run) {
+  label.run = &run;
+  const uint32_t needed = uint32_t(run.quads.size());
+  if (needed <= label.capacity)
+    return;
+  freeRange(text, label.space, label.first, label.capacity);
+  // Zapas do wielokrotności 8 — rosnące liczniki rzadko się przenoszą
+  label.capacity = (needed + 7) & ~7u;
+  label.first = allocateRange(text, label.space, label.capacity);
+}
+
+// Instancje glifów napisu (reszta zakresu: zerowa skala)
+static void writeLabel(TextRenderer &text, const TextLabel &label) {
+  const BitmapFont &font = text.font;
+  const GlyphRun &run = *label.run;
+  const float scale = label.style.size / font.cellHeight;
+  float originX = label.x, originY = label.y;
+  if (label.style.align == TextAlign::Center) {
+    originX -= run.width * scale * 0.5f;
+    originY -= run.height * scale * 0.5f;
+  }
+
+  SpriteBatch &batch = text.batches[uint32_t(label.space)];
+  SpriteInstance *out = batch.instances.data() + label.first;
+  const uint32_t count = uint32_t(run.quads.size());
+  for (uint32_t i = 0; i < count; ++i) {
+    const GlyphQuad &quad = run.quads[i];
+    out[i].position[0] = originX + (quad.x + font.cellWidth * 0.5f) * scale;
+    out[i].position[1] = originY + (quad.y + font.cellHeight * 0.5f) * scale;
+    out[i].scale[0] = font.cellWidth * scale;
+    out[i].scale[1] = font.cellHeight * scale;
+    out[i].rotation = 0.0f;
+    out[i].atlasIndex = quad.frame;
+    out[i].tint = label.style.color;
+  }
+  for (uint32_t i = count; i < label.capacity; ++i)
+    out[i] = SpriteInstance{};
+  spriteBatchMarkDirty(batch, label.first, label.capacity);
+  text.glyphsWritten += label.capacity;
+}
+
+// ============================================================
+//  API
+// ============================================================
+
+bool createTextRenderer(WGPUDevice device, WGPUQueue queue,
+                        PipelineCache &pipelines,
+                        WGPUTextureFormat colorFormat,
+                        const BindGroupLayoutDesc &cameraLayout,
+                        TextRenderer &text) {
+  for (SpriteBatch &batch : text.batches) {
+    if (!createSpriteBatch(device, pipelines, colorFormat, cameraLayout, 256,
+                           batch)) {
+      releaseTextRenderer(text);
+      return false;
+    }
+  }
+  if (!createBitmapFont(device, queue, text.batches[0].atlasLayout,
+                        text.font)) {
+    releaseTextRenderer(text);
+    return false;
+  }
+  for (SpriteBatch &batch : text.batches)
+    spriteBatchSetAtlas(batch, text.font.atlas);
+  return true;
+}
+
+void releaseTextRenderer(TextRenderer &text) {
+  for (SpriteBatch &batch : text.batches)
+    releaseSpriteBatch(batch);
+  releaseBitmapFont(text.font);
+  text = {};
+}
+
+TextLabelId textCreateLabel(TextRenderer &text, TextSpace space,
+                            std::string_view string, float x, float y,
+                            const TextStyle &style) {
+  TextLabelId id;
+  if (!text.freeLabels.empty()) {
+    id = text.freeLabels.back();
+    text.freeLabels.pop_back();
+  } else {
+    id = TextLabelId(text.labels.size());
+    text.labels.emplace_back();
+  }
+
+  TextLabel &label = text.labels[id];
+  label = {};
+  label.text = string;
+  label.x = x;
+  label.y = y;
+  label.style = style;
+  label.space = space;
+  label.alive = true;
+  assignRun(text, label, shapeText(text, label.text));
+  markDirty(text, id);
+  return id;
+}
+
+void textDestroyLabel(TextRenderer &text, TextLabelId id) {
+  if (id >= text.labels.size() || !text.labels[id].alive)
+    return;
+  TextLabel &label = text.labels[id];
+  freeRange(text, label.space, label.first, label.capacity);
+  label.alive = false;
+  label.run = nullptr;
+  label.capacity = 0;
+  text.freeLabels.push_back(id);
+}
+
+void textSetString(TextRenderer &text, TextLabelId id,
+                   std::string_view string) {
+  TextLabel &label = text.labels[id];
+  if (!label.alive || label.text == string)
+    return;
+  label.text = string;
+  assignRun(text, label, shapeText(text, label.text));
+  markDirty(text, id);
+}
+
+void textSetPosition(TextRenderer &text, TextLabelId id, float x, float y) {
+  TextLabel &label = text.labels[id];
+  if (!label.alive || (label.x == x && label.y == y))
+    return;
+  label.x = x;
+  label.y = y;
+  markDirty(text, id);
+}
+
+void textSetColor(TextRenderer &text, TextLabelId id, uint32_t color) {
+  TextLabel &label = text.labels[id];
+  if (!label.alive || label.style.color == color)
+    return;
+  label.style.color = color;
+  markDirty(text, id);
+}
+
+void textUpload(WGPUQueue queue, TextRenderer &text) {
+  // Cache rośnie z każdym nowym tekstem (np. zegar) — po przekroczeniu
+  // limitu budowany od nowa z napisów, które wciąż istnieją
+  if (text.runCache.size() > kMaxCachedRuns) {
+    text.runCache.clear();
+    for (TextLabel &label : text.labels)
+      if (label.alive)
+        label.run = &shapeText(text, label.text);
+  }
+
+  for (TextLabelId id : text.dirtyLabels) {
+    TextLabel &label = text.labels[id];
+    label.dirty = false;
+    if (label.alive)
+      writeLabel(text, label);
+  }
+  text.dirtyLabels.clear();
+
+  for (SpriteBatch &batch : text.batches)
+    spriteBatchUpload(queue, batch);
+}
+
+void textDraw(WGPURenderPassEncoder pass, const TextRenderer &text,
+              TextSpace space) {
+  spriteBatchDraw(pass, text.batches[uint32_t(space)]);
+}
+
+// ============================================================
+//  Liczby obrażeń
+// ============================================================
+
+void floatingNumberSpawn(TextRenderer &text, FloatingNumbers &numbers,
+                         float x, float y, uint32_t value, uint32_t color) {
+  TextStyle style;
+  style.size = numbers.size;
+  style.color = color;
+  style.align = TextAlign::Center;
+  const TextLabelId label = textCreateLabel(
+      text, TextSpace::World, std::to_string(value), x, y, style);
+  numbers.active.push_back({label, x, y, 0.0f, color});
+}
+
+void floatingNumbersUpdate(TextRenderer &text, FloatingNumbers &numbers,
+                           float dt) {
+  for (size_t i = 0; i < numbers.active.size();) {
+    FloatingNumber &number = numbers.active[i];
+    number.age += dt;
+    if (number.age >= numbers.lifetime) {
+      textDestroyLabel(text, number.label);
+      number = numbers.active.back();
+      numbers.active.pop_back();
+      continue;
+    }
+    number.y -= numbers.riseSpeed * dt;
+    const float fade = 1.0f - number.age / numbers.lifetime;
+    const uint32_t alpha = uint32_t(fade * 255.0f);
+    textSetPosition(text, number.label, number.x, number.y);
+    textSetColor(text, number.label,
+                 (number.color & 0x00FFFFFFu) | (alpha << 24));
+    ++i;
+  }
+}
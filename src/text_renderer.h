@@ -0,0 +1,162 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include <webgpu/webgpu.h>
+
+#include "pipeline_cache.h"
+#include "sprite_batch.h"
+#include "texture_atlas.h"
+
+// ============================================================
+//  Font bitmapowy
+// ============================================================
+
+// Glif w atlasie fontu (jednostki: piksele fontu 5x7)
+struct FontGlyph {
+  uint32_t frame = kInvalidAtlasFrame;
+  float advance = 0.0f;
+};
+
+// Wbudowany font 5x7 (cyfry, wielkie litery, interpunkcja; małe litery
+// rysowane jako wielkie) rasteryzowany do atlasu przy starcie. Znaki
+// spoza zestawu rysowane są jako '?'.
+struct BitmapFont {
+  TextureAtlas atlas;
+  FontGlyph glyphs[128];
+  float cellWidth = 5.0f;   // rozmiar glifu w pikselach fontu
+  float cellHeight = 7.0f;
+  float lineHeight = 9.0f;
+};
+
+bool createBitmapFont(WGPUDevice device, WGPUQueue queue,
+                      WGPUBindGroupLayout atlasLayout, BitmapFont &font);
+void releaseBitmapFont(BitmapFont &font);
+
+// ============================================================
+//  Napisy
+// ============================================================
+
+// Ułożony napis (wynik shapingu) w pikselach fontu, względem lewego
+// górnego rogu — cache'owany per tekst
+struct GlyphQuad {
+  float x, y;
+  uint32_t frame;
+};
+struct GlyphRun {
+  std::vector<GlyphQuad> quads;
+  float width = 0.0f;
+  float height = 0.0f;
+};
+
+enum class TextSpace : uint32_t {
+  World,  // kamera świata (np. liczby obrażeń)
+  Screen, // piksele ekranu (HUD)
+  Count
+};
+
+enum class TextAlign : uint32_t {
+  TopLeft, // (x, y) = lewy górny róg
+  Center,  // (x, y) = środek napisu
+};
+
+struct TextStyle {
+  float size = 14.0f; // wysokość glifu w jednostkach przestrzeni
+  uint32_t color = packColor(255, 255, 255);
+  TextAlign align = TextAlign::TopLeft;
+};
+
+using TextLabelId = uint32_t;
+constexpr TextLabelId kInvalidTextLabel = ~0u;
+
+struct TextLabel {
+  std::string text;
+  const GlyphRun *run = nullptr; // z cache'a shapingu
+  float x = 0.0f, y = 0.0f;
+  TextStyle style;
+  TextSpace space = TextSpace::World;
+  uint32_t first = 0;    // zakres instancji w batchu przestrzeni
+  uint32_t capacity = 0; // zarezerwowane glify (>= długość napisu)
+  bool alive = false;
+  bool dirty = false;
+};
+
+// Zakres instancji zwolniony przez usunięty albo przeniesiony napis
+// (lista per przestrzeń posortowana po first, sąsiednie zakresy scalone)
+struct TextRange {
+  uint32_t first;
+  uint32_t count;
+};
+
+// Wszystkie napisy przestrzeni to instancje sprite'ów jednego trwałego
+// bufora (glif = klatka atlasu fontu), więc cała przestrzeń rysowana jest
+// jednym draw callem niezależnie od liczby napisów. Geometria napisu jest
+// przepisywana tylko po zmianie tekstu, pozycji lub stylu — i przesyłany
+// jest tylko zmieniony zakres bufora. Ułożenie glifów jest cache'owane
+// per tekst, więc powtarzające się liczby nie są układane ponownie.
+struct TextRenderer {
+  BitmapFont font;
+  SpriteBatch batches[uint32_t(TextSpace::Count)];
+  std::vector<TextRange> freeRanges[uint32_t(TextSpace::Count)];
+  std::vector<TextLabel> labels;
+  std::vector<TextLabelId> freeLabels;
+  std::vector<TextLabelId> dirtyLabels;
+  std::unordered_map<std::string, GlyphRun> runCache;
+  uint32_t runCacheHits = 0;
+  uint32_t runCacheMisses = 0;
+  uint64_t glyphsWritten = 0; // przepisane instancje (od startu)
+};
+
+// Batche używają pipeline'u sprite'ów z cache'a (ten sam obiekt co
+// SpriteBatch świata) i atlasu fontu
+bool createTextRenderer(WGPUDevice device, WGPUQueue queue,
+                        PipelineCache &pipelines,
+                        WGPUTextureFormat colorFormat,
+                        const BindGroupLayoutDesc &cameraLayout,
+                        TextRenderer &text);
+void releaseTextRenderer(TextRenderer &text);
+
+TextLabelId textCreateLabel(TextRenderer &text, TextSpace space,
+                            std::string_view string, float x, float y,
+                            const TextStyle &style = {});
+void textDestroyLabel(TextRenderer &text, TextLabelId label);
+// Zmiany oznaczają napis jako brudny tylko, gdy coś się faktycznie zmienia
+void textSetString(TextRenderer &text, TextLabelId label,
+                   std::string_view string);
+void textSetPosition(TextRenderer &text, TextLabelId label, float x, float y);
+void textSetColor(TextRenderer &text, TextLabelId label, uint32_t color);
+
+// Przepisuje glify brudnych napisów i przesyła zmienione zakresy (przed
+// submit, wątek główny)
+void textUpload(WGPUQueue queue, TextRenderer &text);
+// Jeden draw call dla przestrzeni — bind group kamery odpowiedniej
+// przestrzeni musi być już ustawiony
+void textDraw(WGPURenderPassEncoder pass, const TextRenderer &text,
+              TextSpace space);
+
+// ============================================================
+//  Liczby obrażeń
+// ============================================================
+
+struct FloatingNumber {
+  TextLabelId label;
+  float x, y;
+  float age;
+  uint32_t color;
+};
+
+// Wznoszące się i gasnące liczby w przestrzeni świata
+struct FloatingNumbers {
+  std::vector<FloatingNumber> active;
+  float lifetime = 0.9f;  // s
+  float riseSpeed = 40.0f; // jednostki świata / s
+  float size = 10.0f;
+};
+
+void floatingNumberSpawn(TextRenderer &text, FloatingNumbers &numbers,
+                         float x, float y, uint32_t value, uint32_t color);
+void floatingNumbersUpdate(TextRenderer &text, FloatingNumbers &numbers,
+                           float dt);
@@ -0,0 +1,273 @@
+#include "texture_atlas.h"
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+#include "mapped_file.h"
+
+// ============================================================
+//  GPU
+// ============================================================
+
+BindGroupLayoutDesc atlasBindGroupLayoutDesc() {
+  BindGroupLayoutDesc desc;
+  desc.label = "Atlas Bind Group Layout";
+  desc.entries = {
+      // binding 0: strony atlasu (texture_2d_array<f32>)
+      BindingDesc::texture(0, WGPUShaderStage_Fragment,
+                           WGPUTextureSampleType_Float,
+                           WGPUTextureViewDimension_2DArray),
+      // binding 1: sampler
+      BindingDesc::sampler(1, WGPUShaderStage_Fragment,
+                           WGPUSamplerBindingType_Filtering),
+      // binding 2: tablica klatek (UV + strona), czytana w vertex shaderze
+      BindingDesc::buffer(2, WGPUShaderStage_Vertex,
+                          WGPUBufferBindingType_ReadOnlyStorage,
+                          sizeof(AtlasGpuFrame)),
+  };
+  return desc;
+}
+
+// Offset pikseli poziomu mip strony w danych pliku
+static uint64_t atlasLevelOffset(const AtlasFileHeader &header, uint32_t page,
+                                 uint32_t level) {
+  uint64_t offset =
+      uint64_t(page) * atlasPageBytes(header.pageSize, header.mipLevelCount);
+  for (uint32_t l = 0; l < level; ++l) {
+    const uint64_t size = std::max(header.pageSize >> l, 1u);
+    offset += size * size * 4;
+  }
+  return offset;
+}
+
+void buildAtlasFrameTable(const AtlasView &view, TextureAtlas &atlas,
+                          std::vector<AtlasGpuFrame> &gpuFrames) {
+  const AtlasFileHeader &header = *view.header;
+  atlas.pageSize = header.pageSize;
+  atlas.pageCount = header.pageCount;
+  atlas.frameCount = header.frameCount;
+
+  gpuFrames.assign(header.frameCount, AtlasGpuFrame{}); // >= 1 (parseAtlas)
+  atlas.frameByName.clear();
+  atlas.frameByName.reserve(header.frameCount);
+  atlas.framePages.assign(header.frameCount, 0);
+  for (uint32_t i = 0; i < header.frameCount; ++i) {
+    const AtlasFrame &frame = view.frames[i];
+    std::memcpy(gpuFrames[i].uvRect, frame.uvRect, sizeof(frame.uvRect));
+    gpuFrames[i].page = frame.page;
+    atlas.framePages[i] = frame.page;
+    if (frame.nameOffset < header.namesSize)
+      atlas.frameByName.emplace(
+          std::string(view.names + frame.nameOffset,
+                      strnlen(view.names + frame.nameOffset,
+                              header.namesSize - frame.nameOffset)),
+          i);
+  }
+}
+
+bool createAtlasGpuResources(WGPUDevice device, WGPUQueue queue,
+                             WGPUBindGroupLayout layout,
+                             const AtlasFileHeader &header,
+                             const std::vector<AtlasGpuFrame> &gpuFrames,
+                             TextureAtlas &atlas) {
+  // 1. Tekstura: strony jako warstwy, wszystkie poziomy mip z pliku
+  WGPUTextureDescriptor textureDesc = {};
+  textureDesc.nextInChain = nullptr;
+  textureDesc.label = "Atlas Texture";
+  textureDesc.usage =
+      WGPUTextureUsage_TextureBinding | WGPUTextureUsage_CopyDst;
+  textureDesc.dimension = WGPUTextureDimension_2D;
+  textureDesc.size = {header.pageSize, header.pageSize, header.pageCount};
+  textureDesc.format = WGPUTextureFormat_RGBA8Unorm;
+  textureDesc.mipLevelCount = header.mipLevelCount;
+  textureDesc.sampleCount = 1;
+  textureDesc.viewFormatCount = 0;
+  textureDesc.viewFormats = nullptr;
+  atlas.texture = wgpuDeviceCreateTexture(device, &textureDesc);
+  if (!atlas.texture) {
+    std::cerr << "Could not create atlas texture!" << std::endl;
+    return false;
+  }
+
+  // 2. Widok 2D array i sampler
+  WGPUTextureViewDescriptor viewDesc = {};
+  viewDesc.nextInChain = nullptr;
+  viewDesc.label = "Atlas Texture View";
+  viewDesc.format = WGPUTextureFormat_RGBA8Unorm;
+  viewDesc.dimension = WGPUTextureViewDimension_2DArray;
+  viewDesc.baseMipLevel = 0;
+  viewDesc.mipLevelCount = header.mipLevelCount;
+  viewDesc.baseArrayLayer = 0;
+  viewDesc.arrayLayerCount = header.pageCount;
+  viewDesc.aspect = WGPUTextureAspect_All;
+  atlas.view = wgpuTextureCreateView(atlas.texture, &viewDesc);
+
+  WGPUSamplerDescriptor samplerDesc = {};
+  samplerDesc.nextInChain = nullptr;
+  samplerDesc.label = "Atlas Sampler";
+  samplerDesc.addressModeU = WGPUAddressMode_ClampToEdge;
+  samplerDesc.addressModeV = WGPUAddressMode_ClampToEdge;
+  samplerDesc.addressModeW = WGPUAddressMode_ClampToEdge;
+  samplerDesc.magFilter = WGPUFilterMode_Linear;
+  samplerDesc.minFilter = WGPUFilterMode_Linear;
+  samplerDesc.mipmapFilter = WGPUMipmapFilterMode_Linear;
+  samplerDesc.lodMinClamp = 0.0f;
+  samplerDesc.lodMaxClamp = float(header.mipLevelCount);
+  samplerDesc.compare = WGPUCompareFunction_Undefined;
+  samplerDesc.maxAnisotropy = 1;
+  atlas.sampler = wgpuDeviceCreateSampler(device, &samplerDesc);
+
+  // 3. Tablica klatek dla vertex shadera
+  WGPUBufferDescriptor bufferDesc = {};
+  bufferDesc.nextInChain = nullptr;
+  bufferDesc.label = "Atlas Frames";
+  bufferDesc.usage = WGPUBufferUsage_Storage | WGPUBufferUsage_CopyDst;
+  bufferDesc.size = gpuFrames.size() * sizeof(AtlasGpuFrame);
+  bufferDesc.mappedAtCreation = false;
+  atlas.frameBuffer = wgpuDeviceCreateBuffer(device, &bufferDesc);
+  if (!atlas.view || !atlas.sampler || !atlas.frameBuffer) {
+    std::cerr << "Could not create atlas resources!" << std::endl;
+    releaseTextureAtlas(atlas);
+    return false;
+  }
+  wgpuQueueWriteBuffer(queue, atlas.frameBuffer, 0, gpuFrames.data(),
+                       bufferDesc.size);
+
+  // 4. Bind group (grupa 1 shadera sprite'ów)
+  WGPUBindGroupEntry entries[3] = {};
+  entries[0].binding = 0;
+  entries[0].textureView = atlas.view;
+  entries[1].binding = 1;
+  entries[1].sampler = atlas.sampler;
+  entries[2].binding = 2;
+  entries[2].buffer = atlas.frameBuffer;
+  entries[2].offset = 0;
+  entries[2].size = bufferDesc.size;
+
+  WGPUBindGroupDescriptor bindGroupDesc = {};
+  bindGroupDesc.nextInChain = nullptr;
+  bindGroupDesc.label = "Atlas Bind Group";
+  bindGroupDesc.layout = layout;
+  bindGroupDesc.entryCount = 3;
+  bindGroupDesc.entries = entries;
+  atlas.bindGroup = wgpuDeviceCreateBindGroup(device, &bindGroupDesc);
+  if (!atlas.bindGroup) {
+    std::cerr << "Could not create atlas bind group!" << std::endl;
+    releaseTextureAtlas(atlas);
+    return false;
+  }
+  return true;
+}
+
+uint64_t writeAtlasPixelRows(WGPUQueue queue, const TextureAtlas &atlas,
+                             const AtlasView &view, uint32_t page,
+                             uint32_t level, uint32_t firstRow,
+                             uint32_t rowCount) {
+  const AtlasFileHeader &header = *view.header;
+  const uint32_t size = std::max(header.pageSize >> level, 1u);
+  const uint64_t rowBytes = uint64_t(size) * 4;
+  const uint8_t *pixels = view.pixels + atlasLevelOffset(header, page, level) +
+                          firstRow * rowBytes;
+
+  WGPUImageCopyTexture destination = {};
+  destination.nextInChain = nullptr;
+  destination.texture = atlas.texture;
+  destination.mipLevel = level;
+  destination.origin = {0, firstRow, page};
+  destination.aspect = WGPUTextureAspect_All;
+
+  WGPUTextureDataLayout source = {};
+  source.nextInChain = nullptr;
+  source.offset = 0;
+  source.bytesPerRow = uint32_t(rowBytes);
+  source.rowsPerImage = rowCount;
+
+  const WGPUExtent3D extent = {size, rowCount, 1};
+  const uint64_t bytes = rowBytes * rowCount;
+  wgpuQueueWriteTexture(queue, &destination, pixels, bytes, &source, &extent);
+  return bytes;
+}
+
+bool uploadTextureAtlas(WGPUDevice device, WGPUQueue queue,
+                        WGPUBindGroupLayout layout, const AtlasView &view,
+                        TextureAtlas &atlas) {
+  const AtlasFileHeader &header = *view.header;
+  std::vector<AtlasGpuFrame> gpuFrames;
+  buildAtlasFrameTable(view, atlas, gpuFrames);
+  if (!createAtlasGpuResources(device, queue, layout, header, gpuFrames,
+                               atlas))
+    return false;
+
+  // Piksele prosto z pliku (jeden zapis na stronę i poziom mip)
+  for (uint32_t page = 0; page < header.pageCount; ++page) {
+    for (uint32_t level = 0; level < header.mipLevelCount; ++level) {
+      const uint32_t size = std::max(header.pageSize >> level, 1u);
+      writeAtlasPixelRows(queue, atlas, view, page, level, 0, size);
+    }
+  }
+  return true;
+}
+
+bool loadTextureAtlas(WGPUDevice device, WGPUQueue queue,
+                      WGPUBindGroupLayout layout, const char *path,
+                      TextureAtlas &atlas) {
+  MappedFile file;
+  if (!mapFile(path, file))
+    return false;
+
+  AtlasView view;
+  bool ok = parseAtlas(file.data, file.size, view) &&
+            uploadTextureAtlas(device, queue, layout, view, atlas);
+  // wgpuQueueWriteTexture kopiuje dane od razu — plik można odmapować
+  unmapFile(file);
+
+  if (ok)
+    std::cout << "Atlas loaded: " << path << " (" << atlas.frameCount
+              << " frames, " << atlas.pageCount << " pages "
+              << atlas.pageSize << "x" << atlas.pageSize << ")" << std::endl;
+  return ok;
+}
+
+bool createSolidTextureAtlas(WGPUDevice device, WGPUQueue queue,
+                             WGPUBindGroupLayout layout, TextureAtlas &atlas) {
+  AtlasImage image;
+  image.pageSize = 4;
+  image.pageCount = 1;
+  image.mipLevelCount = 1;
+  image.pixels.assign(atlasPageBytes(image.pageSize, 1), 255);
+  image.names = {'w', 'h', 'i', 't', 'e', '\0'};
+  AtlasFrame frame = {};
+  frame.nameOffset = 0;
+  frame.page = 0;
+  frame.width = frame.height = 4;
+  // Środek tekstury — filtrowanie nie wyjdzie poza biały obszar
+  frame.uvRect[0] = frame.uvRect[1] = 0.25f;
+  frame.uvRect[2] = frame.uvRect[3] = 0.75f;
+  image.frames.push_back(frame);
+
+  const std::vector<uint8_t> bytes = serializeAtlas(image);
+  AtlasView view;
+  return parseAtlas(bytes.data(), bytes.size(), view) &&
+         uploadTextureAtlas(device, queue, layout, view, atlas);
+}
+
+void releaseTextureAtlas(TextureAtlas &atlas) {
+  if (atlas.bindGroup)
+    wgpuBindGroupRelease(atlas.bindGroup);
+  if (atlas.frameBuffer)
+    wgpuBufferRelease(atlas.frameBuffer);
+  if (atlas.sampler)
+    wgpuSamplerRelease(atlas.sampler);
+  if (atlas.view)
+    wgpuTextureViewRelease(atlas.view);
+  if (atlas.texture)
+    wgpuTextureRelease(atlas.texture);
+  atlas = {};
+}
+
+uint32_t atlasFindFrame(const TextureAtlas &atlas, const std::string &name) {
+  auto it = atlas.frameByName.find(name);
+  return it != atlas.frameByName.end() ? it->second : kInvalidAtlasFrame;
+}
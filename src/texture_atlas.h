@@ -0,0 +1,74 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <webgpu/webgpu.h>
+
+#include "atlas_file.h"
+#include "pipeline_cache.h"
+
+// ============================================================
+//  Atlas na GPU
+// ============================================================
+
+// Klatka w buforze storage czytanym przez vertex shader (32 B, std430)
+struct AtlasGpuFrame {
+  float uvRect[4];
+  uint32_t page;
+  uint32_t padding[3];
+};
+static_assert(sizeof(AtlasGpuFrame) == 32, "AtlasGpuFrame layout");
+
+// Strony atlasu to warstwy jednej tekstury 2D array — cały atlas to jeden
+// bind group, niezależnie od liczby stron i sprite'ów
+struct TextureAtlas {
+  WGPUTexture texture = nullptr;
+  WGPUTextureView view = nullptr;
+  WGPUSampler sampler = nullptr;
+  WGPUBuffer frameBuffer = nullptr; // AtlasGpuFrame[frameCount]
+  WGPUBindGroup bindGroup = nullptr;
+  uint32_t pageSize = 0;
+  uint32_t pageCount = 0;
+  uint32_t frameCount = 0;
+  std::unordered_map<std::string, uint32_t> frameByName;
+  std::vector<uint32_t> framePages; // strona każdej klatki (klucze sortowania)
+};
+
+constexpr uint32_t kInvalidAtlasFrame = ~0u;
+
+// Grupa 1 shadera sprite'ów: tekstura (2D array), sampler, tablica klatek
+BindGroupLayoutDesc atlasBindGroupLayoutDesc();
+
+// Całość na raz: tabela klatek, zasoby GPU i wszystkie piksele
+bool uploadTextureAtlas(WGPUDevice device, WGPUQueue queue,
+                        WGPUBindGroupLayout layout, const AtlasView &view,
+                        TextureAtlas &atlas);
+// Mapuje plik .watl i przesyła go na GPU
+bool loadTextureAtlas(WGPUDevice device, WGPUQueue queue,
+                      WGPUBindGroupLayout layout, const char *path,
+                      TextureAtlas &atlas);
+// Etapy uploadTextureAtlas osobno — do wczytywania w tle (AssetManager):
+// tabela klatek i mapa nazw (CPU, dowolny wątek)...
+void buildAtlasFrameTable(const AtlasView &view, TextureAtlas &atlas,
+                          std::vector<AtlasGpuFrame> &gpuFrames);
+// ...tekstura, sampler, bufor klatek i bind group (bez pikseli)...
+bool createAtlasGpuResources(WGPUDevice device, WGPUQueue queue,
+                             WGPUBindGroupLayout layout,
+                             const AtlasFileHeader &header,
+                             const std::vector<AtlasGpuFrame> &gpuFrames,
+                             TextureAtlas &atlas);
+// ...i piksele w pasach wierszy [firstRow, firstRow + rowCount) poziomu mip
+// strony. Zwraca liczbę przesłanych bajtów.
+uint64_t writeAtlasPixelRows(WGPUQueue queue, const TextureAtlas &atlas,
+                             const AtlasView &view, uint32_t page,
+                             uint32_t level, uint32_t firstRow,
+                             uint32_t rowCount);
+
+// Atlas z jedną białą klatką — sprite'y bez tekstury rysowane kolorem tint
+bool createSolidTextureAtlas(WGPUDevice device, WGPUQueue queue,
+                             WGPUBindGroupLayout layout, TextureAtlas &atlas);
+void releaseTextureAtlas(TextureAtlas &atlas);
+
+uint32_t atlasFindFrame(const TextureAtlas &atlas, const std::string &name);
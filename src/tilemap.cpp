@@ -0,0 +1,257 @@
+#include "tilemap.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <string>
+
+#include "texture_atlas.h"
+
+// Paleta dla typów kafelków bez własnej klatki w atlasie (indeks = typ)
+static const uint32_t kTilePalette[] = {
+    packColor(0, 0, 0, 0),   packColor(26, 26, 72), packColor(88, 88, 120),
+    packColor(24, 52, 44),   packColor(72, 36, 40),
+};
+
+// Ciemniejszy odcień co drugiego kafelka (szachownica jak w tle bez mapy)
+static uint32_t checkerShade(uint32_t tint) {
+  const uint32_t r = (tint & 0xFF) * 13 / 16;
+  const uint32_t g = ((tint >> 8) & 0xFF) * 13 / 16;
+  const uint32_t b = ((tint >> 16) & 0xFF) * 13 / 16;
+  return r | (g << 8) | (b << 16) | (tint & 0xFF000000u);
+}
+constexpr uint32_t kTilePaletteSize =
+    sizeof(kTilePalette) / sizeof(kTilePalette[0]);
+
+bool loadTilemap(WGPUDevice device, const char *path,
+                 const TextureAtlas &atlas, Tilemap &tilemap) {
+  if (!mapFile(path, tilemap.file)) {
+    std::cerr << "Could not open map: " << path << std::endl;
+    return false;
+  }
+  if (!parseTilemap(tilemap.file.data, tilemap.file.size, tilemap.view)) {
+    std::cerr << "Invalid map: " << path << std::endl;
+    unmapFile(tilemap.file);
+    return false;
+  }
+
+  const TilemapFileHeader &header = *tilemap.view.header;
+  tilemap.device = device;
+  tilemap.chunkWorldSize = float(header.chunkSize) * header.tileSize;
+
+  tilemapSetAtlas(tilemap, atlas);
+
+  const size_t tilesPerChunk = size_t(header.chunkSize) * header.chunkSize;
+  tilemap.decodedTiles.resize(tilesPerChunk);
+  tilemap.bakedInstances.reserve(tilesPerChunk);
+
+  std::cout << "Map loaded: " << header.chunksX * header.chunkSize << "x"
+            << header.chunksY * header.chunkSize << " tiles, "
+            << header.chunksX * header.chunksY << " chunks of "
+            << header.chunkSize << "x" << header.chunkSize << std::endl;
+  return true;
+}
+
+void releaseTilemap(Tilemap &tilemap) {
+  for (auto &[index, chunk] : tilemap.resident)
+    if (chunk.buffer)
+      wgpuBufferRelease(chunk.buffer);
+  tilemap.resident.clear();
+  for (WGPUBuffer buffer : tilemap.freeBuffers)
+    wgpuBufferRelease(buffer);
+  tilemap.freeBuffers.clear();
+  tilemap.visible.clear();
+  unmapFile(tilemap.file);
+  tilemap.view = {};
+}
+
+// Bufory mają stały rozmiar (pełny chunk), więc każdy zwolniony pasuje
+// do każdego kolejnego chunku
+static WGPUBuffer acquireChunkBuffer(Tilemap &tilemap) {
+  if (!tilemap.freeBuffers.empty()) {
+    WGPUBuffer buffer = tilemap.freeBuffers.back();
+    tilemap.freeBuffers.pop_back();
+    return buffer;
+  }
+  WGPUBufferDescriptor desc = {};
+  desc.label = "Tile Chunk Instances";
+  desc.usage = WGPUBufferUsage_Vertex | WGPUBufferUsage_CopyDst;
+  desc.size = tilemap.decodedTiles.size() * sizeof(SpriteInstance);
+  desc.mappedAtCreation = false;
+  return wgpuDeviceCreateBuffer(tilemap.device, &desc);
+}
+
+static void releaseChunkBuffer(Tilemap &tilemap, WGPUBuffer buffer) {
+  if (!buffer)
+    return;
+  if (tilemap.freeBuffers.size() < tilemap.maxFreeBuffers)
+    tilemap.freeBuffers.push_back(buffer);
+  else
+    wgpuBufferRelease(buffer);
+}
+
+void tilemapSetAtlas(Tilemap &tilemap, const TextureAtlas &atlas) {
+  const uint32_t tileTypeCount = tilemap.view.header->tileTypeCount;
+  uint32_t fallbackFrame = atlasFindFrame(atlas, "floor");
+  if (fallbackFrame == kInvalidAtlasFrame)
+    fallbackFrame = atlasFindFrame(atlas, "white");
+  if (fallbackFrame == kInvalidAtlasFrame)
+    fallbackFrame = 0;
+  tilemap.tileFrames.assign(tileTypeCount, fallbackFrame);
+  tilemap.tileTints.assign(tileTypeCount, packColor(255, 255, 255));
+  for (uint32_t type = 1; type < tileTypeCount; ++type) {
+    const uint32_t frame =
+        atlasFindFrame(atlas, "tile_" + std::to_string(type));
+    if (frame != kInvalidAtlasFrame)
+      tilemap.tileFrames[type] = frame;
+    else if (type < kTilePaletteSize)
+      tilemap.tileTints[type] = kTilePalette[type];
+  }
+  tilemap.tileCheckerTints = tilemap.tileTints;
+  for (uint32_t type = 1; type < tileTypeCount; ++type)
+    if (tilemap.tileFrames[type] == fallbackFrame)
+      tilemap.tileCheckerTints[type] = checkerShade(tilemap.tileTints[type]);
+
+  // Załadowane chunki mają upieczone stare klatki — wczytają się ponownie
+  for (auto &[index, chunk] : tilemap.resident)
+    releaseChunkBuffer(tilemap, chunk.buffer);
+  tilemap.resident.clear();
+  tilemap.visible.clear();
+}
+
+// Dekoduje RLE chunku i piecze niepuste kafelki jako instancje sprite'ów
+static void loadChunk(WGPUQueue queue, Tilemap &tilemap, uint32_t cx,
+                      uint32_t cy) {
+  const TilemapFileHeader &header = *tilemap.view.header;
+  const uint32_t index = cy * header.chunksX + cx;
+  TileChunk chunk;
+  if (tilemap.view.chunks[index].tileCount > 0) {
+    decodeTilemapChunk(tilemap.view, index, tilemap.decodedTiles.data());
+
+    const float tileSize = header.tileSize;
+    const float originX = float(cx) * tilemap.chunkWorldSize;
+    const float originY = float(cy) * tilemap.chunkWorldSize;
+    tilemap.bakedInstances.clear();
+    for (uint32_t y = 0; y < header.chunkSize; ++y) {
+      for (uint32_t x = 0; x < header.chunkSize; ++x) {
+        const uint16_t tile = tilemap.decodedTiles[y * header.chunkSize + x];
+        if (tile == kEmptyTile || tile >= header.tileTypeCount)
+          continue;
+        SpriteInstance instance = {};
+        instance.position[0] = originX + (float(x) + 0.5f) * tileSize;
+        instance.position[1] = originY + (float(y) + 0.5f) * tileSize;
+        instance.scale[0] = instance.scale[1] = tileSize;
+        instance.atlasIndex = tilemap.tileFrames[tile];
+        instance.tint = (x + y) % 2 ? tilemap.tileCheckerTints[tile]
+                                    : tilemap.tileTints[tile];
+        tilemap.bakedInstances.push_back(instance);
+      }
+    }
+
+    chunk.instanceCount = uint32_t(tilemap.bakedInstances.size());
+    if (chunk.instanceCount > 0) {
+      chunk.buffer = acquireChunkBuffer(tilemap);
+      if (!chunk.buffer) {
+        // Bez bufora chunk nie jest rezydentny — kolejna klatka spróbuje
+        std::cerr << "Failed to create tile chunk buffer (" << cx << ", "
+                  << cy << ")" << std::endl;
+        return;
+      }
+      const size_t bytes = chunk.instanceCount * sizeof(SpriteInstance);
+      wgpuQueueWriteBuffer(queue, chunk.buffer, 0,
+                           tilemap.bakedInstances.data(), bytes);
+      tilemap.bytesUploaded += bytes;
+    }
+  }
+  tilemap.resident.emplace(index, chunk);
+  ++tilemap.chunkLoads;
+}
+
+// Zakres chunków [x0, x1] × [y0, y1] pokrywający prostokąt świata
+struct ChunkRange {
+  int32_t x0, y0, x1, y1;
+};
+
+static ChunkRange chunkRange(const Tilemap &tilemap, const CullRect &rect,
+                             int32_t margin) {
+  const TilemapFileHeader &header = *tilemap.view.header;
+  const float inv = 1.0f / tilemap.chunkWorldSize;
+  ChunkRange range;
+  range.x0 = std::max(int32_t(std::floor(rect.minX * inv)) - margin, 0);
+  range.y0 = std::max(int32_t(std::floor(rect.minY * inv)) - margin, 0);
+  range.x1 = std::min(int32_t(std::floor(rect.maxX * inv)) + margin,
+                      int32_t(header.chunksX) - 1);
+  range.y1 = std::min(int32_t(std::floor(rect.maxY * inv)) + margin,
+                      int32_t(header.chunksY) - 1);
+  return range;
+}
+
+static bool rangeContains(const ChunkRange &range, int32_t x, int32_t y) {
+  return x >= range.x0 && x <= range.x1 && y >= range.y0 && y <= range.y1;
+}
+
+void tilemapStream(WGPUQueue queue, Tilemap &tilemap, const CullRect &view) {
+  if (!tilemap.view.header)
+    return;
+  const uint32_t chunksX = tilemap.view.header->chunksX;
+  const ChunkRange visibleRange = chunkRange(tilemap, view, 0);
+  const ChunkRange preloadRange =
+      chunkRange(tilemap, view, int32_t(tilemap.preloadMargin));
+  const ChunkRange keepRange =
+      chunkRange(tilemap, view, int32_t(tilemap.unloadMargin));
+
+  // Zwolnij chunki poza otoczeniem widoku (bufory wracają do puli)
+  for (auto it = tilemap.resident.begin(); it != tilemap.resident.end();) {
+    const int32_t cx = int32_t(it->first % chunksX);
+    const int32_t cy = int32_t(it->first / chunksX);
+    if (rangeContains(keepRange, cx, cy)) {
+      ++it;
+      continue;
+    }
+    releaseChunkBuffer(tilemap, it->second.buffer);
+    it = tilemap.resident.erase(it);
+    ++tilemap.chunkUnloads;
+  }
+
+  // Widoczne: zawsze od razu (inaczej dziura w podłodze)
+  tilemap.visible.clear();
+  for (int32_t cy = visibleRange.y0; cy <= visibleRange.y1; ++cy) {
+    for (int32_t cx = visibleRange.x0; cx <= visibleRange.x1; ++cx) {
+      const uint32_t index = uint32_t(cy) * chunksX + uint32_t(cx);
+      if (!tilemap.resident.count(index))
+        loadChunk(queue, tilemap, uint32_t(cx), uint32_t(cy));
+      // find, nie operator[] — nieudany loadChunk nie może zostawić
+      // pustego wpisu, inaczej następna klatka nie spróbuje ponownie
+      auto it = tilemap.resident.find(index);
+      if (it != tilemap.resident.end() && it->second.instanceCount > 0)
+        tilemap.visible.push_back(index);
+    }
+  }
+
+  // Otoczenie: z wyprzedzeniem, z limitem na klatkę
+  uint32_t preloads = 0;
+  for (int32_t cy = preloadRange.y0;
+       cy <= preloadRange.y1 && preloads < tilemap.maxPreloadsPerFrame; ++cy) {
+    for (int32_t cx = preloadRange.x0;
+         cx <= preloadRange.x1 && preloads < tilemap.maxPreloadsPerFrame;
+         ++cx) {
+      const uint32_t index = uint32_t(cy) * chunksX + uint32_t(cx);
+      if (tilemap.resident.count(index))
+        continue;
+      loadChunk(queue, tilemap, uint32_t(cx), uint32_t(cy));
+      ++preloads;
+    }
+  }
+
+  tilemap.peakResident =
+      std::max(tilemap.peakResident, uint32_t(tilemap.resident.size()));
+}
+
+void tilemapDraw(WGPURenderPassEncoder pass, const Tilemap &tilemap,
+                 const SpriteBatch &batch) {
+  for (uint32_t index : tilemap.visible) {
+    const TileChunk &chunk = tilemap.resident.at(index);
+    spriteBatchDrawInstances(pass, batch, chunk.buffer, 0,
+                             chunk.instanceCount);
+  }
+}
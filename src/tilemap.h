@@ -0,0 +1,75 @@
+#pragma once
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+#include <webgpu/webgpu.h>
+
+#include "camera.h"
+#include "mapped_file.h"
+#include "sprite_batch.h"
+#include "tilemap_file.h"
+
+struct TextureAtlas;
+
+// ============================================================
+//  Chunki mapy na GPU
+// ============================================================
+
+// Chunk rezydentny: kafelki zapieczone raz (przy wczytaniu) do
+// niezmiennego bufora instancji sprite'ów. Pusty chunk nie ma bufora.
+struct TileChunk {
+  WGPUBuffer buffer = nullptr; // SpriteInstance[instanceCount], z puli
+  uint32_t instanceCount = 0;
+};
+
+// Mapa kafelkowa: plik .wmap zmapowany w pamięci, w pamięci GPU tylko
+// chunki w pobliżu kamery. Co klatkę nie jest budowany ani przesyłany
+// żaden kafelek — rysowanie to jeden draw call na widoczny chunk z jego
+// gotowego bufora (pipeline i atlas sprite'ów). Chunki są dekodowane i
+// przesyłane przy wejściu w otoczenie widoku, a zwalniane (bufor wraca
+// do puli) po oddaleniu się kamery.
+struct Tilemap {
+  WGPUDevice device = nullptr;
+  MappedFile file;
+  TilemapView view;
+  float chunkWorldSize = 0.0f; // chunkSize * tileSize
+  // Wygląd typu kafelka: klatka atlasu + kolor (kafelki bez własnej
+  // klatki co drugi ciemniejsze — szachownica)
+  std::vector<uint32_t> tileFrames;
+  std::vector<uint32_t> tileTints;
+  std::vector<uint32_t> tileCheckerTints;
+  std::unordered_map<uint32_t, TileChunk> resident; // indeks chunku → chunk
+  std::vector<uint32_t> visible; // rezydentne chunki w widoku (do rysowania)
+  std::vector<WGPUBuffer> freeBuffers; // pula buforów o stałym rozmiarze
+  std::vector<uint16_t> decodedTiles;  // scratch dekodowania chunku
+  std::vector<SpriteInstance> bakedInstances;
+  // Chunki wokół widoku ładowane z wyprzedzeniem (limit na klatkę);
+  // widoczne ładowane są zawsze od razu
+  uint32_t preloadMargin = 1;   // w chunkach
+  uint32_t maxPreloadsPerFrame = 4;
+  uint32_t unloadMargin = 2;    // chunki dalej niż to są zwalniane
+  uint32_t maxFreeBuffers = 16;
+  // Statystyki
+  uint64_t chunkLoads = 0;
+  uint64_t chunkUnloads = 0;
+  uint64_t bytesUploaded = 0;
+  uint32_t peakResident = 0;
+};
+
+// Mapuje plik .wmap i przypisuje typom kafelków klatki atlasu: "tile_<n>"
+// (bez barwienia), a gdy jej brak — "floor"/"white" z kolorem z palety
+bool loadTilemap(WGPUDevice device, const char *path,
+                 const TextureAtlas &atlas, Tilemap &tilemap);
+void releaseTilemap(Tilemap &tilemap);
+// Ponownie przypisuje klatki po podmianie atlasu (np. wczytanego w tle);
+// załadowane chunki wracają do puli i wczytają się przy następnym stream
+void tilemapSetAtlas(Tilemap &tilemap, const TextureAtlas &atlas);
+
+// Ładuje brakujące chunki widoku i otoczenia, zwalnia odległe i buduje
+// listę widocznych (wątek główny, przed submit)
+void tilemapStream(WGPUQueue queue, Tilemap &tilemap, const CullRect &view);
+// Jeden draw call na widoczny chunk pipeline'em i atlasem batcha. Bind
+// group kamery świata musi być już ustawiony.
+void tilemapDraw(WGPURenderPassEncoder pass, const Tilemap &tilemap,
+                 const SpriteBatch &batch);
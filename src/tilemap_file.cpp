@@ -0,0 +1,239 @@
+#include "tilemap_file.h"
+
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+
+// Pary RLE są po 2 × uint16
+constexpr uint64_t kRunBytes = 4;
+
+std::vector<uint8_t> serializeTilemap(const TilemapImage &image) {
+  const uint32_t chunkCount = image.chunksX * image.chunksY;
+  const uint32_t mapWidth = image.chunksX * image.chunkSize;
+
+  TilemapFileHeader header = {};
+  std::memcpy(header.magic, "WMAP", 4);
+  header.version = kTilemapFileVersion;
+  header.chunkSize = image.chunkSize;
+  header.chunksX = image.chunksX;
+  header.chunksY = image.chunksY;
+  header.tileSize = image.tileSize;
+  header.tileTypeCount = image.tileTypeCount;
+  header.chunksOffset = sizeof(TilemapFileHeader);
+
+  std::vector<TilemapChunkEntry> entries(chunkCount);
+  std::vector<uint16_t> runs;
+  for (uint32_t cy = 0; cy < image.chunksY; ++cy) {
+    for (uint32_t cx = 0; cx < image.chunksX; ++cx) {
+      TilemapChunkEntry &entry = entries[cy * image.chunksX + cx];
+      entry.offset = runs.size() * sizeof(uint16_t); // względny, niżej +baza
+      entry.tileCount = 0;
+      uint16_t current = 0;
+      uint32_t length = 0;
+      auto flush = [&]() {
+        if (length == 0)
+          return;
+        runs.push_back(uint16_t(length));
+        runs.push_back(current);
+        ++entry.runCount;
+        length = 0;
+      };
+      for (uint32_t y = 0; y < image.chunkSize; ++y) {
+        const uint16_t *row = image.tiles.data() +
+                              size_t(cy * image.chunkSize + y) * mapWidth +
+                              cx * image.chunkSize;
+        for (uint32_t x = 0; x < image.chunkSize; ++x) {
+          if (row[x] != kEmptyTile)
+            ++entry.tileCount;
+          if (length > 0 && (row[x] != current || length == 0xFFFF))
+            flush();
+          current = row[x];
+          ++length;
+        }
+      }
+      flush();
+    }
+  }
+
+  const uint64_t dataOffset =
+      header.chunksOffset + uint64_t(chunkCount) * sizeof(TilemapChunkEntry);
+  for (TilemapChunkEntry &entry : entries)
+    entry.offset += dataOffset;
+
+  std::vector<uint8_t> bytes(dataOffset + runs.size() * sizeof(uint16_t));
+  std::memcpy(bytes.data(), &header, sizeof(header));
+  std::memcpy(bytes.data() + header.chunksOffset, entries.data(),
+              entries.size() * sizeof(TilemapChunkEntry));
+  std::memcpy(bytes.data() + dataOffset, runs.data(),
+              runs.size() * sizeof(uint16_t));
+  return bytes;
+}
+
+bool writeTilemapFile(const char *path, const TilemapImage &image) {
+  const std::vector<uint8_t> bytes = serializeTilemap(image);
+  FILE *file = std::fopen(path, "wb");
+  if (!file) {
+    std::cerr << "Could not open map file for writing: " << path
+              << std::endl;
+    return false;
+  }
+  const bool ok = std::fwrite(bytes.data(), 1, bytes.size(), file) ==
+                  bytes.size();
+  std::fclose(file);
+  if (!ok)
+    std::cerr << "Failed to write map file: " << path << std::endl;
+  return ok;
+}
+
+// Zakres [offset, offset + bytes) mieści się w pliku (bez przepełnienia sumy)
+static bool rangeInFile(uint64_t offset, uint64_t bytes, size_t size) {
+  return offset <= size && bytes <= size - offset;
+}
+
+bool parseTilemap(const uint8_t *data, size_t size, TilemapView &view) {
+  if (size < sizeof(TilemapFileHeader)) {
+    std::cerr << "Map file too small" << std::endl;
+    return false;
+  }
+  const TilemapFileHeader *header =
+      reinterpret_cast<const TilemapFileHeader *>(data);
+  if (std::memcmp(header->magic, "WMAP", 4) != 0 ||
+      header->version != kTilemapFileVersion) {
+    std::cerr << "Not a WMAP map or unsupported version" << std::endl;
+    return false;
+  }
+
+  const uint64_t chunkCount = uint64_t(header->chunksX) * header->chunksY;
+  const uint64_t tilesPerChunk = uint64_t(header->chunkSize) *
+                                 header->chunkSize;
+  // Wymiary ograniczone, zanim ktokolwiek zaalokuje szerokość × wysokość
+  const bool validSize =
+      header->chunkSize != 0 && header->chunkSize <= kMaxTilemapChunkSize &&
+      chunkCount != 0 &&
+      uint64_t(header->chunksX) * header->chunkSize <= kMaxTilemapSide &&
+      uint64_t(header->chunksY) * header->chunkSize <= kMaxTilemapSide;
+  if (!validSize || !std::isfinite(header->tileSize) ||
+      header->tileSize <= 0.0f ||
+      header->chunksOffset % alignof(TilemapChunkEntry) != 0 ||
+      !rangeInFile(header->chunksOffset,
+                   chunkCount * sizeof(TilemapChunkEntry), size)) {
+    std::cerr << "Corrupted map file" << std::endl;
+    return false;
+  }
+  const TilemapChunkEntry *chunks = reinterpret_cast<const TilemapChunkEntry *>(
+      data + header->chunksOffset);
+  // Zakresy chunków i suma długości runów — dekodowanie nie musi
+  // niczego sprawdzać
+  for (uint64_t c = 0; c < chunkCount; ++c) {
+    const TilemapChunkEntry &entry = chunks[c];
+    if (entry.offset % 2 != 0 ||
+        !rangeInFile(entry.offset, uint64_t(entry.runCount) * kRunBytes,
+                     size) ||
+        entry.tileCount > tilesPerChunk) {
+      std::cerr << "Corrupted map chunk " << c << std::endl;
+      return false;
+    }
+    const uint16_t *runs =
+        reinterpret_cast<const uint16_t *>(data + entry.offset);
+    uint64_t total = 0;
+    for (uint32_t r = 0; r < entry.runCount; ++r)
+      total += runs[r * 2];
+    if (total != tilesPerChunk) {
+      std::cerr << "Corrupted map chunk " << c << std::endl;
+      return false;
+    }
+  }
+
+  view.header = header;
+  view.chunks = chunks;
+  view.data = data;
+  return true;
+}
+
+void decodeTilemapChunk(const TilemapView &view, uint32_t chunkIndex,
+                        uint16_t *tiles) {
+  const TilemapChunkEntry &entry = view.chunks[chunkIndex];
+  const uint16_t *runs =
+      reinterpret_cast<const uint16_t *>(view.data + entry.offset);
+  for (uint32_t r = 0; r < entry.runCount; ++r) {
+    const uint16_t length = runs[r * 2];
+    const uint16_t tile = runs[r * 2 + 1];
+    for (uint16_t i = 0; i < length; ++i)
+      *tiles++ = tile;
+  }
+}
+
+std::vector<uint8_t> tilemapBlockedMask(const TilemapView &view) {
+  const TilemapFileHeader &header = *view.header;
+  const uint32_t chunkSize = header.chunkSize;
+  const size_t width = size_t(header.chunksX) * chunkSize;
+  std::vector<uint8_t> mask(width * header.chunksY * chunkSize, 0);
+  std::vector<uint16_t> tiles(size_t(chunkSize) * chunkSize);
+  for (uint32_t cy = 0; cy < header.chunksY; ++cy) {
+    for (uint32_t cx = 0; cx < header.chunksX; ++cx) {
+      decodeTilemapChunk(view, cy * header.chunksX + cx, tiles.data());
+      for (uint32_t y = 0; y < chunkSize; ++y) {
+        uint8_t *row = &mask[(size_t(cy) * chunkSize + y) * width +
+                             size_t(cx) * chunkSize];
+        for (uint32_t x = 0; x < chunkSize; ++x)
+          row[x] = tileBlocksMovement(tiles[y * chunkSize + x]);
+      }
+    }
+  }
+  return mask;
+}
+
+// ============================================================
+//  Generator areny
+// ============================================================
+
+static uint32_t hashTile(uint32_t x, uint32_t y, uint32_t seed) {
+  uint32_t h = x * 374761393u + y * 668265263u + seed * 2246822519u;
+  h = (h ^ (h >> 13)) * 1274126177u;
+  return h ^ (h >> 16);
+}
+
+// Szum wartości na siatce co `cell` kafelków (0..1), interpolowany
+static float valueNoise(uint32_t x, uint32_t y, uint32_t cell, uint32_t seed) {
+  const uint32_t gx = x / cell, gy = y / cell;
+  const float fx = float(x % cell) / float(cell);
+  const float fy = float(y % cell) / float(cell);
+  auto corner = [&](uint32_t cx, uint32_t cy) {
+    return float(hashTile(cx, cy, seed) & 0xFFFF) / 65535.0f;
+  };
+  const float top = corner(gx, gy) + (corner(gx + 1, gy) - corner(gx, gy)) * fx;
+  const float bottom =
+      corner(gx, gy + 1) + (corner(gx + 1, gy + 1) - corner(gx, gy + 1)) * fx;
+  return top + (bottom - top) * fy;
+}
+
+TilemapImage generateArenaTilemap(uint32_t chunksX, uint32_t chunksY,
+                                  uint32_t chunkSize, float tileSize,
+                                  uint32_t seed) {
+  // Szachownica podłogi to tylko cieniowanie przy pieczeniu chunku — w
+  // danych długie runy jednego typu dobrze się kompresują.
+  TilemapImage image;
+  image.chunkSize = chunkSize;
+  image.chunksX = chunksX;
+  image.chunksY = chunksY;
+  image.tileSize = tileSize;
+  image.tileTypeCount = 5;
+
+  const uint32_t width = chunksX * chunkSize;
+  const uint32_t height = chunksY * chunkSize;
+  image.tiles.resize(size_t(width) * height);
+  for (uint32_t y = 0; y < height; ++y) {
+    for (uint32_t x = 0; x < width; ++x) {
+      uint16_t tile = kTileFloor;
+      if (x == 0 || y == 0 || x + 1 == width || y + 1 == height)
+        tile = kTileWall;
+      else if (valueNoise(x, y, 16, seed) > 0.72f)
+        tile = kTileGround;
+      else if (hashTile(x, y, seed + 1) % 97 == 0)
+        tile = kTileObstacle;
+      image.tiles[size_t(y) * width + x] = tile;
+    }
+  }
+  return image;
+}
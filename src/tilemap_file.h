@@ -0,0 +1,85 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// ============================================================
+//  Format pliku mapy (.wmap)
+// ============================================================
+
+// Mapa podzielona na kwadratowe chunki chunkSize × chunkSize kafelków.
+// Po nagłówku tablica wpisów chunków (wiersz po wierszu), potem dane
+// chunków: pary RLE (liczba, kafelek) po uint16. Kafelek 0 = pusty.
+// Runtime mapuje plik i dekoduje tylko chunki w pobliżu kamery.
+// Wszystkie liczby w little-endian.
+constexpr uint32_t kTilemapFileVersion = 1;
+constexpr uint16_t kEmptyTile = 0;
+// Granice sprawdzane przy wczytaniu: chunk to jeden bufor instancji, a
+// maska kolizji i pole przepływu alokują całą mapę (szerokość × wysokość)
+constexpr uint32_t kMaxTilemapChunkSize = 256;
+constexpr uint32_t kMaxTilemapSide = 4096; // kafelki na bok mapy
+
+// Typy kafelków areny (generateArenaTilemap)
+constexpr uint16_t kTileFloor = 1;
+constexpr uint16_t kTileWall = 2;
+constexpr uint16_t kTileGround = 3; // inne podłoże (przechodnie)
+constexpr uint16_t kTileObstacle = 4;
+
+inline bool tileBlocksMovement(uint16_t tile) {
+  return tile == kTileWall || tile == kTileObstacle;
+}
+
+struct TilemapFileHeader {
+  char magic[4]; // "WMAP"
+  uint32_t version;
+  uint32_t chunkSize; // kafelki na bok chunku
+  uint32_t chunksX;
+  uint32_t chunksY;
+  float tileSize;         // rozmiar kafelka w jednostkach świata
+  uint32_t tileTypeCount; // kafelki 1..tileTypeCount-1
+  uint32_t reserved;
+  uint64_t chunksOffset; // TilemapChunkEntry[chunksX * chunksY]
+};
+static_assert(sizeof(TilemapFileHeader) == 40, "TilemapFileHeader layout");
+
+struct TilemapChunkEntry {
+  uint64_t offset;    // pary RLE od początku pliku
+  uint32_t runCount;  // liczba par (liczba, kafelek)
+  uint32_t tileCount; // niepuste kafelki (rozmiar bufora instancji)
+};
+static_assert(sizeof(TilemapChunkEntry) == 16, "TilemapChunkEntry layout");
+
+// Mapa w pamięci (wyjście generatora) — kafelki całej mapy wiersz po wierszu
+struct TilemapImage {
+  uint32_t chunkSize = 32;
+  uint32_t chunksX = 0;
+  uint32_t chunksY = 0;
+  float tileSize = 32.0f;
+  uint32_t tileTypeCount = 0;
+  std::vector<uint16_t> tiles; // (chunksX * chunkSize) × (chunksY * chunkSize)
+};
+
+// Widok na sparsowaną mapę (wskaźniki do pliku zmapowanego lub bufora)
+struct TilemapView {
+  const TilemapFileHeader *header = nullptr;
+  const TilemapChunkEntry *chunks = nullptr;
+  const uint8_t *data = nullptr;
+};
+
+std::vector<uint8_t> serializeTilemap(const TilemapImage &image);
+bool writeTilemapFile(const char *path, const TilemapImage &image);
+// Sprawdza nagłówek i zakresy wszystkich chunków; view wskazuje do data
+bool parseTilemap(const uint8_t *data, size_t size, TilemapView &view);
+// Dekoduje chunk do tiles[chunkSize * chunkSize] (wiersz po wierszu)
+void decodeTilemapChunk(const TilemapView &view, uint32_t chunkIndex,
+                        uint16_t *tiles);
+
+// Maska całej mapy (wiersz po wierszu): 1 = kafelek blokuje ruch
+std::vector<uint8_t> tilemapBlockedMask(const TilemapView &view);
+
+// Proceduralna arena: ściany na brzegu, podłoga, plamy innego podłoża i
+// pojedyncze przeszkody (deterministycznie z seed)
+TilemapImage generateArenaTilemap(uint32_t chunksX, uint32_t chunksY,
+                                  uint32_t chunkSize, float tileSize,
+                                  uint32_t seed);
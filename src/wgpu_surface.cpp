@@ -6,6 +6,8 @@
 #define GLFW_EXPOSE_NATIVE_COCOA
 #elif defined(_WIN32)
 #define GLFW_EXPOSE_NATIVE_WIN32
+#elif defined(__linux__)
+#define GLFW_EXPOSE_NATIVE_X11
 #endif
 
 #include <GLFW/glfw3native.h>
@@ -47,8 +49,39 @@ WGPUSurface createSurfaceForWindow(WGPUInstance instance, GLFWwindow *window) {
 
   return wgpuInstanceCreateSurface(instance, &surfDesc);
 
+#elif defined(__linux__)
+  // --- Linux: Vulkan/GL backend (X11) ---
+  WGPUSurfaceDescriptorFromXlibWindow x11Desc = {};
+  x11Desc.chain.next = nullptr;
+  x11Desc.chain.sType = WGPUSType_SurfaceDescriptorFromXlibWindow;
+  x11Desc.display = (void *)glfwGetX11Display();
+  x11Desc.window = (uint64_t)glfwGetX11Window(window);
+
+  WGPUSurfaceDescriptor surfDesc = {};
+  surfDesc.nextInChain = &x11Desc.chain;
+  surfDesc.label = "WarpEngine Surface (Linux X11)";
+
+  return wgpuInstanceCreateSurface(instance, &surfDesc);
+
 #else
 #error "Unsupported platform for surface creation"
   return nullptr;
 #endif
 }
+
+WGPUPresentMode choosePresentMode(WGPUSurface surface, WGPUAdapter adapter,
+                                  WGPUPresentMode requested) {
+  if (requested == WGPUPresentMode_Fifo)
+    return requested;
+
+  WGPUSurfaceCapabilities caps = {};
+  caps.nextInChain = nullptr;
+  wgpuSurfaceGetCapabilities(surface, adapter, &caps);
+
+  bool supported = false;
+  for (size_t i = 0; i < caps.presentModeCount; ++i)
+    supported = supported || caps.presentModes[i] == requested;
+  wgpuSurfaceCapabilitiesFreeMembers(caps);
+
+  return supported ? requested : WGPUPresentMode_Fifo;
+}
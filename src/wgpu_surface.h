@@ -4,5 +4,11 @@
 
 struct GLFWwindow;
 
-// Creates a WGPUSurface from a GLFW window (cross-platform: macOS + Windows)
+// Creates a WGPUSurface from a GLFW window (cross-platform: macOS + Windows +
+// Linux/X11)
 WGPUSurface createSurfaceForWindow(WGPUInstance instance, GLFWwindow *window);
+
+// Returns `requested` if the surface advertises it for this adapter,
+// otherwise falls back to Fifo (always supported)
+WGPUPresentMode choosePresentMode(WGPUSurface surface, WGPUAdapter adapter,
+                                  WGPUPresentMode requested);
@@ -0,0 +1,422 @@
+#include "world_snapshot.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+
+#include "profiler.h"
+
+// ============================================================
+//  Zrzut świata
+// ============================================================
+
+static WorldSnapshotHeader makeHeader(const EntityStore &entities,
+                                      uint64_t tick, uint32_t rngState) {
+  WorldSnapshotHeader header = {};
+  std::memcpy(header.magic, "WSNP", 4);
+  header.version = kWorldSnapshotVersion;
+  header.tick = tick;
+  header.rngState = rngState;
+  header.storeBytes = entities.snapshotSize();
+  return header;
+}
+
+void captureWorldSnapshot(const EntityStore &entities, uint64_t tick,
+                          uint32_t rngState, std::vector<uint8_t> &out) {
+  const WorldSnapshotHeader header = makeHeader(entities, tick, rngState);
+  // Ten sam rozmiar co poprzednio: resize bez zerowania
+  out.resize(sizeof(header) + header.storeBytes);
+  std::memcpy(out.data(), &header, sizeof(header));
+  entities.writeSnapshot(out.data() + sizeof(header));
+}
+
+bool restoreWorldSnapshot(const uint8_t *data, size_t size,
+                          EntityStore &entities, uint64_t &tick,
+                          uint32_t &rngState) {
+  if (size < sizeof(WorldSnapshotHeader)) {
+    std::cerr << "World snapshot too small" << std::endl;
+    return false;
+  }
+  WorldSnapshotHeader header;
+  std::memcpy(&header, data, sizeof(header));
+  if (std::memcmp(header.magic, "WSNP", 4) != 0 ||
+      header.version != kWorldSnapshotVersion) {
+    std::cerr << "Not a WSNP snapshot or unsupported version" << std::endl;
+    return false;
+  }
+  if (header.storeBytes != size - sizeof(header) ||
+      !entities.readSnapshot(data + sizeof(header), size - sizeof(header))) {
+    std::cerr << "Corrupted world snapshot" << std::endl;
+    return false;
+  }
+  tick = header.tick;
+  rngState = header.rngState;
+  return true;
+}
+
+bool writeWorldSnapshotFile(const char *path,
+                            const std::vector<uint8_t> &snapshot) {
+  FILE *file = std::fopen(path, "wb");
+  if (!file) {
+    std::cerr << "Could not open snapshot file for writing: " << path
+              << std::endl;
+    return false;
+  }
+  const bool ok = std::fwrite(snapshot.data(), 1, snapshot.size(), file) ==
+                  snapshot.size();
+  std::fclose(file);
+  if (!ok)
+    std::cerr << "Failed to write snapshot file: " << path << std::endl;
+  return ok;
+}
+
+bool readWorldSnapshotFile(const char *path, std::vector<uint8_t> &snapshot) {
+  FILE *file = std::fopen(path, "rb");
+  if (!file) {
+    std::cerr << "Could not open snapshot file: " << path << std::endl;
+    return false;
+  }
+  std::fseek(file, 0, SEEK_END);
+  const long size = std::ftell(file);
+  std::fseek(file, 0, SEEK_SET);
+  bool ok = size > 0;
+  if (ok) {
+    snapshot.resize(size_t(size));
+    ok = std::fread(snapshot.data(), 1, snapshot.size(), file) ==
+         snapshot.size();
+  }
+  std::fclose(file);
+  if (!ok)
+    std::cerr << "Failed to read snapshot file: " << path << std::endl;
+  return ok;
+}
+
+// ============================================================
+//  Kompresja delta
+// ============================================================
+
+static uint64_t loadWord(const uint8_t *bytes, size_t word) {
+  uint64_t value;
+  std::memcpy(&value, bytes + word * 8, 8);
+  return value;
+}
+
+static void storeWord(uint8_t *bytes, size_t word, uint64_t value) {
+  std::memcpy(bytes + word * 8, &value, 8);
+}
+
+// Najgorzej: serie dosłowne po jednym słowie rozdzielone dwoma zerami
+static size_t snapshotDeltaBound(size_t snapshotSize) {
+  const size_t words = snapshotSize / 8;
+  return 8 + words * 8 + (words / 3 + 2) * 8;
+}
+
+// Koder delty w jednym przejściu po sekcjach zrzutu: każde słowo jest
+// porównywane z bazą (poprzednim zrzutem) i od razu w niej zapisywane,
+// tylko gdy się zmieniło — baza staje się nowym zrzutem bez osobnej kopii
+// i bez ponownego czytania go przez koder.
+class DeltaStream {
+public:
+  DeltaStream(uint8_t *base, bool keyframe, uint8_t *out)
+      : m_base(base), m_keyframe(keyframe), m_start(out), m_out(out + 8) {}
+
+  void section(const void *data, size_t usedBytes, size_t sectionBytes) {
+    const uint8_t *bytes = static_cast<const uint8_t *>(data);
+    const size_t fullWords = usedBytes / 8;
+    for (size_t w = 0; w < fullWords; ++w)
+      put(loadWord(bytes, w));
+    size_t w = fullWords;
+    if (usedBytes % 8 != 0) {
+      uint64_t value = 0;
+      std::memcpy(&value, bytes + fullWords * 8, usedBytes % 8);
+      put(value);
+      ++w;
+    }
+    for (; w < sectionBytes / 8; ++w)
+      put(0);
+  }
+
+  // Zamyka ostatnią serię; zwraca rozmiar delty
+  size_t finish() {
+    if (m_inLiteral) {
+      const bool pendingZero = m_pendingZero;
+      closeLiteral();
+      m_zeros = pendingZero ? 1 : 0;
+    }
+    if (m_zeros > 0) {
+      const uint32_t pair[2] = {uint32_t(m_zeros), 0};
+      std::memcpy(m_out, pair, sizeof(pair));
+      m_out += sizeof(pair);
+    }
+    const uint64_t targetSize = m_word * 8;
+    std::memcpy(m_start, &targetSize, 8);
+    return size_t(m_out - m_start);
+  }
+
+private:
+  void put(uint64_t value) {
+    const uint64_t old = loadWord(m_base, m_word);
+    if (value != old)
+      storeWord(m_base, m_word, value);
+    ++m_word;
+    const uint64_t delta = m_keyframe ? value : value ^ old;
+    if (delta == 0) {
+      if (!m_inLiteral) {
+        ++m_zeros;
+      } else if (m_pendingZero) {
+        // Dwa zera kończą serię dosłowną; pojedyncze taniej zapisać
+        // dosłownie niż otwierać nową parę
+        closeLiteral();
+        m_zeros = 2;
+      } else {
+        m_pendingZero = true;
+      }
+      return;
+    }
+    if (!m_inLiteral) {
+      m_pair = m_out;
+      m_out += 8;
+      m_pairZeros = m_zeros;
+      m_zeros = 0;
+      m_literals = 0;
+      m_inLiteral = true;
+    } else if (m_pendingZero) {
+      storeWord(m_out, 0, 0);
+      m_out += 8;
+      ++m_literals;
+      m_pendingZero = false;
+    }
+    storeWord(m_out, 0, delta);
+    m_out += 8;
+    ++m_literals;
+  }
+
+  void closeLiteral() {
+    const uint32_t pair[2] = {uint32_t(m_pairZeros), uint32_t(m_literals)};
+    std::memcpy(m_pair, pair, sizeof(pair));
+    m_inLiteral = false;
+    m_pendingZero = false;
+  }
+
+  uint8_t *m_base;
+  bool m_keyframe;
+  uint8_t *m_start;
+  uint8_t *m_out;
+  size_t m_word = 0;
+  size_t m_zeros = 0; // bieżąca seria zer
+  bool m_inLiteral = false;
+  bool m_pendingZero = false; // zero po serii dosłownej (może ją kończyć)
+  uint8_t *m_pair = nullptr;  // para otwartej serii dosłownej
+  size_t m_pairZeros = 0;
+  size_t m_literals = 0;
+};
+
+bool snapshotDeltaDecode(const uint8_t *previous, size_t previousSize,
+                         const uint8_t *delta, size_t deltaSize,
+                         std::vector<uint8_t> &out) {
+  uint64_t targetSize;
+  if (deltaSize < 8)
+    return false;
+  std::memcpy(&targetSize, delta, 8);
+  if (targetSize % 8 != 0)
+    return false;
+  out.resize(size_t(targetSize));
+
+  const size_t words = size_t(targetSize / 8);
+  const size_t previousWords = std::min(previousSize / 8, words);
+  const uint8_t *cursor = delta + 8;
+  const uint8_t *end = delta + deltaSize;
+  size_t i = 0;
+  while (cursor != end) {
+    uint32_t pair[2];
+    if (size_t(end - cursor) < sizeof(pair))
+      return false;
+    std::memcpy(pair, cursor, sizeof(pair));
+    cursor += sizeof(pair);
+    const size_t zeros = pair[0];
+    const size_t literals = pair[1];
+    if (zeros > words - i || literals > words - i - zeros ||
+        literals > size_t(end - cursor) / 8)
+      return false;
+
+    // Zero w delcie = słowo poprzednika (za jego końcem zero)
+    const size_t copied =
+        i < previousWords ? std::min(zeros, previousWords - i) : 0;
+    if (copied)
+      std::memcpy(out.data() + i * 8, previous + i * 8, copied * 8);
+    std::memset(out.data() + (i + copied) * 8, 0, (zeros - copied) * 8);
+    i += zeros;
+    for (size_t l = 0; l < literals; ++l, ++i) {
+      uint64_t value = loadWord(cursor, l);
+      if (i < previousWords)
+        value ^= loadWord(previous, i);
+      std::memcpy(out.data() + i * 8, &value, 8);
+    }
+    cursor += literals * 8;
+  }
+  return i == words;
+}
+
+// ============================================================
+//  SnapshotRing
+// ============================================================
+
+SnapshotRing::SnapshotRing(uint64_t maxTicks, size_t budgetBytes,
+                           uint32_t keyframeInterval)
+    : m_maxTicks(std::max<uint64_t>(maxTicks, 1)), m_budgetBytes(budgetBytes),
+      m_keyframeInterval(std::max(keyframeInterval, 1u)),
+      // Bez zerowania — strony dostaje dopiero pierwszy zapis
+      m_storage(new uint8_t[budgetBytes]) {}
+
+uint64_t SnapshotRing::oldestTick() const {
+  return m_entries.empty() ? 0 : m_entries.front().tick;
+}
+
+uint64_t SnapshotRing::newestTick() const {
+  return m_entries.empty() ? 0 : m_entries.back().tick;
+}
+
+void SnapshotRing::evictOldestGroup() {
+  do {
+    m_storedBytes -= m_entries.front().size;
+    m_entries.pop_front();
+    ++m_stats.evicted;
+  } while (!m_entries.empty() && !m_entries.front().keyframe);
+}
+
+size_t SnapshotRing::reserve(size_t size) {
+  // Za mało miejsca do końca bufora: od początku, a reszta końca przepada
+  const bool wrap = m_head + size > m_budgetBytes;
+  const size_t offset = wrap ? 0 : m_head;
+  // Najstarsze wpisy leżą tuż za m_head, więc wypierane są od przodu kolejki
+  auto claimed = [&](const Entry &entry) {
+    const size_t end = entry.offset + entry.size;
+    if (wrap)
+      return end > m_head || entry.offset < size;
+    return entry.offset < offset + size && end > offset;
+  };
+  while (!m_entries.empty() && claimed(m_entries.front()))
+    evictOldestGroup();
+  m_head = offset + size;
+  return offset;
+}
+
+void SnapshotRing::capture(const EntityStore &entities, uint64_t tick,
+                           uint32_t rngState) {
+  WARP_PROFILE_SCOPE("Snapshot");
+  const uint64_t startNs = profilerNowNs();
+  const WorldSnapshotHeader header = makeHeader(entities, tick, rngState);
+  const size_t snapshotSize = sizeof(header) + header.storeBytes;
+
+  bool keyframe =
+      m_entries.empty() || m_sinceKeyframe + 1 >= m_keyframeInterval;
+  // Zmiana układu (nowy chunk, archetyp, rekordy): baza przycięta albo
+  // dopełniona zerami, jak poprzednik w snapshotDeltaDecode. Bufory
+  // robocze tylko rosną — w stałym rytmie bez alokacji i zerowania.
+  m_previous.resize(snapshotSize);
+  const size_t bound = snapshotDeltaBound(snapshotSize);
+  if (m_encoded.size() < bound)
+    m_encoded.resize(bound);
+  DeltaStream stream(m_previous.data(), keyframe, m_encoded.data());
+  stream.section(&header, sizeof(header), sizeof(header));
+  entities.forEachSnapshotSection(
+      [&stream](const void *data, size_t usedBytes, size_t sectionBytes) {
+        stream.section(data, usedBytes, sectionBytes);
+      });
+  size_t encodedSize = stream.finish();
+
+  size_t offset = 0;
+  if (encodedSize <= m_budgetBytes) {
+    offset = reserve(encodedSize);
+    if (!keyframe && m_entries.empty()) {
+      // Wyparta została cała historia — delta nie ma już poprzednika,
+      // więc zrzut (jest już w bazie) zapisywany jest jako kluczowy
+      keyframe = true;
+      DeltaStream keyStream(m_previous.data(), true, m_encoded.data());
+      keyStream.section(m_previous.data(), snapshotSize, snapshotSize);
+      encodedSize = keyStream.finish();
+      m_head = 0;
+      offset = encodedSize <= m_budgetBytes ? reserve(encodedSize) : 0;
+    }
+  }
+  if (encodedSize > m_budgetBytes) {
+    // Zrzut nie mieści się w budżecie: historia zaczyna się od nowa
+    while (!m_entries.empty())
+      evictOldestGroup();
+    m_head = 0;
+    ++m_stats.skipped;
+  } else {
+    std::memcpy(m_storage.get() + offset, m_encoded.data(), encodedSize);
+    Entry entry;
+    entry.tick = tick;
+    entry.offset = offset;
+    entry.size = encodedSize;
+    entry.keyframe = keyframe;
+    m_entries.push_back(entry);
+    m_storedBytes += encodedSize;
+    m_sinceKeyframe = keyframe ? 0 : m_sinceKeyframe + 1;
+    m_stats.keyframes += keyframe ? 1 : 0;
+  }
+
+  // Wiek: najstarsza grupa odpada, gdy bez niej pierścień nadal pokrywa
+  // maxTicks
+  while (!m_entries.empty()) {
+    size_t nextGroup = 1;
+    while (nextGroup < m_entries.size() && !m_entries[nextGroup].keyframe)
+      ++nextGroup;
+    if (nextGroup == m_entries.size() ||
+        m_entries.back().tick - m_entries[nextGroup].tick < m_maxTicks)
+      break;
+    evictOldestGroup();
+  }
+
+  const double captureMs = double(profilerNowNs() - startNs) * 1e-6;
+  ++m_stats.captures;
+  m_stats.rawBytes += snapshotSize;
+  m_stats.encodedBytes += encodedSize;
+  m_stats.totalCaptureMs += captureMs;
+  m_stats.maxCaptureMs = std::max(m_stats.maxCaptureMs, captureMs);
+}
+
+bool SnapshotRing::rewind(uint64_t tick, EntityStore &entities,
+                          uint64_t &restoredTick, uint32_t &rngState) {
+  WARP_PROFILE_SCOPE("Snapshot Rewind");
+  size_t target = m_entries.size();
+  while (target > 0 && m_entries[target - 1].tick > tick)
+    --target;
+  if (target == 0)
+    return false;
+  --target;
+  size_t keyframe = target;
+  while (!m_entries[keyframe].keyframe)
+    --keyframe;
+
+  // Łańcuch delt od zrzutu kluczowego; baza (m_previous) zostaje
+  // nietknięta, dopóki przywrócenie się nie powiedzie
+  const Entry &first = m_entries[keyframe];
+  if (!snapshotDeltaDecode(nullptr, 0, m_storage.get() + first.offset,
+                           first.size, m_current))
+    return false;
+  for (size_t e = keyframe + 1; e <= target; ++e) {
+    const Entry &entry = m_entries[e];
+    if (!snapshotDeltaDecode(m_current.data(), m_current.size(),
+                             m_storage.get() + entry.offset, entry.size,
+                             m_decoded))
+      return false;
+    m_current.swap(m_decoded);
+  }
+  if (!restoreWorldSnapshot(m_current.data(), m_current.size(), entities,
+                            restoredTick, rngState))
+    return false;
+
+  while (m_entries.size() > target + 1) {
+    m_storedBytes -= m_entries.back().size;
+    m_entries.pop_back();
+  }
+  m_head = m_entries.back().offset + m_entries.back().size;
+  m_sinceKeyframe = uint32_t(target - keyframe);
+  m_previous.swap(m_current);
+  ++m_stats.restores;
+  return true;
+}
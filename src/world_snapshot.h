@@ -0,0 +1,129 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <vector>
+
+#include "entity_store.h"
+
+// ============================================================
+//  Zrzut świata (.wsnp)
+// ============================================================
+
+// Nagłówek, a po nim zrzut EntityStore (EntityStore::writeSnapshot).
+// Zapis to kopie całych kolumn chunków, bez przetwarzania per encja.
+// Wszystkie liczby w little-endian; rozmiar całości to wielokrotność 8.
+constexpr uint32_t kWorldSnapshotVersion = 1;
+
+struct WorldSnapshotHeader {
+  char magic[4]; // "WSNP"
+  uint32_t version;
+  uint64_t tick;     // numer ticku symulacji po zrzucie
+  uint32_t rngState; // stan losowania zdarzeń (powtórka deterministyczna)
+  uint32_t reserved;
+  uint64_t storeBytes; // rozmiar zrzutu EntityStore po nagłówku
+};
+static_assert(sizeof(WorldSnapshotHeader) == 32, "WorldSnapshotHeader layout");
+
+// Zrzut do out (bufor używany ponownie — bez alokacji w stałym rytmie)
+void captureWorldSnapshot(const EntityStore &entities, uint64_t tick,
+                          uint32_t rngState, std::vector<uint8_t> &out);
+// Sprawdza nagłówek i odtwarza magazyn; false (świat bez zmian) przy błędzie
+bool restoreWorldSnapshot(const uint8_t *data, size_t size,
+                          EntityStore &entities, uint64_t &tick,
+                          uint32_t &rngState);
+
+bool writeWorldSnapshotFile(const char *path,
+                            const std::vector<uint8_t> &snapshot);
+bool readWorldSnapshotFile(const char *path, std::vector<uint8_t> &snapshot);
+
+// ============================================================
+//  Kompresja delta
+// ============================================================
+
+// Delta = XOR zrzutu z poprzednim (brakujące bajty poprzedniego to zera)
+// zapisany jako RLE słów 64-bitowych: po rozmiarze celu (uint64) pary
+// uint32 (zerowe słowa, słowa dosłowne), a za każdą parą słowa dosłowne.
+// Niezmienione kolumny i wyzerowane końcówki chunków to długie serie zer.
+// Delta względem pustego poprzednika to zwykła kompresja RLE zrzutu.
+// Koduje SnapshotRing::capture (prosto z kolumn EntityStore).
+// Odtwarza zrzut do out; false przy uszkodzonej delcie
+bool snapshotDeltaDecode(const uint8_t *previous, size_t previousSize,
+                         const uint8_t *delta, size_t deltaSize,
+                         std::vector<uint8_t> &out);
+
+// ============================================================
+//  Pierścień zrzutów
+// ============================================================
+
+struct SnapshotRingStats {
+  uint64_t captures = 0;
+  uint64_t keyframes = 0;
+  uint64_t evicted = 0; // wpisy usunięte (wiek lub miejsce w buforze)
+  uint64_t skipped = 0; // zrzuty większe niż cały budżet
+  uint64_t restores = 0;
+  uint64_t rawBytes = 0; // suma rozmiarów zrzutów przed kompresją
+  uint64_t encodedBytes = 0;
+  double totalCaptureMs = 0.0; // zrzut + kompresja
+  double maxCaptureMs = 0.0;
+};
+
+// Ostatnie maxTicks ticków w stałym budżecie pamięci: co keyframeInterval
+// zrzut jest kluczowy (delta względem pustego), pozostałe to delty względem
+// poprzedniego ticku. Delty leżą jedna za drugą w buforze kołowym o
+// rozmiarze budżetu (alokowanym raz), a nowa delta wypiera najstarsze.
+// Odtworzenie ticku dekoduje łańcuch od jego zrzutu kluczowego, więc
+// wpisy są usuwane całymi grupami (zrzut kluczowy + jego delty); gdy
+// wyparta zostaje ostatnia grupa, nowy zrzut staje się kluczowym.
+// Nie jest thread-safe.
+class SnapshotRing {
+public:
+  SnapshotRing(uint64_t maxTicks, size_t budgetBytes,
+               uint32_t keyframeInterval = 64);
+
+  // Zrzut świata po ticku `tick` (ticki rosnące)
+  void capture(const EntityStore &entities, uint64_t tick, uint32_t rngState);
+  // Przywraca najnowszy zapisany tick <= tick i usuwa nowsze wpisy (kolejne
+  // zrzuty kontynuują od przywróconego stanu). false, gdy brak takiego ticku.
+  bool rewind(uint64_t tick, EntityStore &entities, uint64_t &restoredTick,
+              uint32_t &rngState);
+
+  // Ostatni zrzut przed kompresją (zapis do pliku)
+  const std::vector<uint8_t> &latest() const { return m_previous; }
+  bool empty() const { return m_entries.empty(); }
+  uint64_t oldestTick() const;
+  uint64_t newestTick() const;
+  size_t entryCount() const { return m_entries.size(); }
+  size_t storedBytes() const { return m_storedBytes; }
+  size_t budgetBytes() const { return m_budgetBytes; }
+  const SnapshotRingStats &stats() const { return m_stats; }
+
+private:
+  struct Entry {
+    uint64_t tick = 0;
+    size_t offset = 0; // w m_storage
+    size_t size = 0;
+    bool keyframe = false;
+  };
+
+  // Miejsce na size bajtów za ostatnim wpisem (albo od początku bufora);
+  // wypiera grupy, które na nie zachodzą. Zwraca offset.
+  size_t reserve(size_t size);
+  void evictOldestGroup();
+
+  uint64_t m_maxTicks;
+  size_t m_budgetBytes;
+  uint32_t m_keyframeInterval;
+  uint32_t m_sinceKeyframe = 0;
+  std::unique_ptr<uint8_t[]> m_storage;
+  size_t m_head = 0; // koniec najnowszego wpisu
+  std::deque<Entry> m_entries;
+  size_t m_storedBytes = 0;
+  std::vector<uint8_t> m_previous; // ostatni zrzut (baza następnej delty)
+  std::vector<uint8_t> m_current;  // bufory robocze łańcucha delt
+  std::vector<uint8_t> m_decoded;
+  std::vector<uint8_t> m_encoded; // bufor roboczy kompresji (tylko rośnie)
+  SnapshotRingStats m_stats;
+};
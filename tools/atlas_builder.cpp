@@ -0,0 +1,227 @@
+// WarpAtlas — etap potoku assetów: pakuje luźne klatki PNG w strony atlasu
+// i zapisuje binarny plik .watl wczytywany przez silnik bez dekodowania.
+//
+//   WarpAtlas -o sprites.watl [--page 2048] [--padding 4] [--mips 3]
+//             <plik.png | katalog>...
+//
+// Nazwa klatki to ścieżka pliku względem podanego katalogu, bez
+// rozszerzenia (np. "enemies/bat_0"); dla pojedynczego pliku — sama nazwa.
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#define STB_IMAGE_IMPLEMENTATION
+#define STBI_ONLY_PNG
+#include <stb_image.h>
+
+#include "atlas_file.h"
+#include "atlas_packer.h"
+
+namespace fs = std::filesystem;
+
+struct BuilderOptions {
+  std::string outputPath;
+  uint32_t pageSize = 2048;
+  uint32_t padding = 4; // piksele wokół klatki (powielona krawędź)
+  uint32_t mipLevelCount = 3;
+  std::vector<std::string> inputs;
+};
+
+// Zdekodowana klatka źródłowa
+struct SourceImage {
+  std::string name;
+  std::string path;
+  int width = 0;
+  int height = 0;
+  stbi_uc *pixels = nullptr;
+  uint32_t page = 0;
+  uint32_t x = 0, y = 0; // lewy górny róg z marginesem
+};
+
+static bool parseOptions(int argc, char **argv, BuilderOptions &options) {
+  for (int i = 1; i < argc; ++i) {
+    std::string arg = argv[i];
+    if (arg == "-o" && i + 1 < argc) {
+      options.outputPath = argv[++i];
+    } else if (arg == "--page" && i + 1 < argc) {
+      options.pageSize = uint32_t(std::strtoul(argv[++i], nullptr, 10));
+    } else if (arg == "--padding" && i + 1 < argc) {
+      options.padding = uint32_t(std::strtoul(argv[++i], nullptr, 10));
+    } else if (arg == "--mips" && i + 1 < argc) {
+      options.mipLevelCount =
+          std::max(1u, uint32_t(std::strtoul(argv[++i], nullptr, 10)));
+    } else if (!arg.empty() && arg[0] == '-') {
+      std::cerr << "Unknown option: " << arg << std::endl;
+      return false;
+    } else {
+      options.inputs.push_back(arg);
+    }
+  }
+
+  const uint32_t page = options.pageSize;
+  if (options.outputPath.empty() || options.inputs.empty() || page == 0 ||
+      page > (1u << 16) || (page & (page - 1)) != 0 ||
+      options.mipLevelCount > 17 ||
+      (page >> (options.mipLevelCount - 1)) == 0) {
+    std::cerr << "Usage: WarpAtlas -o out.watl [--page 2048] [--padding 4] "
+                 "[--mips 3] <file.png | directory>...\n"
+                 "  --page must be a power of two up to 65536, --mips at most "
+                 "log2(page) + 1"
+              << std::endl;
+    return false;
+  }
+  return true;
+}
+
+// Zbiera pliki PNG (katalogi rekurencyjnie), posortowane dla powtarzalności
+static std::vector<SourceImage> collectInputs(const BuilderOptions &options) {
+  std::vector<SourceImage> images;
+  for (const std::string &input : options.inputs) {
+    const fs::path root(input);
+    if (fs::is_directory(root)) {
+      std::vector<fs::path> files;
+      for (const auto &entry : fs::recursive_directory_iterator(root))
+        if (entry.is_regular_file() && entry.path().extension() == ".png")
+          files.push_back(entry.path());
+      std::sort(files.begin(), files.end());
+      for (const fs::path &file : files) {
+        fs::path relative = fs::relative(file, root);
+        relative.replace_extension();
+        images.push_back({relative.generic_string(), file.string()});
+      }
+    } else {
+      images.push_back({root.stem().string(), root.string()});
+    }
+  }
+  return images;
+}
+
+// Kopiuje klatkę na stronę i powiela skrajne piksele w margines — przy
+// filtrowaniu i niższych mipach sąsiednie klatki nie "przeciekają"
+static void blitWithExtrude(const SourceImage &image, uint32_t padding,
+                            uint8_t *page, uint32_t pageSize) {
+  const int w = image.width;
+  const int h = image.height;
+  const int pad = int(padding);
+  for (int y = -pad; y < h + pad; ++y) {
+    const int sy = std::clamp(y, 0, h - 1);
+    for (int x = -pad; x < w + pad; ++x) {
+      const int sx = std::clamp(x, 0, w - 1);
+      const uint64_t dst =
+          (uint64_t(image.y + pad + y) * pageSize + (image.x + pad + x)) * 4;
+      std::memcpy(page + dst, image.pixels + (uint64_t(sy) * w + sx) * 4, 4);
+    }
+  }
+}
+
+int main(int argc, char **argv) {
+  BuilderOptions options;
+  if (!parseOptions(argc, argv, options))
+    return -1;
+
+  // 1. Dekodowanie PNG (jedyne miejsce, gdzie to się dzieje)
+  std::vector<SourceImage> images = collectInputs(options);
+  if (images.empty()) {
+    std::cerr << "No PNG files found" << std::endl;
+    return -1;
+  }
+  for (SourceImage &image : images) {
+    int channels = 0;
+    image.pixels = stbi_load(image.path.c_str(), &image.width, &image.height,
+                             &channels, 4);
+    if (!image.pixels) {
+      std::cerr << "Could not decode " << image.path << ": "
+                << stbi_failure_reason() << std::endl;
+      return -1;
+    }
+  }
+
+  // 2. Pakowanie: od najwyższych klatek, pierwsza strona, na którą wejdzie
+  std::vector<uint32_t> order(images.size());
+  for (uint32_t i = 0; i < order.size(); ++i)
+    order[i] = i;
+  std::stable_sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) {
+    if (images[a].height != images[b].height)
+      return images[a].height > images[b].height;
+    return images[a].width > images[b].width;
+  });
+
+  std::vector<SkylinePacker> pages;
+  for (uint32_t index : order) {
+    SourceImage &image = images[index];
+    const uint32_t w = uint32_t(image.width) + options.padding * 2;
+    const uint32_t h = uint32_t(image.height) + options.padding * 2;
+    bool placed = false;
+    for (uint32_t page = 0; page < pages.size() && !placed; ++page) {
+      if (pages[page].insert(w, h, image.x, image.y)) {
+        image.page = page;
+        placed = true;
+      }
+    }
+    if (!placed) {
+      pages.emplace_back(options.pageSize, options.pageSize);
+      if (!pages.back().insert(w, h, image.x, image.y)) {
+        std::cerr << image.path << " (" << image.width << "x" << image.height
+                  << ") does not fit on a " << options.pageSize
+                  << " page" << std::endl;
+        return -1;
+      }
+      image.page = uint32_t(pages.size() - 1);
+    }
+  }
+
+  // 3. Strony z pikselami i łańcuchem mip
+  AtlasImage atlas;
+  atlas.pageSize = options.pageSize;
+  atlas.pageCount = uint32_t(pages.size());
+  atlas.mipLevelCount = options.mipLevelCount;
+  const uint64_t pageBytes =
+      atlasPageBytes(atlas.pageSize, atlas.mipLevelCount);
+  atlas.pixels.assign(pageBytes * atlas.pageCount, 0);
+  for (const SourceImage &image : images)
+    blitWithExtrude(image, options.padding,
+                    atlas.pixels.data() + pageBytes * image.page,
+                    atlas.pageSize);
+  for (uint32_t page = 0; page < atlas.pageCount; ++page)
+    generateMipChain(atlas.pixels.data() + pageBytes * page, atlas.pageSize,
+                     atlas.mipLevelCount);
+
+  // 4. Tablica klatek (kolejność wejścia) i nazwy
+  const float invSize = 1.0f / float(atlas.pageSize);
+  for (const SourceImage &image : images) {
+    AtlasFrame frame = {};
+    frame.nameOffset = uint32_t(atlas.names.size());
+    frame.page = image.page;
+    frame.x = uint16_t(image.x + options.padding);
+    frame.y = uint16_t(image.y + options.padding);
+    frame.width = uint16_t(image.width);
+    frame.height = uint16_t(image.height);
+    frame.uvRect[0] = frame.x * invSize;
+    frame.uvRect[1] = frame.y * invSize;
+    frame.uvRect[2] = (frame.x + frame.width) * invSize;
+    frame.uvRect[3] = (frame.y + frame.height) * invSize;
+    atlas.frames.push_back(frame);
+    atlas.names.insert(atlas.names.end(), image.name.begin(),
+                       image.name.end());
+    atlas.names.push_back('\0');
+    stbi_image_free(image.pixels);
+  }
+
+  if (!writeAtlasFile(options.outputPath.c_str(), atlas))
+    return -1;
+
+  std::cout << "Atlas written to " << options.outputPath << ": "
+            << atlas.frames.size() << " frames, " << atlas.pageCount
+            << " pages " << atlas.pageSize << "x" << atlas.pageSize << ", "
+            << atlas.mipLevelCount << " mips" << std::endl;
+  for (uint32_t page = 0; page < pages.size(); ++page)
+    std::cout << "  page " << page << ": "
+              << int(pages[page].occupancy() * 100.0f) << "% used"
+              << std::endl;
+  return 0;
+}
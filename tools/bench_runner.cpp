@@ -0,0 +1,202 @@
+// WarpBench — deterministyczne scenariusze wydajności: uruchamia silnik w
+// trybie headless dla każdego scenariusza, zbiera raporty JSON (p50/p95/
+// p99/max czasów CPU i GPU, encje/s) i porównuje je z plikiem bazowym.
+//
+//   WarpBench [--engine path/WarpEngine] [--frames 600] [--warmup 60]
+//             [--seed 12345] [--scenario name]... [-o results.json]
+//             [--baseline baseline.json] [--tolerance 0.10]
+//             [--update-baseline]
+//
+// Kod wyjścia: 0 — brak regresji, 1 — regresja względem bazy, 2 — błąd.
+
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "bench_report.h"
+
+namespace fs = std::filesystem;
+
+// Scenariusz = zestaw opcji silnika; ten sam seed i liczba klatek dają
+// tę samą pracę w każdym przebiegu
+struct BenchScenario {
+  const char *name;
+  const char *arguments;
+};
+
+static const BenchScenario kScenarios[] = {
+    {"sprites_1k", "--enemies 1000"},
+    {"sprites_10k", "--enemies 10000"},
+    {"sprites_100k", "--enemies 100000"},
+    {"horde_collision", "--enemies 20000 --gpu-horde 131072"},
+    {"particle_bursts", "--particles 262144 --bursts 30"},
+    {"text_flood", "--enemies 1000 --damage-numbers 2000"},
+};
+
+struct BenchOptions {
+  std::string enginePath;
+  uint32_t frames = 600;
+  uint32_t warmup = 60;
+  uint32_t seed = 12345;
+  std::vector<std::string> scenarios; // puste = wszystkie
+  std::string outputPath = "bench_results.json";
+  std::string baselinePath;
+  double tolerance = 0.10;
+  bool updateBaseline = false;
+};
+
+static bool parseOptions(int argc, char **argv, BenchOptions &options) {
+  for (int i = 1; i < argc; ++i) {
+    std::string arg = argv[i];
+    if (arg == "--engine" && i + 1 < argc) {
+      options.enginePath = argv[++i];
+    } else if (arg == "--frames" && i + 1 < argc) {
+      options.frames = uint32_t(std::strtoul(argv[++i], nullptr, 10));
+    } else if (arg == "--warmup" && i + 1 < argc) {
+      options.warmup = uint32_t(std::strtoul(argv[++i], nullptr, 10));
+    } else if (arg == "--seed" && i + 1 < argc) {
+      options.seed = uint32_t(std::strtoul(argv[++i], nullptr, 10));
+    } else if (arg == "--scenario" && i + 1 < argc) {
+      options.scenarios.push_back(argv[++i]);
+    } else if (arg == "-o" && i + 1 < argc) {
+      options.outputPath = argv[++i];
+    } else if (arg == "--baseline" && i + 1 < argc) {
+      options.baselinePath = argv[++i];
+    } else if (arg == "--tolerance" && i + 1 < argc) {
+      options.tolerance = std::strtod(argv[++i], nullptr);
+    } else if (arg == "--update-baseline") {
+      options.updateBaseline = true;
+    } else {
+      std::cerr << "Unknown option: " << arg << "\n"
+                << "Usage: WarpBench [--engine path] [--frames 600] "
+                   "[--warmup 60] [--seed 12345]\n"
+                   "                 [--scenario name]... [-o results.json] "
+                   "[--baseline baseline.json]\n"
+                   "                 [--tolerance 0.10] [--update-baseline]"
+                << std::endl;
+      return false;
+    }
+  }
+  if (options.frames == 0 || options.tolerance < 0.0) {
+    std::cerr << "--frames must be positive and --tolerance non-negative"
+              << std::endl;
+    return false;
+  }
+  if (options.updateBaseline && options.baselinePath.empty()) {
+    std::cerr << "--update-baseline requires --baseline" << std::endl;
+    return false;
+  }
+  return true;
+}
+
+// Domyślnie silnik leży obok WarpBench (ten sam katalog wyjściowy CMake)
+static std::string defaultEnginePath(const char *argv0) {
+#ifdef _WIN32
+  const char *engineName = "WarpEngine.exe";
+#else
+  const char *engineName = "WarpEngine";
+#endif
+  return (fs::path(argv0).parent_path() / engineName).string();
+}
+
+static bool runScenario(const BenchOptions &options,
+                        const BenchScenario &scenario, BenchResult &result) {
+  const fs::path reportPath =
+      fs::temp_directory_path() /
+      (std::string("warpbench_") + scenario.name + ".json");
+  const std::string logPath = reportPath.string() + ".log";
+  // Bez pliku rozgrzewki pipeline'ów — każdy przebieg startuje tak samo,
+  // a kompilacja mieści się w klatkach rozgrzewki
+  const std::string command =
+      "\"" + options.enginePath + "\" --headless --frames " +
+      std::to_string(options.frames + options.warmup) + " --warmup " +
+      std::to_string(options.warmup) + " --seed " +
+      std::to_string(options.seed) + " --pipeline-cache none " +
+      scenario.arguments + " --report \"" + reportPath.string() + "\" > \"" +
+      logPath + "\" 2>&1";
+
+  std::cout << "[" << scenario.name << "] " << scenario.arguments
+            << std::endl;
+  std::error_code error;
+  fs::remove(reportPath, error);
+  const int status = std::system(command.c_str());
+  std::vector<BenchResult> results;
+  if (status != 0 || !readBenchReport(reportPath.string().c_str(), results) ||
+      results.empty()) {
+    std::cerr << "Scenario " << scenario.name << " failed (exit " << status
+              << "), engine log: " << logPath << std::endl;
+    return false;
+  }
+  fs::remove(reportPath, error);
+  fs::remove(logPath, error);
+
+  result = results.front();
+  result.name = scenario.name;
+  std::printf("  cpu p50 %.3f p95 %.3f p99 %.3f max %.3f ms", result.cpu.p50,
+              result.cpu.p95, result.cpu.p99, result.cpu.max);
+  if (result.gpu.samples)
+    std::printf(" | gpu p50 %.3f p99 %.3f ms", result.gpu.p50,
+                result.gpu.p99);
+  std::printf(" | %.3g entities/s\n", result.entitiesPerSecond);
+  return true;
+}
+
+int main(int argc, char **argv) {
+  BenchOptions options;
+  if (!parseOptions(argc, argv, options))
+    return 2;
+  if (options.enginePath.empty())
+    options.enginePath = defaultEnginePath(argv[0]);
+
+  std::vector<BenchResult> results;
+  for (const BenchScenario &scenario : kScenarios) {
+    bool selected = options.scenarios.empty();
+    for (const std::string &name : options.scenarios)
+      selected |= name == scenario.name;
+    if (!selected)
+      continue;
+    BenchResult result;
+    if (!runScenario(options, scenario, result))
+      return 2;
+    results.push_back(std::move(result));
+  }
+  if (results.empty()) {
+    std::cerr << "No matching scenarios" << std::endl;
+    return 2;
+  }
+  if (!writeBenchReport(options.outputPath.c_str(), results))
+    return 2;
+  std::cout << "Results written to " << options.outputPath << std::endl;
+
+  if (options.baselinePath.empty())
+    return 0;
+  if (options.updateBaseline) {
+    if (!writeBenchReport(options.baselinePath.c_str(), results))
+      return 2;
+    std::cout << "Baseline updated: " << options.baselinePath << std::endl;
+    return 0;
+  }
+  if (!fs::exists(options.baselinePath)) {
+    std::cout << "No baseline at " << options.baselinePath
+              << " (create it with --update-baseline)" << std::endl;
+    return 0;
+  }
+  std::vector<BenchResult> baseline;
+  if (!readBenchReport(options.baselinePath.c_str(), baseline))
+    return 2;
+
+  std::cout << "\nComparison with " << options.baselinePath
+            << " (tolerance " << options.tolerance * 100.0 << "%):"
+            << std::endl;
+  const uint32_t regressions =
+      compareBenchResults(results, baseline, options.tolerance);
+  if (regressions) {
+    std::cout << regressions << " regression(s)" << std::endl;
+    return 1;
+  }
+  std::cout << "No regressions" << std::endl;
+  return 0;
+}
@@ -0,0 +1,81 @@
+// WarpMap — etap potoku assetów: generuje proceduralną arenę kafelkową i
+// zapisuje ją jako plik .wmap (chunki RLE) strumieniowany przez silnik.
+//
+//   WarpMap -o arena.wmap [--chunks 32] [--chunk-size 32] [--tile 32]
+//           [--seed 1]
+//
+// Mapa ma --chunks × --chunks chunków po --chunk-size × --chunk-size
+// kafelków o boku --tile jednostek świata.
+
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <string>
+
+#include "tilemap_file.h"
+
+namespace fs = std::filesystem;
+
+struct BuilderOptions {
+  std::string outputPath;
+  uint32_t chunks = 32;
+  uint32_t chunkSize = 32;
+  float tileSize = 32.0f;
+  uint32_t seed = 1;
+};
+
+static bool parseOptions(int argc, char **argv, BuilderOptions &options) {
+  for (int i = 1; i < argc; ++i) {
+    std::string arg = argv[i];
+    if (arg == "-o" && i + 1 < argc) {
+      options.outputPath = argv[++i];
+    } else if (arg == "--chunks" && i + 1 < argc) {
+      options.chunks = uint32_t(std::strtoul(argv[++i], nullptr, 10));
+    } else if (arg == "--chunk-size" && i + 1 < argc) {
+      options.chunkSize = uint32_t(std::strtoul(argv[++i], nullptr, 10));
+    } else if (arg == "--tile" && i + 1 < argc) {
+      options.tileSize = std::strtof(argv[++i], nullptr);
+    } else if (arg == "--seed" && i + 1 < argc) {
+      options.seed = uint32_t(std::strtoul(argv[++i], nullptr, 10));
+    } else {
+      std::cerr << "Unknown option: " << arg << std::endl;
+      return false;
+    }
+  }
+
+  // Chunk to jeden bufor instancji na GPU — większe psują ziarno
+  // strumieniowania (i culling)
+  if (options.outputPath.empty() || options.chunks == 0 ||
+      options.chunkSize == 0 || options.chunkSize > kMaxTilemapChunkSize ||
+      uint64_t(options.chunks) * options.chunkSize > kMaxTilemapSide ||
+      options.tileSize <= 0.0f) {
+    std::cerr << "Usage: WarpMap -o out.wmap [--chunks 32] [--chunk-size 32] "
+                 "[--tile 32] [--seed 1]\n"
+                 "  --chunk-size must be in 1..256 and the map at most "
+                 "4096 tiles per side"
+              << std::endl;
+    return false;
+  }
+  return true;
+}
+
+int main(int argc, char **argv) {
+  BuilderOptions options;
+  if (!parseOptions(argc, argv, options))
+    return -1;
+
+  const TilemapImage map =
+      generateArenaTilemap(options.chunks, options.chunks, options.chunkSize,
+                           options.tileSize, options.seed);
+  if (!writeTilemapFile(options.outputPath.c_str(), map))
+    return -1;
+
+  std::cout << "Map written to " << options.outputPath << ": "
+            << map.chunksX * map.chunkSize << "x"
+            << map.chunksY * map.chunkSize << " tiles, "
+            << map.chunksX * map.chunksY << " chunks, "
+            << fs::file_size(options.outputPath) / 1024
+            << " KB (raw " << map.tiles.size() * sizeof(uint16_t) / 1024
+            << " KB)" << std::endl;
+  return 0;
+}